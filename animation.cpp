@@ -0,0 +1,163 @@
+#include "animation.h"
+
+#include <cmath>
+#include <limits>
+
+namespace {
+    const int kEaseLutSize = 256;
+    const float kNever = std::numeric_limits<float>::infinity();
+
+    float EaseExact(Ease ease, float t) {
+        switch (ease) {
+        case Ease::OutQuad:
+            return 1.0f - (1.0f - t) * (1.0f - t);
+        case Ease::OutCubic: {
+            float u = 1.0f - t;
+            return 1.0f - u * u * u;
+        }
+        case Ease::InOutCubic: {
+            if (t < 0.5f) return 4.0f * t * t * t;
+            float u = -2.0f * t + 2.0f;
+            return 1.0f - u * u * u * 0.5f;
+        }
+        default:
+            return t;
+        }
+    }
+
+    // One extra sample per curve so t = 1 interpolates without a branch.
+    struct EaseTables {
+        float samples[static_cast<int>(Ease::Count)][kEaseLutSize + 1];
+
+        EaseTables() {
+            for (int e = 0; e < static_cast<int>(Ease::Count); ++e) {
+                for (int i = 0; i <= kEaseLutSize; ++i) {
+                    samples[e][i] = EaseExact(static_cast<Ease>(e), static_cast<float>(i) / kEaseLutSize);
+                }
+            }
+        }
+    };
+
+    const EaseTables g_ease_tables;
+}
+
+float EvaluateEase(Ease ease, float t) {
+    float x = t * kEaseLutSize;
+    int i = static_cast<int>(x);
+    if (i < 0) return g_ease_tables.samples[static_cast<int>(ease)][0];
+    if (i >= kEaseLutSize) return g_ease_tables.samples[static_cast<int>(ease)][kEaseLutSize];
+    const float* lut = g_ease_tables.samples[static_cast<int>(ease)];
+    return lut[i] + (lut[i + 1] - lut[i]) * (x - static_cast<float>(i));
+}
+
+Animator::Animator() : next_redraw_(kNever) {}
+
+TweenId Animator::Start(float from, float to, float duration, Ease ease, float start_time, bool loop) {
+    uint16_t slot = 0;
+    if (!free_slots_.empty()) {
+        slot = free_slots_.back();
+        free_slots_.pop_back();
+    } else {
+        slot = static_cast<uint16_t>(generation_.size());
+        generation_.push_back(0);
+        running_index_.push_back(-1);
+        value_.push_back(0.0f);
+    }
+    // Generation 0 is skipped so that no live id equals kNoTween.
+    if (++generation_[slot] == 0) generation_[slot] = 1;
+    TweenId id = (static_cast<TweenId>(generation_[slot]) << 16) | slot;
+
+    if (duration <= 0.0f && !loop) {
+        value_[slot] = to;
+        running_index_[slot] = -1;
+        return id;
+    }
+    value_[slot] = from;
+    running_index_[slot] = static_cast<int32_t>(slot_.size());
+    slot_.push_back(slot);
+    start_.push_back(start_time);
+    inv_duration_.push_back(duration > 0.0f ? 1.0f / duration : 0.0f);
+    from_.push_back(from);
+    delta_.push_back(to - from);
+    ease_.push_back(ease);
+    loop_.push_back(loop ? 1 : 0);
+    // Started after this frame's Update(): draw again on the next frame at
+    // the latest.
+    float first_change = start_time > last_update_ ? start_time : last_update_;
+    if (first_change < next_redraw_) next_redraw_ = first_change;
+    return id;
+}
+
+void Animator::Release(TweenId& id) {
+    if (Live(id)) {
+        uint16_t slot = static_cast<uint16_t>(id & 0xFFFF);
+        if (running_index_[slot] >= 0) RemoveRunning(static_cast<size_t>(running_index_[slot]));
+        ++generation_[slot];
+        free_slots_.push_back(slot);
+    }
+    id = kNoTween;
+}
+
+void Animator::Update(float now) {
+    last_update_ = now;
+    float next = kNever;
+    size_t i = 0;
+    while (i < slot_.size()) {
+        float elapsed = now - start_[i];
+        if (elapsed < 0.0f) {
+            value_[slot_[i]] = from_[i];
+            if (start_[i] < next) next = start_[i];
+            ++i;
+            continue;
+        }
+        float t = elapsed * inv_duration_[i];
+        if (loop_[i]) {
+            t -= std::floor(t);
+        } else if (t >= 1.0f) {
+            value_[slot_[i]] = from_[i] + delta_[i];
+            RemoveRunning(i);
+            continue;
+        }
+        value_[slot_[i]] = from_[i] + delta_[i] * EvaluateEase(ease_[i], t);
+        next = now;
+        ++i;
+    }
+    next_redraw_ = next;
+}
+
+float Animator::Value(TweenId id, float fallback) const {
+    if (!Live(id)) return fallback;
+    return value_[id & 0xFFFF];
+}
+
+bool Animator::Running(TweenId id) const {
+    return Live(id) && running_index_[id & 0xFFFF] >= 0;
+}
+
+bool Animator::Live(TweenId id) const {
+    size_t slot = id & 0xFFFF;
+    return id != kNoTween && slot < generation_.size() && generation_[slot] == (id >> 16);
+}
+
+// Swap-removes entry |index| from the running arrays.
+void Animator::RemoveRunning(size_t index) {
+    size_t last = slot_.size() - 1;
+    running_index_[slot_[index]] = -1;
+    if (index != last) {
+        slot_[index] = slot_[last];
+        start_[index] = start_[last];
+        inv_duration_[index] = inv_duration_[last];
+        from_[index] = from_[last];
+        delta_[index] = delta_[last];
+        ease_[index] = ease_[last];
+        loop_[index] = loop_[last];
+        running_index_[slot_[index]] = static_cast<int32_t>(index);
+    }
+    slot_.pop_back();
+    start_.pop_back();
+    inv_duration_.pop_back();
+    from_.pop_back();
+    delta_.pop_back();
+    ease_.pop_back();
+    loop_.pop_back();
+}
@@ -0,0 +1,75 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Tween scheduler for UI animation. Running tweens are stored as parallel
+// arrays and evaluated together by one Update() per frame, with easing curves
+// sampled from lookup tables. Callers keep a TweenId and read Value() while
+// drawing; NextRedrawTime() tells the frame loop when anything animated will
+// next change, so it can sleep until then.
+
+enum class Ease : uint8_t {
+    Linear,
+    OutQuad,
+    OutCubic,
+    InOutCubic,
+    Count
+};
+
+// Slot index in the low 16 bits, slot generation in the high 16. Ids of
+// released tweens never match a live one, and kNoTween is never issued.
+using TweenId = uint32_t;
+static constexpr TweenId kNoTween = 0;
+
+// |t| in [0, 1].
+float EvaluateEase(Ease ease, float t);
+
+class Animator {
+public:
+    Animator();
+
+    // Animates from |from| to |to| over |duration| seconds starting at
+    // |start_time|; before then Value() is |from|. A looping tween wraps
+    // back to |from| each period and only stops when released.
+    TweenId Start(float from, float to, float duration, Ease ease, float start_time, bool loop = false);
+    // Frees the tween's slot and resets |id| to kNoTween.
+    void Release(TweenId& id);
+
+    // Evaluates every running tween at |now|; tweens that reach the end hold
+    // their final value until released.
+    void Update(float now);
+
+    // Value as of the last Update(), or |fallback| for kNoTween or a
+    // released id.
+    float Value(TweenId id, float fallback = 0.0f) const;
+    // True until a non-looping tween reaches its end.
+    bool Running(TweenId id) const;
+
+    // Earliest time any tween changes value: the last Update() time while
+    // one is in progress, the start of the next delayed tween, or infinity
+    // when nothing is animating.
+    float NextRedrawTime() const { return next_redraw_; }
+
+private:
+    bool Live(TweenId id) const;
+    void RemoveRunning(size_t index);
+
+    // Running tweens, one entry per array; order is not significant.
+    std::vector<uint16_t> slot_;
+    std::vector<float> start_;
+    std::vector<float> inv_duration_;
+    std::vector<float> from_;
+    std::vector<float> delta_;
+    std::vector<Ease> ease_;
+    std::vector<uint8_t> loop_;
+
+    // Per slot; running_index_ is -1 once the tween has finished.
+    std::vector<uint16_t> generation_;
+    std::vector<int32_t> running_index_;
+    std::vector<float> value_;
+    std::vector<uint16_t> free_slots_;
+
+    float last_update_ = 0.0f;
+    float next_redraw_;
+};
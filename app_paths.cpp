@@ -0,0 +1,107 @@
+#include "app_paths.h"
+
+#include <cstdlib>
+#include <cstring>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/stat.h>
+#endif
+
+static std::string ResolveAppDataDir() {
+#ifdef _WIN32
+    const wchar_t* base = _wgetenv(L"APPDATA");
+    if (!base || !*base) return "";
+    std::wstring dir = std::wstring(base) + L"\\ModGui";
+    CreateDirectoryW(dir.c_str(), nullptr);
+    int size = WideCharToMultiByte(CP_UTF8, 0, dir.c_str(), -1, nullptr, 0, nullptr, nullptr);
+    std::string utf8(size - 1, '\0');
+    WideCharToMultiByte(CP_UTF8, 0, dir.c_str(), -1, utf8.data(), size, nullptr, nullptr);
+    return utf8 + "\\";
+#else
+    std::string dir;
+    if (const char* xdg = std::getenv("XDG_DATA_HOME"); xdg && *xdg) {
+        dir = xdg;
+    } else if (const char* home = std::getenv("HOME"); home && *home) {
+        dir = std::string(home) + "/.local/share";
+    } else {
+        return "";
+    }
+    dir += "/ModGui";
+    for (size_t pos = dir.find('/', 1); pos != std::string::npos; pos = dir.find('/', pos + 1)) {
+        mkdir(dir.substr(0, pos).c_str(), 0755);
+    }
+    mkdir(dir.c_str(), 0755);
+    return dir + "/";
+#endif
+}
+
+const std::string& GetAppDataDir() {
+    static const std::string dir = ResolveAppDataDir();
+    return dir;
+}
+
+std::string AppDataPath(const char* file_name) {
+    return GetAppDataDir() + file_name;
+}
+
+#ifdef _WIN32
+static std::wstring WidenPath(const std::string& path) {
+    int size = MultiByteToWideChar(CP_UTF8, 0, path.c_str(), -1, nullptr, 0);
+    if (size <= 0) return L"";
+    std::wstring wide(size - 1, L'\0');
+    MultiByteToWideChar(CP_UTF8, 0, path.c_str(), -1, wide.data(), size);
+    return wide;
+}
+#endif
+
+FILE* OpenFileUtf8(const std::string& path, const char* mode) {
+#ifdef _WIN32
+    std::wstring wide_mode(mode, mode + strlen(mode));
+    return _wfopen(WidenPath(path).c_str(), wide_mode.c_str());
+#else
+    return fopen(path.c_str(), mode);
+#endif
+}
+
+bool RenameFileUtf8(const std::string& from, const std::string& to) {
+#ifdef _WIN32
+    return MoveFileExW(WidenPath(from).c_str(), WidenPath(to).c_str(), MOVEFILE_REPLACE_EXISTING) != 0;
+#else
+    return rename(from.c_str(), to.c_str()) == 0;
+#endif
+}
+
+bool RemoveFileUtf8(const std::string& path) {
+#ifdef _WIN32
+    return DeleteFileW(WidenPath(path).c_str()) != 0;
+#else
+    return remove(path.c_str()) == 0;
+#endif
+}
+
+bool ReadFileUtf8(const std::string& path, std::string& out) {
+    FILE* file = OpenFileUtf8(path, "rb");
+    if (!file) return false;
+    out.clear();
+    char buffer[1024];
+    size_t read = 0;
+    while ((read = fread(buffer, 1, sizeof(buffer), file)) > 0) {
+        out.append(buffer, read);
+    }
+    fclose(file);
+    return true;
+}
+
+bool WriteFileAtomicUtf8(const std::string& path, const std::string& data) {
+    std::string tmp = path + ".tmp";
+    FILE* file = OpenFileUtf8(tmp, "wb");
+    if (!file) return false;
+#ifndef _WIN32
+    chmod(tmp.c_str(), 0600);
+#endif
+    bool ok = fwrite(data.data(), 1, data.size(), file) == data.size();
+    ok = fclose(file) == 0 && ok;
+    return ok && RenameFileUtf8(tmp, path);
+}
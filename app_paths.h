@@ -0,0 +1,23 @@
+#pragma once
+#include <cstdio>
+#include <string>
+
+// Per-user data directory for launcher state (logs, caches, indexes), as a
+// UTF-8 path with a trailing separator. Created on first use; empty when no
+// suitable location exists.
+const std::string& GetAppDataDir();
+
+// Joins the data directory with |file_name|.
+std::string AppDataPath(const char* file_name);
+
+// fopen/rename for UTF-8 paths; on Windows these go through the wide APIs so
+// non-ASCII profile directories work. RenameFileUtf8 replaces |to|.
+FILE* OpenFileUtf8(const std::string& path, const char* mode);
+bool RenameFileUtf8(const std::string& from, const std::string& to);
+bool RemoveFileUtf8(const std::string& path);
+
+// Reads the whole file into |out|.
+bool ReadFileUtf8(const std::string& path, std::string& out);
+// Writes through a temporary file and renames it into place, so a crash never
+// leaves a torn file. On POSIX the file is created owner-only.
+bool WriteFileAtomicUtf8(const std::string& path, const std::string& data);
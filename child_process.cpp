@@ -0,0 +1,544 @@
+#include "child_process.h"
+
+#include <algorithm>
+#include <atomic>
+
+#include "output_ring.h"
+#include "string_util.h"
+#include "trace.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#include <cwchar>
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <spawn.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+extern char** environ;
+#endif
+
+static const size_t kReadChunkSize = 16 * 1024;
+
+ChildProcess::~ChildProcess() {
+    Release();
+}
+
+#ifdef _WIN32
+
+static void CloseIfValid(HANDLE& handle) {
+    if (handle && handle != INVALID_HANDLE_VALUE) CloseHandle(handle);
+    handle = nullptr;
+}
+
+// Anonymous pipes cannot be read with OVERLAPPED I/O, so each pipe is a
+// uniquely named one: the parent keeps the overlapped read end, the child
+// inherits a plain write end.
+static bool CreateOverlappedPipe(HANDLE& read_end, HANDLE& write_end) {
+    static std::atomic<unsigned> counter{0};
+    wchar_t name[80];
+    swprintf(name, 80, L"\\\\.\\pipe\\ModGui.%lu.%u", GetCurrentProcessId(), counter.fetch_add(1));
+    read_end = CreateNamedPipeW(name, PIPE_ACCESS_INBOUND | FILE_FLAG_OVERLAPPED | FILE_FLAG_FIRST_PIPE_INSTANCE,
+                                PIPE_TYPE_BYTE | PIPE_WAIT | PIPE_REJECT_REMOTE_CLIENTS, 1, 0,
+                                static_cast<DWORD>(kReadChunkSize), 0, nullptr);
+    if (read_end == INVALID_HANDLE_VALUE) {
+        read_end = nullptr;
+        return false;
+    }
+    SECURITY_ATTRIBUTES sa = { sizeof(sa), nullptr, TRUE };
+    write_end = CreateFileW(name, GENERIC_WRITE, 0, &sa, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (write_end == INVALID_HANDLE_VALUE) {
+        write_end = nullptr;
+        CloseIfValid(read_end);
+        return false;
+    }
+    return true;
+}
+
+// Name part of a "NAME=value" entry. Hidden per-drive entries such as
+// "=C:=C:\dir" start with '=', so the search skips the first character.
+static size_t EnvNameLength(const std::wstring& var) {
+    size_t eq = var.find(L'=', 1);
+    return eq == std::wstring::npos ? var.size() : eq;
+}
+
+// The launcher's environment with |overrides| applied, as a double-null
+// terminated block sorted by name the way CreateProcessW expects.
+static std::vector<wchar_t> BuildEnvironmentBlock(const std::vector<EnvOverride>& overrides) {
+    std::vector<std::wstring> vars;
+    if (wchar_t* current = GetEnvironmentStringsW()) {
+        for (const wchar_t* p = current; *p; p += wcslen(p) + 1) vars.emplace_back(p);
+        FreeEnvironmentStringsW(current);
+    }
+    for (const EnvOverride& entry : overrides) {
+        std::wstring name = Utf8ToWide(entry.name);
+        if (name.empty() || name.find(L'=') != std::wstring::npos) continue;
+        for (size_t i = 0; i < vars.size();) {
+            size_t length = EnvNameLength(vars[i]);
+            if (CompareStringOrdinal(vars[i].c_str(), static_cast<int>(length), name.c_str(),
+                                     static_cast<int>(name.size()), TRUE) == CSTR_EQUAL) {
+                vars.erase(vars.begin() + i);
+            } else {
+                ++i;
+            }
+        }
+        if (!entry.value.empty()) vars.push_back(name + L"=" + Utf8ToWide(entry.value));
+    }
+    std::sort(vars.begin(), vars.end(), [](const std::wstring& a, const std::wstring& b) {
+        return CompareStringOrdinal(a.c_str(), static_cast<int>(EnvNameLength(a)), b.c_str(),
+                                    static_cast<int>(EnvNameLength(b)), TRUE) == CSTR_LESS_THAN;
+    });
+
+    std::vector<wchar_t> block;
+    for (const std::wstring& var : vars) {
+        block.insert(block.end(), var.begin(), var.end());
+        block.push_back(L'\0');
+    }
+    if (vars.empty()) block.push_back(L'\0');
+    block.push_back(L'\0');
+    return block;
+}
+
+// Reads both pipes until the child closes them or |stop| is signaled,
+// appending to |output|, or discarding the bytes when it is null.
+static void ReaderMain(HANDLE out_pipe, HANDLE err_pipe, HANDLE stop, OutputRing* output) {
+    TRACE_THREAD_NAME(output ? "Child output" : "Child drain");
+    struct PendingRead {
+        HANDLE pipe;
+        OVERLAPPED overlapped;
+        bool open;
+        bool pending;
+        char buffer[kReadChunkSize];
+    };
+    static const OutputStream kStreams[2] = { OutputStream::Stdout, OutputStream::Stderr };
+    PendingRead* reads = new PendingRead[2]();
+    HANDLE pipes[2] = { out_pipe, err_pipe };
+    for (int i = 0; i < 2; ++i) {
+        reads[i].pipe = pipes[i];
+        reads[i].overlapped.hEvent = CreateEventW(nullptr, TRUE, FALSE, nullptr);
+        reads[i].open = true;
+    }
+
+    for (;;) {
+        HANDLE waits[3];
+        int wait_index[3];
+        DWORD wait_count = 0;
+        for (int i = 0; i < 2; ++i) {
+            PendingRead& read = reads[i];
+            if (read.open && !read.pending) {
+                ResetEvent(read.overlapped.hEvent);
+                // Completion always signals the event, even when ReadFile
+                // finishes synchronously, so both cases are handled below.
+                if (ReadFile(read.pipe, read.buffer, static_cast<DWORD>(kReadChunkSize), nullptr, &read.overlapped) ||
+                    GetLastError() == ERROR_IO_PENDING) {
+                    read.pending = true;
+                } else {
+                    read.open = false;
+                }
+            }
+            if (read.pending) {
+                wait_index[wait_count] = i;
+                waits[wait_count++] = read.overlapped.hEvent;
+            }
+        }
+        if (wait_count == 0) break;
+        if (stop) {
+            wait_index[wait_count] = -1;
+            waits[wait_count++] = stop;
+        }
+
+        DWORD signaled = WaitForMultipleObjects(wait_count, waits, FALSE, INFINITE);
+        if (signaled < WAIT_OBJECT_0 || signaled >= WAIT_OBJECT_0 + wait_count) break;
+        int index = wait_index[signaled - WAIT_OBJECT_0];
+        if (index < 0) break;
+
+        PendingRead& read = reads[index];
+        read.pending = false;
+        DWORD bytes = 0;
+        if (GetOverlappedResult(read.pipe, &read.overlapped, &bytes, FALSE)) {
+            if (output) output->Append(kStreams[index], read.buffer, bytes);
+        } else {
+            // ERROR_BROKEN_PIPE: the child side closed.
+            read.open = false;
+        }
+    }
+
+    // Outstanding reads must finish before their buffers are freed.
+    for (int i = 0; i < 2; ++i) {
+        if (reads[i].pending) {
+            DWORD bytes = 0;
+            CancelIoEx(reads[i].pipe, &reads[i].overlapped);
+            GetOverlappedResult(reads[i].pipe, &reads[i].overlapped, &bytes, TRUE);
+        }
+        CloseHandle(reads[i].overlapped.hEvent);
+    }
+    delete[] reads;
+}
+
+bool ChildProcess::Start(const std::string& path, const ChildLaunchOptions& options, OutputRing* output) {
+    Release();
+    error_ = 0;
+    bool capture = options.capture_output && output;
+
+    HANDLE child_ends[2] = {};
+    HANDLE null_input = nullptr;
+    STARTUPINFOEXW si = {};
+    si.StartupInfo.cb = sizeof(si);
+    std::vector<char> attribute_storage;
+    if (capture) {
+        SECURITY_ATTRIBUTES sa = { sizeof(sa), nullptr, TRUE };
+        null_input = CreateFileW(L"NUL", GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, &sa, OPEN_EXISTING, 0, nullptr);
+        HANDLE read_ends[2] = {};
+        bool ok = null_input != INVALID_HANDLE_VALUE &&
+                  CreateOverlappedPipe(read_ends[0], child_ends[0]) &&
+                  CreateOverlappedPipe(read_ends[1], child_ends[1]);
+        // Inheritable handles are visible to every child created while they
+        // exist, so with launches running in parallel one child could hold
+        // another's pipe open. The handle list limits each child to its own.
+        HANDLE inherited[3] = { null_input, child_ends[0], child_ends[1] };
+        if (ok) {
+            SIZE_T size = 0;
+            InitializeProcThreadAttributeList(nullptr, 1, 0, &size);
+            attribute_storage.resize(size);
+            si.lpAttributeList = reinterpret_cast<LPPROC_THREAD_ATTRIBUTE_LIST>(attribute_storage.data());
+            ok = InitializeProcThreadAttributeList(si.lpAttributeList, 1, 0, &size) != FALSE;
+            if (!ok) si.lpAttributeList = nullptr;
+            ok = ok && UpdateProcThreadAttribute(si.lpAttributeList, 0, PROC_THREAD_ATTRIBUTE_HANDLE_LIST, inherited,
+                                                 sizeof(inherited), nullptr, nullptr);
+        }
+        if (!ok) {
+            error_ = GetLastError();
+            if (si.lpAttributeList) DeleteProcThreadAttributeList(si.lpAttributeList);
+            CloseIfValid(read_ends[0]);
+            CloseIfValid(read_ends[1]);
+            CloseIfValid(child_ends[0]);
+            CloseIfValid(child_ends[1]);
+            if (null_input != INVALID_HANDLE_VALUE) CloseHandle(null_input);
+            return false;
+        }
+        pipes_[0] = read_ends[0];
+        pipes_[1] = read_ends[1];
+        si.StartupInfo.dwFlags = STARTF_USESTDHANDLES;
+        si.StartupInfo.hStdInput = null_input;
+        si.StartupInfo.hStdOutput = child_ends[0];
+        si.StartupInfo.hStdError = child_ends[1];
+    }
+
+    std::wstring command = L"\"" + Utf8ToWide(path) + L"\"";
+    if (!options.arguments.empty()) command += L" " + Utf8ToWide(options.arguments);
+    std::wstring working_dir = Utf8ToWide(options.working_dir);
+    std::vector<wchar_t> environment;
+    DWORD flags = capture ? CREATE_NO_WINDOW | EXTENDED_STARTUPINFO_PRESENT : 0;
+    if (!options.environment.empty()) {
+        environment = BuildEnvironmentBlock(options.environment);
+        flags |= CREATE_UNICODE_ENVIRONMENT;
+    }
+
+    PROCESS_INFORMATION pi = {};
+    BOOL ok = CreateProcessW(nullptr, command.data(), nullptr, nullptr, capture ? TRUE : FALSE, flags,
+                             environment.empty() ? nullptr : environment.data(),
+                             working_dir.empty() ? nullptr : working_dir.c_str(), &si.StartupInfo, &pi);
+    if (!ok) error_ = GetLastError();
+    if (si.lpAttributeList) DeleteProcThreadAttributeList(si.lpAttributeList);
+    // The child holds its own copies; closing ours lets the reader see EOF
+    // once the child and its descendants exit.
+    CloseIfValid(child_ends[0]);
+    CloseIfValid(child_ends[1]);
+    if (capture) CloseHandle(null_input);
+    if (!ok) {
+        CloseIfValid(pipes_[0]);
+        CloseIfValid(pipes_[1]);
+        return false;
+    }
+
+    CloseHandle(pi.hThread);
+    process_ = pi.hProcess;
+    pid_ = pi.dwProcessId;
+    started_ = true;
+    if (capture) {
+        stop_event_ = CreateEventW(nullptr, TRUE, FALSE, nullptr);
+        reader_ = std::thread(ReaderMain, pipes_[0], pipes_[1], stop_event_, output);
+    }
+    return true;
+}
+
+void ChildProcess::StopCapture() {
+    if (reader_.joinable()) {
+        SetEvent(stop_event_);
+        reader_.join();
+    }
+    CloseIfValid(stop_event_);
+    if (!pipes_[0] && !pipes_[1]) return;
+    // Closing the read ends would fail the child's next write with
+    // ERROR_NO_DATA, so they are drained until the child closes its side.
+    HANDLE out_pipe = pipes_[0];
+    HANDLE err_pipe = pipes_[1];
+    pipes_[0] = nullptr;
+    pipes_[1] = nullptr;
+    std::thread([out_pipe, err_pipe]() mutable {
+        ReaderMain(out_pipe, err_pipe, nullptr, nullptr);
+        CloseIfValid(out_pipe);
+        CloseIfValid(err_pipe);
+    }).detach();
+}
+
+void ChildProcess::Release() {
+    StopCapture();
+    CloseIfValid(process_);
+    started_ = false;
+    exited_ = false;
+    exit_code_ = 0;
+    pid_ = 0;
+}
+
+bool ChildProcess::Running() {
+    return process_ && WaitForSingleObject(process_, 0) == WAIT_TIMEOUT;
+}
+
+bool ChildProcess::ExitCode(int& out) {
+    if (!process_ || Running()) return false;
+    DWORD code = 0;
+    if (!GetExitCodeProcess(process_, &code)) return false;
+    out = static_cast<int>(code);
+    return true;
+}
+
+#else
+
+static void CloseIfValid(int& fd) {
+    if (fd >= 0) close(fd);
+    fd = -1;
+}
+
+// Whitespace separates words; single quotes are literal, double quotes keep
+// \" and \\ escapes, and a backslash outside quotes escapes any character.
+static std::vector<std::string> SplitArguments(const std::string& args) {
+    std::vector<std::string> words;
+    std::string word;
+    bool in_word = false;
+    char quote = 0;
+    for (size_t i = 0; i < args.size(); ++i) {
+        char c = args[i];
+        if (quote == '\'') {
+            if (c == '\'') {
+                quote = 0;
+            } else {
+                word += c;
+            }
+            continue;
+        }
+        if (quote == '"') {
+            if (c == '"') {
+                quote = 0;
+            } else if (c == '\\' && i + 1 < args.size() && (args[i + 1] == '"' || args[i + 1] == '\\')) {
+                word += args[++i];
+            } else {
+                word += c;
+            }
+            continue;
+        }
+        if (c == ' ' || c == '\t') {
+            if (in_word) words.push_back(word);
+            word.clear();
+            in_word = false;
+            continue;
+        }
+        in_word = true;
+        if (c == '\'' || c == '"') {
+            quote = c;
+        } else if (c == '\\' && i + 1 < args.size()) {
+            word += args[++i];
+        } else {
+            word += c;
+        }
+    }
+    if (in_word) words.push_back(word);
+    return words;
+}
+
+// The launcher's environment with |overrides| applied.
+static std::vector<std::string> BuildEnvironment(const std::vector<EnvOverride>& overrides) {
+    std::vector<std::string> vars;
+    for (char** p = environ; *p; ++p) vars.emplace_back(*p);
+    for (const EnvOverride& entry : overrides) {
+        if (entry.name.empty() || entry.name.find('=') != std::string::npos) continue;
+        std::string prefix = entry.name + "=";
+        for (size_t i = 0; i < vars.size();) {
+            if (vars[i].compare(0, prefix.size(), prefix) == 0) {
+                vars.erase(vars.begin() + i);
+            } else {
+                ++i;
+            }
+        }
+        if (!entry.value.empty()) vars.push_back(prefix + entry.value);
+    }
+    return vars;
+}
+
+// Reads both pipes until the child closes them or |wake| becomes readable,
+// appending to |output|, or discarding the bytes when it is null. A negative
+// |wake| is ignored by poll().
+static void ReaderMain(int out_pipe, int err_pipe, int wake, OutputRing* output) {
+    TRACE_THREAD_NAME(output ? "Child output" : "Child drain");
+    static const OutputStream kStreams[2] = { OutputStream::Stdout, OutputStream::Stderr };
+    const int pipes[2] = { out_pipe, err_pipe };
+    char buffer[kReadChunkSize];
+    bool open[2] = { true, true };
+    while (open[0] || open[1]) {
+        pollfd fds[3] = {
+            { open[0] ? pipes[0] : -1, POLLIN, 0 },
+            { open[1] ? pipes[1] : -1, POLLIN, 0 },
+            { wake, POLLIN, 0 },
+        };
+        if (poll(fds, 3, -1) < 0) {
+            if (errno == EINTR) continue;
+            break;
+        }
+        if (fds[2].revents) break;
+        for (int i = 0; i < 2; ++i) {
+            if (!fds[i].revents) continue;
+            ssize_t n = read(pipes[i], buffer, sizeof(buffer));
+            if (n > 0) {
+                if (output) output->Append(kStreams[i], buffer, static_cast<size_t>(n));
+            } else if (n == 0 || (errno != EINTR && errno != EAGAIN)) {
+                open[i] = false;
+            }
+        }
+    }
+}
+
+bool ChildProcess::Start(const std::string& path, const ChildLaunchOptions& options, OutputRing* output) {
+    Release();
+    error_ = 0;
+    bool capture = options.capture_output && output;
+
+    int out_pipe[2] = { -1, -1 };
+    int err_pipe[2] = { -1, -1 };
+    posix_spawn_file_actions_t actions;
+    posix_spawn_file_actions_init(&actions);
+    if (capture) {
+        // O_CLOEXEC keeps every pipe end out of the child except the two
+        // dup2'ed onto stdout and stderr.
+        if (pipe2(out_pipe, O_CLOEXEC) != 0 || pipe2(err_pipe, O_CLOEXEC) != 0 || pipe2(wake_, O_CLOEXEC) != 0) {
+            error_ = static_cast<uint32_t>(errno);
+            CloseIfValid(out_pipe[0]);
+            CloseIfValid(out_pipe[1]);
+            CloseIfValid(err_pipe[0]);
+            CloseIfValid(err_pipe[1]);
+            CloseIfValid(wake_[0]);
+            CloseIfValid(wake_[1]);
+            posix_spawn_file_actions_destroy(&actions);
+            return false;
+        }
+        posix_spawn_file_actions_addopen(&actions, STDIN_FILENO, "/dev/null", O_RDONLY, 0);
+        posix_spawn_file_actions_adddup2(&actions, out_pipe[1], STDOUT_FILENO);
+        posix_spawn_file_actions_adddup2(&actions, err_pipe[1], STDERR_FILENO);
+    }
+    if (!options.working_dir.empty()) {
+        posix_spawn_file_actions_addchdir_np(&actions, options.working_dir.c_str());
+    }
+
+    std::vector<std::string> words = SplitArguments(options.arguments);
+    std::vector<char*> argv;
+    argv.push_back(const_cast<char*>(path.c_str()));
+    for (std::string& word : words) argv.push_back(&word[0]);
+    argv.push_back(nullptr);
+    std::vector<std::string> vars;
+    std::vector<char*> envp;
+    if (!options.environment.empty()) {
+        vars = BuildEnvironment(options.environment);
+        for (std::string& var : vars) envp.push_back(&var[0]);
+        envp.push_back(nullptr);
+    }
+
+    pid_t pid = 0;
+    int result = posix_spawn(&pid, path.c_str(), &actions, nullptr, argv.data(), envp.empty() ? environ : envp.data());
+    posix_spawn_file_actions_destroy(&actions);
+    CloseIfValid(out_pipe[1]);
+    CloseIfValid(err_pipe[1]);
+    if (result != 0) {
+        error_ = static_cast<uint32_t>(result);
+        CloseIfValid(out_pipe[0]);
+        CloseIfValid(err_pipe[0]);
+        CloseIfValid(wake_[0]);
+        CloseIfValid(wake_[1]);
+        return false;
+    }
+
+    pid_ = static_cast<uint32_t>(pid);
+    started_ = true;
+    if (capture) {
+        pipes_[0] = out_pipe[0];
+        pipes_[1] = err_pipe[0];
+        reader_ = std::thread(ReaderMain, pipes_[0], pipes_[1], wake_[0], output);
+    }
+    return true;
+}
+
+void ChildProcess::StopCapture() {
+    if (reader_.joinable()) {
+        char wake = 1;
+        ssize_t written = write(wake_[1], &wake, 1);
+        (void)written;
+        reader_.join();
+    }
+    CloseIfValid(wake_[0]);
+    CloseIfValid(wake_[1]);
+    if (pipes_[0] < 0 && pipes_[1] < 0) return;
+    // Closing the read ends would kill the child with SIGPIPE on its next
+    // write, so they are drained until the child closes its side.
+    int out_pipe = pipes_[0];
+    int err_pipe = pipes_[1];
+    pipes_[0] = -1;
+    pipes_[1] = -1;
+    std::thread([out_pipe, err_pipe]() mutable {
+        ReaderMain(out_pipe, err_pipe, -1, nullptr);
+        CloseIfValid(out_pipe);
+        CloseIfValid(err_pipe);
+    }).detach();
+}
+
+void ChildProcess::Release() {
+    StopCapture();
+    // Reap a finished child now; one still running is waited for on a
+    // detached thread so it does not linger as a zombie once it exits.
+    if (started_ && !exited_) {
+        int status = 0;
+        pid_t pid = static_cast<pid_t>(pid_);
+        if (waitpid(pid, &status, WNOHANG) == 0) {
+            std::thread([pid]() {
+                int status = 0;
+                while (waitpid(pid, &status, 0) < 0 && errno == EINTR) {
+                }
+            }).detach();
+        }
+    }
+    started_ = false;
+    exited_ = false;
+    exit_code_ = 0;
+    pid_ = 0;
+}
+
+bool ChildProcess::Running() {
+    if (!started_ || exited_) return false;
+    int status = 0;
+    pid_t result = waitpid(static_cast<pid_t>(pid_), &status, WNOHANG);
+    if (result == 0) return true;
+    exited_ = true;
+    if (result > 0) {
+        exit_code_ = WIFEXITED(status) ? WEXITSTATUS(status) : 128 + WTERMSIG(status);
+    }
+    return false;
+}
+
+bool ChildProcess::ExitCode(int& out) {
+    if (!started_ || Running()) return false;
+    out = exit_code_;
+    return true;
+}
+
+#endif
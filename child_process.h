@@ -0,0 +1,76 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <vector>
+
+class OutputRing;
+
+struct EnvOverride {
+    std::string name;
+    std::string value;  // Empty removes the variable.
+};
+
+struct ChildLaunchOptions {
+    // Command line after the executable, UTF-8. Passed through verbatim on
+    // Windows; split on whitespace honoring quotes and backslashes on POSIX.
+    std::string arguments;
+    // Empty inherits the launcher's working directory.
+    std::string working_dir;
+    // Applied on top of the launcher's environment, in order.
+    std::vector<EnvOverride> environment;
+    // Redirect stdout/stderr into the ring passed to Start(). stdin is always
+    // the null device when capturing.
+    bool capture_output = false;
+};
+
+// A launched target process. With capture enabled, one background I/O thread
+// drains both pipes into an OutputRing as fast as the child writes, so the
+// child never blocks on a full pipe and the UI never waits on the child.
+// Once capture stops, a detached thread keeps draining the pipes and
+// discards what it reads until the child closes them, so a child that keeps
+// writing is never broken by a closed pipe.
+// Windows uses overlapped named pipes; POSIX uses posix_spawn and poll().
+// Start() may run on any thread, and several may run at once: each child
+// inherits only its own pipe ends.
+class ChildProcess {
+public:
+    ChildProcess() = default;
+    ~ChildProcess();
+    ChildProcess(const ChildProcess&) = delete;
+    ChildProcess& operator=(const ChildProcess&) = delete;
+
+    // Launches |path| (UTF-8). Any previous process is released first. On
+    // failure LastError() holds the Win32 error or errno.
+    bool Start(const std::string& path, const ChildLaunchOptions& options, OutputRing* output);
+    // Stops capturing and closes handles; the child keeps running. On POSIX
+    // a child still running is reaped by a detached thread when it exits.
+    void Release();
+    // Stops writing into the ring, which the caller may then free, but keeps
+    // the process handle, so Running() and ExitCode() still work. The child's
+    // further output is discarded.
+    void StopCapture();
+
+    bool Started() const { return started_; }
+    bool Running();
+    // False while the process is still running.
+    bool ExitCode(int& out);
+    uint32_t Pid() const { return pid_; }
+    uint32_t LastError() const { return error_; }
+
+private:
+    bool started_ = false;
+    uint32_t pid_ = 0;
+    uint32_t error_ = 0;
+    bool exited_ = false;
+    int exit_code_ = 0;
+#ifdef _WIN32
+    void* process_ = nullptr;
+    void* pipes_[2] = {};     // Read ends: stdout, stderr.
+    void* stop_event_ = nullptr;
+#else
+    int pipes_[2] = { -1, -1 };
+    int wake_[2] = { -1, -1 };
+#endif
+    std::thread reader_;
+};
@@ -0,0 +1,252 @@
+#include "damage_tracker.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace {
+    // Above this many merged rectangles the damage is reported as one box.
+    const size_t kMaxRectsBeforeBounds = 64;
+
+    inline uint64_t Mix(uint64_t h, uint64_t v) {
+        h ^= v * 0x9E3779B97F4A7C15ull;
+        h = (h << 31) | (h >> 33);
+        return h * 0xC2B2AE3D27D4EB4Full;
+    }
+
+    inline uint64_t Finalize(uint64_t h) {
+        h ^= h >> 33;
+        h *= 0xFF51AFD7ED558CCDull;
+        h ^= h >> 33;
+        return h;
+    }
+
+    inline uint64_t HashVertex(uint64_t h, const ImDrawVert& v) {
+        uint64_t pos = 0;
+        uint64_t uv = 0;
+        memcpy(&pos, &v.pos, sizeof(pos));
+        memcpy(&uv, &v.uv, sizeof(uv));
+        return Mix(Mix(Mix(h, pos), uv), v.col);
+    }
+
+    inline uint64_t HashClip(const ImVec4& clip, ImTextureID texture) {
+        uint64_t xy = 0;
+        uint64_t zw = 0;
+        memcpy(&xy, &clip.x, sizeof(xy));
+        memcpy(&zw, &clip.z, sizeof(zw));
+        return Mix(Mix(Mix(0x2545F4914F6CDD1Dull, xy), zw), reinterpret_cast<uintptr_t>(texture));
+    }
+
+    inline int64_t Area(const DamageRect& r) {
+        return static_cast<int64_t>(r.x1 - r.x0) * (r.y1 - r.y0);
+    }
+
+    inline DamageRect Union(const DamageRect& a, const DamageRect& b) {
+        DamageRect r;
+        r.x0 = std::min(a.x0, b.x0);
+        r.y0 = std::min(a.y0, b.y0);
+        r.x1 = std::max(a.x1, b.x1);
+        r.y1 = std::max(a.y1, b.y1);
+        return r;
+    }
+}
+
+void DamageTracker::Invalidate() {
+    // Buffers predating this frame are unknown; forget them.
+    std::fill(pending_.begin(), pending_.end(), 1);
+    pending_any_ = true;
+    history_count_ = 0;
+}
+
+void DamageTracker::Update(const ImDrawData* draw_data) {
+    int width = static_cast<int>(std::ceil(draw_data->DisplaySize.x));
+    int height = static_cast<int>(std::ceil(draw_data->DisplaySize.y));
+    if (width != width_ || height != height_) {
+        width_ = width;
+        height_ = height;
+        tiles_x_ = (width + kTileSize - 1) / kTileSize;
+        tiles_y_ = (height + kTileSize - 1) / kTileSize;
+        size_t tile_count = static_cast<size_t>(tiles_x_) * tiles_y_;
+        hashes_.assign(tile_count, 0);
+        previous_hashes_.assign(tile_count, 0);
+        pending_.assign(tile_count, 1);
+        for (std::vector<uint8_t>& dirty : history_) dirty.assign(tile_count, 1);
+        Invalidate();
+    }
+    std::swap(hashes_, previous_hashes_);
+    std::fill(hashes_.begin(), hashes_.end(), 0);
+
+    const float origin_x = draw_data->DisplayPos.x;
+    const float origin_y = draw_data->DisplayPos.y;
+    const float tile_scale = 1.0f / kTileSize;
+    for (int n = 0; n < draw_data->CmdLists.Size; ++n) {
+        const ImDrawList* list = draw_data->CmdLists[n];
+        for (const ImDrawCmd& cmd : list->CmdBuffer) {
+            float clip_x0 = std::max(cmd.ClipRect.x - origin_x, 0.0f);
+            float clip_y0 = std::max(cmd.ClipRect.y - origin_y, 0.0f);
+            float clip_x1 = std::min(cmd.ClipRect.z - origin_x, static_cast<float>(width_));
+            float clip_y1 = std::min(cmd.ClipRect.w - origin_y, static_cast<float>(height_));
+            if (clip_x1 <= clip_x0 || clip_y1 <= clip_y0) continue;
+            uint64_t seed = HashClip(cmd.ClipRect, cmd.TextureId);
+
+            const ImDrawIdx* idx = list->IdxBuffer.Data + cmd.IdxOffset;
+            for (unsigned int i = 0; i + 2 < cmd.ElemCount; i += 3) {
+                const ImDrawVert& a = list->VtxBuffer[static_cast<int>(idx[i])];
+                const ImDrawVert& b = list->VtxBuffer[static_cast<int>(idx[i + 1])];
+                const ImDrawVert& c = list->VtxBuffer[static_cast<int>(idx[i + 2])];
+                // One pixel of slack covers rasterizer rounding at the edges.
+                float x0 = std::max(std::min(std::min(a.pos.x, b.pos.x), c.pos.x) - origin_x - 1.0f, clip_x0);
+                float y0 = std::max(std::min(std::min(a.pos.y, b.pos.y), c.pos.y) - origin_y - 1.0f, clip_y0);
+                float x1 = std::min(std::max(std::max(a.pos.x, b.pos.x), c.pos.x) - origin_x + 1.0f, clip_x1);
+                float y1 = std::min(std::max(std::max(a.pos.y, b.pos.y), c.pos.y) - origin_y + 1.0f, clip_y1);
+                if (x1 <= x0 || y1 <= y0) continue;
+
+                uint64_t h = Finalize(HashVertex(HashVertex(HashVertex(seed, a), b), c));
+                int tx0 = static_cast<int>(x0 * tile_scale);
+                int ty0 = static_cast<int>(y0 * tile_scale);
+                int tx1 = std::min(static_cast<int>((x1 - 1e-3f) * tile_scale), tiles_x_ - 1);
+                int ty1 = std::min(static_cast<int>((y1 - 1e-3f) * tile_scale), tiles_y_ - 1);
+                for (int ty = ty0; ty <= ty1; ++ty) {
+                    uint64_t* row = hashes_.data() + static_cast<size_t>(ty) * tiles_x_;
+                    for (int tx = tx0; tx <= tx1; ++tx) {
+                        // Order-dependent, so restacked geometry counts as a change.
+                        row[tx] = row[tx] * 0x100000001B3ull ^ h;
+                    }
+                }
+            }
+        }
+    }
+
+    // A tile that differs from the last presented frame changed in at least
+    // one of the Updates since, so OR-ing them covers it.
+    for (size_t t = 0; t < hashes_.size(); ++t) {
+        uint8_t changed = hashes_[t] != previous_hashes_[t];
+        pending_[t] |= changed;
+        pending_any_ |= changed != 0;
+    }
+}
+
+void DamageTracker::Presented() {
+    if (pending_.empty()) return;
+    // The presented changes go to history_[0].
+    const int slots = kMaxBufferAge - 1;
+    for (int i = slots - 1; i > 0; --i) std::swap(history_[i], history_[i - 1]);
+    std::swap(history_[0], pending_);
+    pending_.assign(history_[0].size(), 0);
+    pending_any_ = false;
+    if (history_count_ < slots) ++history_count_;
+}
+
+const std::vector<DamageRect>& DamageTracker::Damage(int buffer_age) {
+    rects_.clear();
+    if (width_ <= 0 || height_ <= 0) return rects_;
+    // A buffer |buffer_age| presents old misses the pending changes and
+    // those of the buffer_age - 1 presents since it was shown.
+    if (buffer_age < 1 || buffer_age - 1 > history_count_) {
+        DamageRect full;
+        full.x1 = width_;
+        full.y1 = height_;
+        rects_.push_back(full);
+        return rects_;
+    }
+    merged_ = pending_;
+    for (int age = 1; age < buffer_age; ++age) {
+        const std::vector<uint8_t>& older = history_[age - 1];
+        for (size_t t = 0; t < merged_.size(); ++t) merged_[t] |= older[t];
+    }
+    BuildRects(merged_);
+    return rects_;
+}
+
+DamageRect DamageTracker::Bounds(const std::vector<DamageRect>& rects) {
+    if (rects.empty()) return DamageRect();
+    DamageRect bounds = rects[0];
+    for (const DamageRect& r : rects) bounds = Union(bounds, r);
+    return bounds;
+}
+
+// Dirty tiles become rects in tile units: runs within a row, extended
+// downwards while the row below has a run with the same span.
+void DamageTracker::BuildRects(const std::vector<uint8_t>& dirty) {
+    size_t open_begin = 0;
+    for (int ty = 0; ty < tiles_y_; ++ty) {
+        size_t row_begin = rects_.size();
+        const uint8_t* row = dirty.data() + static_cast<size_t>(ty) * tiles_x_;
+        for (int tx = 0; tx < tiles_x_;) {
+            if (!row[tx]) {
+                ++tx;
+                continue;
+            }
+            int run_begin = tx;
+            while (tx < tiles_x_ && row[tx]) ++tx;
+            bool extended = false;
+            for (size_t i = open_begin; i < row_begin; ++i) {
+                DamageRect& above = rects_[i];
+                if (above.x0 == run_begin && above.x1 == tx && above.y1 == ty) {
+                    above.y1 = ty + 1;
+                    extended = true;
+                    break;
+                }
+            }
+            if (!extended) {
+                DamageRect r;
+                r.x0 = run_begin;
+                r.y0 = ty;
+                r.x1 = tx;
+                r.y1 = ty + 1;
+                rects_.push_back(r);
+            }
+        }
+        // Rects not extended into this row can never grow again; only scan
+        // those that reach it next time.
+        size_t keep = open_begin;
+        for (size_t i = open_begin; i < rects_.size(); ++i) {
+            if (rects_[i].y1 != ty + 1) std::swap(rects_[i], rects_[keep++]);
+        }
+        open_begin = keep;
+    }
+    if (rects_.empty()) return;
+
+    if (rects_.size() > kMaxRectsBeforeBounds) {
+        DamageRect bounds = rects_[0];
+        for (const DamageRect& r : rects_) bounds = Union(bounds, r);
+        rects_.assign(1, bounds);
+    }
+    // Merge the pair that grows the covered area least until few enough
+    // rects remain.
+    while (rects_.size() > static_cast<size_t>(kMaxRects)) {
+        size_t best_a = 0;
+        size_t best_b = 1;
+        int64_t best_growth = INT64_MAX;
+        for (size_t a = 0; a < rects_.size(); ++a) {
+            for (size_t b = a + 1; b < rects_.size(); ++b) {
+                int64_t growth = Area(Union(rects_[a], rects_[b])) - Area(rects_[a]) - Area(rects_[b]);
+                if (growth < best_growth) {
+                    best_growth = growth;
+                    best_a = a;
+                    best_b = b;
+                }
+            }
+        }
+        rects_[best_a] = Union(rects_[best_a], rects_[best_b]);
+        rects_[best_b] = rects_.back();
+        rects_.pop_back();
+    }
+
+    // Tiles to pixels, clamped to the display.
+    int64_t area = 0;
+    for (DamageRect& r : rects_) {
+        r.x0 *= kTileSize;
+        r.y0 *= kTileSize;
+        r.x1 = std::min(r.x1 * kTileSize, width_);
+        r.y1 = std::min(r.y1 * kTileSize, height_);
+        area += Area(r);
+    }
+    // Mostly damaged: one full repaint is cheaper than many partial ones.
+    if (area * 4 >= static_cast<int64_t>(width_) * height_ * 3) {
+        DamageRect full;
+        full.x1 = width_;
+        full.y1 = height_;
+        rects_.assign(1, full);
+    }
+}
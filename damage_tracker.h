@@ -0,0 +1,69 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+#include "imgui.h"
+
+// Finds the parts of the screen whose pixels differ from earlier frames.
+// Every triangle of the draw data is hashed together with its command's clip
+// rect and texture, and binned into fixed screen tiles; a tile is damaged
+// when its painter-ordered hash differs from the previous frame. Damaged
+// tiles are merged into a few rectangles for partial rasterization and
+// dirty-rect presentation.
+
+struct DamageRect {
+    int x0 = 0;
+    int y0 = 0;
+    int x1 = 0;
+    int y1 = 0;
+};
+
+class DamageTracker {
+public:
+    static const int kTileSize = 32;
+    // Oldest back buffer a caller may ask about.
+    static const int kMaxBufferAge = 3;
+
+    // Diffs |draw_data| against the previous Update(). Damage accumulates
+    // across Updates until Presented(), so frames that are skipped never
+    // count towards a buffer's age.
+    void Update(const ImDrawData* draw_data);
+    // Call after the frame from the last Update() was shown.
+    void Presented();
+    // Forces a full repaint of every buffer, e.g. after a resize or when
+    // texture contents changed under unchanged geometry.
+    void Invalidate();
+
+    // Whether anything changed since the last presented frame; a frame
+    // without changes need not be drawn or presented.
+    bool HasChanges() const { return pending_any_; }
+    // Region to repaint in a buffer last presented |buffer_age| presents ago,
+    // as up to kMaxRects rectangles. A single rect covering the display means
+    // a full repaint; an empty result means nothing changed.
+    static const int kMaxRects = 8;
+    const std::vector<DamageRect>& Damage(int buffer_age);
+    // Bounding box of |rects|; empty for an empty list.
+    static DamageRect Bounds(const std::vector<DamageRect>& rects);
+
+    int Width() const { return width_; }
+    int Height() const { return height_; }
+
+private:
+    void BuildRects(const std::vector<uint8_t>& dirty);
+
+    int width_ = 0;
+    int height_ = 0;
+    int tiles_x_ = 0;
+    int tiles_y_ = 0;
+    std::vector<uint64_t> hashes_;
+    std::vector<uint64_t> previous_hashes_;
+    // Tiles changed since the last presented frame.
+    std::vector<uint8_t> pending_;
+    bool pending_any_ = false;
+    // Tiles each of the most recent presents changed, newest first.
+    std::vector<uint8_t> history_[kMaxBufferAge - 1];
+    int history_count_ = 0;
+
+    std::vector<uint8_t> merged_;
+    std::vector<DamageRect> rects_;
+};
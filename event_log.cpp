@@ -0,0 +1,360 @@
+#include "event_log.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "app_paths.h"
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define EVENT_LOG_HAS_TSC
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define EVENT_LOG_HAS_TSC
+#endif
+
+namespace {
+    const size_t kRingCapacity = 1024; // Records per thread, power of two.
+    const size_t kRotateBytes = 1024 * 1024;
+    const int kRotateKeep = 3;
+    const auto kFlushInterval = std::chrono::milliseconds(250);
+
+    // Each field is its own relaxed atomic so readers may race the writer
+    // without undefined behaviour; |seq| brackets the payload like a seqlock.
+    // seq == 2 * position + 2 once the record at |position| is complete.
+    struct Slot {
+        std::atomic<uint64_t> seq{0};
+        std::atomic<uint64_t> ticks{0};
+        std::atomic<uint64_t> event{0};
+        std::atomic<int64_t> a{0};
+        std::atomic<int64_t> b{0};
+    };
+
+    // A ring belongs to one live thread at a time. When the thread exits the
+    // ring goes back to the pool with its records, and the next new thread
+    // continues writing at its head. Each record carries its writer's thread
+    // index in the top half of |event|, so reuse does not relabel old records.
+    struct Ring {
+        Slot slots[kRingCapacity];
+        std::atomic<uint64_t> head{0};
+        std::atomic<uint32_t> thread{0};
+        uint64_t flush_cursor = 0; // Only touched by the flusher.
+        bool in_use = false;       // Guarded by g_rings_mutex.
+        Ring* next = nullptr;      // Fixed once the ring is published.
+    };
+
+    struct LogClock {
+        std::chrono::steady_clock::time_point start_time = std::chrono::steady_clock::now();
+        uint64_t start_ticks = 0;
+
+        LogClock() { start_ticks = Now(); }
+
+        static uint64_t Now() {
+#ifdef EVENT_LOG_HAS_TSC
+            return __rdtsc();
+#else
+            return static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+#endif
+        }
+
+        // Converts raw ticks using the tick rate observed since startup, so
+        // conversion cost stays off the hot path.
+        uint64_t ToNanoseconds(uint64_t ticks) const {
+#ifdef EVENT_LOG_HAS_TSC
+            auto elapsed = std::chrono::steady_clock::now() - start_time;
+            double elapsed_ns = static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+            double elapsed_ticks = static_cast<double>(Now() - start_ticks);
+            if (elapsed_ticks <= 0.0 || ticks < start_ticks) return 0;
+            return static_cast<uint64_t>(static_cast<double>(ticks - start_ticks) * (elapsed_ns / elapsed_ticks));
+#else
+            auto since_start = std::chrono::steady_clock::time_point(std::chrono::steady_clock::duration(ticks)) - start_time;
+            return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(since_start).count());
+#endif
+        }
+    };
+
+    LogClock g_clock;
+    std::mutex g_rings_mutex;
+    std::vector<std::unique_ptr<Ring>> g_rings;
+    uint32_t g_next_thread = 0;
+    // Every ring ever created, newest first. Readers walk it without the
+    // mutex; rings are only ever added, never unlinked.
+    std::atomic<Ring*> g_ring_list{nullptr};
+
+    std::mutex g_flush_mutex;
+    std::condition_variable g_flush_cv;
+    std::thread g_flush_thread;
+    bool g_flush_stop = false;
+    std::string g_path;
+    FILE* g_file = nullptr;
+    size_t g_file_bytes = 0;
+
+    Ring* AcquireRing() {
+        std::lock_guard<std::mutex> lock(g_rings_mutex);
+        Ring* ring = nullptr;
+        for (auto& candidate : g_rings) {
+            if (!candidate->in_use) {
+                ring = candidate.get();
+                break;
+            }
+        }
+        if (!ring) {
+            g_rings.push_back(std::make_unique<Ring>());
+            ring = g_rings.back().get();
+            ring->next = g_ring_list.load(std::memory_order_relaxed);
+            g_ring_list.store(ring, std::memory_order_release);
+        }
+        ring->in_use = true;
+        ring->thread.store(++g_next_thread, std::memory_order_relaxed);
+        return ring;
+    }
+
+    void ReleaseRing(Ring* ring) {
+        std::lock_guard<std::mutex> lock(g_rings_mutex);
+        ring->in_use = false;
+    }
+
+    // Hands the calling thread's ring back to the pool when the thread exits.
+    struct ThreadSlot {
+        Ring* ring = AcquireRing();
+        ~ThreadSlot() { ReleaseRing(ring); }
+    };
+
+    Ring* ThreadRing() {
+        thread_local ThreadSlot slot;
+        return slot.ring;
+    }
+
+    // Copies the record at |position| if it is still present and complete.
+    bool ReadSlot(const Ring& ring, uint64_t position, LogRecord& out) {
+        const Slot& slot = ring.slots[position & (kRingCapacity - 1)];
+        uint64_t expected = position * 2 + 2;
+        if (slot.seq.load(std::memory_order_acquire) != expected) return false;
+        uint64_t ticks = slot.ticks.load(std::memory_order_relaxed);
+        uint64_t event = slot.event.load(std::memory_order_relaxed);
+        int64_t a = slot.a.load(std::memory_order_relaxed);
+        int64_t b = slot.b.load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slot.seq.load(std::memory_order_relaxed) != expected) return false;
+        out.time_ns = ticks;
+        out.thread = static_cast<uint32_t>(event >> 32);
+        out.event = static_cast<LogEvent>(event & 0xffff);
+        out.a = a;
+        out.b = b;
+        return true;
+    }
+
+    void RotateIfNeeded() {
+        if (!g_file || g_file_bytes < kRotateBytes) return;
+        fclose(g_file);
+        for (int i = kRotateKeep - 1; i >= 1; --i) {
+            std::string from = g_path + "." + std::to_string(i);
+            std::string to = g_path + "." + std::to_string(i + 1);
+            RenameFileUtf8(from, to);
+        }
+        RenameFileUtf8(g_path, g_path + ".1");
+        g_file = OpenFileUtf8(g_path, "wb");
+        g_file_bytes = 0;
+    }
+
+    void FlushRings() {
+        char text[160];
+        char line[224];
+        for (Ring* ring = g_ring_list.load(std::memory_order_acquire); ring; ring = ring->next) {
+            uint64_t head = ring->head.load(std::memory_order_acquire);
+            uint64_t dropped = 0;
+            if (head - ring->flush_cursor > kRingCapacity) {
+                dropped = head - kRingCapacity - ring->flush_cursor;
+                ring->flush_cursor = head - kRingCapacity;
+            }
+            for (; ring->flush_cursor < head; ++ring->flush_cursor) {
+                LogRecord record;
+                if (!ReadSlot(*ring, ring->flush_cursor, record)) {
+                    ++dropped;
+                    continue;
+                }
+                if (!g_file) continue;
+                FormatLogRecord(record, text, sizeof(text));
+                uint64_t ns = g_clock.ToNanoseconds(record.time_ns);
+                int len = snprintf(line, sizeof(line), "%10.3f t%u %-18s %s\n",
+                                   static_cast<double>(ns) / 1e9, record.thread,
+                                   LogEventName(record.event), text);
+                if (len > 0) {
+                    fwrite(line, 1, static_cast<size_t>(len), g_file);
+                    g_file_bytes += static_cast<size_t>(len);
+                    RotateIfNeeded();
+                }
+            }
+            if (dropped && g_file) {
+                int len = snprintf(line, sizeof(line), "           t%u dropped %llu records\n",
+                                   ring->thread.load(std::memory_order_relaxed),
+                                   static_cast<unsigned long long>(dropped));
+                fwrite(line, 1, static_cast<size_t>(len), g_file);
+                g_file_bytes += static_cast<size_t>(len);
+            }
+        }
+        if (g_file) fflush(g_file);
+    }
+
+    void FlushThreadMain() {
+        std::unique_lock<std::mutex> lock(g_flush_mutex);
+        while (!g_flush_stop) {
+            g_flush_cv.wait_for(lock, kFlushInterval);
+            FlushRings();
+        }
+    }
+}
+
+void LogWrite(LogEvent event, int64_t a, int64_t b) {
+    Ring* ring = ThreadRing();
+    uint64_t position = ring->head.load(std::memory_order_relaxed);
+    Slot& slot = ring->slots[position & (kRingCapacity - 1)];
+    slot.seq.store(position * 2 + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    slot.ticks.store(LogClock::Now(), std::memory_order_relaxed);
+    uint64_t thread = ring->thread.load(std::memory_order_relaxed);
+    slot.event.store(static_cast<uint64_t>(event) | thread << 32, std::memory_order_relaxed);
+    slot.a.store(a, std::memory_order_relaxed);
+    slot.b.store(b, std::memory_order_relaxed);
+    slot.seq.store(position * 2 + 2, std::memory_order_release);
+    ring->head.store(position + 1, std::memory_order_release);
+}
+
+bool EventLogStart(const std::string& path) {
+    std::lock_guard<std::mutex> lock(g_flush_mutex);
+    if (g_flush_thread.joinable()) return true;
+    g_path = path;
+    g_file = OpenFileUtf8(path, "ab");
+    if (g_file) {
+        fseek(g_file, 0, SEEK_END);
+        g_file_bytes = static_cast<size_t>(ftell(g_file));
+    }
+    g_flush_stop = false;
+    g_flush_thread = std::thread(FlushThreadMain);
+    return g_file != nullptr;
+}
+
+void EventLogStop() {
+    {
+        std::lock_guard<std::mutex> lock(g_flush_mutex);
+        if (!g_flush_thread.joinable()) return;
+        g_flush_stop = true;
+    }
+    g_flush_cv.notify_all();
+    g_flush_thread.join();
+    if (g_file) {
+        fclose(g_file);
+        g_file = nullptr;
+    }
+}
+
+uint64_t EventLogSequence() {
+    uint64_t sequence = 0;
+    for (Ring* ring = g_ring_list.load(std::memory_order_acquire); ring; ring = ring->next) {
+        sequence += ring->head.load(std::memory_order_acquire);
+    }
+    return sequence;
+}
+
+size_t EventLogReadRecent(LogRecord* out, size_t max) {
+    if (max == 0) return 0;
+    // Reused across calls so a refresh does not allocate once it has grown.
+    thread_local std::vector<LogRecord> records;
+    records.clear();
+    for (Ring* ring = g_ring_list.load(std::memory_order_acquire); ring; ring = ring->next) {
+        uint64_t head = ring->head.load(std::memory_order_acquire);
+        uint64_t count = std::min<uint64_t>(std::min<uint64_t>(head, kRingCapacity), max);
+        for (uint64_t pos = head - count; pos < head; ++pos) {
+            LogRecord record;
+            if (ReadSlot(*ring, pos, record)) records.push_back(record);
+        }
+    }
+    std::sort(records.begin(), records.end(), [](const LogRecord& l, const LogRecord& r) {
+        return l.time_ns < r.time_ns;
+    });
+    size_t count = std::min(records.size(), max);
+    size_t first = records.size() - count;
+    for (size_t i = 0; i < count; ++i) {
+        out[i] = records[first + i];
+        out[i].time_ns = g_clock.ToNanoseconds(out[i].time_ns);
+    }
+    return count;
+}
+
+const char* LogEventName(LogEvent event) {
+    switch (event) {
+    case LogEvent::VerifyStarted: return "verify.start";
+    case LogEvent::VerifyHttpStatus: return "verify.http";
+    case LogEvent::VerifyNetworkError: return "verify.neterr";
+    case LogEvent::VerifyRetryScheduled: return "verify.retry";
+    case LogEvent::VerifyAccepted: return "verify.accepted";
+    case LogEvent::VerifyDeclined: return "verify.declined";
+    case LogEvent::VerifyCacheHit: return "verify.cached";
+    case LogEvent::LaunchSucceeded: return "launch.ok";
+    case LogEvent::LaunchFailed: return "launch.failed";
+    case LogEvent::ProcessExited: return "process.exit";
+    default: return "unknown";
+    }
+}
+
+static const char* VerifyStageName(int64_t stage) {
+    switch (static_cast<VerifyStage>(stage)) {
+    case VerifyStage::Open: return "WinHttpOpen";
+    case VerifyStage::Connect: return "WinHttpConnect";
+    case VerifyStage::OpenRequest: return "WinHttpOpenRequest";
+    case VerifyStage::SendRequest: return "WinHttpSendRequest";
+    case VerifyStage::ReceiveResponse: return "WinHttpReceiveResponse";
+    default: return "unknown stage";
+    }
+}
+
+void FormatLogRecord(const LogRecord& record, char* buf, size_t buf_size) {
+    long long a = static_cast<long long>(record.a);
+    long long b = static_cast<long long>(record.b);
+    switch (record.event) {
+    case LogEvent::VerifyStarted:
+        if (a > 0) {
+            snprintf(buf, buf_size, "Verification retry %lld", a);
+        } else {
+            snprintf(buf, buf_size, "Verification started");
+        }
+        break;
+    case LogEvent::VerifyHttpStatus:
+        snprintf(buf, buf_size, "HTTP %lld", a);
+        break;
+    case LogEvent::VerifyNetworkError:
+        snprintf(buf, buf_size, "%s failed (error %lld)", VerifyStageName(record.a), b);
+        break;
+    case LogEvent::VerifyRetryScheduled:
+        snprintf(buf, buf_size, "Retry %lld in %lld ms", a, b);
+        break;
+    case LogEvent::VerifyAccepted:
+        snprintf(buf, buf_size, "Key accepted");
+        break;
+    case LogEvent::VerifyDeclined:
+        snprintf(buf, buf_size, "Key declined");
+        break;
+    case LogEvent::VerifyCacheHit:
+        snprintf(buf, buf_size, "Using saved verification (expires in %lld min)", a / 60);
+        break;
+    case LogEvent::LaunchSucceeded:
+        snprintf(buf, buf_size, "Launched pid %lld in %lld.%lld ms", a, b / 1000, (b % 1000) / 100);
+        break;
+    case LogEvent::LaunchFailed:
+        snprintf(buf, buf_size, "Launch failed (error %lld)", a);
+        break;
+    case LogEvent::ProcessExited:
+        snprintf(buf, buf_size, "Exited pid %lld code %lld", a, b);
+        break;
+    default:
+        snprintf(buf, buf_size, "event %u (%lld, %lld)", static_cast<unsigned>(record.event), a, b);
+        break;
+    }
+}
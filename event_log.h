@@ -0,0 +1,61 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Structured event log for launcher operations. LogWrite() stores a fixed-size
+// binary record into a per-thread lock-free ring; nothing is formatted until
+// the background flusher writes records to the rotating log file, or the
+// in-app viewer reads them back with EventLogReadRecent().
+
+enum class LogEvent : uint16_t {
+    VerifyStarted,        // a = retry attempt
+    VerifyHttpStatus,     // a = HTTP status code
+    VerifyNetworkError,   // a = VerifyStage, b = Win32 error code
+    VerifyRetryScheduled, // a = attempt, b = delay in milliseconds
+    VerifyAccepted,
+    VerifyDeclined,
+    VerifyCacheHit,       // a = seconds until the cached result expires
+    LaunchSucceeded,      // a = process id, b = spawn time in microseconds
+    LaunchFailed,         // a = Win32 error code
+    ProcessExited,        // a = process id, b = exit code
+    Count
+};
+
+// Stage of the verification request that failed, for VerifyNetworkError.
+enum class VerifyStage : int64_t {
+    Open,
+    Connect,
+    OpenRequest,
+    SendRequest,
+    ReceiveResponse
+};
+
+struct LogRecord {
+    uint64_t time_ns = 0;   // Nanoseconds since the log was started.
+    uint32_t thread = 0;    // Small per-thread index, 1-based.
+    LogEvent event = LogEvent::Count;
+    int64_t a = 0;
+    int64_t b = 0;
+};
+
+// Hot path: a handful of relaxed stores into the calling thread's ring.
+void LogWrite(LogEvent event, int64_t a = 0, int64_t b = 0);
+
+// Starts the background flusher writing to |path|; rotated files are named
+// path.1 .. path.N. Records written before this call are kept in the rings.
+bool EventLogStart(const std::string& path);
+// Flushes pending records and joins the flusher thread.
+void EventLogStop();
+
+// Copies up to |max| of the most recent records across all threads into
+// |out|, oldest first. Returns the number of records copied.
+size_t EventLogReadRecent(LogRecord* out, size_t max);
+// Count of records written so far, summed from the per-thread ring heads
+// without locking. Viewers compare it with the value seen at their last
+// EventLogReadRecent() and skip the read while it is unchanged.
+uint64_t EventLogSequence();
+
+const char* LogEventName(LogEvent event);
+// Human-readable one-line description, e.g. "HTTP 200" or "Exited pid 42 code 0".
+void FormatLogRecord(const LogRecord& record, char* buf, size_t buf_size);
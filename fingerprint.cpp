@@ -0,0 +1,189 @@
+#include "fingerprint.h"
+
+#include <cstdio>
+#include <cstdlib>
+
+#include "app_paths.h"
+#include "mapped_file.h"
+#include "trace.h"
+#include "xxh3.h"
+
+static const char* kCacheFile = "fingerprints.idx";
+static const char* kCacheVersion = "v1";
+static const size_t kMaxCacheEntries = 64;
+// Progress and cancellation are checked between chunks.
+static const size_t kHashChunkSize = 8u << 20;
+
+FingerprintService::FingerprintService() {
+    worker_ = std::thread(&FingerprintService::WorkerMain, this);
+}
+
+FingerprintService::~FingerprintService() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    generation_.fetch_add(1, std::memory_order_relaxed);
+    cv_.notify_all();
+    worker_.join();
+}
+
+void FingerprintService::Load() {
+    std::string contents;
+    if (!ReadFileUtf8(AppDataPath(kCacheFile), contents)) return;
+
+    std::vector<CacheEntry> loaded;
+    size_t start = 0;
+    bool header = true;
+    for (size_t pos = contents.find('\n'); pos != std::string::npos; pos = contents.find('\n', start)) {
+        std::string line = contents.substr(start, pos - start);
+        start = pos + 1;
+        if (header) {
+            if (line != kCacheVersion) return;
+            header = false;
+            continue;
+        }
+        unsigned long long size = 0;
+        long long mtime = 0;
+        unsigned long long hash = 0;
+        int path_offset = 0;
+        if (sscanf(line.c_str(), "%llu\t%lld\t%16llx\t%n", &size, &mtime, &hash, &path_offset) != 3 || path_offset == 0) {
+            continue;
+        }
+        if (static_cast<size_t>(path_offset) >= line.size()) continue;
+        loaded.push_back({ line.substr(path_offset), size, mtime, hash });
+        if (loaded.size() == kMaxCacheEntries) break;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    cache_ = loaded;
+}
+
+std::string FingerprintService::SerializeCacheLocked() const {
+    std::string text = std::string(kCacheVersion) + "\n";
+    char line[96];
+    for (const CacheEntry& entry : cache_) {
+        snprintf(line, sizeof(line), "%llu\t%lld\t%016llx\t", static_cast<unsigned long long>(entry.size),
+                 static_cast<long long>(entry.mtime), static_cast<unsigned long long>(entry.hash));
+        text += line;
+        text += entry.path;
+        text += "\n";
+    }
+    return text;
+}
+
+void FingerprintService::Request(const std::string& path) {
+    if (path.empty() || path.find('\n') != std::string::npos) return;
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (pending_ && pending_path_ == path) return;
+    // Only a different path abandons the hash in flight; the same path is
+    // re-checked once the current pass finishes.
+    if (status_.path != path || status_.state != FingerprintState::Hashing) {
+        generation_.fetch_add(1, std::memory_order_relaxed);
+    }
+    pending_path_ = path;
+    pending_ = true;
+    cv_.notify_all();
+}
+
+FingerprintStatus FingerprintService::Status() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    FingerprintStatus status = status_;
+    if (status.state == FingerprintState::Hashing) {
+        status.bytes_done = bytes_done_.load(std::memory_order_relaxed);
+    }
+    return status;
+}
+
+void FingerprintService::Run(const std::string& path, uint64_t generation) {
+    uint64_t size = 0;
+    int64_t mtime = 0;
+    bool exists = StatFileUtf8(path, size, mtime);
+
+    uint64_t previous_hash = 0;
+    bool has_previous = false;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (size_t i = 0; i < cache_.size(); ++i) {
+            if (cache_[i].path != path) continue;
+            if (exists && cache_[i].size == size && cache_[i].mtime == mtime) {
+                CacheEntry entry = cache_[i];
+                cache_.erase(cache_.begin() + i);
+                cache_.insert(cache_.begin(), entry);
+                // Keep the changed flag while the same file stays selected.
+                bool changed = status_.path == path && status_.hash == entry.hash && status_.changed;
+                status_ = FingerprintStatus();
+                status_.state = FingerprintState::Done;
+                status_.path = path;
+                status_.size = size;
+                status_.bytes_done = size;
+                status_.hash = entry.hash;
+                status_.from_cache = true;
+                status_.changed = changed;
+                return;
+            }
+            previous_hash = cache_[i].hash;
+            has_previous = true;
+            break;
+        }
+        status_ = FingerprintStatus();
+        status_.path = path;
+        status_.size = size;
+        status_.state = exists ? FingerprintState::Hashing : FingerprintState::Failed;
+        bytes_done_.store(0, std::memory_order_relaxed);
+    }
+    if (!exists) return;
+
+    TRACE_SCOPE("fingerprint.hash");
+    MappedFile file;
+    bool ok = file.Open(path, true);
+    Xxh3 hasher;
+    for (size_t offset = 0; ok && offset < file.Size(); offset += kHashChunkSize) {
+        if (generation_.load(std::memory_order_relaxed) != generation) return;
+        size_t chunk = file.Size() - offset < kHashChunkSize ? file.Size() - offset : kHashChunkSize;
+        hasher.Update(file.Data() + offset, chunk);
+        bytes_done_.store(offset + chunk, std::memory_order_relaxed);
+    }
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (generation_.load(std::memory_order_relaxed) != generation) return;
+    if (!ok) {
+        status_.state = FingerprintState::Failed;
+        return;
+    }
+    uint64_t hash = hasher.Digest();
+    status_.state = FingerprintState::Done;
+    status_.size = file.Size();
+    status_.bytes_done = file.Size();
+    status_.hash = hash;
+    status_.changed = has_previous && previous_hash != hash;
+
+    for (size_t i = 0; i < cache_.size(); ++i) {
+        if (cache_[i].path == path) {
+            cache_.erase(cache_.begin() + i);
+            break;
+        }
+    }
+    cache_.insert(cache_.begin(), { path, file.Size(), file.ModifiedTime(), hash });
+    if (cache_.size() > kMaxCacheEntries) cache_.resize(kMaxCacheEntries);
+    std::string text = SerializeCacheLocked();
+    lock.unlock();
+    WriteFileAtomicUtf8(AppDataPath(kCacheFile), text);
+}
+
+void FingerprintService::WorkerMain() {
+    TRACE_THREAD_NAME("Fingerprint worker");
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (!stop_) {
+        if (!pending_) {
+            cv_.wait(lock);
+            continue;
+        }
+        std::string path = pending_path_;
+        pending_ = false;
+        uint64_t generation = generation_.load(std::memory_order_relaxed);
+        lock.unlock();
+        Run(path, generation);
+        lock.lock();
+    }
+}
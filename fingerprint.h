@@ -0,0 +1,71 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Background content fingerprints (XXH3-64) of the selected target, used to
+// tell when the executable has been replaced on disk. Files are streamed
+// through a read-only mapping on a worker thread. Results are cached in a
+// small index keyed by path, size and mtime, so an unchanged file is never
+// read twice.
+
+enum class FingerprintState {
+    None,
+    Hashing,
+    Done,
+    Failed
+};
+
+struct FingerprintStatus {
+    FingerprintState state = FingerprintState::None;
+    std::string path;
+    uint64_t size = 0;
+    uint64_t bytes_done = 0;
+    uint64_t hash = 0;
+    bool from_cache = false;
+    // The content differs from the last fingerprint recorded for this path.
+    bool changed = false;
+};
+
+class FingerprintService {
+public:
+    FingerprintService();
+    ~FingerprintService();
+    FingerprintService(const FingerprintService&) = delete;
+    FingerprintService& operator=(const FingerprintService&) = delete;
+
+    // Reads the cache index. Call once at startup.
+    void Load();
+    // Fingerprints |path|, replacing any earlier request; a hash in progress
+    // for another path is abandoned. Repeating the current path only re-stats
+    // it, so this is cheap to call periodically to notice updates.
+    void Request(const std::string& path);
+    FingerprintStatus Status() const;
+
+private:
+    struct CacheEntry {
+        std::string path;
+        uint64_t size;
+        int64_t mtime;
+        uint64_t hash;
+    };
+
+    void WorkerMain();
+    void Run(const std::string& path, uint64_t generation);
+    std::string SerializeCacheLocked() const;
+
+    mutable std::mutex mutex_;
+    std::condition_variable cv_;
+    std::vector<CacheEntry> cache_;  // Most recently used first.
+    FingerprintStatus status_;
+    std::string pending_path_;
+    bool pending_ = false;
+    bool stop_ = false;
+    std::atomic<uint64_t> generation_{0};
+    std::atomic<uint64_t> bytes_done_{0};
+    std::thread worker_;
+};
@@ -0,0 +1,320 @@
+#include "image_cache.h"
+
+#include <algorithm>
+#include <cstring>
+
+#define STB_RECT_PACK_IMPLEMENTATION
+#include "imstb_rectpack.h"
+
+#include "image_decode.h"
+#include "image_resample.h"
+#include "trace.h"
+
+// Transparent border around each image so bilinear sampling at the edges
+// never picks up a neighbour.
+static const int kAtlasPadding = 1;
+// Ready images that found no room are retried this often, not every frame.
+static const uint64_t kRetryFrames = 30;
+
+ImageCache::ImageCache(int atlas_size, unsigned decode_threads)
+    : atlas_size_(atlas_size),
+      atlas_(static_cast<size_t>(atlas_size) * atlas_size * 4, 0),
+      nodes_(atlas_size) {
+    stbrp_init_target(&packer_, atlas_size_, atlas_size_, nodes_.data(), static_cast<int>(nodes_.size()));
+    if (decode_threads == 0) decode_threads = 1;
+    for (unsigned i = 0; i < decode_threads; ++i) {
+        workers_.emplace_back(&ImageCache::WorkerMain, this);
+    }
+}
+
+ImageCache::~ImageCache() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+        jobs_.clear();
+    }
+    cv_.notify_all();
+    for (std::thread& worker : workers_) {
+        worker.join();
+    }
+}
+
+ImageHandle ImageCache::Request(const std::string& path, int size) {
+    std::string key = path + '\n' + std::to_string(size);
+    auto it = handles_.find(key);
+    if (it != handles_.end()) return it->second;
+    Entry entry;
+    entry.path = path;
+    entry.size = size;
+    entry.last_used = frame_;
+    entries_.push_back(std::move(entry));
+    ImageHandle handle = static_cast<ImageHandle>(entries_.size());
+    handles_.emplace(std::move(key), handle);
+    Queue(handle);
+    return handle;
+}
+
+void ImageCache::Queue(ImageHandle handle) {
+    Entry& entry = entries_[handle - 1];
+    entry.state = State::Queued;
+    Job job;
+    job.handle = handle;
+    job.path = entry.path;
+    job.size = entry.size;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        jobs_.push_back(std::move(job));
+    }
+    cv_.notify_one();
+}
+
+void ImageCache::WorkerMain() {
+    TRACE_THREAD_NAME("Image decoder");
+    ImageDecoder decoder;
+    DecodedImage decoded;
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (!stop_) {
+        if (jobs_.empty()) {
+            cv_.wait(lock);
+            continue;
+        }
+        Job job = std::move(jobs_.front());
+        jobs_.pop_front();
+        lock.unlock();
+
+        Result result;
+        result.handle = job.handle;
+        {
+            TRACE_SCOPE("image.decode");
+            result.ok = decoder.Decode(job.path, job.size, decoded);
+        }
+        if (result.ok) {
+            TRACE_SCOPE("image.resample");
+            FitImageSize(decoded.width, decoded.height, job.size, result.width, result.height);
+            if (result.width == decoded.width && result.height == decoded.height) {
+                result.pixels.swap(decoded.rgba);
+            } else {
+                result.pixels.resize(static_cast<size_t>(result.width) * result.height * 4);
+                ResampleRgbaArea(decoded.rgba.data(), decoded.width, decoded.height, decoded.width * 4,
+                                 result.pixels.data(), result.width, result.height, result.width * 4);
+            }
+            UnpremultiplyRgba(result.pixels.data(), result.width, result.height, result.width * 4);
+        }
+
+        lock.lock();
+        results_.push_back(std::move(result));
+    }
+}
+
+void ImageCache::Update() {
+    ++frame_;
+    std::vector<Result> results;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        results.swap(results_);
+    }
+    std::vector<ImageHandle> ready;
+    for (Result& result : results) {
+        Entry& entry = entries_[result.handle - 1];
+        if (!result.ok || result.width + kAtlasPadding * 2 > atlas_size_ ||
+            result.height + kAtlasPadding * 2 > atlas_size_) {
+            entry.state = State::Failed;
+            continue;
+        }
+        entry.state = State::Ready;
+        entry.width = result.width;
+        entry.height = result.height;
+        entry.pixels.swap(result.pixels);
+        ready.push_back(result.handle);
+    }
+    if (frame_ % kRetryFrames == 0) {
+        for (size_t i = 0; i < entries_.size(); ++i) {
+            if (entries_[i].state == State::Ready &&
+                std::find(ready.begin(), ready.end(), static_cast<ImageHandle>(i + 1)) == ready.end()) {
+                ready.push_back(static_cast<ImageHandle>(i + 1));
+            }
+        }
+    }
+    if (!ready.empty()) Place(ready);
+}
+
+// Packs into the free space first; only if that fails is the atlas rebuilt.
+void ImageCache::Place(const std::vector<ImageHandle>& handles) {
+    std::vector<stbrp_rect> rects(handles.size());
+    for (size_t i = 0; i < handles.size(); ++i) {
+        const Entry& entry = entries_[handles[i] - 1];
+        rects[i].id = static_cast<int>(i);
+        rects[i].w = entry.width + kAtlasPadding * 2;
+        rects[i].h = entry.height + kAtlasPadding * 2;
+    }
+    stbrp_pack_rects(&packer_, rects.data(), static_cast<int>(rects.size()));
+    std::vector<ImageHandle> unplaced;
+    for (size_t i = 0; i < handles.size(); ++i) {
+        Entry& entry = entries_[handles[i] - 1];
+        if (!rects[i].was_packed) {
+            unplaced.push_back(handles[i]);
+            continue;
+        }
+        entry.x = rects[i].x + kAtlasPadding;
+        entry.y = rects[i].y + kAtlasPadding;
+        entry.state = State::Resident;
+        Blit(entry);
+    }
+    if (!unplaced.empty()) Repack(unplaced);
+}
+
+// Rebuilds the atlas from the resident images plus |wanted|, evicting the
+// least recently drawn images until everything fits. Images drawn last frame
+// are on screen and never evicted; if they alone fill the atlas, |wanted|
+// stays Ready and is retried later.
+bool ImageCache::Repack(const std::vector<ImageHandle>& wanted) {
+    TRACE_SCOPE("image.repack");
+    std::vector<ImageHandle> residents;
+    long long needed = 0;
+    long long used = 0;
+    long long pinned = 0;
+    for (size_t i = 0; i < entries_.size(); ++i) {
+        const Entry& entry = entries_[i];
+        if (entry.state == State::Resident) {
+            residents.push_back(static_cast<ImageHandle>(i + 1));
+            used += PaddedArea(entry);
+            if (OnScreen(entry)) pinned += PaddedArea(entry);
+        }
+    }
+    for (ImageHandle handle : wanted) {
+        needed += PaddedArea(entries_[handle - 1]);
+    }
+    const long long atlas_area = static_cast<long long>(atlas_size_) * atlas_size_;
+    if (pinned + needed > atlas_area) return false;
+    // Oldest first.
+    std::sort(residents.begin(), residents.end(), [this](ImageHandle a, ImageHandle b) {
+        return entries_[a - 1].last_used < entries_[b - 1].last_used;
+    });
+
+    // Evict up front until the area leaves some slack, so one repack usually
+    // suffices; then one at a time while packing still fails.
+    size_t evicted = 0;
+    auto evict_next = [&]() {
+        if (evicted >= residents.size()) return false;
+        Entry& entry = entries_[residents[evicted] - 1];
+        if (OnScreen(entry)) return false;
+        used -= PaddedArea(entry);
+        Evict(entry);
+        ++evicted;
+        return true;
+    };
+    while (used + needed > atlas_area - atlas_area / 8 && evict_next()) {
+    }
+
+    std::vector<ImageHandle> packing;
+    std::vector<stbrp_rect> rects;
+    for (;;) {
+        packing.assign(residents.begin() + evicted, residents.end());
+        packing.insert(packing.end(), wanted.begin(), wanted.end());
+        rects.resize(packing.size());
+        for (size_t i = 0; i < packing.size(); ++i) {
+            const Entry& entry = entries_[packing[i] - 1];
+            rects[i].id = static_cast<int>(i);
+            rects[i].w = entry.width + kAtlasPadding * 2;
+            rects[i].h = entry.height + kAtlasPadding * 2;
+        }
+        stbrp_init_target(&packer_, atlas_size_, atlas_size_, nodes_.data(), static_cast<int>(nodes_.size()));
+        if (stbrp_pack_rects(&packer_, rects.data(), static_cast<int>(rects.size()))) break;
+        if (!evict_next()) {
+            // Keep the survivors; what did not fit waits.
+            packing.assign(residents.begin() + evicted, residents.end());
+            rects.resize(packing.size());
+            stbrp_init_target(&packer_, atlas_size_, atlas_size_, nodes_.data(), static_cast<int>(nodes_.size()));
+            stbrp_pack_rects(&packer_, rects.data(), static_cast<int>(rects.size()));
+            break;
+        }
+    }
+
+    std::fill(atlas_.begin(), atlas_.end(), 0);
+    for (size_t i = 0; i < packing.size(); ++i) {
+        Entry& entry = entries_[packing[i] - 1];
+        if (!rects[i].was_packed) {
+            // Only possible if the survivors no longer fit; drop them too.
+            Evict(entry);
+            continue;
+        }
+        entry.x = rects[i].x + kAtlasPadding;
+        entry.y = rects[i].y + kAtlasPadding;
+        entry.state = State::Resident;
+        Blit(entry);
+    }
+    MarkDirty(0, atlas_size_);
+    for (ImageHandle handle : wanted) {
+        if (entries_[handle - 1].state != State::Resident) return false;
+    }
+    return true;
+}
+
+long long ImageCache::PaddedArea(const Entry& entry) {
+    return static_cast<long long>(entry.width + kAtlasPadding * 2) * (entry.height + kAtlasPadding * 2);
+}
+
+// Update() runs before the frame's draws, so last frame's draws are what is
+// on screen.
+bool ImageCache::OnScreen(const Entry& entry) const {
+    return entry.last_used + 1 >= frame_;
+}
+
+void ImageCache::Evict(Entry& entry) {
+    entry.state = State::Evicted;
+    std::vector<uint8_t>().swap(entry.pixels);
+}
+
+void ImageCache::Blit(const Entry& entry) {
+    const size_t row_bytes = static_cast<size_t>(entry.width) * 4;
+    for (int y = 0; y < entry.height; ++y) {
+        memcpy(atlas_.data() + (static_cast<size_t>(entry.y + y) * atlas_size_ + entry.x) * 4,
+               entry.pixels.data() + y * row_bytes, row_bytes);
+    }
+    MarkDirty(entry.y, entry.y + entry.height);
+}
+
+void ImageCache::MarkDirty(int y_begin, int y_end) {
+    if (dirty_begin_ == dirty_end_) {
+        dirty_begin_ = y_begin;
+        dirty_end_ = y_end;
+        return;
+    }
+    dirty_begin_ = std::min(dirty_begin_, y_begin);
+    dirty_end_ = std::max(dirty_end_, y_end);
+}
+
+bool ImageCache::TakeDirtyRows(int& y_begin, int& y_end) {
+    if (dirty_begin_ == dirty_end_) return false;
+    y_begin = dirty_begin_;
+    y_end = dirty_end_;
+    dirty_begin_ = dirty_end_ = 0;
+    return true;
+}
+
+bool ImageCache::Resident(ImageHandle handle) const {
+    return handle > 0 && handle <= entries_.size() && entries_[handle - 1].state == State::Resident;
+}
+
+void ImageCache::Draw(ImDrawList* draw_list, ImageHandle handle, const ImVec2& p_min, const ImVec2& p_max, ImU32 tint) {
+    if (handle == 0 || handle > entries_.size()) return;
+    Entry& entry = entries_[handle - 1];
+    entry.last_used = frame_;
+    if (entry.state == State::Evicted) Queue(handle);
+    if (entry.state != State::Resident || !texture_) {
+        float rounding = std::min(p_max.x - p_min.x, p_max.y - p_min.y) * 0.2f;
+        draw_list->AddRectFilled(p_min, p_max, IM_COL32(70, 78, 92, 140), rounding);
+        return;
+    }
+
+    float box_w = p_max.x - p_min.x;
+    float box_h = p_max.y - p_min.y;
+    float scale = std::min(box_w / entry.width, box_h / entry.height);
+    float w = entry.width * scale;
+    float h = entry.height * scale;
+    ImVec2 a(p_min.x + (box_w - w) * 0.5f, p_min.y + (box_h - h) * 0.5f);
+    float inv = 1.0f / static_cast<float>(atlas_size_);
+    draw_list->AddImage(texture_, a, ImVec2(a.x + w, a.y + h),
+                        ImVec2(entry.x * inv, entry.y * inv),
+                        ImVec2((entry.x + entry.width) * inv, (entry.y + entry.height) * inv), tint);
+}
@@ -0,0 +1,113 @@
+#pragma once
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "imgui.h"
+#include "imstb_rectpack.h"
+
+// Images (target icons, badges) decoded and downscaled on worker threads,
+// then packed into one RGBA atlas texture on the UI thread. Draw() shows a
+// placeholder until an image is resident. When the atlas is full the images
+// drawn least recently are evicted and the rest repacked; an evicted image
+// reloads the next time it is drawn. Memory is bounded by the atlas size.
+
+// Stays valid for the lifetime of the cache, resident or not. 0 is never a
+// valid handle.
+using ImageHandle = uint32_t;
+
+class ImageCache {
+public:
+    explicit ImageCache(int atlas_size = 1024, unsigned decode_threads = 2);
+    ~ImageCache();
+    ImageCache(const ImageCache&) = delete;
+    ImageCache& operator=(const ImageCache&) = delete;
+
+    // Handle for |path| scaled to fit |size| x |size|; the first request
+    // queues the load. UI thread only, like everything below.
+    ImageHandle Request(const std::string& path, int size);
+    // Moves finished decodes into the atlas. Call once per frame before
+    // drawing.
+    void Update();
+    // Draws the image centered in [p_min, p_max] with its aspect ratio kept,
+    // or a placeholder until it is resident. Counts as a use for eviction.
+    void Draw(ImDrawList* draw_list, ImageHandle handle, const ImVec2& p_min, const ImVec2& p_max,
+              ImU32 tint = IM_COL32_WHITE);
+    bool Resident(ImageHandle handle) const;
+
+    // The atlas is straight-alpha RGBA, AtlasSize() pixels square. The
+    // renderer uploads the rows reported by TakeDirtyRows() and registers its
+    // texture with SetTextureId(); nothing is drawn from the atlas before.
+    const uint8_t* AtlasPixels() const { return atlas_.data(); }
+    int AtlasSize() const { return atlas_size_; }
+    bool TakeDirtyRows(int& y_begin, int& y_end);
+    void SetTextureId(ImTextureID texture) { texture_ = texture; }
+
+private:
+    enum class State {
+        Queued,
+        Ready,     // Decoded, waiting for atlas space.
+        Resident,
+        Evicted,
+        Failed
+    };
+
+    struct Entry {
+        std::string path;
+        int size = 0;
+        State state = State::Queued;
+        int width = 0;
+        int height = 0;
+        std::vector<uint8_t> pixels;  // Straight alpha; kept for repacking.
+        int x = 0;
+        int y = 0;
+        uint64_t last_used = 0;
+    };
+
+    struct Job {
+        ImageHandle handle = 0;
+        std::string path;
+        int size = 0;
+    };
+
+    struct Result {
+        ImageHandle handle = 0;
+        bool ok = false;
+        int width = 0;
+        int height = 0;
+        std::vector<uint8_t> pixels;
+    };
+
+    void WorkerMain();
+    void Queue(ImageHandle handle);
+    void Place(const std::vector<ImageHandle>& handles);
+    bool Repack(const std::vector<ImageHandle>& wanted);
+    static long long PaddedArea(const Entry& entry);
+    bool OnScreen(const Entry& entry) const;
+    void Evict(Entry& entry);
+    void Blit(const Entry& entry);
+    void MarkDirty(int y_begin, int y_end);
+
+    int atlas_size_ = 0;
+    std::vector<uint8_t> atlas_;
+    std::vector<stbrp_node> nodes_;
+    stbrp_context packer_;
+    ImTextureID texture_ = nullptr;
+    int dirty_begin_ = 0;
+    int dirty_end_ = 0;
+    uint64_t frame_ = 0;
+    std::vector<Entry> entries_;  // Indexed by handle - 1.
+    std::unordered_map<std::string, ImageHandle> handles_;
+
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::deque<Job> jobs_;
+    std::vector<Result> results_;
+    bool stop_ = false;
+    std::vector<std::thread> workers_;
+};
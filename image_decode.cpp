@@ -0,0 +1,109 @@
+#include "image_decode.h"
+
+#ifdef _WIN32
+#include <cstring>
+
+#include <windows.h>
+#include <wincodec.h>
+#pragma comment(lib, "windowscodecs.lib")
+
+#include "string_util.h"
+
+// Larger images are rejected rather than decoded; icons and badges are tiny.
+static const UINT kMaxDecodeSize = 4096;
+
+ImageDecoder::ImageDecoder() {
+    com_initialized_ = SUCCEEDED(CoInitializeEx(nullptr, COINIT_MULTITHREADED));
+    IWICImagingFactory* factory = nullptr;
+    if (SUCCEEDED(CoCreateInstance(CLSID_WICImagingFactory, nullptr, CLSCTX_INPROC_SERVER,
+                                   IID_PPV_ARGS(&factory)))) {
+        factory_ = factory;
+    }
+}
+
+ImageDecoder::~ImageDecoder() {
+    if (factory_) static_cast<IWICImagingFactory*>(factory_)->Release();
+    if (com_initialized_) CoUninitialize();
+}
+
+static bool CopyPremultiplied(IWICBitmapSource* source, DecodedImage& out) {
+    UINT width = 0;
+    UINT height = 0;
+    if (FAILED(source->GetSize(&width, &height)) || width == 0 || height == 0 ||
+        width > kMaxDecodeSize || height > kMaxDecodeSize) {
+        return false;
+    }
+    IWICBitmapSource* converted = nullptr;
+    if (FAILED(WICConvertBitmapSource(GUID_WICPixelFormat32bppPRGBA, source, &converted))) return false;
+    out.width = static_cast<int>(width);
+    out.height = static_cast<int>(height);
+    out.rgba.resize(static_cast<size_t>(width) * height * 4);
+    HRESULT hr = converted->CopyPixels(nullptr, width * 4, static_cast<UINT>(out.rgba.size()), out.rgba.data());
+    converted->Release();
+    return SUCCEEDED(hr);
+}
+
+static bool HasExtension(const std::string& path, const char* ext) {
+    size_t len = strlen(ext);
+    return path.size() >= len && _stricmp(path.c_str() + path.size() - len, ext) == 0;
+}
+
+bool ImageDecoder::Decode(const std::string& path, int size_hint, DecodedImage& out) {
+    IWICImagingFactory* factory = static_cast<IWICImagingFactory*>(factory_);
+    if (!factory) return false;
+    std::wstring wide = Utf8ToWide(path);
+
+    if (HasExtension(path, ".exe") || HasExtension(path, ".dll")) {
+        HICON icon = nullptr;
+        UINT extracted = PrivateExtractIconsW(wide.c_str(), 0, size_hint, size_hint, &icon, nullptr, 1, 0);
+        if (extracted == 0 || extracted == 0xFFFFFFFF || !icon) return false;
+        IWICBitmap* bitmap = nullptr;
+        bool ok = SUCCEEDED(factory->CreateBitmapFromHICON(icon, &bitmap)) && CopyPremultiplied(bitmap, out);
+        if (bitmap) bitmap->Release();
+        DestroyIcon(icon);
+        return ok;
+    }
+
+    IWICBitmapDecoder* decoder = nullptr;
+    if (FAILED(factory->CreateDecoderFromFilename(wide.c_str(), nullptr, GENERIC_READ,
+                                                  WICDecodeMetadataCacheOnDemand, &decoder))) {
+        return false;
+    }
+    // ICO files hold several sizes: take the smallest one at least size_hint
+    // wide, or the largest if none is.
+    UINT frame_count = 0;
+    decoder->GetFrameCount(&frame_count);
+    UINT best = 0;
+    UINT best_width = 0;
+    for (UINT i = 0; i < frame_count && frame_count > 1; ++i) {
+        IWICBitmapFrameDecode* frame = nullptr;
+        if (FAILED(decoder->GetFrame(i, &frame))) continue;
+        UINT w = 0;
+        UINT h = 0;
+        frame->GetSize(&w, &h);
+        frame->Release();
+        bool fits = w >= static_cast<UINT>(size_hint);
+        bool best_fits = best_width >= static_cast<UINT>(size_hint);
+        if (best_width == 0 || (fits && (!best_fits || w < best_width)) || (!fits && !best_fits && w > best_width)) {
+            best = i;
+            best_width = w;
+        }
+    }
+    IWICBitmapFrameDecode* frame = nullptr;
+    bool ok = SUCCEEDED(decoder->GetFrame(best, &frame)) && CopyPremultiplied(frame, out);
+    if (frame) frame->Release();
+    decoder->Release();
+    return ok;
+}
+
+#else
+
+ImageDecoder::ImageDecoder() {}
+
+ImageDecoder::~ImageDecoder() {}
+
+bool ImageDecoder::Decode(const std::string&, int, DecodedImage&) {
+    return false;
+}
+
+#endif
@@ -0,0 +1,33 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Decodes image files to premultiplied RGBA. PNG, ICO, BMP and JPEG go
+// through WIC; for .exe and .dll paths the file's main icon is extracted.
+// Other platforms have no decoder and always fail.
+
+struct DecodedImage {
+    int width = 0;
+    int height = 0;
+    std::vector<uint8_t> rgba;  // Premultiplied, width * 4 bytes per row.
+};
+
+// One per thread: holds the thread's COM apartment and WIC factory.
+class ImageDecoder {
+public:
+    ImageDecoder();
+    ~ImageDecoder();
+    ImageDecoder(const ImageDecoder&) = delete;
+    ImageDecoder& operator=(const ImageDecoder&) = delete;
+
+    // |size_hint| picks the icon frame or extracted icon size closest above
+    // it; the result may still be larger and is not scaled here.
+    bool Decode(const std::string& path, int size_hint, DecodedImage& out);
+
+private:
+#ifdef _WIN32
+    bool com_initialized_ = false;
+    void* factory_ = nullptr;  // IWICImagingFactory
+#endif
+};
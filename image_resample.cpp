@@ -0,0 +1,153 @@
+#include "image_resample.h"
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+#if defined(_M_X64) || defined(__x86_64__) || defined(__SSE2__)
+#define IMAGE_RESAMPLE_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace {
+    // Source pixels [first, first + weights.size()) and their coverage of
+    // one destination pixel; the weights sum to one.
+    struct AreaTaps {
+        int first = 0;
+        int count = 0;
+        int weight_index = 0;
+    };
+
+    void BuildAreaTaps(int src_size, int dst_size, std::vector<AreaTaps>& taps, std::vector<float>& weights) {
+        taps.resize(dst_size);
+        weights.clear();
+        double scale = static_cast<double>(src_size) / dst_size;
+        for (int i = 0; i < dst_size; ++i) {
+            double lo = i * scale;
+            double hi = (i + 1) * scale;
+            int first = static_cast<int>(lo);
+            int last = static_cast<int>(hi);
+            if (last >= src_size || static_cast<double>(last) == hi) --last;
+            if (last < first) last = first;
+            AreaTaps& tap = taps[i];
+            tap.first = first;
+            tap.count = last - first + 1;
+            tap.weight_index = static_cast<int>(weights.size());
+            for (int j = first; j <= last; ++j) {
+                double cover_lo = j > lo ? j : lo;
+                double cover_hi = j + 1 < hi ? j + 1 : hi;
+                weights.push_back(static_cast<float>((cover_hi - cover_lo) / scale));
+            }
+        }
+    }
+
+    inline uint8_t ToByte(float v) {
+        v += 0.5f;
+        if (v <= 0.0f) return 0;
+        if (v >= 255.0f) return 255;
+        return static_cast<uint8_t>(v);
+    }
+}
+
+void ResampleRgbaArea(const uint8_t* src, int src_w, int src_h, int src_stride,
+                      uint8_t* dst, int dst_w, int dst_h, int dst_stride) {
+    if (src_w <= 0 || src_h <= 0 || dst_w <= 0 || dst_h <= 0) return;
+    std::vector<AreaTaps> taps_x, taps_y;
+    std::vector<float> weights_x, weights_y;
+    BuildAreaTaps(src_w, dst_w, taps_x, weights_x);
+    BuildAreaTaps(src_h, dst_h, taps_y, weights_y);
+
+    // Horizontal pass into float RGBA rows, one pixel per 4-float vector.
+    std::vector<float> rows(static_cast<size_t>(dst_w) * src_h * 4);
+    for (int y = 0; y < src_h; ++y) {
+        const uint8_t* in = src + static_cast<size_t>(y) * src_stride;
+        float* out = rows.data() + static_cast<size_t>(y) * dst_w * 4;
+        for (int x = 0; x < dst_w; ++x, out += 4) {
+            const AreaTaps& tap = taps_x[x];
+            const float* w = weights_x.data() + tap.weight_index;
+            const uint8_t* p = in + tap.first * 4;
+#ifdef IMAGE_RESAMPLE_SSE2
+            const __m128i zero = _mm_setzero_si128();
+            __m128 acc = _mm_setzero_ps();
+            for (int k = 0; k < tap.count; ++k, p += 4) {
+                int packed;
+                memcpy(&packed, p, 4);
+                __m128i v = _mm_unpacklo_epi16(_mm_unpacklo_epi8(_mm_cvtsi32_si128(packed), zero), zero);
+                acc = _mm_add_ps(acc, _mm_mul_ps(_mm_cvtepi32_ps(v), _mm_set1_ps(w[k])));
+            }
+            _mm_storeu_ps(out, acc);
+#else
+            float acc[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+            for (int k = 0; k < tap.count; ++k, p += 4) {
+                for (int c = 0; c < 4; ++c) acc[c] += p[c] * w[k];
+            }
+            for (int c = 0; c < 4; ++c) out[c] = acc[c];
+#endif
+        }
+    }
+
+    // Vertical pass: weighted sum of whole rows, then pack to bytes.
+    const int row_floats = dst_w * 4;
+    std::vector<float> acc(row_floats);
+    for (int y = 0; y < dst_h; ++y) {
+        const AreaTaps& tap = taps_y[y];
+        const float* w = weights_y.data() + tap.weight_index;
+        std::fill(acc.begin(), acc.end(), 0.0f);
+        for (int k = 0; k < tap.count; ++k) {
+            const float* row = rows.data() + static_cast<size_t>(tap.first + k) * row_floats;
+            int i = 0;
+#ifdef IMAGE_RESAMPLE_SSE2
+            __m128 wk = _mm_set1_ps(w[k]);
+            for (; i + 4 <= row_floats; i += 4) {
+                _mm_storeu_ps(&acc[i], _mm_add_ps(_mm_loadu_ps(&acc[i]), _mm_mul_ps(_mm_loadu_ps(row + i), wk)));
+            }
+#endif
+            for (; i < row_floats; ++i) acc[i] += row[i] * w[k];
+        }
+        uint8_t* out = dst + static_cast<size_t>(y) * dst_stride;
+        int i = 0;
+#ifdef IMAGE_RESAMPLE_SSE2
+        const __m128 half = _mm_set1_ps(0.5f);
+        for (; i + 8 <= row_floats; i += 8) {
+            __m128i lo = _mm_cvttps_epi32(_mm_add_ps(_mm_loadu_ps(&acc[i]), half));
+            __m128i hi = _mm_cvttps_epi32(_mm_add_ps(_mm_loadu_ps(&acc[i + 4]), half));
+            __m128i bytes = _mm_packus_epi16(_mm_packs_epi32(lo, hi), _mm_setzero_si128());
+            _mm_storel_epi64(reinterpret_cast<__m128i*>(out + i), bytes);
+        }
+#endif
+        for (; i < row_floats; ++i) out[i] = ToByte(acc[i]);
+    }
+}
+
+void UnpremultiplyRgba(uint8_t* pixels, int width, int height, int stride) {
+    for (int y = 0; y < height; ++y) {
+        uint8_t* p = pixels + static_cast<size_t>(y) * stride;
+        for (int x = 0; x < width; ++x, p += 4) {
+            unsigned int a = p[3];
+            if (a == 255) continue;
+            if (a == 0) {
+                p[0] = p[1] = p[2] = 0;
+                continue;
+            }
+            for (int c = 0; c < 3; ++c) {
+                unsigned int v = (p[c] * 255u + a / 2) / a;
+                p[c] = static_cast<uint8_t>(v > 255 ? 255 : v);
+            }
+        }
+    }
+}
+
+void FitImageSize(int width, int height, int max_size, int& out_w, int& out_h) {
+    out_w = width;
+    out_h = height;
+    if (width <= 0 || height <= 0 || (width <= max_size && height <= max_size)) return;
+    if (width >= height) {
+        out_w = max_size;
+        out_h = static_cast<int>((static_cast<long long>(height) * max_size + width / 2) / width);
+    } else {
+        out_h = max_size;
+        out_w = static_cast<int>((static_cast<long long>(width) * max_size + height / 2) / height);
+    }
+    if (out_w < 1) out_w = 1;
+    if (out_h < 1) out_h = 1;
+}
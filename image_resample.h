@@ -0,0 +1,20 @@
+#pragma once
+#include <cstdint>
+
+// Image helpers for the icon pipeline. Pixels are 8-bit RGBA, rows
+// |stride| bytes apart.
+
+// Area-average (box) downscale of premultiplied RGBA: every source pixel
+// contributes in proportion to how much of it each destination pixel covers,
+// so thin features fade instead of aliasing away. Separable, SSE2 where
+// available. Intended for dst sizes at or below the source size.
+void ResampleRgbaArea(const uint8_t* src, int src_w, int src_h, int src_stride,
+                      uint8_t* dst, int dst_w, int dst_h, int dst_stride);
+
+// Converts premultiplied RGBA to straight alpha in place, for renderers that
+// blend with straight alpha.
+void UnpremultiplyRgba(uint8_t* pixels, int width, int height, int stride);
+
+// Largest size within max_size x max_size with the aspect ratio of
+// width x height; never larger than the image itself.
+void FitImageSize(int width, int height, int max_size, int& out_w, int& out_h);
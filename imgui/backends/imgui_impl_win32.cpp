@@ -1,4 +1,5 @@
 #include "imgui_impl_win32.h"
+#include <windowsx.h>
 
 static HWND g_hwnd = nullptr;
 
@@ -20,6 +21,91 @@ void ImGui_ImplWin32_NewFrame() {
     }
 }
 
-LRESULT ImGui_ImplWin32_WndProcHandler(HWND, UINT, WPARAM, LPARAM) {
+static ImGuiKey VirtualKeyToImGuiKey(WPARAM wParam) {
+    switch (wParam) {
+    case VK_TAB: return ImGuiKey_Tab;
+    case VK_LEFT: return ImGuiKey_LeftArrow;
+    case VK_RIGHT: return ImGuiKey_RightArrow;
+    case VK_UP: return ImGuiKey_UpArrow;
+    case VK_DOWN: return ImGuiKey_DownArrow;
+    case VK_PRIOR: return ImGuiKey_PageUp;
+    case VK_NEXT: return ImGuiKey_PageDown;
+    case VK_HOME: return ImGuiKey_Home;
+    case VK_END: return ImGuiKey_End;
+    case VK_INSERT: return ImGuiKey_Insert;
+    case VK_DELETE: return ImGuiKey_Delete;
+    case VK_BACK: return ImGuiKey_Backspace;
+    case VK_RETURN: return ImGuiKey_Enter;
+    case VK_ESCAPE: return ImGuiKey_Escape;
+    case 'A': return ImGuiKey_A;
+    case 'C': return ImGuiKey_C;
+    case 'V': return ImGuiKey_V;
+    case 'X': return ImGuiKey_X;
+    default: return ImGuiKey_None;
+    }
+}
+
+static void UpdateKeyModifiers(ImGuiIO& io) {
+    io.KeyCtrl = (GetKeyState(VK_CONTROL) & 0x8000) != 0;
+    io.KeyShift = (GetKeyState(VK_SHIFT) & 0x8000) != 0;
+}
+
+static void MouseButtonEvent(HWND hWnd, ImGuiIO& io, int button, bool down) {
+    // Captured while held so drags that leave the window still end.
+    bool any_down = io.MouseDown[0] || io.MouseDown[1] || io.MouseDown[2];
+    if (down && !any_down && GetCapture() == nullptr) SetCapture(hWnd);
+    io.AddMouseButtonEvent(button, down);
+    any_down = io.MouseDown[0] || io.MouseDown[1] || io.MouseDown[2];
+    if (!down && !any_down && GetCapture() == hWnd) ReleaseCapture();
+}
+
+// Feeds mouse, keyboard and text input to ImGuiIO. Always returns 0, so the
+// application still sees every message.
+LRESULT ImGui_ImplWin32_WndProcHandler(HWND hWnd, UINT msg, WPARAM wParam, LPARAM lParam) {
+    ImGuiIO& io = ImGui::GetIO();
+    switch (msg) {
+    case WM_MOUSEMOVE:
+        io.AddMousePosEvent(static_cast<float>(GET_X_LPARAM(lParam)), static_cast<float>(GET_Y_LPARAM(lParam)));
+        break;
+    case WM_LBUTTONDOWN:
+    case WM_LBUTTONDBLCLK:
+        MouseButtonEvent(hWnd, io, 0, true);
+        break;
+    case WM_RBUTTONDOWN:
+    case WM_RBUTTONDBLCLK:
+        MouseButtonEvent(hWnd, io, 1, true);
+        break;
+    case WM_MBUTTONDOWN:
+    case WM_MBUTTONDBLCLK:
+        MouseButtonEvent(hWnd, io, 2, true);
+        break;
+    case WM_LBUTTONUP:
+        MouseButtonEvent(hWnd, io, 0, false);
+        break;
+    case WM_RBUTTONUP:
+        MouseButtonEvent(hWnd, io, 1, false);
+        break;
+    case WM_MBUTTONUP:
+        MouseButtonEvent(hWnd, io, 2, false);
+        break;
+    case WM_MOUSEWHEEL:
+        io.AddMouseWheelEvent(static_cast<float>(GET_WHEEL_DELTA_WPARAM(wParam)) / static_cast<float>(WHEEL_DELTA));
+        break;
+    case WM_KEYDOWN:
+    case WM_SYSKEYDOWN:
+    case WM_KEYUP:
+    case WM_SYSKEYUP:
+        UpdateKeyModifiers(io);
+        io.AddKeyEvent(VirtualKeyToImGuiKey(wParam), msg == WM_KEYDOWN || msg == WM_SYSKEYDOWN);
+        break;
+    case WM_CHAR:
+        if (wParam > 0 && wParam < 0x10000) io.AddInputCharacterUTF16(static_cast<unsigned short>(wParam));
+        break;
+    case WM_KILLFOCUS:
+        io.KeyCtrl = false;
+        io.KeyShift = false;
+        for (int button = 0; button < 3; ++button) io.AddMouseButtonEvent(button, false);
+        break;
+    }
     return 0;
 }
@@ -1,21 +1,219 @@
 #include "imgui.h"
+#include "imgui_internal.h"
 #include <chrono>
 #include <cstdarg>
 #include <cstdio>
+#include <unordered_map>
+#include <vector>
+#ifdef _WIN32
 #include <windows.h>
+#endif
 
 namespace {
     ImGuiIO g_io;
     ImGuiStyle g_style;
     ImGuiViewport g_viewport;
+    ImFont g_font;
     ImDrawList g_draw_list;
     ImDrawData g_draw_data;
     ImVec2 g_cursor_pos(0, 0);
     ImVec2 g_window_pos(0, 0);
     ImVec2 g_window_size(0, 0);
+    ImVec2 g_next_window_pos(0, 0);
+    ImVec2 g_next_window_size(0, 0);
+    bool g_has_next_window_pos = false;
+    bool g_has_next_window_size = false;
     bool g_item_active = false;
+    float g_wheel_unclaimed = 0.0f;
     std::chrono::steady_clock::time_point g_start_time;
     std::string g_clipboard_cache;
+
+    void PushInputEvent(ImGuiIO& io, ImGuiInputEventType type, ImGuiKey key, unsigned int c) {
+        ImGuiInputEvent e;
+        e.Type = type;
+        e.Key = key;
+        e.Char = c;
+        e.KeyCtrl = io.KeyCtrl;
+        e.KeyShift = io.KeyShift;
+        io.InputEventsQueue.push_back(e);
+    }
+
+    bool ValidMousePos(const ImVec2& pos) {
+        return pos.x > -FLT_MAX && pos.y > -FLT_MAX;
+    }
+
+    // Scroll state of a window, kept across frames.
+    struct WindowState {
+        float scroll_y = 0.0f;
+        float scroll_max_y = 0.0f;
+    };
+
+    // A window being submitted, and the layout of its parent to restore when
+    // it ends.
+    struct WindowFrame {
+        ImGuiID id = 0;
+        WindowState* state = nullptr;
+        ImVec2 parent_pos;
+        ImVec2 parent_size;
+        ImVec2 parent_cursor;
+        float content_max_y = 0.0f;
+    };
+
+    std::unordered_map<ImGuiID, WindowState> g_windows;
+    std::vector<WindowFrame> g_window_stack;
+
+    // Children are keyed under their parent, like upstream's ID stack.
+    void PushWindow(const char* name) {
+        WindowFrame frame;
+        frame.id = ImHashStr(name);
+        if (!g_window_stack.empty()) frame.id ^= g_window_stack.back().id * 16777619u;
+        frame.state = &g_windows[frame.id];
+        frame.parent_pos = g_window_pos;
+        frame.parent_size = g_window_size;
+        frame.parent_cursor = g_cursor_pos;
+        g_window_stack.push_back(frame);
+        g_cursor_pos = ImVec2(0, 0);
+    }
+
+    // Scroll extent comes from the furthest the cursor reached, so a clipped
+    // list counts at its full height. The innermost hovered window that can
+    // scroll takes the mouse wheel.
+    void PopWindow() {
+        if (g_window_stack.empty()) return;
+        WindowFrame frame = g_window_stack.back();
+        g_window_stack.pop_back();
+        WindowState& state = *frame.state;
+        float max_y = frame.content_max_y - g_window_size.y;
+        state.scroll_max_y = max_y > 0.0f ? max_y : 0.0f;
+        const ImVec2& mouse = g_io.MousePos;
+        if (g_wheel_unclaimed != 0.0f && state.scroll_max_y > 0.0f && mouse.x >= g_window_pos.x &&
+            mouse.y >= g_window_pos.y && mouse.x < g_window_pos.x + g_window_size.x &&
+            mouse.y < g_window_pos.y + g_window_size.y) {
+            state.scroll_y -= g_wheel_unclaimed * (g_font.FontSize + g_style.ItemSpacing.y) * 3.0f;
+            g_wheel_unclaimed = 0.0f;
+        }
+        if (state.scroll_y > state.scroll_max_y) state.scroll_y = state.scroll_max_y;
+        if (state.scroll_y < 0.0f) state.scroll_y = 0.0f;
+        g_window_pos = frame.parent_pos;
+        g_window_size = frame.parent_size;
+        g_cursor_pos = frame.parent_cursor;
+    }
+
+    void NoteCursor() {
+        if (g_window_stack.empty()) return;
+        float& max_y = g_window_stack.back().content_max_y;
+        if (g_cursor_pos.y > max_y) max_y = g_cursor_pos.y;
+    }
+
+    float CurrentScrollY() {
+        return g_window_stack.empty() ? 0.0f : g_window_stack.back().state->scroll_y;
+    }
+}
+
+void ImGuiIO::AddMousePosEvent(float x, float y) {
+    MousePos = ImVec2(x, y);
+}
+
+void ImGuiIO::AddMouseButtonEvent(int button, bool down) {
+    if (button < 0 || button >= IM_ARRAYSIZE(MouseDown) || MouseDown[button] == down) return;
+    MouseDown[button] = down;
+    if (down)
+        MouseClickedQueued[button] = true;
+    else
+        MouseReleasedQueued[button] = true;
+}
+
+void ImGuiIO::AddMouseWheelEvent(float wheel_y) {
+    MouseWheelQueued += wheel_y;
+}
+
+void ImGuiIO::AddKeyEvent(ImGuiKey key, bool down) {
+    if (down && key != ImGuiKey_None) PushInputEvent(*this, ImGuiInputEventType_Key, key, 0);
+}
+
+void ImGuiIO::AddInputCharacter(unsigned int c) {
+    if (c != 0) PushInputEvent(*this, ImGuiInputEventType_Text, ImGuiKey_None, c);
+}
+
+void ImGuiIO::AddInputCharacterUTF16(unsigned short c) {
+    if (c >= 0xD800 && c <= 0xDBFF) {
+        InputQueueSurrogate = c;
+        return;
+    }
+    unsigned int cp = c;
+    if (c >= 0xDC00 && c <= 0xDFFF) {
+        cp = InputQueueSurrogate ? 0x10000 + ((InputQueueSurrogate - 0xD800u) << 10) + (c - 0xDC00u) : 0xFFFD;
+    } else if (InputQueueSurrogate) {
+        AddInputCharacter(0xFFFD);
+    }
+    InputQueueSurrogate = 0;
+    AddInputCharacter(cp);
+}
+
+int ImTextCharFromUtf8(unsigned int* out_char, const char* in_text, const char* in_text_end) {
+    static const unsigned char kLengths[32] = { 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+                                                0, 0, 0, 0, 0, 0, 0, 0, 2, 2, 2, 2, 3, 3, 4, 0 };
+    static const unsigned int kMins[5] = { 0x400000, 0, 0x80, 0x800, 0x10000 };
+    const unsigned char* s = reinterpret_cast<const unsigned char*>(in_text);
+    int len = kLengths[s[0] >> 3];
+    if (len == 1) {
+        *out_char = s[0];
+        return 1;
+    }
+    // Bytes past the end (or past a terminator) read as invalid.
+    int avail = 4;
+    if (in_text_end) avail = static_cast<int>(in_text_end - in_text);
+    unsigned int c = 0;
+    bool valid = len != 0 && len <= avail;
+    if (valid) {
+        c = s[0] & (0xFFu >> (len + 1));
+        for (int i = 1; i < len; ++i) {
+            if ((s[i] & 0xC0) != 0x80) {
+                valid = false;
+                len = i;
+                break;
+            }
+            c = (c << 6) | (s[i] & 0x3Fu);
+        }
+    }
+    if (!valid || c < kMins[len] || c > 0x10FFFF || (c >= 0xD800 && c <= 0xDFFF)) {
+        *out_char = 0xFFFD;
+        return len > 0 ? len : 1;
+    }
+    *out_char = c;
+    return len;
+}
+
+int ImTextCharToUtf8(char out[4], unsigned int c) {
+    if (c < 0x80) {
+        out[0] = static_cast<char>(c);
+        return 1;
+    }
+    if (c < 0x800) {
+        out[0] = static_cast<char>(0xC0 | (c >> 6));
+        out[1] = static_cast<char>(0x80 | (c & 0x3F));
+        return 2;
+    }
+    if (c >= 0xD800 && c <= 0xDFFF) c = 0xFFFD;
+    if (c < 0x10000) {
+        out[0] = static_cast<char>(0xE0 | (c >> 12));
+        out[1] = static_cast<char>(0x80 | ((c >> 6) & 0x3F));
+        out[2] = static_cast<char>(0x80 | (c & 0x3F));
+        return 3;
+    }
+    if (c > 0x10FFFF) return ImTextCharToUtf8(out, 0xFFFD);
+    out[0] = static_cast<char>(0xF0 | (c >> 18));
+    out[1] = static_cast<char>(0x80 | ((c >> 12) & 0x3F));
+    out[2] = static_cast<char>(0x80 | ((c >> 6) & 0x3F));
+    out[3] = static_cast<char>(0x80 | (c & 0x3F));
+    return 4;
+}
+
+// FNV-1a over the whole label, "##" suffix included.
+ImGuiID ImHashStr(const char* str) {
+    ImGuiID h = 2166136261u;
+    for (; *str; ++str) h = (h ^ static_cast<unsigned char>(*str)) * 16777619u;
+    return h;
 }
 
 namespace ImGui {
@@ -41,58 +239,184 @@ namespace ImGui {
 
     void NewFrame() {
         g_item_active = false;
+        g_draw_list._ResetForNewFrame();
+
+        ImGuiIO& io = g_io;
+        if (ValidMousePos(io.MousePos) && ValidMousePos(io.MousePosPrev))
+            io.MouseDelta = ImVec2(io.MousePos.x - io.MousePosPrev.x, io.MousePos.y - io.MousePosPrev.y);
+        else
+            io.MouseDelta = ImVec2(0, 0);
+        io.MousePosPrev = io.MousePos;
+        io.MouseWheel = io.MouseWheelQueued;
+        io.MouseWheelQueued = 0.0f;
+        g_wheel_unclaimed = io.MouseWheel;
+        g_window_stack.clear();
+
+        float now = GetTime();
+        for (int i = 0; i < IM_ARRAYSIZE(io.MouseDown); ++i) {
+            io.MouseClicked[i] = io.MouseClickedQueued[i];
+            io.MouseReleased[i] = io.MouseReleasedQueued[i];
+            io.MouseClickedQueued[i] = io.MouseReleasedQueued[i] = false;
+            io.MouseDoubleClicked[i] = false;
+            if (!io.MouseClicked[i]) continue;
+            float dx = io.MousePos.x - io.MouseClickedPos[i].x;
+            float dy = io.MousePos.y - io.MouseClickedPos[i].y;
+            float max_dist = io.MouseDoubleClickMaxDist;
+            if (now - io.MouseClickedTime[i] < io.MouseDoubleClickTime && dx * dx + dy * dy < max_dist * max_dist) {
+                io.MouseDoubleClicked[i] = true;
+                io.MouseClickedTime[i] = -FLT_MAX;  // A third click starts over.
+            } else {
+                io.MouseClickedTime[i] = now;
+            }
+            io.MouseClickedPos[i] = io.MousePos;
+        }
+
+        io.InputEvents = io.InputEventsQueue;
+        io.InputEventsQueue.clear();
     }
 
-    void Render() {}
+    void Render() {
+        g_draw_data.CmdLists.clear();
+        g_draw_data.CmdLists.push_back(&g_draw_list);
+        g_draw_data.TotalVtxCount = g_draw_list.VtxBuffer.Size;
+        g_draw_data.TotalIdxCount = g_draw_list.IdxBuffer.Size;
+        g_draw_data.DisplayPos = ImVec2(0, 0);
+        g_draw_data.DisplaySize = g_io.DisplaySize;
+    }
 
     ImDrawData* GetDrawData() {
         return &g_draw_data;
     }
 
     void SetNextWindowPos(const ImVec2& pos, int, const ImVec2&) {
-        g_window_pos = pos;
+        g_next_window_pos = pos;
+        g_has_next_window_pos = true;
     }
 
     void SetNextWindowSize(const ImVec2& size, int) {
-        g_window_size = size;
-        g_viewport.Pos = g_window_pos;
+        g_next_window_size = size;
+        g_has_next_window_size = true;
+        g_viewport.Pos = g_has_next_window_pos ? g_next_window_pos : g_window_pos;
         g_viewport.Size = size;
     }
 
     void SetNextWindowBgAlpha(float) {}
 
-    bool Begin(const char*, bool*, int) {
-        g_cursor_pos = ImVec2(0, 0);
+    // Top-level windows take the size and position set for them, and keep
+    // their parent's otherwise.
+    bool Begin(const char* name, bool*, int) {
+        PushWindow(name);
+        if (g_has_next_window_pos) g_window_pos = g_next_window_pos;
+        if (g_has_next_window_size) g_window_size = g_next_window_size;
+        g_has_next_window_pos = g_has_next_window_size = false;
         return true;
     }
 
-    void End() {}
+    void End() {
+        PopWindow();
+    }
 
-    bool BeginChild(const char*, const ImVec2&, bool, int) {
-        g_cursor_pos = ImVec2(0, 0);
+    // Children sit at the parent's cursor; a size of zero or less on an axis
+    // fills the parent's remaining space minus that amount.
+    bool BeginChild(const char* str_id, const ImVec2& size, bool, int) {
+        ImVec2 pos = GetCursorScreenPos();
+        ImVec2 avail = GetContentRegionAvail();
+        PushWindow(str_id);
+        g_window_pos = pos;
+        g_window_size.x = size.x > 0.0f ? size.x : (avail.x + size.x > 0.0f ? avail.x + size.x : 0.0f);
+        g_window_size.y = size.y > 0.0f ? size.y : (avail.y + size.y > 0.0f ? avail.y + size.y : 0.0f);
         return true;
     }
 
-    void EndChild() {}
+    void EndChild() {
+        float height = g_window_size.y;
+        PopWindow();
+        g_cursor_pos.y += height + g_style.ItemSpacing.y;
+        NoteCursor();
+    }
 
     void SetCursorPos(const ImVec2& local_pos) {
         g_cursor_pos = local_pos;
+        NoteCursor();
     }
 
     void SetCursorPosY(float local_y) {
         g_cursor_pos.y = local_y;
+        NoteCursor();
     }
 
     void SetCursorScreenPos(const ImVec2& pos) {
-        g_cursor_pos = pos;
+        g_cursor_pos = ImVec2(pos.x - g_window_pos.x, pos.y - g_window_pos.y + CurrentScrollY());
+        NoteCursor();
     }
 
     ImVec2 GetCursorPos() {
         return g_cursor_pos;
     }
 
+    // Content scrolls up under the window.
+    ImVec2 GetCursorScreenPos() {
+        return ImVec2(g_window_pos.x + g_cursor_pos.x, g_window_pos.y + g_cursor_pos.y - CurrentScrollY());
+    }
+
     ImVec2 GetContentRegionAvail() {
-        return g_window_size;
+        return ImVec2(g_window_size.x - g_cursor_pos.x, g_window_size.y - g_cursor_pos.y);
+    }
+
+    // Upstream's default item width: 65% of the window.
+    float CalcItemWidth() {
+        float width = g_window_size.x * 0.65f;
+        return width > 1.0f ? width : 1.0f;
+    }
+
+    ImFont* GetFont() {
+        return &g_font;
+    }
+
+    float GetFontSize() {
+        return g_font.FontSize;
+    }
+
+    // Width of the longest line and height of all lines.
+    ImVec2 CalcTextSize(const char* text, const char* text_end) {
+        if (!text_end) text_end = text + strlen(text);
+        float line_width = 0.0f;
+        float max_width = 0.0f;
+        int lines = 1;
+        for (const char* s = text; s < text_end;) {
+            if (*s == '\n') {
+                max_width = line_width > max_width ? line_width : max_width;
+                line_width = 0.0f;
+                ++lines;
+                ++s;
+                continue;
+            }
+            unsigned int c = 0;
+            s += ImTextCharFromUtf8(&c, s, text_end);
+            line_width += c <= 0xFFFF ? g_font.GetCharAdvance(static_cast<ImWchar>(c)) : g_font.FallbackAdvanceX;
+        }
+        max_width = line_width > max_width ? line_width : max_width;
+        return ImVec2(max_width, g_font.FontSize * lines);
+    }
+
+    // Font size plus vertical item spacing, as upstream.
+    float GetTextLineHeightWithSpacing() {
+        return g_font.FontSize + g_style.ItemSpacing.y;
+    }
+
+    float GetScrollY() {
+        return CurrentScrollY();
+    }
+
+    // As upstream, the extent measured when the window last ended.
+    float GetScrollMaxY() {
+        return g_window_stack.empty() ? 0.0f : g_window_stack.back().state->scroll_max_y;
+    }
+
+    // Clamped to the extent once the window ends, when it is known.
+    void SetScrollY(float scroll_y) {
+        if (g_window_stack.empty()) return;
+        g_window_stack.back().state->scroll_y = scroll_y < 0.0f ? 0.0f : scroll_y;
     }
 
     ImVec2 GetWindowPos() {
@@ -111,15 +435,16 @@ namespace ImGui {
 
     void Separator() {}
 
-    bool Button(const char*, const ImVec2&) {
-        return false;
+    void Dummy(const ImVec2& size) {
+        g_cursor_pos.y += size.y + g_style.ItemSpacing.y;
+        NoteCursor();
     }
 
-    bool Checkbox(const char*, bool*) {
+    bool Button(const char*, const ImVec2&) {
         return false;
     }
 
-    bool InputText(const char*, char*, size_t, int) {
+    bool Checkbox(const char*, bool*) {
         return false;
     }
 
@@ -158,6 +483,10 @@ namespace ImGui {
         return g_item_active;
     }
 
+    void SetLastItemActive(bool active) {
+        g_item_active = active;
+    }
+
     bool IsMouseDragging(int, float) {
         return false;
     }
@@ -168,25 +497,56 @@ namespace ImGui {
         return elapsed.count();
     }
 
+#ifdef _WIN32
+    // UTF-8 in and out, through CF_UNICODETEXT.
     const char* GetClipboardText() {
         g_clipboard_cache.clear();
         if (!OpenClipboard(nullptr)) {
             return nullptr;
         }
-        HANDLE data = GetClipboardData(CF_TEXT);
+        HANDLE data = GetClipboardData(CF_UNICODETEXT);
         if (!data) {
             CloseClipboard();
             return nullptr;
         }
-        char* text = static_cast<char*>(GlobalLock(data));
+        const wchar_t* text = static_cast<const wchar_t*>(GlobalLock(data));
         if (text) {
-            g_clipboard_cache = text;
+            int size = WideCharToMultiByte(CP_UTF8, 0, text, -1, nullptr, 0, nullptr, nullptr);
+            if (size > 1) {
+                g_clipboard_cache.resize(static_cast<size_t>(size));
+                WideCharToMultiByte(CP_UTF8, 0, text, -1, &g_clipboard_cache[0], size, nullptr, nullptr);
+                g_clipboard_cache.resize(static_cast<size_t>(size - 1));
+            }
             GlobalUnlock(data);
         }
         CloseClipboard();
         return g_clipboard_cache.empty() ? nullptr : g_clipboard_cache.c_str();
     }
 
+    void SetClipboardText(const char* text) {
+        int length = MultiByteToWideChar(CP_UTF8, 0, text, -1, nullptr, 0);
+        if (length <= 0 || !OpenClipboard(nullptr)) return;
+        HGLOBAL memory = GlobalAlloc(GMEM_MOVEABLE, static_cast<SIZE_T>(length) * sizeof(wchar_t));
+        if (memory) {
+            wchar_t* dest = static_cast<wchar_t*>(GlobalLock(memory));
+            MultiByteToWideChar(CP_UTF8, 0, text, -1, dest, length);
+            GlobalUnlock(memory);
+            EmptyClipboard();
+            if (!SetClipboardData(CF_UNICODETEXT, memory)) GlobalFree(memory);
+        }
+        CloseClipboard();
+    }
+#else
+    // Process-local clipboard for offline tools.
+    const char* GetClipboardText() {
+        return g_clipboard_cache.empty() ? nullptr : g_clipboard_cache.c_str();
+    }
+
+    void SetClipboardText(const char* text) {
+        g_clipboard_cache = text;
+    }
+#endif
+
     unsigned int ColorConvertFloat4ToU32(const ImVec4& in) {
         auto to_byte = [](float v) {
             if (v < 0.0f) v = 0.0f;
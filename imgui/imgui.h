@@ -1,13 +1,24 @@
 #pragma once
+#include <cfloat>
 #include <cstddef>
 #include <cstdint>
+#include <cstdlib>
+#include <cstring>
 #include <string>
 
+typedef unsigned int ImU32;
+typedef unsigned int ImDrawIdx;
+typedef void* ImTextureID;
+typedef unsigned int ImGuiID;
+typedef int ImGuiSortDirection;
+typedef int ImGuiInputTextFlags;
+typedef unsigned short ImWchar;
+
 struct ImVec2 {
     float x;
     float y;
-    ImVec2() : x(0), y(0) {}
-    ImVec2(float _x, float _y) : x(_x), y(_y) {}
+    constexpr ImVec2() : x(0), y(0) {}
+    constexpr ImVec2(float _x, float _y) : x(_x), y(_y) {}
 };
 
 struct ImVec4 {
@@ -15,15 +26,22 @@ struct ImVec4 {
     float y;
     float z;
     float w;
-    ImVec4() : x(0), y(0), z(0), w(0) {}
-    ImVec4(float _x, float _y, float _z, float _w) : x(_x), y(_y), z(_z), w(_w) {}
+    constexpr ImVec4() : x(0), y(0), z(0), w(0) {}
+    constexpr ImVec4(float _x, float _y, float _z, float _w) : x(_x), y(_y), z(_z), w(_w) {}
 };
 
-struct ImGuiIO {
-    ImVec2 DisplaySize;
-    float DeltaTime = 1.0f / 60.0f;
-    const char* IniFilename = nullptr;
-    int ConfigFlags = 0;
+
+enum ImGuiCol_ {
+    ImGuiCol_Text,
+    ImGuiCol_WindowBg,
+    ImGuiCol_ChildBg,
+    ImGuiCol_Border,
+    ImGuiCol_FrameBg,
+    ImGuiCol_Button,
+    ImGuiCol_ButtonHovered,
+    ImGuiCol_ButtonActive,
+    ImGuiCol_TextSelectedBg,
+    ImGuiCol_COUNT
 };
 
 struct ImGuiStyle {
@@ -32,7 +50,10 @@ struct ImGuiStyle {
     float ChildRounding = 0.0f;
     float PopupRounding = 0.0f;
     ImVec2 WindowPadding = ImVec2(8, 8);
+    ImVec2 FramePadding = ImVec2(4, 3);
     ImVec2 ItemSpacing = ImVec2(8, 4);
+    ImVec2 ItemInnerSpacing = ImVec2(4, 4);
+    ImVec4 Colors[ImGuiCol_COUNT];
 };
 
 struct ImGuiViewport {
@@ -40,13 +61,225 @@ struct ImGuiViewport {
     ImVec2 Size;
 };
 
+// Minimal growable array for POD types, same contract as upstream ImVector:
+// clear() keeps the allocation so per-frame buffers stop reallocating once warm.
+template<typename T>
+struct ImVector {
+    int Size = 0;
+    int Capacity = 0;
+    T* Data = nullptr;
+
+    ImVector() {}
+    ImVector(const ImVector<T>& src) { operator=(src); }
+    ImVector<T>& operator=(const ImVector<T>& src) {
+        clear();
+        resize(src.Size);
+        if (src.Size) memcpy(Data, src.Data, static_cast<size_t>(src.Size) * sizeof(T));
+        return *this;
+    }
+    ~ImVector() { free(Data); }
+
+    bool empty() const { return Size == 0; }
+    int size() const { return Size; }
+    T* begin() { return Data; }
+    T* end() { return Data + Size; }
+    const T* begin() const { return Data; }
+    const T* end() const { return Data + Size; }
+    T& operator[](int i) { return Data[i]; }
+    const T& operator[](int i) const { return Data[i]; }
+    T& back() { return Data[Size - 1]; }
+
+    void clear() { Size = 0; }
+    void clear_and_free() { free(Data); Data = nullptr; Size = Capacity = 0; }
+    void reserve(int new_capacity) {
+        if (new_capacity <= Capacity) return;
+        T* new_data = static_cast<T*>(malloc(static_cast<size_t>(new_capacity) * sizeof(T)));
+        if (Data) {
+            memcpy(new_data, Data, static_cast<size_t>(Size) * sizeof(T));
+            free(Data);
+        }
+        Data = new_data;
+        Capacity = new_capacity;
+    }
+    void resize(int new_size) {
+        if (new_size > Capacity) reserve(GrowCapacity(new_size));
+        Size = new_size;
+    }
+    void push_back(const T& v) {
+        if (Size == Capacity) reserve(GrowCapacity(Size + 1));
+        Data[Size++] = v;
+    }
+    void pop_back() { --Size; }
+
+private:
+    int GrowCapacity(int size) const {
+        int new_capacity = Capacity ? (Capacity + Capacity / 2) : 8;
+        return new_capacity > size ? new_capacity : size;
+    }
+};
+
+// Keys widgets react to; the platform backend maps its key codes onto these.
+enum ImGuiKey : int {
+    ImGuiKey_None = 0,
+    ImGuiKey_Tab,
+    ImGuiKey_LeftArrow,
+    ImGuiKey_RightArrow,
+    ImGuiKey_UpArrow,
+    ImGuiKey_DownArrow,
+    ImGuiKey_PageUp,
+    ImGuiKey_PageDown,
+    ImGuiKey_Home,
+    ImGuiKey_End,
+    ImGuiKey_Insert,
+    ImGuiKey_Delete,
+    ImGuiKey_Backspace,
+    ImGuiKey_Enter,
+    ImGuiKey_Escape,
+    ImGuiKey_A,
+    ImGuiKey_C,
+    ImGuiKey_V,
+    ImGuiKey_X,
+    ImGuiKey_COUNT
+};
+
+enum ImGuiInputEventType {
+    ImGuiInputEventType_Key,
+    ImGuiInputEventType_Text
+};
+
+// A key press (auto-repeat included) or typed character, with the modifiers
+// held when it arrived. Kept in arrival order so fast typing interleaved
+// with editing keys replays correctly.
+struct ImGuiInputEvent {
+    ImGuiInputEventType Type = ImGuiInputEventType_Key;
+    ImGuiKey Key = ImGuiKey_None;
+    unsigned int Char = 0;
+    bool KeyCtrl = false;
+    bool KeyShift = false;
+};
+
+struct ImGuiIO {
+    ImVec2 DisplaySize;
+    float DeltaTime = 1.0f / 60.0f;
+    const char* IniFilename = nullptr;
+    int ConfigFlags = 0;
+    float MouseDoubleClickTime = 0.30f;
+    float MouseDoubleClickMaxDist = 6.0f;
+
+    // Input state, fed by the platform backend.
+    ImVec2 MousePos = ImVec2(-FLT_MAX, -FLT_MAX);
+    bool MouseDown[3] = {};
+    bool KeyCtrl = false;
+    bool KeyShift = false;
+    void AddMousePosEvent(float x, float y);
+    void AddMouseButtonEvent(int button, bool down);
+    void AddMouseWheelEvent(float wheel_y);
+    // Queues a press when |down|; KeyCtrl/KeyShift should be current.
+    void AddKeyEvent(ImGuiKey key, bool down);
+    void AddInputCharacter(unsigned int c);
+    // Pairs surrogates from WM_CHAR.
+    void AddInputCharacterUTF16(unsigned short c);
+
+    // Per-frame input, computed by NewFrame(). A press and release between
+    // two frames still reports the click.
+    ImVec2 MouseDelta;
+    float MouseWheel = 0.0f;
+    bool MouseClicked[3] = {};
+    bool MouseDoubleClicked[3] = {};
+    bool MouseReleased[3] = {};
+    ImVector<ImGuiInputEvent> InputEvents;
+
+    // Internal.
+    ImVector<ImGuiInputEvent> InputEventsQueue;
+    ImVec2 MousePosPrev = ImVec2(-FLT_MAX, -FLT_MAX);
+    float MouseWheelQueued = 0.0f;
+    bool MouseClickedQueued[3] = {};
+    bool MouseReleasedQueued[3] = {};
+    float MouseClickedTime[3] = { -FLT_MAX, -FLT_MAX, -FLT_MAX };
+    ImVec2 MouseClickedPos[3];
+    unsigned short InputQueueSurrogate = 0;
+};
+
+struct ImDrawVert {
+    ImVec2 pos;
+    ImVec2 uv;
+    ImU32 col;
+};
+
+struct ImDrawCmd {
+    ImVec4 ClipRect;
+    ImTextureID TextureId = nullptr;
+    unsigned int IdxOffset = 0;
+    unsigned int ElemCount = 0;
+};
+
+// Geometry is written straight into VtxBuffer/IdxBuffer through PrimReserve();
+// the batch builders in imgui_draw.cpp fill many quads or fan vertices per call.
 struct ImDrawList {
-    void AddRectFilled(const ImVec2&, const ImVec2&, unsigned int, float = 0.0f, int = 0) {}
-    void AddRectFilledMultiColor(const ImVec2&, const ImVec2&, unsigned int, unsigned int, unsigned int, unsigned int) {}
-    void AddText(const ImVec2&, unsigned int, const char*) {}
-    void AddCircleFilled(const ImVec2&, float, unsigned int, int = 0) {}
-    void PathLineTo(const ImVec2&) {}
-    void PathStroke(unsigned int, bool = false, float = 1.0f) {}
+    ImVector<ImDrawCmd> CmdBuffer;
+    ImVector<ImDrawIdx> IdxBuffer;
+    ImVector<ImDrawVert> VtxBuffer;
+
+    ImDrawVert* _VtxWritePtr = nullptr;
+    ImDrawIdx* _IdxWritePtr = nullptr;
+    unsigned int _VtxCurrentIdx = 0;
+    ImVector<ImVec2> _Path;
+    // Stroker scratch, kept across frames so long paths stop reallocating.
+    ImVector<ImVec2> _StrokeScratch;
+    ImVector<unsigned char> _StrokeBevel;
+    ImVector<ImTextureID> _TextureIdStack;
+
+    void _ResetForNewFrame();
+    void _OnChangedTextureID();
+    void PushTextureID(ImTextureID texture_id);
+    void PopTextureID();
+    void PrimReserve(int idx_count, int vtx_count);
+    void PrimRectBatch(const ImVec4* rects, const ImU32* cols, int count);
+    // Splices the geometry of |count| lists in at the given index positions
+    // (IdxBuffer.Size values taken earlier, non-decreasing), so each draws
+    // before anything added after its position. One pass over the buffers
+    // however many lists; the sources must use the default texture and are
+    // clipped like the command they land in.
+    void InsertDrawLists(const ImDrawList* const* srcs, const int* idx_pos, int count);
+
+    void AddRectFilled(const ImVec2& p_min, const ImVec2& p_max, ImU32 col, float rounding = 0.0f, int flags = 0);
+    void AddRectFilledMultiColor(const ImVec2& p_min, const ImVec2& p_max, ImU32 col_upr_left, ImU32 col_upr_right,
+                                 ImU32 col_bot_right, ImU32 col_bot_left, float rounding = 0.0f, int flags = 0);
+    void AddText(const ImVec2&, ImU32, const char*, const char* = nullptr) {}
+    void AddImage(ImTextureID user_texture_id, const ImVec2& p_min, const ImVec2& p_max,
+                  const ImVec2& uv_min = ImVec2(0, 0), const ImVec2& uv_max = ImVec2(1, 1), ImU32 col = 0xFFFFFFFF);
+    void AddCircleFilled(const ImVec2& center, float radius, ImU32 col, int num_segments = 0);
+    void AddConvexPolyFilled(const ImVec2* points, int num_points, ImU32 col);
+    void AddPolyline(const ImVec2* points, int num_points, ImU32 col, bool closed, float thickness);
+
+    void PathClear() { _Path.clear(); }
+    void PathLineTo(const ImVec2& pos) {
+        if (_Path.Size == 0 || _Path.back().x != pos.x || _Path.back().y != pos.y) _Path.push_back(pos);
+    }
+    void PathStroke(ImU32 col, bool closed = false, float thickness = 1.0f) {
+        AddPolyline(_Path.Data, _Path.Size, col, closed, thickness);
+        _Path.clear();
+    }
+};
+
+// Metrics of the default font (13px ProggyClean): advances by code point,
+// FallbackAdvanceX for anything not in IndexAdvanceX. The stub rasterizes no
+// glyphs, but widgets lay text out with these.
+struct ImFont {
+    float FontSize = 13.0f;
+    float FallbackAdvanceX = 7.0f;
+    ImVector<float> IndexAdvanceX;
+
+    float GetCharAdvance(ImWchar c) const {
+        return static_cast<int>(c) < IndexAdvanceX.Size ? IndexAdvanceX.Data[c] : FallbackAdvanceX;
+    }
+};
+
+enum ImGuiInputTextFlags_ {
+    ImGuiInputTextFlags_None = 0,
+    ImGuiInputTextFlags_EnterReturnsTrue = 1 << 5,   // Return true on Enter instead of on every edit.
+    ImGuiInputTextFlags_Password = 1 << 15,          // Draw '*' per character; disables copy and cut.
+    ImGuiInputTextFlags_Multiline = 1 << 26          // Set by InputTextMultiline().
 };
 
 enum ImGuiConfigFlags_ {
@@ -67,12 +300,6 @@ enum ImGuiCond_ {
     ImGuiCond_Always = 1 << 0
 };
 
-enum ImGuiCol_ {
-    ImGuiCol_Button = 0,
-    ImGuiCol_ButtonHovered = 1,
-    ImGuiCol_ButtonActive = 2
-};
-
 enum ImGuiStyleVar_ {
     ImGuiStyleVar_Alpha = 0
 };
@@ -82,13 +309,85 @@ enum ImGuiMouseButton_ {
 };
 
 enum ImDrawFlags_ {
-    ImDrawFlags_RoundCornersTop = 1 << 4
+    ImDrawFlags_None = 0,
+    ImDrawFlags_RoundCornersTopLeft = 1 << 4,
+    ImDrawFlags_RoundCornersTopRight = 1 << 5,
+    ImDrawFlags_RoundCornersBottomLeft = 1 << 6,
+    ImDrawFlags_RoundCornersBottomRight = 1 << 7,
+    ImDrawFlags_RoundCornersTop = ImDrawFlags_RoundCornersTopLeft | ImDrawFlags_RoundCornersTopRight,
+    ImDrawFlags_RoundCornersBottom = ImDrawFlags_RoundCornersBottomLeft | ImDrawFlags_RoundCornersBottomRight,
+    ImDrawFlags_RoundCornersAll = ImDrawFlags_RoundCornersTop | ImDrawFlags_RoundCornersBottom
 };
 
-struct ImDrawData {};
+enum ImGuiTableFlags_ {
+    ImGuiTableFlags_None = 0,
+    ImGuiTableFlags_Sortable = 1 << 3,
+    ImGuiTableFlags_RowBg = 1 << 6,
+    ImGuiTableFlags_ScrollY = 1 << 25
+};
+
+enum ImGuiTableColumnFlags_ {
+    ImGuiTableColumnFlags_None = 0,
+    ImGuiTableColumnFlags_DefaultSort = 1 << 2,
+    ImGuiTableColumnFlags_WidthStretch = 1 << 3,
+    ImGuiTableColumnFlags_WidthFixed = 1 << 4
+};
+
+enum ImGuiSortDirection_ {
+    ImGuiSortDirection_None = 0,
+    ImGuiSortDirection_Ascending = 1,
+    ImGuiSortDirection_Descending = 2
+};
+
+struct ImGuiTableColumnSortSpecs {
+    ImGuiID ColumnUserID = 0;
+    short ColumnIndex = 0;
+    short SortOrder = 0;
+    ImGuiSortDirection SortDirection = ImGuiSortDirection_None;
+};
+
+// Single-column sort specs. SpecsDirty is set when the user changes the sort;
+// clear it once the data has been (re)sorted.
+struct ImGuiTableSortSpecs {
+    const ImGuiTableColumnSortSpecs* Specs = nullptr;
+    int SpecsCount = 0;
+    bool SpecsDirty = false;
+};
+
+// Computes which rows of a long list are visible so only those are submitted.
+// Same usage as upstream:
+//     ImGuiListClipper clipper;
+//     clipper.Begin(count, row_height);
+//     while (clipper.Step())
+//         for (int i = clipper.DisplayStart; i < clipper.DisplayEnd; ++i) ...
+// The per-frame cost depends on the visible rows, not on the row count.
+struct ImGuiListClipper {
+    int DisplayStart = 0;
+    int DisplayEnd = 0;
+    int ItemsCount = 0;
+    float ItemsHeight = 0.0f;
+    float StartPosY = 0.0f;
+    int StepNo = -1;  // -1 until Begin(), 2 once finished.
+
+    ~ImGuiListClipper() { End(); }
+    void Begin(int items_count, float items_height = -1.0f);
+    bool Step();
+    void End();
+    // Top of |row| relative to StartPosY.
+    float RowTop(int row) const;
+};
+
+struct ImDrawData {
+    ImVector<ImDrawList*> CmdLists;
+    int TotalIdxCount = 0;
+    int TotalVtxCount = 0;
+    ImVec2 DisplayPos;
+    ImVec2 DisplaySize;
+};
 
 #define IM_ARRAYSIZE(_ARR) ((int)(sizeof(_ARR) / sizeof(*(_ARR))))
 #define IM_COL32(R, G, B, A) (((A) << 24) | ((B) << 16) | ((G) << 8) | (R))
+#define IM_COL32_WHITE IM_COL32(255, 255, 255, 255)
 
 namespace ImGui {
     void CreateContext();
@@ -114,21 +413,48 @@ namespace ImGui {
     void SetCursorPosY(float local_y);
     void SetCursorScreenPos(const ImVec2& pos);
     ImVec2 GetCursorPos();
+    ImVec2 GetCursorScreenPos();
     ImVec2 GetContentRegionAvail();
+    float CalcItemWidth();
+    ImFont* GetFont();
+    float GetFontSize();
+    ImVec2 CalcTextSize(const char* text, const char* text_end = nullptr);
+    float GetTextLineHeightWithSpacing();
+    float GetScrollY();
+    float GetScrollMaxY();
+    void SetScrollY(float scroll_y);
     ImVec2 GetWindowPos();
     ImVec2 GetWindowSize();
     ImDrawList* GetWindowDrawList();
 
     void SameLine(float offset_from_start_x = 0.0f, float spacing = -1.0f);
     void Separator();
+    void Dummy(const ImVec2& size);
 
     bool Button(const char* label, const ImVec2& size = ImVec2(0, 0));
     bool Checkbox(const char* label, bool* v);
-    bool InputText(const char* label, char* buf, size_t buf_size, int flags = 0);
+    // Text fields. They return true when the text changed this frame (or on
+    // Enter with ImGuiInputTextFlags_EnterReturnsTrue). The std::string
+    // overloads grow the string as needed, like imgui_stdlib's.
+    bool InputText(const char* label, char* buf, size_t buf_size, ImGuiInputTextFlags flags = 0);
+    bool InputText(const char* label, std::string* str, ImGuiInputTextFlags flags = 0);
+    bool InputTextMultiline(const char* label, char* buf, size_t buf_size, const ImVec2& size = ImVec2(0, 0),
+                            ImGuiInputTextFlags flags = 0);
+    bool InputTextMultiline(const char* label, std::string* str, const ImVec2& size = ImVec2(0, 0),
+                            ImGuiInputTextFlags flags = 0);
     void Text(const char* fmt, ...);
     void TextColored(const ImVec4& col, const char* fmt, ...);
     void ProgressBar(float fraction, const ImVec2& size = ImVec2(0, 0), const char* overlay = nullptr);
 
+    bool BeginTable(const char* str_id, int columns, int flags = 0, const ImVec2& outer_size = ImVec2(0, 0));
+    void EndTable();
+    void TableSetupColumn(const char* label, int flags = 0, float init_width_or_weight = 0.0f);
+    void TableHeadersRow();
+    void TableNextRow(int row_flags = 0, float min_row_height = 0.0f);
+    bool TableNextColumn();
+    bool TableSetColumnIndex(int column_n);
+    ImGuiTableSortSpecs* TableGetSortSpecs();
+
     void PushStyleVar(int idx, float val);
     void PopStyleVar(int count = 1);
     void PushStyleColor(int idx, unsigned int col);
@@ -140,5 +466,6 @@ namespace ImGui {
 
     float GetTime();
     const char* GetClipboardText();
+    void SetClipboardText(const char* text);
     unsigned int ColorConvertFloat4ToU32(const ImVec4& in);
 }
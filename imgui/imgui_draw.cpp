@@ -1,2 +1,658 @@
 #include "imgui.h"
-// Minimal stub for build-only template.
+#include <cmath>
+
+// Primitive builders write positions, UVs and colors straight into the
+// reserved vertex/index memory. SSE2 is part of the x64 baseline, so the
+// vector paths are always taken there; other targets use the scalar loops.
+// Define IMGUI_DISABLE_SSE to force the scalar loops, e.g. to compare them.
+#if (defined(_M_X64) || defined(__x86_64__) || defined(__SSE2__)) && !defined(IMGUI_DISABLE_SSE)
+#define IMGUI_DRAW_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace {
+    const ImVec2 kUvWhite(0.0f, 0.0f);
+    const float kDrawPi = 3.14159265358979323846f;
+
+    // Unit circle sampled at 48 points, interleaved as (cos, sin) pairs.
+    // Quarter arcs for rounded corners are 12 consecutive samples.
+    const int kArcSamples = 48;
+    const int kArcQuarter = kArcSamples / 4;
+
+    struct ArcTable {
+        float cs[kArcSamples * 2];
+        ArcTable() {
+            for (int i = 0; i < kArcSamples; ++i) {
+                float a = (static_cast<float>(i) / kArcSamples) * 2.0f * kDrawPi;
+                cs[i * 2 + 0] = std::cos(a);
+                cs[i * 2 + 1] = std::sin(a);
+            }
+        }
+    };
+
+    const ArcTable& GetArcTable() {
+        static const ArcTable table;
+        return table;
+    }
+
+    int ArcStepForRadius(float radius) {
+        if (radius < 4.0f) return 4;
+        if (radius < 10.0f) return 2;
+        return 1;
+    }
+
+    // Writes |count| quads (4 vertices, 6 indices each). |cols| holds one
+    // color per quad, or four per quad (UL, UR, BR, BL) when per_vertex is set.
+    void WriteQuads(ImDrawVert* vtx, ImDrawIdx* idx, unsigned int base, const ImVec4* rects,
+                    const ImU32* cols, bool per_vertex, int count) {
+#ifdef IMGUI_DRAW_SSE2
+        const __m128 uv = _mm_set_ps(kUvWhite.y, kUvWhite.x, kUvWhite.y, kUvWhite.x);
+        const __m128i idx_lo = _mm_setr_epi32(0, 1, 2, 0);
+        const __m128i idx_hi = _mm_setr_epi32(2, 3, 0, 0);
+        for (int i = 0; i < count; ++i, vtx += 4, idx += 6, base += 4) {
+            __m128 r = _mm_loadu_ps(&rects[i].x);
+            _mm_storeu_ps(&vtx[0].pos.x, _mm_movelh_ps(r, uv));
+            _mm_storeu_ps(&vtx[1].pos.x, _mm_shuffle_ps(r, uv, _MM_SHUFFLE(1, 0, 1, 2)));
+            _mm_storeu_ps(&vtx[2].pos.x, _mm_shuffle_ps(r, uv, _MM_SHUFFLE(1, 0, 3, 2)));
+            _mm_storeu_ps(&vtx[3].pos.x, _mm_shuffle_ps(r, uv, _MM_SHUFFLE(1, 0, 3, 0)));
+            const ImU32* c = per_vertex ? cols + i * 4 : cols + i;
+            int c_step = per_vertex ? 1 : 0;
+            vtx[0].col = c[0];
+            vtx[1].col = c[c_step];
+            vtx[2].col = c[c_step * 2];
+            vtx[3].col = c[c_step * 3];
+            __m128i b = _mm_set1_epi32(static_cast<int>(base));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(idx), _mm_add_epi32(b, idx_lo));
+            _mm_storel_epi64(reinterpret_cast<__m128i*>(idx + 4), _mm_add_epi32(b, idx_hi));
+        }
+#else
+        for (int i = 0; i < count; ++i, vtx += 4, idx += 6, base += 4) {
+            const ImVec4& r = rects[i];
+            vtx[0].pos = ImVec2(r.x, r.y);
+            vtx[1].pos = ImVec2(r.z, r.y);
+            vtx[2].pos = ImVec2(r.z, r.w);
+            vtx[3].pos = ImVec2(r.x, r.w);
+            for (int k = 0; k < 4; ++k) {
+                vtx[k].uv = kUvWhite;
+                vtx[k].col = per_vertex ? cols[i * 4 + k] : cols[i];
+            }
+            idx[0] = base; idx[1] = base + 1; idx[2] = base + 2;
+            idx[3] = base; idx[4] = base + 2; idx[5] = base + 3;
+        }
+#endif
+    }
+
+    // Writes one vertex per point, two points per iteration on the SSE path.
+    void WritePolyVerts(ImDrawVert* vtx, const ImVec2* pts, ImU32 col, int count) {
+        int i = 0;
+#ifdef IMGUI_DRAW_SSE2
+        const __m128 uv = _mm_set_ps(kUvWhite.y, kUvWhite.x, kUvWhite.y, kUvWhite.x);
+        for (; i + 2 <= count; i += 2) {
+            __m128 p = _mm_loadu_ps(&pts[i].x);
+            _mm_storeu_ps(&vtx[i].pos.x, _mm_movelh_ps(p, uv));
+            _mm_storeu_ps(&vtx[i + 1].pos.x, _mm_shuffle_ps(p, uv, _MM_SHUFFLE(1, 0, 3, 2)));
+            vtx[i].col = col;
+            vtx[i + 1].col = col;
+        }
+#endif
+        for (; i < count; ++i) {
+            vtx[i].pos = pts[i];
+            vtx[i].uv = kUvWhite;
+            vtx[i].col = col;
+        }
+    }
+
+    // Triangle fan indices (0, i, i + 1) for a convex polygon of |count| points.
+    void WriteFanIndices(ImDrawIdx* idx, unsigned int base, int count) {
+        int tris = count - 2;
+        int t = 0;
+#ifdef IMGUI_DRAW_SSE2
+        // Four triangles are twelve indices, i.e. three 128-bit stores. The
+        // patterns are for triangles 1..4; the masks mark lanes that advance
+        // by one per triangle.
+        const __m128i pat0 = _mm_setr_epi32(0, 1, 2, 0);
+        const __m128i pat1 = _mm_setr_epi32(2, 3, 0, 3);
+        const __m128i pat2 = _mm_setr_epi32(4, 0, 4, 5);
+        const __m128i mask0 = _mm_setr_epi32(0, -1, -1, 0);
+        const __m128i mask1 = _mm_setr_epi32(-1, -1, 0, -1);
+        const __m128i mask2 = _mm_setr_epi32(-1, 0, -1, -1);
+        const __m128i b = _mm_set1_epi32(static_cast<int>(base));
+        for (; t + 4 <= tris; t += 4, idx += 12) {
+            __m128i step = _mm_set1_epi32(t);
+            __m128i* out = reinterpret_cast<__m128i*>(idx);
+            _mm_storeu_si128(out + 0, _mm_add_epi32(_mm_add_epi32(b, pat0), _mm_and_si128(step, mask0)));
+            _mm_storeu_si128(out + 1, _mm_add_epi32(_mm_add_epi32(b, pat1), _mm_and_si128(step, mask1)));
+            _mm_storeu_si128(out + 2, _mm_add_epi32(_mm_add_epi32(b, pat2), _mm_and_si128(step, mask2)));
+        }
+#endif
+        for (; t < tris; ++t, idx += 3) {
+            idx[0] = base;
+            idx[1] = base + static_cast<unsigned int>(t) + 1;
+            idx[2] = base + static_cast<unsigned int>(t) + 2;
+        }
+    }
+
+    // Appends arc points from sample a_min to a_max (inclusive, may exceed
+    // the table size and wrap). Returns the number of points written.
+    int WriteArc(ImVec2* out, const ImVec2& center, float radius, int a_min, int a_max, int step) {
+        const float* cs = GetArcTable().cs;
+        int n = 0;
+        int a = a_min;
+#ifdef IMGUI_DRAW_SSE2
+        const __m128 c = _mm_set_ps(center.y, center.x, center.y, center.x);
+        const __m128 r = _mm_set1_ps(radius);
+        for (; a + step <= a_max; a += step * 2, n += 2) {
+            __m128 unit = _mm_loadl_pi(_mm_setzero_ps(), reinterpret_cast<const __m64*>(cs + (a % kArcSamples) * 2));
+            unit = _mm_loadh_pi(unit, reinterpret_cast<const __m64*>(cs + ((a + step) % kArcSamples) * 2));
+            _mm_storeu_ps(&out[n].x, _mm_add_ps(c, _mm_mul_ps(unit, r)));
+        }
+#endif
+        for (; a <= a_max; a += step, ++n) {
+            int s = (a % kArcSamples) * 2;
+            out[n] = ImVec2(center.x + cs[s] * radius, center.y + cs[s + 1] * radius);
+        }
+        return n;
+    }
+
+    void PathRoundedRect(ImVector<ImVec2>& path, const ImVec2& a, const ImVec2& b, float rounding, int flags) {
+        float max_rounding = std::fabs(b.x - a.x) < std::fabs(b.y - a.y) ? std::fabs(b.x - a.x) : std::fabs(b.y - a.y);
+        if (rounding > max_rounding * 0.5f) rounding = max_rounding * 0.5f;
+        float r_tl = (flags & ImDrawFlags_RoundCornersTopLeft) ? rounding : 0.0f;
+        float r_tr = (flags & ImDrawFlags_RoundCornersTopRight) ? rounding : 0.0f;
+        float r_br = (flags & ImDrawFlags_RoundCornersBottomRight) ? rounding : 0.0f;
+        float r_bl = (flags & ImDrawFlags_RoundCornersBottomLeft) ? rounding : 0.0f;
+        int step = ArcStepForRadius(rounding);
+
+        path.reserve(path.Size + 4 * (kArcQuarter + 2));
+        auto corner = [&](float r, const ImVec2& c, int a_min) {
+            if (r <= 0.5f) {
+                path.Data[path.Size++] = c;
+                return;
+            }
+            path.Size += WriteArc(path.Data + path.Size, c, r, a_min, a_min + kArcQuarter, step);
+        };
+        corner(r_tl, ImVec2(a.x + r_tl, a.y + r_tl), kArcQuarter * 2);
+        corner(r_tr, ImVec2(b.x - r_tr, a.y + r_tr), kArcQuarter * 3);
+        corner(r_br, ImVec2(b.x - r_br, b.y - r_br), 0);
+        corner(r_bl, ImVec2(a.x + r_bl, b.y - r_bl), kArcQuarter);
+    }
+
+    // Bilinear interpolation of the four corner colors at each vertex
+    // position, one vertex per iteration with all four channels in a lane.
+    void LerpCornerColors(ImDrawVert* vtx, int count, const ImVec2& p_min, const ImVec2& p_max,
+                          ImU32 ul, ImU32 ur, ImU32 br, ImU32 bl) {
+        float inv_w = p_max.x > p_min.x ? 1.0f / (p_max.x - p_min.x) : 0.0f;
+        float inv_h = p_max.y > p_min.y ? 1.0f / (p_max.y - p_min.y) : 0.0f;
+#ifdef IMGUI_DRAW_SSE2
+        const __m128i zero = _mm_setzero_si128();
+        auto unpack = [&](ImU32 c) {
+            __m128i v = _mm_cvtsi32_si128(static_cast<int>(c));
+            return _mm_cvtepi32_ps(_mm_unpacklo_epi16(_mm_unpacklo_epi8(v, zero), zero));
+        };
+        const __m128 c_ul = unpack(ul);
+        const __m128 c_bl = unpack(bl);
+        const __m128 d_top = _mm_sub_ps(unpack(ur), c_ul);
+        const __m128 d_bot = _mm_sub_ps(unpack(br), c_bl);
+        const __m128 half = _mm_set1_ps(0.5f);
+        for (int i = 0; i < count; ++i) {
+            float u = (vtx[i].pos.x - p_min.x) * inv_w;
+            float v = (vtx[i].pos.y - p_min.y) * inv_h;
+            u = u < 0.0f ? 0.0f : (u > 1.0f ? 1.0f : u);
+            v = v < 0.0f ? 0.0f : (v > 1.0f ? 1.0f : v);
+            __m128 uu = _mm_set1_ps(u);
+            __m128 top = _mm_add_ps(c_ul, _mm_mul_ps(d_top, uu));
+            __m128 bot = _mm_add_ps(c_bl, _mm_mul_ps(d_bot, uu));
+            __m128 c = _mm_add_ps(top, _mm_mul_ps(_mm_sub_ps(bot, top), _mm_set1_ps(v)));
+            __m128i ci = _mm_cvttps_epi32(_mm_add_ps(c, half));
+            ci = _mm_packs_epi32(ci, ci);
+            ci = _mm_packus_epi16(ci, ci);
+            vtx[i].col = static_cast<ImU32>(_mm_cvtsi128_si32(ci));
+        }
+#else
+        for (int i = 0; i < count; ++i) {
+            float u = (vtx[i].pos.x - p_min.x) * inv_w;
+            float v = (vtx[i].pos.y - p_min.y) * inv_h;
+            u = u < 0.0f ? 0.0f : (u > 1.0f ? 1.0f : u);
+            v = v < 0.0f ? 0.0f : (v > 1.0f ? 1.0f : v);
+            ImU32 out = 0;
+            for (int shift = 0; shift < 32; shift += 8) {
+                float top = ((ul >> shift) & 0xFF) + (static_cast<float>((ur >> shift) & 0xFF) - ((ul >> shift) & 0xFF)) * u;
+                float bot = ((bl >> shift) & 0xFF) + (static_cast<float>((br >> shift) & 0xFF) - ((bl >> shift) & 0xFF)) * u;
+                out |= static_cast<ImU32>(top + (bot - top) * v + 0.5f) << shift;
+            }
+            vtx[i].col = out;
+        }
+#endif
+    }
+}
+
+namespace {
+    // Anti-aliasing feather width in pixels, and the longest miter (relative
+    // to the half width) kept before a join falls back to a bevel.
+    const float kStrokeFeather = 1.0f;
+    const float kStrokeMiterLimit = 2.0f;
+
+    // Unit normals for segments i -> i + 1 of |seg_count| open segments,
+    // two segments per iteration. Degenerate segments get a zero normal.
+    void ComputeSegmentNormals(const ImVec2* pts, int seg_count, ImVec2* out) {
+        int i = 0;
+#ifdef IMGUI_DRAW_SSE2
+        const __m128 eps = _mm_set1_ps(1e-12f);
+        const __m128 one = _mm_set1_ps(1.0f);
+        const __m128 flip = _mm_setr_ps(0.0f, -0.0f, 0.0f, -0.0f);
+        for (; i + 2 <= seg_count; i += 2) {
+            __m128 a = _mm_loadu_ps(&pts[i].x);
+            __m128 b = _mm_loadu_ps(&pts[i + 1].x);
+            __m128 d = _mm_sub_ps(b, a);
+            __m128 sq = _mm_mul_ps(d, d);
+            __m128 len2 = _mm_add_ps(sq, _mm_shuffle_ps(sq, sq, _MM_SHUFFLE(2, 3, 0, 1)));
+            __m128 inv = _mm_div_ps(one, _mm_sqrt_ps(_mm_max_ps(len2, eps)));
+            inv = _mm_and_ps(inv, _mm_cmpgt_ps(len2, eps));
+            __m128 n = _mm_xor_ps(_mm_shuffle_ps(d, d, _MM_SHUFFLE(2, 3, 0, 1)), flip);
+            _mm_storeu_ps(&out[i].x, _mm_mul_ps(n, inv));
+        }
+#endif
+        for (; i < seg_count; ++i) {
+            float dx = pts[i + 1].x - pts[i].x;
+            float dy = pts[i + 1].y - pts[i].y;
+            float len2 = dx * dx + dy * dy;
+            float inv = len2 > 1e-12f ? 1.0f / std::sqrt(len2) : 0.0f;
+            out[i] = ImVec2(dy * inv, -dx * inv);
+        }
+    }
+
+    // Four vertices across the stroke at |p|: fringe, core, core, fringe.
+    void WriteStrokeSet(ImDrawVert* vtx, const ImVec2& p, const ImVec2& off, float inner, float outer,
+                        ImU32 col, ImU32 col_trans) {
+#ifdef IMGUI_DRAW_SSE2
+        const __m128 uv = _mm_set_ps(kUvWhite.y, kUvWhite.x, kUvWhite.y, kUvWhite.x);
+        __m128 pp = _mm_set_ps(p.y, p.x, p.y, p.x);
+        __m128 ext = _mm_mul_ps(_mm_set_ps(off.y, off.x, off.y, off.x), _mm_set_ps(inner, inner, outer, outer));
+        __m128 plus = _mm_add_ps(pp, ext);
+        __m128 minus = _mm_sub_ps(pp, ext);
+        _mm_storeu_ps(&vtx[0].pos.x, _mm_movelh_ps(plus, uv));
+        _mm_storeu_ps(&vtx[1].pos.x, _mm_shuffle_ps(plus, uv, _MM_SHUFFLE(1, 0, 3, 2)));
+        _mm_storeu_ps(&vtx[2].pos.x, _mm_shuffle_ps(minus, uv, _MM_SHUFFLE(1, 0, 3, 2)));
+        _mm_storeu_ps(&vtx[3].pos.x, _mm_movelh_ps(minus, uv));
+#else
+        vtx[0].pos = ImVec2(p.x + off.x * outer, p.y + off.y * outer);
+        vtx[1].pos = ImVec2(p.x + off.x * inner, p.y + off.y * inner);
+        vtx[2].pos = ImVec2(p.x - off.x * inner, p.y - off.y * inner);
+        vtx[3].pos = ImVec2(p.x - off.x * outer, p.y - off.y * outer);
+        for (int k = 0; k < 4; ++k) vtx[k].uv = kUvWhite;
+#endif
+        vtx[0].col = col_trans;
+        vtx[1].col = col;
+        vtx[2].col = col;
+        vtx[3].col = col_trans;
+    }
+
+    // Three quads joining vertex set |a| to vertex set |b|.
+    void WriteStrokeStitch(ImDrawIdx* idx, unsigned int a, unsigned int b) {
+        for (unsigned int k = 0; k < 3; ++k, idx += 6) {
+            idx[0] = a + k; idx[1] = a + k + 1; idx[2] = b + k + 1;
+            idx[3] = a + k; idx[4] = b + k + 1; idx[5] = b + k;
+        }
+    }
+
+    // Fills the outer side of a bevel join between the incoming set |a| and
+    // the outgoing set |b| at the same point, whose center vertex is
+    // |center|: one solid triangle and its feather quad. The inner side is
+    // already covered by both segment bodies, so nothing is drawn there and
+    // translucent strokes are not blended twice. |plus_outer| says whether
+    // the outer side is the +normal one (vertices 0 and 1 of each set).
+    void WriteStrokeBevel(ImDrawIdx* idx, unsigned int a, unsigned int b, unsigned int center, bool plus_outer) {
+        unsigned int solid = plus_outer ? 1 : 2;
+        unsigned int feather = plus_outer ? 0 : 3;
+        idx[0] = center; idx[1] = a + solid; idx[2] = b + solid;
+        idx[3] = a + feather; idx[4] = a + solid; idx[5] = b + solid;
+        idx[6] = a + feather; idx[7] = b + solid; idx[8] = b + feather;
+    }
+}
+
+void ImDrawList::_ResetForNewFrame() {
+    CmdBuffer.clear();
+    IdxBuffer.clear();
+    VtxBuffer.clear();
+    _Path.clear();
+    _TextureIdStack.clear();
+    _VtxCurrentIdx = 0;
+    _VtxWritePtr = nullptr;
+    _IdxWritePtr = nullptr;
+    ImDrawCmd cmd;
+    cmd.ClipRect = ImVec4(-8192.0f, -8192.0f, 8192.0f, 8192.0f);
+    CmdBuffer.push_back(cmd);
+}
+
+// Draws after a texture change go to a new command, unless the current one
+// is still empty.
+void ImDrawList::_OnChangedTextureID() {
+    ImTextureID texture = _TextureIdStack.Size ? _TextureIdStack.back() : nullptr;
+    ImDrawCmd& current = CmdBuffer.back();
+    if (current.TextureId == texture) return;
+    if (current.ElemCount == 0) {
+        current.TextureId = texture;
+        return;
+    }
+    ImDrawCmd cmd;
+    cmd.ClipRect = current.ClipRect;
+    cmd.TextureId = texture;
+    cmd.IdxOffset = static_cast<unsigned int>(IdxBuffer.Size);
+    CmdBuffer.push_back(cmd);
+}
+
+void ImDrawList::PushTextureID(ImTextureID texture_id) {
+    if (CmdBuffer.Size == 0) {
+        _ResetForNewFrame();
+    }
+    _TextureIdStack.push_back(texture_id);
+    _OnChangedTextureID();
+}
+
+void ImDrawList::PopTextureID() {
+    if (_TextureIdStack.Size == 0) return;
+    _TextureIdStack.pop_back();
+    _OnChangedTextureID();
+}
+
+void ImDrawList::PrimReserve(int idx_count, int vtx_count) {
+    if (CmdBuffer.Size == 0) {
+        _ResetForNewFrame();
+    }
+    CmdBuffer.back().ElemCount += static_cast<unsigned int>(idx_count);
+
+    int vtx_size = VtxBuffer.Size;
+    VtxBuffer.resize(vtx_size + vtx_count);
+    _VtxWritePtr = VtxBuffer.Data + vtx_size;
+
+    int idx_size = IdxBuffer.Size;
+    IdxBuffer.resize(idx_size + idx_count);
+    _IdxWritePtr = IdxBuffer.Data + idx_size;
+}
+
+void ImDrawList::PrimRectBatch(const ImVec4* rects, const ImU32* cols, int count) {
+    if (count <= 0) return;
+    PrimReserve(count * 6, count * 4);
+    WriteQuads(_VtxWritePtr, _IdxWritePtr, _VtxCurrentIdx, rects, cols, false, count);
+    _VtxWritePtr += count * 4;
+    _IdxWritePtr += count * 6;
+    _VtxCurrentIdx += static_cast<unsigned int>(count * 4);
+}
+
+void ImDrawList::InsertDrawLists(const ImDrawList* const* srcs, const int* idx_pos, int count) {
+    int add_idx = 0;
+    int add_vtx = 0;
+    for (int i = 0; i < count; ++i) {
+        add_idx += srcs[i]->IdxBuffer.Size;
+        add_vtx += srcs[i]->VtxBuffer.Size;
+    }
+    if (add_idx == 0) return;
+    if (CmdBuffer.Size == 0) {
+        _ResetForNewFrame();
+    }
+
+    // Walk the insertions backwards: each moves the old indices above its
+    // position up by everything inserted at or below it. Vertices are
+    // appended; only the index order decides what draws first.
+    const int old_idx = IdxBuffer.Size;
+    VtxBuffer.resize(VtxBuffer.Size + add_vtx);
+    IdxBuffer.resize(old_idx + add_idx);
+    ImDrawIdx* idx = IdxBuffer.Data;
+    int read_end = old_idx;
+    int write_end = old_idx + add_idx;
+    int vtx_end = VtxBuffer.Size;
+    for (int i = count - 1; i >= 0; --i) {
+        int pos = idx_pos[i] < 0 ? 0 : (idx_pos[i] > read_end ? read_end : idx_pos[i]);
+        int tail = read_end - pos;
+        write_end -= tail;
+        memmove(idx + write_end, idx + pos, static_cast<size_t>(tail) * sizeof(ImDrawIdx));
+        read_end = pos;
+
+        const ImDrawList& src = *srcs[i];
+        vtx_end -= src.VtxBuffer.Size;
+        memcpy(VtxBuffer.Data + vtx_end, src.VtxBuffer.Data, static_cast<size_t>(src.VtxBuffer.Size) * sizeof(ImDrawVert));
+        write_end -= src.IdxBuffer.Size;
+        const unsigned int vtx_base = static_cast<unsigned int>(vtx_end);
+        for (int k = 0; k < src.IdxBuffer.Size; ++k) {
+            idx[write_end + k] = src.IdxBuffer.Data[k] + vtx_base;
+        }
+    }
+
+    // Rebuild the commands: each insertion splits the command covering its
+    // position, then neighbours with the same state merge again, so an
+    // untextured list landing in an untextured command just grows it.
+    ImVector<ImDrawCmd> cmds;
+    unsigned int offset = 0;
+    auto emit = [&](const ImDrawCmd& state, ImTextureID texture, unsigned int elem_count) {
+        if (elem_count == 0) return;
+        if (cmds.Size > 0 && cmds.back().TextureId == texture &&
+            memcmp(&cmds.back().ClipRect, &state.ClipRect, sizeof(ImVec4)) == 0) {
+            cmds.back().ElemCount += elem_count;
+        } else {
+            ImDrawCmd cmd;
+            cmd.ClipRect = state.ClipRect;
+            cmd.TextureId = texture;
+            cmd.IdxOffset = offset;
+            cmd.ElemCount = elem_count;
+            cmds.push_back(cmd);
+        }
+        offset += elem_count;
+    };
+    int next = 0;
+    for (int c = 0; c < CmdBuffer.Size; ++c) {
+        const ImDrawCmd& cmd = CmdBuffer[c];
+        unsigned int at = cmd.IdxOffset;
+        unsigned int cmd_end = cmd.IdxOffset + cmd.ElemCount;
+        bool last = c == CmdBuffer.Size - 1;
+        while (next < count && (last || static_cast<unsigned int>(idx_pos[next]) <= cmd_end)) {
+            unsigned int pos = static_cast<unsigned int>(idx_pos[next]);
+            pos = pos < at ? at : (pos > cmd_end ? cmd_end : pos);
+            emit(cmd, cmd.TextureId, pos - at);
+            emit(cmd, nullptr, static_cast<unsigned int>(srcs[next]->IdxBuffer.Size));
+            at = pos;
+            ++next;
+        }
+        emit(cmd, cmd.TextureId, cmd_end - at);
+    }
+    // Later draws continue in the state of the last command.
+    const ImDrawCmd& current = CmdBuffer.back();
+    if (cmds.Size == 0 || cmds.back().TextureId != current.TextureId ||
+        memcmp(&cmds.back().ClipRect, &current.ClipRect, sizeof(ImVec4)) != 0) {
+        ImDrawCmd cmd = current;
+        cmd.IdxOffset = offset;
+        cmd.ElemCount = 0;
+        cmds.push_back(cmd);
+    }
+    CmdBuffer = cmds;
+
+    _VtxCurrentIdx += static_cast<unsigned int>(add_vtx);
+    _VtxWritePtr = VtxBuffer.Data + VtxBuffer.Size;
+    _IdxWritePtr = IdxBuffer.Data + IdxBuffer.Size;
+}
+
+void ImDrawList::AddConvexPolyFilled(const ImVec2* points, int num_points, ImU32 col) {
+    if (num_points < 3 || (col >> 24) == 0) return;
+    PrimReserve((num_points - 2) * 3, num_points);
+    WritePolyVerts(_VtxWritePtr, points, col, num_points);
+    WriteFanIndices(_IdxWritePtr, _VtxCurrentIdx, num_points);
+    _VtxWritePtr += num_points;
+    _IdxWritePtr += (num_points - 2) * 3;
+    _VtxCurrentIdx += static_cast<unsigned int>(num_points);
+}
+
+void ImDrawList::AddRectFilled(const ImVec2& p_min, const ImVec2& p_max, ImU32 col, float rounding, int flags) {
+    if ((col >> 24) == 0) return;
+    if ((flags & ImDrawFlags_RoundCornersAll) == 0) flags |= ImDrawFlags_RoundCornersAll;
+    if (rounding < 0.5f) {
+        ImVec4 rect(p_min.x, p_min.y, p_max.x, p_max.y);
+        PrimRectBatch(&rect, &col, 1);
+        return;
+    }
+    _Path.clear();
+    PathRoundedRect(_Path, p_min, p_max, rounding, flags);
+    AddConvexPolyFilled(_Path.Data, _Path.Size, col);
+    _Path.clear();
+}
+
+void ImDrawList::AddRectFilledMultiColor(const ImVec2& p_min, const ImVec2& p_max, ImU32 col_upr_left,
+                                         ImU32 col_upr_right, ImU32 col_bot_right, ImU32 col_bot_left,
+                                         float rounding, int flags) {
+    if (((col_upr_left | col_upr_right | col_bot_right | col_bot_left) >> 24) == 0) return;
+    if ((flags & ImDrawFlags_RoundCornersAll) == 0) flags |= ImDrawFlags_RoundCornersAll;
+    if (rounding < 0.5f) {
+        ImVec4 rect(p_min.x, p_min.y, p_max.x, p_max.y);
+        const ImU32 cols[4] = { col_upr_left, col_upr_right, col_bot_right, col_bot_left };
+        PrimReserve(6, 4);
+        WriteQuads(_VtxWritePtr, _IdxWritePtr, _VtxCurrentIdx, &rect, cols, true, 1);
+        _VtxWritePtr += 4;
+        _IdxWritePtr += 6;
+        _VtxCurrentIdx += 4;
+        return;
+    }
+    _Path.clear();
+    PathRoundedRect(_Path, p_min, p_max, rounding, flags);
+    int vtx_start = VtxBuffer.Size;
+    // Fill opaque first so the fill is never culled, then recolor per vertex.
+    AddConvexPolyFilled(_Path.Data, _Path.Size, 0xFFFFFFFF);
+    LerpCornerColors(VtxBuffer.Data + vtx_start, VtxBuffer.Size - vtx_start, p_min, p_max,
+                     col_upr_left, col_upr_right, col_bot_right, col_bot_left);
+    _Path.clear();
+}
+
+void ImDrawList::AddImage(ImTextureID user_texture_id, const ImVec2& p_min, const ImVec2& p_max,
+                          const ImVec2& uv_min, const ImVec2& uv_max, ImU32 col) {
+    if ((col >> 24) == 0) return;
+    PushTextureID(user_texture_id);
+    PrimReserve(6, 4);
+    ImDrawVert* vtx = _VtxWritePtr;
+    vtx[0].pos = p_min;
+    vtx[0].uv = uv_min;
+    vtx[1].pos = ImVec2(p_max.x, p_min.y);
+    vtx[1].uv = ImVec2(uv_max.x, uv_min.y);
+    vtx[2].pos = p_max;
+    vtx[2].uv = uv_max;
+    vtx[3].pos = ImVec2(p_min.x, p_max.y);
+    vtx[3].uv = ImVec2(uv_min.x, uv_max.y);
+    for (int k = 0; k < 4; ++k) vtx[k].col = col;
+    ImDrawIdx* idx = _IdxWritePtr;
+    unsigned int base = _VtxCurrentIdx;
+    idx[0] = base; idx[1] = base + 1; idx[2] = base + 2;
+    idx[3] = base; idx[4] = base + 2; idx[5] = base + 3;
+    _VtxWritePtr += 4;
+    _IdxWritePtr += 6;
+    _VtxCurrentIdx += 4;
+    PopTextureID();
+}
+
+void ImDrawList::AddCircleFilled(const ImVec2& center, float radius, ImU32 col, int num_segments) {
+    if ((col >> 24) == 0 || radius < 0.5f) return;
+    int step = ArcStepForRadius(radius);
+    if (num_segments > 0) {
+        step = kArcSamples / num_segments;
+        if (step < 1) step = 1;
+    }
+    _Path.clear();
+    _Path.reserve(kArcSamples + 2);
+    _Path.Size = WriteArc(_Path.Data, center, radius, 0, kArcSamples - step, step);
+    AddConvexPolyFilled(_Path.Data, _Path.Size, col);
+    _Path.clear();
+}
+
+void ImDrawList::AddPolyline(const ImVec2* points, int num_points, ImU32 col, bool closed, float thickness) {
+    if (num_points < 2 || (col >> 24) == 0) return;
+    const int count = num_points;
+    const int seg_count = closed ? count : count - 1;
+
+    // Pass 1: segment normals. Slot count - 1 holds the closing segment, or a
+    // copy of the last normal to serve as the end cap of an open path.
+    _StrokeScratch.resize(count * 2);
+    _StrokeBevel.resize(count);
+    ImVec2* normals = _StrokeScratch.Data;
+    ImVec2* offsets = _StrokeScratch.Data + count;
+    ComputeSegmentNormals(points, count - 1, normals);
+    if (closed) {
+        float dx = points[0].x - points[count - 1].x;
+        float dy = points[0].y - points[count - 1].y;
+        float len2 = dx * dx + dy * dy;
+        float inv = len2 > 1e-12f ? 1.0f / std::sqrt(len2) : 0.0f;
+        normals[count - 1] = ImVec2(dy * inv, -dx * inv);
+    } else {
+        normals[count - 1] = normals[count - 2];
+    }
+    for (int i = 1; i < count; ++i) {
+        if (normals[i].x == 0.0f && normals[i].y == 0.0f) normals[i] = normals[i - 1];
+    }
+
+    // Pass 2: classify joins and size the output exactly.
+    const float min_d2 = 1.0f / (kStrokeMiterLimit * kStrokeMiterLimit);
+    int bevel_count = 0;
+    for (int i = 0; i < count; ++i) {
+        const ImVec2& n_in = normals[i == 0 ? (closed ? count - 1 : 0) : i - 1];
+        const ImVec2& n_out = normals[i];
+        float mx = (n_in.x + n_out.x) * 0.5f;
+        float my = (n_in.y + n_out.y) * 0.5f;
+        float d2 = mx * mx + my * my;
+        if (d2 < min_d2) {
+            _StrokeBevel[i] = 1;
+            ++bevel_count;
+        } else {
+            _StrokeBevel[i] = 0;
+            offsets[i] = ImVec2(mx / d2, my / d2);
+        }
+    }
+
+    // A bevel adds a second vertex set and a center vertex, and 3 triangles.
+    const int vtx_count = count * 4 + bevel_count * 5;
+    const int idx_count = seg_count * 18 + bevel_count * 9;
+    PrimReserve(idx_count, vtx_count);
+
+    // Pass 3: extrude every point and stitch neighbouring vertex sets.
+    float inner = (thickness - kStrokeFeather) * 0.5f;
+    if (inner < 0.0f) inner = 0.0f;
+    const float outer = inner + kStrokeFeather;
+    const ImU32 col_trans = col & 0x00FFFFFF;
+    ImDrawVert* vtx = _VtxWritePtr;
+    ImDrawIdx* idx = _IdxWritePtr;
+    unsigned int base = _VtxCurrentIdx;
+    unsigned int first_in = base;
+    unsigned int prev_out = base;
+    for (int i = 0; i < count; ++i) {
+        unsigned int in_set = base;
+        unsigned int out_set = base;
+        if (_StrokeBevel[i]) {
+            const ImVec2& n_in = normals[i == 0 ? count - 1 : i - 1];
+            const ImVec2& n_out = normals[i];
+            WriteStrokeSet(vtx, points[i], n_in, inner, outer, col, col_trans);
+            WriteStrokeSet(vtx + 4, points[i], n_out, inner, outer, col, col_trans);
+            vtx[8].pos = points[i];
+            vtx[8].uv = kUvWhite;
+            vtx[8].col = col;
+            // The gap opens on the side the path turns away from.
+            bool plus_outer = n_in.x * n_out.y - n_in.y * n_out.x > 0.0f;
+            WriteStrokeBevel(idx, in_set, in_set + 4, in_set + 8, plus_outer);
+            idx += 9;
+            out_set = in_set + 4;
+            vtx += 9;
+            base += 9;
+        } else {
+            WriteStrokeSet(vtx, points[i], offsets[i], inner, outer, col, col_trans);
+            vtx += 4;
+            base += 4;
+        }
+        if (i == 0) {
+            first_in = in_set;
+        } else {
+            WriteStrokeStitch(idx, prev_out, in_set);
+            idx += 18;
+        }
+        prev_out = out_set;
+    }
+    if (closed) {
+        WriteStrokeStitch(idx, prev_out, first_in);
+        idx += 18;
+    }
+
+    _VtxWritePtr = vtx;
+    _IdxWritePtr = idx;
+    _VtxCurrentIdx = base;
+}
@@ -1,2 +1,74 @@
 #pragma once
-// Minimal stub internal header for build-only template.
+// Internal declarations shared by the stub's translation units.
+#include "imgui.h"
+#include "imstb_textedit.h"
+
+// Decodes one UTF-8 code point from [in_text, in_text_end) (null-terminated
+// when in_text_end is null). Returns the bytes consumed, at least 1; invalid
+// sequences decode as U+FFFD.
+int ImTextCharFromUtf8(unsigned int* out_char, const char* in_text, const char* in_text_end);
+// Encodes |c| into |out| (4 bytes); returns the byte count.
+int ImTextCharToUtf8(char out[4], unsigned int c);
+ImGuiID ImHashStr(const char* str);
+
+// Edit buffer of the focused InputText, with a glyph position cache:
+// LineStarts holds the first byte of every line and CharX the x of the caret
+// before each byte, measured from its line start (continuation bytes repeat
+// their lead byte's x, so the array is sorted within a line). Caret
+// placement, hit-testing and selection drawing are lookups and binary
+// searches; an edit shifts the arrays and re-measures only from the edit
+// point to the end of its line, since later lines keep their offsets.
+// Masked text is measured with the mask glyph's advance, so password fields
+// use the same cache.
+struct ImGuiInputTextState {
+    ImGuiID ID = 0;
+    ImVector<char> Text;        // UTF-8, not null-terminated.
+    ImVector<float> CharX;      // Text.Size + 1 entries.
+    ImVector<int> LineStarts;   // LineStarts[0] == 0.
+    const ImFont* Font = nullptr;
+    float LineHeight = 13.0f;
+    float MaskAdvance = 0.0f;   // Advance of every code point when masked, 0 when shown.
+    int Capacity = -1;          // Max text bytes, -1 for unlimited.
+    // First byte changed since the text was last copied to the caller, -1
+    // when unchanged; the copy starts there. CopiedLen is the caller's
+    // length after that copy, to spot changes made from outside.
+    int EditedFrom = -1;
+    int CopiedLen = 0;
+    bool SelectingWithMouse = false;
+    float ScrollX = 0.0f;
+    float ScrollY = 0.0f;
+    float CursorResetTime = 0.0f;  // Caret is shown solid for a moment after moving.
+    // Per-line selection highlights of the frame, drawn as one batch.
+    ImVector<ImVec4> SelectionRects;
+    ImVector<ImU32> SelectionCols;
+    ImStb::STB_TexteditState Stb;
+
+    void Init(const char* text, int len, int capacity, float mask_advance, bool single_line);
+    // Measures the whole text, e.g. after the mask changes.
+    void RebuildCache();
+    void SetMaskAdvance(float mask_advance);
+
+    // Edits, keeping the cache current. InsertChars() fails when the text
+    // would exceed Capacity.
+    bool InsertChars(int pos, const char* text, int len);
+    void DeleteChars(int pos, int len);
+
+    int LineCount() const { return LineStarts.Size; }
+    int LineOf(int pos) const;
+    // Position of the line's '\n', or Text.Size for the last line.
+    int LineEnd(int line) const { return line + 1 < LineStarts.Size ? LineStarts[line + 1] - 1 : Text.Size; }
+    int LineStartAtY(float y) const;
+    // Position in the line starting at |line_start| whose caret is closest to |x|.
+    int PosAtX(int line_start, float x) const;
+    int NextCharIndex(int pos) const;
+    int PrevCharIndex(int pos) const;
+
+private:
+    float Advance(unsigned int c) const;
+    void Measure(int pos, float x, int stop);
+};
+
+namespace ImGui {
+    // What IsItemActive() reports for the item just submitted.
+    void SetLastItemActive(bool active);
+}
@@ -1,2 +1,234 @@
 #include "imgui.h"
-// Minimal stub for build-only template.
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+//-----------------------------------------------------------------------------
+// ImGuiListClipper
+//-----------------------------------------------------------------------------
+
+float ImGuiListClipper::RowTop(int row) const {
+    return ItemsHeight * static_cast<float>(row);
+}
+
+void ImGuiListClipper::Begin(int items_count, float items_height) {
+    ItemsCount = items_count;
+    ItemsHeight = items_height > 0.0f ? items_height : ImGui::GetTextLineHeightWithSpacing();
+    StartPosY = ImGui::GetCursorPos().y;
+    DisplayStart = DisplayEnd = 0;
+    StepNo = 0;
+}
+
+// Step 0 positions the cursor at the first visible row and returns that
+// range; step 1 moves the cursor past the last row so the scroll extent
+// covers the whole list.
+bool ImGuiListClipper::Step() {
+    if (StepNo == 0) {
+        StepNo = 1;
+        float view_top = ImGui::GetScrollY() - StartPosY;
+        float view_bottom = view_top + ImGui::GetWindowSize().y;
+        DisplayStart = static_cast<int>(std::floor(view_top / ItemsHeight));
+        DisplayEnd = static_cast<int>(std::ceil(view_bottom / ItemsHeight));
+        DisplayStart = std::max(0, std::min(DisplayStart, ItemsCount));
+        DisplayEnd = std::max(DisplayStart, std::min(DisplayEnd, ItemsCount));
+        if (DisplayStart < DisplayEnd) {
+            ImGui::SetCursorPosY(StartPosY + RowTop(DisplayStart));
+            return true;
+        }
+    }
+    End();
+    return false;
+}
+
+void ImGuiListClipper::End() {
+    if (StepNo < 0 || StepNo >= 2) return;
+    StepNo = 2;
+    ImGui::SetCursorPosY(StartPosY + RowTop(ItemsCount));
+    DisplayStart = DisplayEnd = ItemsCount;
+}
+
+//-----------------------------------------------------------------------------
+// Tables
+//-----------------------------------------------------------------------------
+// A subset of the upstream table API: fixed or stretched columns laid out
+// from the table origin, header row and single-column sort specs. Rows are
+// placed from the current cursor, so they compose with ImGuiListClipper.
+
+namespace {
+    struct TableColumn {
+        std::string label;
+        int flags = 0;
+        float init_width_or_weight = 0.0f;
+        float offset_x = 0.0f;
+        float width = 0.0f;
+    };
+
+    struct TableSortState {
+        ImGuiTableColumnSortSpecs column;
+        ImGuiTableSortSpecs specs;
+        bool initialized = false;
+    };
+
+    struct TableState {
+        bool active = false;
+        std::string id;
+        int flags = 0;
+        int columns_count = 0;
+        std::vector<TableColumn> columns;
+        bool layout_done = false;
+        ImVec2 origin;
+        float width = 0.0f;
+        float row_y = 0.0f;
+        float row_height = 0.0f;
+        int column = -1;
+    };
+
+    TableState g_table;
+    std::unordered_map<std::string, TableSortState> g_table_sort;
+
+    void TableLayoutColumns() {
+        if (g_table.layout_done) return;
+        g_table.layout_done = true;
+        // Columns never set up behave as equal stretch columns.
+        while (static_cast<int>(g_table.columns.size()) < g_table.columns_count) {
+            g_table.columns.push_back(TableColumn());
+        }
+        float spacing = ImGui::GetStyle().ItemSpacing.x;
+        float fixed_total = 0.0f;
+        float weight_total = 0.0f;
+        for (const TableColumn& column : g_table.columns) {
+            if (column.flags & ImGuiTableColumnFlags_WidthFixed) {
+                fixed_total += column.init_width_or_weight;
+            } else {
+                weight_total += column.init_width_or_weight > 0.0f ? column.init_width_or_weight : 1.0f;
+            }
+        }
+        float stretch_total = g_table.width - fixed_total - spacing * static_cast<float>(g_table.columns_count - 1);
+        if (stretch_total < 0.0f) stretch_total = 0.0f;
+        float x = 0.0f;
+        for (TableColumn& column : g_table.columns) {
+            if (column.flags & ImGuiTableColumnFlags_WidthFixed) {
+                column.width = column.init_width_or_weight;
+            } else {
+                float weight = column.init_width_or_weight > 0.0f ? column.init_width_or_weight : 1.0f;
+                column.width = weight_total > 0.0f ? stretch_total * weight / weight_total : 0.0f;
+            }
+            column.offset_x = x;
+            x += column.width + spacing;
+        }
+    }
+
+    void TableEndRow() {
+        if (g_table.column < 0) return;
+        ImGui::SetCursorPos(ImVec2(g_table.origin.x, g_table.row_y + g_table.row_height));
+        g_table.column = -1;
+    }
+}
+
+namespace ImGui {
+    bool BeginTable(const char* str_id, int columns, int flags, const ImVec2& outer_size) {
+        if (g_table.active || columns <= 0) return false;
+        g_table = TableState();
+        g_table.active = true;
+        g_table.id = str_id;
+        g_table.flags = flags;
+        g_table.columns_count = columns;
+        g_table.origin = GetCursorPos();
+        g_table.width = outer_size.x > 0.0f ? outer_size.x : GetContentRegionAvail().x;
+        g_table.row_y = g_table.origin.y;
+        return true;
+    }
+
+    void EndTable() {
+        TableEndRow();
+        g_table.active = false;
+    }
+
+    void TableSetupColumn(const char* label, int flags, float init_width_or_weight) {
+        if (!g_table.active || static_cast<int>(g_table.columns.size()) >= g_table.columns_count) return;
+        TableColumn column;
+        column.label = label ? label : "";
+        column.flags = flags;
+        column.init_width_or_weight = init_width_or_weight;
+        g_table.columns.push_back(column);
+    }
+
+    // Clicking a header sorts by that column, toggling direction on repeat.
+    void TableHeadersRow() {
+        TableNextRow();
+        ImGuiTableSortSpecs* specs = TableGetSortSpecs();
+        for (int i = 0; i < g_table.columns_count; ++i) {
+            TableSetColumnIndex(i);
+            const TableColumn& column = g_table.columns[i];
+            std::string label = column.label;
+            if (specs && specs->Specs->ColumnIndex == i) {
+                label += specs->Specs->SortDirection == ImGuiSortDirection_Ascending ? " ^" : " v";
+            }
+            label += "##header";
+            label += std::to_string(i);
+            if (Button(label.c_str(), ImVec2(column.width, 0.0f)) && specs) {
+                TableSortState& state = g_table_sort[g_table.id];
+                if (state.column.ColumnIndex == i) {
+                    state.column.SortDirection = state.column.SortDirection == ImGuiSortDirection_Ascending
+                        ? ImGuiSortDirection_Descending : ImGuiSortDirection_Ascending;
+                } else {
+                    state.column.ColumnIndex = static_cast<short>(i);
+                    state.column.ColumnUserID = static_cast<ImGuiID>(i);
+                    state.column.SortDirection = ImGuiSortDirection_Ascending;
+                }
+                state.specs.SpecsDirty = true;
+            }
+        }
+    }
+
+    void TableNextRow(int, float min_row_height) {
+        if (!g_table.active) return;
+        TableLayoutColumns();
+        TableEndRow();
+        g_table.row_y = GetCursorPos().y;
+        float line_height = GetTextLineHeightWithSpacing();
+        g_table.row_height = min_row_height > line_height ? min_row_height : line_height;
+        g_table.column = -1;
+    }
+
+    bool TableNextColumn() {
+        if (!g_table.active) return false;
+        if (g_table.column < 0 && g_table.row_height == 0.0f) TableNextRow();
+        if (g_table.column + 1 >= g_table.columns_count) TableNextRow();
+        return TableSetColumnIndex(g_table.column + 1);
+    }
+
+    bool TableSetColumnIndex(int column_n) {
+        if (!g_table.active || column_n < 0 || column_n >= g_table.columns_count) return false;
+        TableLayoutColumns();
+        g_table.column = column_n;
+        SetCursorPos(ImVec2(g_table.origin.x + g_table.columns[column_n].offset_x, g_table.row_y));
+        return true;
+    }
+
+    ImGuiTableSortSpecs* TableGetSortSpecs() {
+        if (!g_table.active || !(g_table.flags & ImGuiTableFlags_Sortable)) return nullptr;
+        TableLayoutColumns();
+        TableSortState& state = g_table_sort[g_table.id];
+        if (!state.initialized) {
+            state.initialized = true;
+            int default_column = 0;
+            for (int i = 0; i < g_table.columns_count; ++i) {
+                if (g_table.columns[i].flags & ImGuiTableColumnFlags_DefaultSort) {
+                    default_column = i;
+                    break;
+                }
+            }
+            state.column.ColumnIndex = static_cast<short>(default_column);
+            state.column.ColumnUserID = static_cast<ImGuiID>(default_column);
+            state.column.SortDirection = ImGuiSortDirection_Ascending;
+            state.specs.SpecsDirty = true;
+        }
+        state.specs.Specs = &state.column;
+        state.specs.SpecsCount = 1;
+        return &state.specs;
+    }
+}
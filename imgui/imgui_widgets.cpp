@@ -1,2 +1,564 @@
 #include "imgui.h"
-// Minimal stub for build-only template.
+#include "imgui_internal.h"
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+
+//-----------------------------------------------------------------------------
+// ImGuiInputTextState
+//-----------------------------------------------------------------------------
+
+namespace {
+    // Opens |count| uninitialized slots at |pos|.
+    template<typename T>
+    void InsertGap(ImVector<T>& v, int pos, int count) {
+        int tail = v.Size - pos;
+        v.resize(v.Size + count);
+        if (tail > 0) memmove(v.Data + pos + count, v.Data + pos, static_cast<size_t>(tail) * sizeof(T));
+    }
+
+    template<typename T>
+    void EraseRange(ImVector<T>& v, int pos, int count) {
+        int tail = v.Size - pos - count;
+        if (tail > 0) memmove(v.Data + pos, v.Data + pos + count, static_cast<size_t>(tail) * sizeof(T));
+        v.resize(v.Size - count);
+    }
+
+    inline bool IsContinuationByte(char c) {
+        return (static_cast<unsigned char>(c) & 0xC0) == 0x80;
+    }
+}
+
+// The edit state machine reads layout straight from the cache.
+#define IMSTB_TEXTEDIT_STRING ImGuiInputTextState
+#define IMSTB_TEXTEDIT_STRINGLEN(obj) ((obj)->Text.Size)
+#define IMSTB_TEXTEDIT_GETCHAR(obj, i) ((obj)->Text.Data[i])
+#define IMSTB_TEXTEDIT_GETNEXTCHARINDEX(obj, i) ((obj)->NextCharIndex(i))
+#define IMSTB_TEXTEDIT_GETPREVCHARINDEX(obj, i) ((obj)->PrevCharIndex(i))
+#define IMSTB_TEXTEDIT_ROWSTART(obj, i) ((obj)->LineStarts[(obj)->LineOf(i)])
+#define IMSTB_TEXTEDIT_ROWEND(obj, i) ((obj)->LineEnd((obj)->LineOf(i)))
+#define IMSTB_TEXTEDIT_ROWATY(obj, y) ((obj)->LineStartAtY(y))
+#define IMSTB_TEXTEDIT_CHARATX(obj, row, x) ((obj)->PosAtX(row, x))
+#define IMSTB_TEXTEDIT_CHARX(obj, i) ((obj)->CharX[i])
+#define IMSTB_TEXTEDIT_DELETECHARS(obj, i, n) ((obj)->DeleteChars(i, n))
+#define IMSTB_TEXTEDIT_INSERTCHARS(obj, i, text, n) ((obj)->InsertChars(i, text, n))
+#define IMSTB_TEXTEDIT_IMPLEMENTATION
+#include "imstb_textedit.h"
+
+void ImGuiInputTextState::Init(const char* text, int len, int capacity, float mask_advance, bool single_line) {
+    Text.resize(len);
+    if (len) memcpy(Text.Data, text, static_cast<size_t>(len));
+    Capacity = capacity;
+    Font = ImGui::GetFont();
+    LineHeight = Font->FontSize;
+    MaskAdvance = mask_advance;
+    EditedFrom = -1;
+    CopiedLen = len;
+    SelectingWithMouse = false;
+    ScrollX = 0.0f;
+    ScrollY = 0.0f;
+    CursorResetTime = ImGui::GetTime();
+    ImStb::stb_textedit_initialize_state(&Stb, single_line ? 1 : 0);
+    RebuildCache();
+}
+
+void ImGuiInputTextState::RebuildCache() {
+    CharX.resize(Text.Size + 1);
+    LineStarts.clear();
+    LineStarts.push_back(0);
+    for (int i = 0; i < Text.Size; ++i) {
+        if (Text.Data[i] == '\n') LineStarts.push_back(i + 1);
+    }
+    Measure(0, 0.0f, Text.Size);
+}
+
+void ImGuiInputTextState::SetMaskAdvance(float mask_advance) {
+    if (mask_advance == MaskAdvance) return;
+    MaskAdvance = mask_advance;
+    RebuildCache();
+}
+
+float ImGuiInputTextState::Advance(unsigned int c) const {
+    if (MaskAdvance > 0.0f) return MaskAdvance;
+    return c <= 0xFFFF ? Font->GetCharAdvance(static_cast<ImWchar>(c)) : Font->FallbackAdvanceX;
+}
+
+// Fills CharX from |pos|, whose caret x is |x|, through the end of the line
+// holding |stop|. Later lines start at x = 0 and keep their offsets.
+void ImGuiInputTextState::Measure(int pos, float x, int stop) {
+    const char* text = Text.Data;
+    const int size = Text.Size;
+    float* char_x = CharX.Data;
+    int i = pos;
+    while (i < size) {
+        unsigned char ch = static_cast<unsigned char>(text[i]);
+        if (ch == '\n') {
+            char_x[i++] = x;
+            x = 0.0f;
+            if (i > stop) break;
+            continue;
+        }
+        if (ch < 0x80) {
+            char_x[i++] = x;
+            x += Advance(ch);
+            continue;
+        }
+        unsigned int c = 0;
+        int n = ImTextCharFromUtf8(&c, text + i, text + size);
+        for (int k = 0; k < n; ++k) char_x[i + k] = x;
+        i += n;
+        x += Advance(c);
+    }
+    char_x[i] = x;
+}
+
+bool ImGuiInputTextState::InsertChars(int pos, const char* text, int len) {
+    if (len <= 0) return true;
+    if (Capacity >= 0 && Text.Size + len > Capacity) return false;
+    // The caret x at |pos| only depends on what precedes it.
+    const float x = CharX[pos];
+    const int line = LineOf(pos);
+    InsertGap(Text, pos, len);
+    memcpy(Text.Data + pos, text, static_cast<size_t>(len));
+    InsertGap(CharX, pos, len);
+
+    for (int l = line + 1; l < LineStarts.Size; ++l) LineStarts[l] += len;
+    int newlines = 0;
+    for (int i = 0; i < len; ++i) newlines += text[i] == '\n';
+    if (newlines) {
+        InsertGap(LineStarts, line + 1, newlines);
+        int* out = LineStarts.Data + line + 1;
+        for (int i = 0; i < len; ++i) {
+            if (text[i] == '\n') *out++ = pos + i + 1;
+        }
+    }
+    Measure(pos, x, pos + len);
+    EditedFrom = EditedFrom < 0 ? pos : std::min(EditedFrom, pos);
+    return true;
+}
+
+void ImGuiInputTextState::DeleteChars(int pos, int len) {
+    if (len <= 0) return;
+    const float x = CharX[pos];
+    const int line = LineOf(pos);
+    int newlines = 0;
+    for (int i = pos; i < pos + len; ++i) newlines += Text.Data[i] == '\n';
+    EraseRange(Text, pos, len);
+    EraseRange(CharX, pos, len);
+    if (newlines) EraseRange(LineStarts, line + 1, newlines);
+    for (int l = line + 1; l < LineStarts.Size; ++l) LineStarts[l] -= len;
+    Measure(pos, x, pos);
+    EditedFrom = EditedFrom < 0 ? pos : std::min(EditedFrom, pos);
+}
+
+int ImGuiInputTextState::LineOf(int pos) const {
+    const int* it = std::upper_bound(LineStarts.begin(), LineStarts.end(), pos);
+    return static_cast<int>(it - LineStarts.begin()) - 1;
+}
+
+int ImGuiInputTextState::LineStartAtY(float y) const {
+    int line = y <= 0.0f ? 0 : static_cast<int>(y / LineHeight);
+    if (line >= LineStarts.Size) line = LineStarts.Size - 1;
+    return LineStarts[line];
+}
+
+int ImGuiInputTextState::PosAtX(int line_start, float x) const {
+    const int line_end = LineEnd(LineOf(line_start));
+    // Continuation bytes share their lead byte's x, so the first offset
+    // past |x| belongs to a code point start.
+    const float* first = CharX.Data + line_start;
+    const float* last = CharX.Data + line_end + 1;
+    int right = static_cast<int>(std::upper_bound(first, last, x) - CharX.Data);
+    if (right > line_end) return line_end;
+    if (right == line_start) return line_start;
+    int left = right - 1;
+    while (left > line_start && IsContinuationByte(Text.Data[left])) --left;
+    return x - CharX[left] < CharX[right] - x ? left : right;
+}
+
+int ImGuiInputTextState::NextCharIndex(int pos) const {
+    ++pos;
+    while (pos < Text.Size && IsContinuationByte(Text.Data[pos])) ++pos;
+    return pos;
+}
+
+int ImGuiInputTextState::PrevCharIndex(int pos) const {
+    --pos;
+    while (pos > 0 && IsContinuationByte(Text.Data[pos])) --pos;
+    return pos;
+}
+
+//-----------------------------------------------------------------------------
+// InputText
+//-----------------------------------------------------------------------------
+
+namespace {
+    // One field is edited at a time, as upstream.
+    ImGuiInputTextState g_input_text;
+    ImGuiID g_active_input_id = 0;
+    // Run of '*' drawn for masked text; grows to the longest field seen.
+    std::string g_mask_text;
+
+    const float kCaretBlinkPeriod = 1.2f;
+    const float kCaretBlinkOn = 0.8f;
+
+    const char* MaskText(int count) {
+        if (static_cast<int>(g_mask_text.size()) < count) g_mask_text.resize(static_cast<size_t>(count), '*');
+        return g_mask_text.c_str();
+    }
+
+    int CountCodePoints(const char* text, const char* text_end) {
+        int count = 0;
+        for (; text < text_end; ++text) count += !IsContinuationByte(*text);
+        return count;
+    }
+
+    // Labels hide everything from "##" on.
+    const char* FindRenderedTextEnd(const char* label) {
+        const char* end = label;
+        while (*end && !(end[0] == '#' && end[1] == '#')) ++end;
+        return end;
+    }
+
+    void CopySelection(const ImGuiInputTextState& state) {
+        int begin = std::min(state.Stb.select_start, state.Stb.select_end);
+        int end = std::max(state.Stb.select_start, state.Stb.select_end);
+        std::string copy(state.Text.Data + begin, static_cast<size_t>(end - begin));
+        ImGui::SetClipboardText(copy.c_str());
+    }
+
+    // Control characters are dropped, and line breaks too on a single line.
+    void PasteClipboard(ImGuiInputTextState& state, bool multiline) {
+        const char* clip = ImGui::GetClipboardText();
+        if (!clip) return;
+        std::string text;
+        text.reserve(strlen(clip));
+        for (const char* p = clip; *p; ++p) {
+            unsigned char c = static_cast<unsigned char>(*p);
+            if (c < 0x20 && !(c == '\n' && multiline)) continue;
+            text.push_back(*p);
+        }
+        if (!text.empty()) ImStb::stb_textedit_paste(&state, &state.Stb, text.data(), static_cast<int>(text.size()));
+    }
+
+    // Double-click: the word under the cursor and the spaces after it, but
+    // not the line break.
+    void SelectWordAtCursor(ImGuiInputTextState& state) {
+        int cursor = state.Stb.cursor;
+        int begin = ImStb::stb_textedit_is_word_boundary(&state, cursor)
+            ? cursor : ImStb::stb_textedit_move_to_word_previous(&state, cursor);
+        int end = ImStb::stb_textedit_move_to_word_next(&state, begin);
+        while (end > begin && state.Text.Data[end - 1] == '\n') --end;
+        state.Stb.select_start = begin;
+        state.Stb.select_end = state.Stb.cursor = end;
+        state.Stb.has_preferred_x = 0;
+    }
+
+    void SelectAll(ImGuiInputTextState& state) {
+        state.Stb.select_start = 0;
+        state.Stb.select_end = state.Stb.cursor = state.Text.Size;
+        state.Stb.has_preferred_x = 0;
+    }
+
+    // Applies one queued key press. Returns false when it ends editing.
+    bool HandleKey(ImGuiInputTextState& state, const ImGuiInputEvent& e, bool multiline, bool password,
+                   bool* enter_pressed) {
+        using namespace ImStb;
+        const int shift = e.KeyShift ? STB_TEXTEDIT_K_SHIFT : 0;
+        switch (e.Key) {
+        case ImGuiKey_LeftArrow:
+            stb_textedit_key(&state, &state.Stb, (e.KeyCtrl ? STB_TEXTEDIT_K_WORDLEFT : STB_TEXTEDIT_K_LEFT) | shift);
+            break;
+        case ImGuiKey_RightArrow:
+            stb_textedit_key(&state, &state.Stb, (e.KeyCtrl ? STB_TEXTEDIT_K_WORDRIGHT : STB_TEXTEDIT_K_RIGHT) | shift);
+            break;
+        case ImGuiKey_UpArrow:
+            stb_textedit_key(&state, &state.Stb, STB_TEXTEDIT_K_UP | shift);
+            break;
+        case ImGuiKey_DownArrow:
+            stb_textedit_key(&state, &state.Stb, STB_TEXTEDIT_K_DOWN | shift);
+            break;
+        case ImGuiKey_PageUp:
+            stb_textedit_key(&state, &state.Stb, STB_TEXTEDIT_K_PGUP | shift);
+            break;
+        case ImGuiKey_PageDown:
+            stb_textedit_key(&state, &state.Stb, STB_TEXTEDIT_K_PGDOWN | shift);
+            break;
+        case ImGuiKey_Home:
+            stb_textedit_key(&state, &state.Stb, (e.KeyCtrl ? STB_TEXTEDIT_K_TEXTSTART : STB_TEXTEDIT_K_LINESTART) | shift);
+            break;
+        case ImGuiKey_End:
+            stb_textedit_key(&state, &state.Stb, (e.KeyCtrl ? STB_TEXTEDIT_K_TEXTEND : STB_TEXTEDIT_K_LINEEND) | shift);
+            break;
+        case ImGuiKey_Insert:
+            if (!e.KeyCtrl && !e.KeyShift) stb_textedit_key(&state, &state.Stb, STB_TEXTEDIT_K_INSERT);
+            break;
+        case ImGuiKey_Delete:
+            stb_textedit_key(&state, &state.Stb, STB_TEXTEDIT_K_DELETE);
+            break;
+        case ImGuiKey_Backspace:
+            // Ctrl+Backspace removes the word before the cursor.
+            if (e.KeyCtrl && !stb_textedit_has_selection(&state.Stb))
+                stb_textedit_key(&state, &state.Stb, STB_TEXTEDIT_K_WORDLEFT | STB_TEXTEDIT_K_SHIFT);
+            stb_textedit_key(&state, &state.Stb, STB_TEXTEDIT_K_BACKSPACE);
+            break;
+        case ImGuiKey_Enter:
+            if (multiline)
+                stb_textedit_text(&state, &state.Stb, "\n", 1);
+            else
+                *enter_pressed = true;
+            break;
+        case ImGuiKey_Escape:
+            return false;
+        case ImGuiKey_A:
+            if (e.KeyCtrl) SelectAll(state);
+            break;
+        case ImGuiKey_C:
+        case ImGuiKey_X:
+            // Masked text never leaves the field.
+            if (e.KeyCtrl && !password && stb_textedit_has_selection(&state.Stb)) {
+                CopySelection(state);
+                if (e.Key == ImGuiKey_X) stb_textedit_cut(&state, &state.Stb);
+            }
+            break;
+        case ImGuiKey_V:
+            if (e.KeyCtrl) PasteClipboard(state, multiline);
+            break;
+        default:
+            break;
+        }
+        return true;
+    }
+
+    // Keeps the caret inside the visible text area.
+    void ScrollToCursor(ImGuiInputTextState& state, const ImVec2& inner_size) {
+        const int cursor = state.Stb.cursor;
+        const float caret_x = state.CharX[cursor];
+        const float caret_y = static_cast<float>(state.LineOf(cursor)) * state.LineHeight;
+        const float scroll_step_x = inner_size.x * 0.25f;
+        if (caret_x < state.ScrollX) {
+            state.ScrollX = std::max(0.0f, caret_x - scroll_step_x);
+        } else if (caret_x - inner_size.x >= state.ScrollX) {
+            state.ScrollX = caret_x - inner_size.x + scroll_step_x;
+        }
+        if (caret_y < state.ScrollY) {
+            state.ScrollY = caret_y;
+        } else if (caret_y + state.LineHeight > state.ScrollY + inner_size.y) {
+            state.ScrollY = caret_y + state.LineHeight - inner_size.y;
+        }
+    }
+
+    void DrawActiveText(ImGuiInputTextState& state, ImDrawList* draw_list, const ImVec2& text_origin,
+                        const ImVec2& inner_size, bool password) {
+        const ImGuiStyle& style = ImGui::GetStyle();
+        const ImU32 text_col = ImGui::ColorConvertFloat4ToU32(style.Colors[ImGuiCol_Text]);
+        const ImU32 select_col = ImGui::ColorConvertFloat4ToU32(style.Colors[ImGuiCol_TextSelectedBg]);
+        const float line_height = state.LineHeight;
+        const float clip_x0 = text_origin.x;
+        const float clip_y0 = text_origin.y;
+        const float clip_x1 = text_origin.x + inner_size.x;
+        const float clip_y1 = text_origin.y + inner_size.y;
+        const float origin_x = text_origin.x - state.ScrollX;
+        // Selected line breaks show as half a space, as upstream.
+        const float newline_width = state.Font->GetCharAdvance(' ') * 0.5f;
+
+        const int sel_min = std::min(state.Stb.select_start, state.Stb.select_end);
+        const int sel_max = std::max(state.Stb.select_start, state.Stb.select_end);
+        const int first_line = std::max(0, static_cast<int>(state.ScrollY / line_height));
+        const int last_line = std::min(state.LineCount() - 1, static_cast<int>((state.ScrollY + inner_size.y) / line_height));
+        // Selection highlights sit behind all the text, so every line's rect
+        // goes out as one quad batch.
+        if (sel_min < sel_max) {
+            state.SelectionRects.resize(0);
+            for (int line = std::max(first_line, state.LineOf(sel_min)); line <= last_line; ++line) {
+                const int line_start = state.LineStarts[line];
+                const int line_end = state.LineEnd(line);
+                if (line_start >= sel_max) break;
+                const float y = text_origin.y + static_cast<float>(line) * line_height - state.ScrollY;
+                const int a = std::max(sel_min, line_start);
+                const int b = std::min(sel_max, line_end);
+                float x0 = std::max(origin_x + state.CharX[a], clip_x0);
+                float x1 = std::min(origin_x + state.CharX[b] + (sel_max > line_end ? newline_width : 0.0f), clip_x1);
+                float y0 = std::max(y, clip_y0);
+                float y1 = std::min(y + line_height, clip_y1);
+                if (x1 > x0 && y1 > y0) state.SelectionRects.push_back(ImVec4(x0, y0, x1, y1));
+            }
+            state.SelectionCols.resize(state.SelectionRects.Size);
+            for (ImU32& col : state.SelectionCols) col = select_col;
+            if ((select_col >> 24) != 0)
+                draw_list->PrimRectBatch(state.SelectionRects.Data, state.SelectionCols.Data, state.SelectionRects.Size);
+        }
+        for (int line = first_line; line <= last_line; ++line) {
+            const int line_start = state.LineStarts[line];
+            const int line_end = state.LineEnd(line);
+            const float y = text_origin.y + static_cast<float>(line) * line_height - state.ScrollY;
+            if (password) {
+                // The masked width is already cached; it gives the glyph count.
+                const int count = static_cast<int>(state.CharX[line_end] / state.MaskAdvance + 0.5f);
+                const char* mask = MaskText(count);
+                draw_list->AddText(ImVec2(origin_x, y), text_col, mask, mask + count);
+            } else {
+                draw_list->AddText(ImVec2(origin_x, y), text_col, state.Text.Data + line_start, state.Text.Data + line_end);
+            }
+        }
+
+        const float blink = std::fmod(ImGui::GetTime() - state.CursorResetTime, kCaretBlinkPeriod);
+        if (blink <= kCaretBlinkOn) {
+            const int cursor = state.Stb.cursor;
+            const float x = origin_x + state.CharX[cursor];
+            const float y = text_origin.y + static_cast<float>(state.LineOf(cursor)) * line_height - state.ScrollY;
+            if (x >= clip_x0 && x < clip_x1 && y >= clip_y0 && y + line_height <= clip_y1 + 0.5f)
+                draw_list->AddRectFilled(ImVec2(x, y), ImVec2(x + 1.0f, y + line_height), text_col);
+        }
+    }
+
+    bool InputTextEx(const char* label, char* buf, size_t buf_size, std::string* str, const ImVec2& size_arg,
+                     ImGuiInputTextFlags flags) {
+        using namespace ImStb;
+        ImGuiIO& io = ImGui::GetIO();
+        const ImGuiStyle& style = ImGui::GetStyle();
+        const ImFont* font = ImGui::GetFont();
+        const bool multiline = (flags & ImGuiInputTextFlags_Multiline) != 0;
+        const bool password = (flags & ImGuiInputTextFlags_Password) != 0 && !multiline;
+        const float line_height = font->FontSize;
+        const ImGuiID id = ImHashStr(label);
+        const char* text = str ? str->c_str() : buf;
+
+        const ImVec2 pos = ImGui::GetCursorScreenPos();
+        ImVec2 size(size_arg.x > 0.0f ? size_arg.x : ImGui::CalcItemWidth(), size_arg.y);
+        if (size.y <= 0.0f) size.y = (multiline ? line_height * 8.0f : line_height) + style.FramePadding.y * 2.0f;
+        const ImVec2 frame_max(pos.x + size.x, pos.y + size.y);
+        const ImVec2 text_origin(pos.x + style.FramePadding.x, pos.y + style.FramePadding.y);
+        const ImVec2 inner_size(size.x - style.FramePadding.x * 2.0f, size.y - style.FramePadding.y * 2.0f);
+        const bool hovered = io.MousePos.x >= pos.x && io.MousePos.y >= pos.y &&
+                             io.MousePos.x < frame_max.x && io.MousePos.y < frame_max.y;
+        const float mask_advance = password ? font->GetCharAdvance('*') : 0.0f;
+
+        ImGuiInputTextState& state = g_input_text;
+        if (io.MouseClicked[0]) {
+            if (hovered && g_active_input_id != id) {
+                int capacity = str ? -1 : (buf_size > 0 ? static_cast<int>(buf_size) - 1 : 0);
+                state.ID = id;
+                state.Init(text, static_cast<int>(strlen(text)), capacity, mask_advance, !multiline);
+                g_active_input_id = id;
+            } else if (!hovered && g_active_input_id == id) {
+                g_active_input_id = 0;
+            }
+        }
+
+        bool value_changed = false;
+        bool enter_pressed = false;
+        if (g_active_input_id == id) {
+            // Toggling the mask re-measures once; edits never do.
+            state.SetMaskAdvance(mask_advance);
+            state.Stb.row_count_per_page = std::max(1, static_cast<int>(inner_size.y / line_height));
+            bool cursor_moved = false;
+
+            const float mouse_x = io.MousePos.x - text_origin.x + state.ScrollX;
+            const float mouse_y = io.MousePos.y - text_origin.y + state.ScrollY;
+            if (io.MouseClicked[0] && hovered) {
+                if (io.KeyShift)
+                    stb_textedit_drag(&state, &state.Stb, mouse_x, mouse_y);
+                else
+                    stb_textedit_click(&state, &state.Stb, mouse_x, mouse_y);
+                if (io.MouseDoubleClicked[0]) SelectWordAtCursor(state);
+                state.SelectingWithMouse = !io.MouseDoubleClicked[0];
+                cursor_moved = true;
+            } else if (state.SelectingWithMouse) {
+                if (!io.MouseDown[0]) {
+                    state.SelectingWithMouse = false;
+                } else if (io.MouseDelta.x != 0.0f || io.MouseDelta.y != 0.0f) {
+                    stb_textedit_drag(&state, &state.Stb, mouse_x, mouse_y);
+                    cursor_moved = true;
+                }
+            }
+
+            bool keep_active = true;
+            for (const ImGuiInputEvent& e : io.InputEvents) {
+                cursor_moved = true;
+                if (e.Type == ImGuiInputEventType_Text) {
+                    // Control characters also arrive as key presses.
+                    if (e.Char < 0x20 || e.Char == 0x7F) continue;
+                    char utf8[4];
+                    stb_textedit_text(&state, &state.Stb, utf8, ImTextCharToUtf8(utf8, e.Char));
+                } else if (!HandleKey(state, e, multiline, password, &enter_pressed)) {
+                    keep_active = false;
+                    break;
+                }
+            }
+
+            if (state.EditedFrom >= 0) {
+                // The caller's text still matches up to the first edit, unless
+                // it was replaced while the field had focus.
+                const size_t user_len = str ? str->size() : strlen(buf);
+                const int from = user_len == static_cast<size_t>(state.CopiedLen)
+                    ? std::min(state.EditedFrom, state.Text.Size) : 0;
+                const size_t count = static_cast<size_t>(state.Text.Size - from);
+                if (str) {
+                    str->resize(static_cast<size_t>(state.Text.Size));
+                    if (count) memcpy(&(*str)[static_cast<size_t>(from)], state.Text.Data + from, count);
+                } else {
+                    if (count) memcpy(buf + from, state.Text.Data + from, count);
+                    buf[state.Text.Size] = '\0';
+                }
+                state.EditedFrom = -1;
+                state.CopiedLen = state.Text.Size;
+                value_changed = true;
+            }
+            if (cursor_moved) {
+                state.CursorResetTime = ImGui::GetTime();
+                ScrollToCursor(state, inner_size);
+            }
+            if (multiline && hovered && io.MouseWheel != 0.0f) {
+                const float max_scroll = std::max(0.0f, static_cast<float>(state.LineCount()) * line_height - inner_size.y);
+                state.ScrollY = std::min(std::max(state.ScrollY - io.MouseWheel * line_height * 3.0f, 0.0f), max_scroll);
+            }
+            if (!keep_active) g_active_input_id = 0;
+        }
+
+        ImDrawList* draw_list = ImGui::GetWindowDrawList();
+        const ImU32 text_col = ImGui::ColorConvertFloat4ToU32(style.Colors[ImGuiCol_Text]);
+        draw_list->AddRectFilled(pos, frame_max, ImGui::ColorConvertFloat4ToU32(style.Colors[ImGuiCol_FrameBg]),
+                                 style.FrameRounding);
+        if (g_active_input_id == id) {
+            DrawActiveText(state, draw_list, text_origin, inner_size, password);
+        } else {
+            text = str ? str->c_str() : buf;  // An edit may have reallocated the string.
+            const char* text_end = text + (str ? str->size() : strlen(text));
+            if (password) {
+                const int count = CountCodePoints(text, text_end);
+                const char* mask = MaskText(count);
+                draw_list->AddText(text_origin, text_col, mask, mask + count);
+            } else {
+                draw_list->AddText(text_origin, text_col, text, text_end);
+            }
+        }
+        const char* label_end = FindRenderedTextEnd(label);
+        if (label_end != label)
+            draw_list->AddText(ImVec2(frame_max.x + style.ItemInnerSpacing.x, text_origin.y), text_col, label, label_end);
+
+        ImGui::Dummy(size);
+        ImGui::SetLastItemActive(g_active_input_id == id);
+        return (flags & ImGuiInputTextFlags_EnterReturnsTrue) ? enter_pressed : value_changed;
+    }
+}
+
+namespace ImGui {
+    bool InputText(const char* label, char* buf, size_t buf_size, ImGuiInputTextFlags flags) {
+        return InputTextEx(label, buf, buf_size, nullptr, ImVec2(0, 0), flags & ~ImGuiInputTextFlags_Multiline);
+    }
+
+    bool InputText(const char* label, std::string* str, ImGuiInputTextFlags flags) {
+        return InputTextEx(label, nullptr, 0, str, ImVec2(0, 0), flags & ~ImGuiInputTextFlags_Multiline);
+    }
+
+    bool InputTextMultiline(const char* label, char* buf, size_t buf_size, const ImVec2& size,
+                            ImGuiInputTextFlags flags) {
+        return InputTextEx(label, buf, buf_size, nullptr, size, flags | ImGuiInputTextFlags_Multiline);
+    }
+
+    bool InputTextMultiline(const char* label, std::string* str, const ImVec2& size, ImGuiInputTextFlags flags) {
+        return InputTextEx(label, nullptr, 0, str, size, flags | ImGuiInputTextFlags_Multiline);
+    }
+}
@@ -1,2 +1,161 @@
-#pragma once
-// Minimal stub for build-only template.
+// Skyline rectangle packer with the stb_rect_pack API subset used here:
+// stbrp_init_target() + stbrp_pack_rects(), bottom-left heuristic, rects
+// packed tallest first and reported in their original order. The context can
+// be packed into repeatedly until it is full; define
+// STB_RECT_PACK_IMPLEMENTATION in one translation unit (before or after
+// other includes of this header, as with stb).
+#ifndef STB_INCLUDE_STB_RECT_PACK_H
+#define STB_INCLUDE_STB_RECT_PACK_H
+
+typedef int stbrp_coord;
+
+struct stbrp_rect {
+    int id;
+    stbrp_coord w, h;   // Input.
+    stbrp_coord x, y;   // Output.
+    int was_packed;     // Non-zero if the rect was placed.
+};
+
+struct stbrp_node {
+    stbrp_coord x, y;
+    stbrp_node* next;
+};
+
+struct stbrp_context {
+    int width;
+    int height;
+    stbrp_node* active_head;
+    stbrp_node* free_head;
+    stbrp_node extra[2];
+};
+
+// |nodes| must hold at least |width| entries and outlive the context.
+void stbrp_init_target(stbrp_context* context, int width, int height, stbrp_node* nodes, int num_nodes);
+// Returns 1 if every rect was packed.
+int stbrp_pack_rects(stbrp_context* context, stbrp_rect* rects, int num_rects);
+
+#endif
+
+#if defined(STB_RECT_PACK_IMPLEMENTATION) && !defined(STB_RECT_PACK_IMPLEMENTATION_DONE)
+#define STB_RECT_PACK_IMPLEMENTATION_DONE
+#include <algorithm>
+
+void stbrp_init_target(stbrp_context* context, int width, int height, stbrp_node* nodes, int num_nodes) {
+    for (int i = 0; i < num_nodes - 1; ++i) nodes[i].next = &nodes[i + 1];
+    nodes[num_nodes - 1].next = nullptr;
+    context->width = width;
+    context->height = height;
+    context->free_head = nodes;
+    // One segment spanning the width at y = 0, and a sentinel past the end.
+    context->active_head = &context->extra[0];
+    context->extra[0].x = 0;
+    context->extra[0].y = 0;
+    context->extra[0].next = &context->extra[1];
+    context->extra[1].x = static_cast<stbrp_coord>(width);
+    context->extra[1].y = 1 << 30;
+    context->extra[1].next = nullptr;
+}
+
+namespace stbrp_detail {
+    // Lowest y at which a rect of |width| fits with its left edge on |first|.
+    inline int SkylineFitY(const stbrp_node* first, int x0, int width) {
+        int x1 = x0 + width;
+        int y = 0;
+        for (const stbrp_node* node = first; node->x < x1; node = node->next) {
+            if (node->y > y) y = node->y;
+        }
+        return y;
+    }
+
+    // Bottom-left: lowest resting y, then the leftmost. Returns the link
+    // that points at the chosen node, or nullptr if nothing fits.
+    inline stbrp_node** FindBottomLeft(stbrp_context* c, int w, int h, int& out_y) {
+        stbrp_node** best = nullptr;
+        int best_y = 1 << 30;
+        int best_waste = 1 << 30;
+        stbrp_node** prev = &c->active_head;
+        for (stbrp_node* node = c->active_head; node->x + w <= c->width; node = node->next) {
+            int y = SkylineFitY(node, node->x, w);
+            if (y + h <= c->height) {
+                // Area left unused under the rect breaks ties between equal y.
+                int waste = 0;
+                for (const stbrp_node* n = node; n->x < node->x + w; n = n->next) {
+                    int right = std::min(n->next->x, node->x + w);
+                    waste += (y - n->y) * (right - n->x);
+                }
+                if (y < best_y || (y == best_y && waste < best_waste)) {
+                    best = prev;
+                    best_y = y;
+                    best_waste = waste;
+                }
+            }
+            prev = &node->next;
+        }
+        out_y = best_y;
+        return best;
+    }
+
+    inline bool PackOne(stbrp_context* c, stbrp_rect& r) {
+        if (r.w <= 0 || r.h <= 0) {
+            r.x = r.y = 0;
+            return true;
+        }
+        int y = 0;
+        stbrp_node** link = FindBottomLeft(c, r.w, r.h, y);
+        if (!link || !c->free_head) return false;
+
+        // Raise the skyline under the rect: a new node covers [x, x + w) at
+        // y + h, and the nodes it fully covers return to the free list.
+        stbrp_node* first = *link;
+        int x0 = first->x;
+        int x1 = x0 + r.w;
+        stbrp_node* node = c->free_head;
+        c->free_head = node->next;
+        node->x = static_cast<stbrp_coord>(x0);
+        node->y = static_cast<stbrp_coord>(y + r.h);
+        *link = node;
+
+        stbrp_node* cur = first;
+        while (cur->next && cur->next->x <= x1) {
+            stbrp_node* done = cur;
+            cur = cur->next;
+            done->next = c->free_head;
+            c->free_head = done;
+        }
+        // |cur| starts at or left of x1 and now begins where the rect ends.
+        // The sentinel is only reached when x1 is the right edge, so it
+        // never moves.
+        if (cur->x < x1) cur->x = static_cast<stbrp_coord>(x1);
+        node->next = cur;
+
+        r.x = static_cast<stbrp_coord>(x0);
+        r.y = static_cast<stbrp_coord>(y);
+        return true;
+    }
+}
+
+int stbrp_pack_rects(stbrp_context* context, stbrp_rect* rects, int num_rects) {
+    // Tallest first, then widest; the original order is restored after.
+    for (int i = 0; i < num_rects; ++i) rects[i].was_packed = i;
+    std::sort(rects, rects + num_rects, [](const stbrp_rect& a, const stbrp_rect& b) {
+        if (a.h != b.h) return a.h > b.h;
+        return a.w > b.w;
+    });
+    int all_packed = 1;
+    for (int i = 0; i < num_rects; ++i) {
+        int order = rects[i].was_packed;
+        bool packed = stbrp_detail::PackOne(context, rects[i]);
+        if (!packed) {
+            rects[i].x = rects[i].y = 0x7fffffff;
+            all_packed = 0;
+        }
+        // Keep the original index in the high bits until the sort back.
+        rects[i].was_packed = order * 2 + (packed ? 1 : 0);
+    }
+    std::sort(rects, rects + num_rects, [](const stbrp_rect& a, const stbrp_rect& b) {
+        return a.was_packed < b.was_packed;
+    });
+    for (int i = 0; i < num_rects; ++i) rects[i].was_packed &= 1;
+    return all_packed;
+}
+#endif
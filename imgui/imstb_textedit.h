@@ -1,2 +1,386 @@
-#pragma once
-// Minimal stub for build-only template.
+// Text editing state machine with the stb_textedit API subset used by
+// InputText: click and drag placement, cursor and selection keys, typed
+// text, cut and paste; no undo history. Text is UTF-8 and positions are byte
+// offsets stepped a code point at a time, as in current Dear ImGui. Rows are
+// text lines (no wrapping). Layout is queried through position callbacks
+// instead of stb's LAYOUTROW/GETWIDTH, so the caller can answer from cached
+// glyph offsets rather than measuring rows on every key or mouse move.
+//
+// Define IMSTB_TEXTEDIT_IMPLEMENTATION in one translation unit, after:
+//   IMSTB_TEXTEDIT_STRING                      edited object type
+//   IMSTB_TEXTEDIT_STRINGLEN(obj)              length in bytes
+//   IMSTB_TEXTEDIT_GETCHAR(obj, i)             byte at i
+//   IMSTB_TEXTEDIT_GETNEXTCHARINDEX(obj, i)    next code point start
+//   IMSTB_TEXTEDIT_GETPREVCHARINDEX(obj, i)    previous code point start
+//   IMSTB_TEXTEDIT_ROWSTART(obj, i)            first position of the row holding i
+//   IMSTB_TEXTEDIT_ROWEND(obj, i)              its '\n' position, or the length
+//   IMSTB_TEXTEDIT_ROWATY(obj, y)              first position of the row at y, clamped
+//   IMSTB_TEXTEDIT_CHARATX(obj, row, x)        position in the row starting at row closest to x
+//   IMSTB_TEXTEDIT_CHARX(obj, i)               x of position i from its row start
+//   IMSTB_TEXTEDIT_DELETECHARS(obj, i, n)
+//   IMSTB_TEXTEDIT_INSERTCHARS(obj, i, text, n)  false when the text does not fit
+#ifndef IMSTB_INCLUDE_TEXTEDIT_H
+#define IMSTB_INCLUDE_TEXTEDIT_H
+
+namespace ImStb {
+
+enum {
+    STB_TEXTEDIT_K_LEFT = 1,
+    STB_TEXTEDIT_K_RIGHT,
+    STB_TEXTEDIT_K_UP,
+    STB_TEXTEDIT_K_DOWN,
+    STB_TEXTEDIT_K_PGUP,
+    STB_TEXTEDIT_K_PGDOWN,
+    STB_TEXTEDIT_K_LINESTART,
+    STB_TEXTEDIT_K_LINEEND,
+    STB_TEXTEDIT_K_TEXTSTART,
+    STB_TEXTEDIT_K_TEXTEND,
+    STB_TEXTEDIT_K_WORDLEFT,
+    STB_TEXTEDIT_K_WORDRIGHT,
+    STB_TEXTEDIT_K_DELETE,
+    STB_TEXTEDIT_K_BACKSPACE,
+    STB_TEXTEDIT_K_INSERT,
+    STB_TEXTEDIT_K_SHIFT = 1 << 16  // Or'ed in to extend the selection.
+};
+
+struct STB_TexteditState {
+    int cursor;
+    // Selection is [min(select_start, select_end), max(...)); empty when
+    // equal. While selecting, select_end follows the cursor.
+    int select_start;
+    int select_end;
+    unsigned char insert_mode;      // Typed text overwrites.
+    unsigned char single_line;      // Up/down act as left/right.
+    unsigned char has_preferred_x;  // Column kept across up/down moves.
+    float preferred_x;
+    int row_count_per_page;
+};
+
+}
+
+#endif
+
+#if defined(IMSTB_TEXTEDIT_IMPLEMENTATION) && !defined(IMSTB_TEXTEDIT_IMPLEMENTATION_DONE)
+#define IMSTB_TEXTEDIT_IMPLEMENTATION_DONE
+
+namespace ImStb {
+
+static void stb_textedit_initialize_state(STB_TexteditState* state, int is_single_line) {
+    state->cursor = 0;
+    state->select_start = 0;
+    state->select_end = 0;
+    state->insert_mode = 0;
+    state->single_line = static_cast<unsigned char>(is_single_line);
+    state->has_preferred_x = 0;
+    state->preferred_x = 0.0f;
+    state->row_count_per_page = 1;
+}
+
+static bool stb_textedit_has_selection(const STB_TexteditState* state) {
+    return state->select_start != state->select_end;
+}
+
+static int stb_text_locate_coord(IMSTB_TEXTEDIT_STRING* str, float x, float y) {
+    return IMSTB_TEXTEDIT_CHARATX(str, IMSTB_TEXTEDIT_ROWATY(str, y), x);
+}
+
+static void stb_textedit_clamp(IMSTB_TEXTEDIT_STRING* str, STB_TexteditState* state) {
+    int n = IMSTB_TEXTEDIT_STRINGLEN(str);
+    if (stb_textedit_has_selection(state)) {
+        if (state->select_start > n) state->select_start = n;
+        if (state->select_end > n) state->select_end = n;
+        if (state->select_start == state->select_end) state->cursor = state->select_start;
+    }
+    if (state->cursor > n) state->cursor = n;
+}
+
+static void stb_textedit_sortselection(STB_TexteditState* state) {
+    if (state->select_end < state->select_start) {
+        int temp = state->select_end;
+        state->select_end = state->select_start;
+        state->select_start = temp;
+    }
+}
+
+static void stb_textedit_delete_selection(IMSTB_TEXTEDIT_STRING* str, STB_TexteditState* state) {
+    stb_textedit_clamp(str, state);
+    if (!stb_textedit_has_selection(state)) return;
+    stb_textedit_sortselection(state);
+    IMSTB_TEXTEDIT_DELETECHARS(str, state->select_start, state->select_end - state->select_start);
+    state->select_end = state->cursor = state->select_start;
+    state->has_preferred_x = 0;
+}
+
+static void stb_textedit_move_to_first(STB_TexteditState* state) {
+    if (!stb_textedit_has_selection(state)) return;
+    stb_textedit_sortselection(state);
+    state->cursor = state->select_start;
+    state->select_end = state->select_start;
+    state->has_preferred_x = 0;
+}
+
+static void stb_textedit_move_to_last(IMSTB_TEXTEDIT_STRING* str, STB_TexteditState* state) {
+    if (!stb_textedit_has_selection(state)) return;
+    stb_textedit_sortselection(state);
+    stb_textedit_clamp(str, state);
+    state->cursor = state->select_end;
+    state->select_start = state->select_end;
+    state->has_preferred_x = 0;
+}
+
+// Starts a selection at the cursor unless one is in progress.
+static void stb_textedit_prep_selection_at_cursor(STB_TexteditState* state) {
+    if (!stb_textedit_has_selection(state))
+        state->select_start = state->select_end = state->cursor;
+    else
+        state->cursor = state->select_end;
+}
+
+static bool stb_textedit_is_separator(char c) {
+    switch (c) {
+    case ' ': case '\t': case '\n': case '\r': case ',': case ';': case '.': case ':':
+    case '(': case ')': case '{': case '}': case '[': case ']': case '<': case '>':
+    case '|': case '!': case '?': case '\'': case '"': case '\\': case '/': case '=':
+        return true;
+    default:
+        return false;
+    }
+}
+
+// True at the first character of a word. Non-ASCII bytes count as word
+// characters.
+static bool stb_textedit_is_word_boundary(IMSTB_TEXTEDIT_STRING* str, int idx) {
+    if (idx <= 0) return true;
+    return stb_textedit_is_separator(IMSTB_TEXTEDIT_GETCHAR(str, idx - 1)) &&
+           !stb_textedit_is_separator(IMSTB_TEXTEDIT_GETCHAR(str, idx));
+}
+
+static int stb_textedit_move_to_word_previous(IMSTB_TEXTEDIT_STRING* str, int c) {
+    if (c <= 0) return 0;
+    c = IMSTB_TEXTEDIT_GETPREVCHARINDEX(str, c);
+    while (c > 0 && !stb_textedit_is_word_boundary(str, c)) c = IMSTB_TEXTEDIT_GETPREVCHARINDEX(str, c);
+    return c < 0 ? 0 : c;
+}
+
+static int stb_textedit_move_to_word_next(IMSTB_TEXTEDIT_STRING* str, int c) {
+    int len = IMSTB_TEXTEDIT_STRINGLEN(str);
+    if (c >= len) return len;
+    c = IMSTB_TEXTEDIT_GETNEXTCHARINDEX(str, c);
+    while (c < len && !stb_textedit_is_word_boundary(str, c)) c = IMSTB_TEXTEDIT_GETNEXTCHARINDEX(str, c);
+    return c > len ? len : c;
+}
+
+static void stb_textedit_click(IMSTB_TEXTEDIT_STRING* str, STB_TexteditState* state, float x, float y) {
+    state->cursor = stb_text_locate_coord(str, x, y);
+    state->select_start = state->cursor;
+    state->select_end = state->cursor;
+    state->has_preferred_x = 0;
+}
+
+static void stb_textedit_drag(IMSTB_TEXTEDIT_STRING* str, STB_TexteditState* state, float x, float y) {
+    int p = stb_text_locate_coord(str, x, y);
+    if (state->select_start == state->select_end) state->select_start = state->cursor;
+    state->cursor = state->select_end = p;
+}
+
+// Replaces the selection with |text|; returns 0 if it did not fit.
+static int stb_textedit_paste(IMSTB_TEXTEDIT_STRING* str, STB_TexteditState* state, const char* text, int len) {
+    stb_textedit_clamp(str, state);
+    stb_textedit_delete_selection(str, state);
+    if (!IMSTB_TEXTEDIT_INSERTCHARS(str, state->cursor, text, len)) return 0;
+    state->cursor += len;
+    state->has_preferred_x = 0;
+    return 1;
+}
+
+// Typed text: like paste, but in insert mode it overwrites the next
+// character. The overwritten character is restored if the text does not fit.
+static void stb_textedit_text(IMSTB_TEXTEDIT_STRING* str, STB_TexteditState* state, const char* text, int len) {
+    stb_textedit_clamp(str, state);
+    int len_total = IMSTB_TEXTEDIT_STRINGLEN(str);
+    if (state->insert_mode && !stb_textedit_has_selection(state) && state->cursor < len_total) {
+        char removed[4];
+        int removed_len = IMSTB_TEXTEDIT_GETNEXTCHARINDEX(str, state->cursor) - state->cursor;
+        if (removed_len > 4) removed_len = 4;
+        for (int i = 0; i < removed_len; ++i) removed[i] = IMSTB_TEXTEDIT_GETCHAR(str, state->cursor + i);
+        IMSTB_TEXTEDIT_DELETECHARS(str, state->cursor, removed_len);
+        if (!IMSTB_TEXTEDIT_INSERTCHARS(str, state->cursor, text, len)) {
+            IMSTB_TEXTEDIT_INSERTCHARS(str, state->cursor, removed, removed_len);
+            return;
+        }
+        state->cursor += len;
+        state->has_preferred_x = 0;
+        return;
+    }
+    stb_textedit_paste(str, state, text, len);
+}
+
+// Deletes the selection; returns 0 if there was none.
+static int stb_textedit_cut(IMSTB_TEXTEDIT_STRING* str, STB_TexteditState* state) {
+    if (!stb_textedit_has_selection(state)) return 0;
+    stb_textedit_delete_selection(str, state);
+    return 1;
+}
+
+static void stb_textedit_key(IMSTB_TEXTEDIT_STRING* str, STB_TexteditState* state, int key) {
+retry:
+    const bool shift = (key & STB_TEXTEDIT_K_SHIFT) != 0;
+    const int len = IMSTB_TEXTEDIT_STRINGLEN(str);
+    switch (key & ~STB_TEXTEDIT_K_SHIFT) {
+    case STB_TEXTEDIT_K_INSERT:
+        if (!shift) state->insert_mode = !state->insert_mode;
+        break;
+
+    case STB_TEXTEDIT_K_LEFT:
+        stb_textedit_clamp(str, state);
+        if (shift) {
+            stb_textedit_prep_selection_at_cursor(state);
+            if (state->select_end > 0) state->select_end = IMSTB_TEXTEDIT_GETPREVCHARINDEX(str, state->select_end);
+            state->cursor = state->select_end;
+        } else if (stb_textedit_has_selection(state)) {
+            stb_textedit_move_to_first(state);
+        } else if (state->cursor > 0) {
+            state->cursor = IMSTB_TEXTEDIT_GETPREVCHARINDEX(str, state->cursor);
+        }
+        state->has_preferred_x = 0;
+        break;
+
+    case STB_TEXTEDIT_K_RIGHT:
+        stb_textedit_clamp(str, state);
+        if (shift) {
+            stb_textedit_prep_selection_at_cursor(state);
+            if (state->select_end < len) state->select_end = IMSTB_TEXTEDIT_GETNEXTCHARINDEX(str, state->select_end);
+            state->cursor = state->select_end;
+        } else if (stb_textedit_has_selection(state)) {
+            stb_textedit_move_to_last(str, state);
+        } else if (state->cursor < len) {
+            state->cursor = IMSTB_TEXTEDIT_GETNEXTCHARINDEX(str, state->cursor);
+        }
+        state->has_preferred_x = 0;
+        break;
+
+    case STB_TEXTEDIT_K_WORDLEFT:
+        stb_textedit_clamp(str, state);
+        if (shift) {
+            stb_textedit_prep_selection_at_cursor(state);
+            state->cursor = state->select_end = stb_textedit_move_to_word_previous(str, state->cursor);
+        } else if (stb_textedit_has_selection(state)) {
+            stb_textedit_move_to_first(state);
+        } else {
+            state->cursor = stb_textedit_move_to_word_previous(str, state->cursor);
+        }
+        state->has_preferred_x = 0;
+        break;
+
+    case STB_TEXTEDIT_K_WORDRIGHT:
+        stb_textedit_clamp(str, state);
+        if (shift) {
+            stb_textedit_prep_selection_at_cursor(state);
+            state->cursor = state->select_end = stb_textedit_move_to_word_next(str, state->cursor);
+        } else if (stb_textedit_has_selection(state)) {
+            stb_textedit_move_to_last(str, state);
+        } else {
+            state->cursor = stb_textedit_move_to_word_next(str, state->cursor);
+        }
+        state->has_preferred_x = 0;
+        break;
+
+    case STB_TEXTEDIT_K_UP:
+    case STB_TEXTEDIT_K_DOWN:
+    case STB_TEXTEDIT_K_PGUP:
+    case STB_TEXTEDIT_K_PGDOWN: {
+        const int base = key & ~STB_TEXTEDIT_K_SHIFT;
+        const bool up = base == STB_TEXTEDIT_K_UP || base == STB_TEXTEDIT_K_PGUP;
+        if (state->single_line) {
+            // As in Windows edit controls.
+            key = (up ? STB_TEXTEDIT_K_LEFT : STB_TEXTEDIT_K_RIGHT) | (key & STB_TEXTEDIT_K_SHIFT);
+            goto retry;
+        }
+        int rows = 1;
+        if (base == STB_TEXTEDIT_K_PGUP || base == STB_TEXTEDIT_K_PGDOWN)
+            rows = state->row_count_per_page > 1 ? state->row_count_per_page : 1;
+        stb_textedit_clamp(str, state);
+        if (shift)
+            stb_textedit_prep_selection_at_cursor(state);
+        else if (up)
+            stb_textedit_move_to_first(state);
+        else
+            stb_textedit_move_to_last(str, state);
+
+        float goal_x = state->has_preferred_x ? state->preferred_x : IMSTB_TEXTEDIT_CHARX(str, state->cursor);
+        int pos = state->cursor;
+        for (int r = 0; r < rows; ++r) {
+            int row = IMSTB_TEXTEDIT_ROWSTART(str, pos);
+            if (up) {
+                if (row == 0) break;
+                row = IMSTB_TEXTEDIT_ROWSTART(str, row - 1);
+            } else {
+                int end = IMSTB_TEXTEDIT_ROWEND(str, pos);
+                if (end >= len) break;
+                row = end + 1;
+            }
+            pos = IMSTB_TEXTEDIT_CHARATX(str, row, goal_x);
+        }
+        state->cursor = pos;
+        if (shift) state->select_end = pos;
+        state->has_preferred_x = 1;
+        state->preferred_x = goal_x;
+        break;
+    }
+
+    case STB_TEXTEDIT_K_DELETE:
+        if (stb_textedit_has_selection(state)) {
+            stb_textedit_delete_selection(str, state);
+        } else if (state->cursor < len) {
+            IMSTB_TEXTEDIT_DELETECHARS(str, state->cursor, IMSTB_TEXTEDIT_GETNEXTCHARINDEX(str, state->cursor) - state->cursor);
+        }
+        state->has_preferred_x = 0;
+        break;
+
+    case STB_TEXTEDIT_K_BACKSPACE:
+        if (stb_textedit_has_selection(state)) {
+            stb_textedit_delete_selection(str, state);
+        } else {
+            stb_textedit_clamp(str, state);
+            if (state->cursor > 0) {
+                int prev = IMSTB_TEXTEDIT_GETPREVCHARINDEX(str, state->cursor);
+                IMSTB_TEXTEDIT_DELETECHARS(str, prev, state->cursor - prev);
+                state->cursor = prev;
+            }
+        }
+        state->has_preferred_x = 0;
+        break;
+
+    case STB_TEXTEDIT_K_TEXTSTART:
+    case STB_TEXTEDIT_K_TEXTEND: {
+        int target = (key & ~STB_TEXTEDIT_K_SHIFT) == STB_TEXTEDIT_K_TEXTSTART ? 0 : len;
+        if (shift) {
+            stb_textedit_prep_selection_at_cursor(state);
+            state->cursor = state->select_end = target;
+        } else {
+            state->cursor = state->select_start = state->select_end = target;
+        }
+        state->has_preferred_x = 0;
+        break;
+    }
+
+    case STB_TEXTEDIT_K_LINESTART:
+    case STB_TEXTEDIT_K_LINEEND: {
+        const bool start = (key & ~STB_TEXTEDIT_K_SHIFT) == STB_TEXTEDIT_K_LINESTART;
+        stb_textedit_clamp(str, state);
+        if (shift)
+            stb_textedit_prep_selection_at_cursor(state);
+        else
+            stb_textedit_move_to_first(state);
+        int target = start ? IMSTB_TEXTEDIT_ROWSTART(str, state->cursor) : IMSTB_TEXTEDIT_ROWEND(str, state->cursor);
+        state->cursor = target;
+        if (shift) state->select_end = target;
+        state->has_preferred_x = 0;
+        break;
+    }
+    }
+}
+
+}
+
+#endif
@@ -0,0 +1,89 @@
+#include "launch_profiles.h"
+
+#include "app_paths.h"
+
+static const char* kProfilesFile = "launch_profiles.txt";
+static const char* kProfilesVersion = "v1";
+
+// Fields are single lines; a stray break would start a bogus record.
+static std::string OneLine(const std::string& text) {
+    std::string line = text;
+    for (char& c : line) {
+        if (c == '\r' || c == '\n') c = ' ';
+    }
+    return line;
+}
+
+std::vector<LaunchProfile> LoadLaunchProfiles() {
+    std::vector<LaunchProfile> profiles;
+    std::string contents;
+    if (!ReadFileUtf8(AppDataPath(kProfilesFile), contents)) return profiles;
+
+    size_t start = 0;
+    bool header = true;
+    for (size_t pos = contents.find('\n'); pos != std::string::npos; pos = contents.find('\n', start)) {
+        std::string line = contents.substr(start, pos - start);
+        start = pos + 1;
+        if (header) {
+            if (line != kProfilesVersion) return profiles;
+            header = false;
+            continue;
+        }
+        size_t tab = line.find('\t');
+        if (tab == std::string::npos) continue;
+        std::string key = line.substr(0, tab);
+        std::string value = line.substr(tab + 1);
+
+        // "profile" opens a record; the other keys fill in the last one.
+        if (key == "profile") {
+            if (profiles.size() == kMaxLaunchProfiles) break;
+            profiles.emplace_back();
+            profiles.back().name = value;
+            continue;
+        }
+        if (profiles.empty()) continue;
+        LaunchProfile& profile = profiles.back();
+        if (key == "path") {
+            profile.path = value;
+        } else if (key == "args") {
+            profile.options.arguments = value;
+        } else if (key == "cwd") {
+            profile.options.working_dir = value;
+        } else if (key == "capture") {
+            profile.options.capture_output = value == "1";
+        } else if (key == "env") {
+            // The name cannot contain a tab; the value may.
+            size_t split = value.find('\t');
+            if (split == std::string::npos || split == 0) continue;
+            EnvOverride entry;
+            entry.name = value.substr(0, split);
+            entry.value = value.substr(split + 1);
+            profile.options.environment.push_back(entry);
+        }
+    }
+    // A profile without an executable cannot be launched.
+    for (size_t i = 0; i < profiles.size();) {
+        if (profiles[i].path.empty()) {
+            profiles.erase(profiles.begin() + i);
+        } else {
+            ++i;
+        }
+    }
+    return profiles;
+}
+
+bool SaveLaunchProfiles(const std::vector<LaunchProfile>& profiles) {
+    std::string text = std::string(kProfilesVersion) + "\n";
+    for (const LaunchProfile& profile : profiles) {
+        text += "profile\t" + OneLine(profile.name) + "\n";
+        text += "path\t" + OneLine(profile.path) + "\n";
+        if (!profile.options.arguments.empty()) text += "args\t" + OneLine(profile.options.arguments) + "\n";
+        if (!profile.options.working_dir.empty()) text += "cwd\t" + OneLine(profile.options.working_dir) + "\n";
+        if (profile.options.capture_output) text += "capture\t1\n";
+        for (const EnvOverride& entry : profile.options.environment) {
+            if (entry.name.empty() || entry.name.find('\t') != std::string::npos) continue;
+            text += "env\t" + OneLine(entry.name) + "\t" + OneLine(entry.value) + "\n";
+        }
+    }
+    return WriteFileAtomicUtf8(AppDataPath(kProfilesFile), text);
+}
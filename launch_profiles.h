@@ -0,0 +1,22 @@
+#pragma once
+#include <string>
+#include <vector>
+
+#include "child_process.h"
+
+// Saved launch configurations: an executable with its arguments, working
+// directory and environment overrides. Kept as a small line-based text file
+// in the app data directory, one "key<TAB>value" line per field.
+
+struct LaunchProfile {
+    std::string name;
+    std::string path;             // UTF-8.
+    ChildLaunchOptions options;
+};
+
+static const size_t kMaxLaunchProfiles = 32;
+
+// Reads the saved profiles. A missing or unrecognized file yields none.
+std::vector<LaunchProfile> LoadLaunchProfiles();
+// Replaces the saved file. Line breaks inside fields become spaces.
+bool SaveLaunchProfiles(const std::vector<LaunchProfile>& profiles);
@@ -0,0 +1,102 @@
+#include "launch_queue.h"
+
+#include <utility>
+
+#include "trace.h"
+
+static double MillisecondsBetween(std::chrono::steady_clock::time_point from,
+                                  std::chrono::steady_clock::time_point to) {
+    return std::chrono::duration<double, std::milli>(to - from).count();
+}
+
+LaunchQueue::LaunchQueue(int concurrency) {
+    SetConcurrency(concurrency);
+}
+
+LaunchQueue::~LaunchQueue() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+        queue_.clear();
+    }
+    cv_.notify_all();
+    for (std::thread& worker : workers_) worker.join();
+}
+
+uint64_t LaunchQueue::Submit(LaunchRequest request) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Job job;
+    job.id = next_id_++;
+    job.request = std::move(request);
+    job.submitted = Clock::now();
+    uint64_t id = job.id;
+    queue_.push_back(std::move(job));
+    cv_.notify_one();
+    return id;
+}
+
+bool LaunchQueue::Poll(std::vector<LaunchResult>& out) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (done_.empty()) return false;
+    for (LaunchResult& result : done_) out.push_back(std::move(result));
+    done_.clear();
+    return true;
+}
+
+// Workers are only ever added: lowering the limit leaves the extra ones
+// waiting on the active count.
+void LaunchQueue::SetConcurrency(int concurrency) {
+    if (concurrency < 1) concurrency = 1;
+    if (concurrency > kMaxConcurrency) concurrency = kMaxConcurrency;
+    std::lock_guard<std::mutex> lock(mutex_);
+    concurrency_ = concurrency;
+    while (static_cast<int>(workers_.size()) < concurrency_) {
+        workers_.emplace_back(&LaunchQueue::WorkerMain, this);
+    }
+    cv_.notify_all();
+}
+
+int LaunchQueue::Concurrency() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return concurrency_;
+}
+
+size_t LaunchQueue::Pending() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return queue_.size() + static_cast<size_t>(active_) + done_.size();
+}
+
+void LaunchQueue::WorkerMain() {
+    TRACE_THREAD_NAME("Launch worker");
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (!stop_) {
+        if (queue_.empty() || active_ >= concurrency_) {
+            cv_.wait(lock);
+            continue;
+        }
+        Job job = std::move(queue_.front());
+        queue_.pop_front();
+        ++active_;
+        lock.unlock();
+
+        LaunchResult result;
+        result.id = job.id;
+        result.label = job.request.label;
+        result.path = job.request.path;
+        result.output = std::move(job.request.output);
+        result.process.reset(new ChildProcess());
+        Clock::time_point picked = Clock::now();
+        {
+            TRACE_SCOPE("launch.spawn");
+            result.ok = result.process->Start(job.request.path, job.request.options, result.output.get());
+        }
+        result.queued_ms = MillisecondsBetween(job.submitted, picked);
+        result.spawn_ms = MillisecondsBetween(picked, Clock::now());
+
+        lock.lock();
+        --active_;
+        done_.push_back(std::move(result));
+        // A slot is free again for a worker held back by the limit.
+        cv_.notify_all();
+    }
+}
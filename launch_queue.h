@@ -0,0 +1,83 @@
+#pragma once
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "child_process.h"
+
+class OutputRing;
+
+struct LaunchRequest {
+    std::string label;              // For display, e.g. the profile name.
+    std::string path;               // UTF-8.
+    ChildLaunchOptions options;
+    // Each capturing launch gets its own ring, so output from launches that
+    // overlap never interleaves.
+    std::shared_ptr<OutputRing> output;
+};
+
+struct LaunchResult {
+    uint64_t id = 0;
+    std::string label;
+    std::string path;
+    // Declared before |process| so the ring outlives its reader.
+    std::shared_ptr<OutputRing> output;
+    // Always set; holds LastError() when the launch failed.
+    std::unique_ptr<ChildProcess> process;
+    bool ok = false;
+    double queued_ms = 0.0;         // Submit() until a worker picked it up.
+    double spawn_ms = 0.0;          // ChildProcess::Start() alone.
+};
+
+// Creates processes off the UI thread. Launches wait in submission order and
+// are started by a small worker pool, at most Concurrency() at a time, so a
+// slow CreateProcess never stalls a frame and a batch of launches overlaps.
+// Finished launches are collected with Poll().
+class LaunchQueue {
+public:
+    static const int kMaxConcurrency = 8;
+
+    explicit LaunchQueue(int concurrency = 2);
+    ~LaunchQueue();
+    LaunchQueue(const LaunchQueue&) = delete;
+    LaunchQueue& operator=(const LaunchQueue&) = delete;
+
+    // Returns the launch's id; ids start at 1.
+    uint64_t Submit(LaunchRequest request);
+    // Appends launches finished since the last call to |out|, in completion
+    // order. Returns false if there were none.
+    bool Poll(std::vector<LaunchResult>& out);
+
+    // Clamped to [1, kMaxConcurrency]. Launches already spawning finish.
+    void SetConcurrency(int concurrency);
+    int Concurrency() const;
+    // Submitted launches not yet returned by Poll().
+    size_t Pending() const;
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Job {
+        uint64_t id = 0;
+        LaunchRequest request;
+        Clock::time_point submitted;
+    };
+
+    void WorkerMain();
+
+    mutable std::mutex mutex_;
+    std::condition_variable cv_;
+    std::deque<Job> queue_;
+    std::vector<LaunchResult> done_;
+    uint64_t next_id_ = 1;
+    int concurrency_ = 1;
+    int active_ = 0;
+    bool stop_ = false;
+    std::vector<std::thread> workers_;
+};
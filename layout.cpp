@@ -0,0 +1,136 @@
+#include "layout.h"
+
+Layout::Layout() {
+    nodes_.emplace_back();
+}
+
+int Layout::Add(int parent, LayoutSize width, LayoutSize height) {
+    Node node;
+    node.parent = parent;
+    node.width = width;
+    node.height = height;
+    int index = static_cast<int>(nodes_.size());
+    nodes_.push_back(node);
+
+    Node& p = nodes_[parent];
+    if (p.last_child >= 0) {
+        nodes_[p.last_child].next_sibling = index;
+    } else {
+        p.first_child = index;
+    }
+    p.last_child = index;
+    valid_ = false;
+    return index;
+}
+
+void Layout::SetAxis(int node, LayoutAxis axis) {
+    nodes_[node].axis = axis;
+    valid_ = false;
+}
+
+void Layout::SetAlign(int node, LayoutAlign main, LayoutAlign cross) {
+    nodes_[node].align_main = main;
+    nodes_[node].align_cross = cross;
+    valid_ = false;
+}
+
+void Layout::SetPadding(int node, float padding) {
+    nodes_[node].padding = padding;
+    valid_ = false;
+}
+
+void Layout::SetGap(int node, float gap) {
+    nodes_[node].gap = gap;
+    valid_ = false;
+}
+
+bool Layout::Resolve(const ImVec2& root_size, uint32_t content_version) {
+    if (valid_ && resolved_size_.x == root_size.x && resolved_size_.y == root_size.y &&
+        resolved_version_ == content_version) {
+        return false;
+    }
+
+    nodes_[0].rect.pos = ImVec2(0, 0);
+    nodes_[0].rect.size = root_size;
+    // Children are always added after their parent, so a single forward pass
+    // sees every parent rectangle before its children need it.
+    for (int i = 0; i < static_cast<int>(nodes_.size()); ++i) {
+        ResolveChildren(i);
+    }
+
+    resolved_size_ = root_size;
+    resolved_version_ = content_version;
+    valid_ = true;
+    return true;
+}
+
+LayoutRect Layout::RectIn(int node, int ancestor) const {
+    LayoutRect rect = nodes_[node].rect;
+    const LayoutRect& base = nodes_[ancestor].rect;
+    rect.pos = ImVec2(rect.pos.x - base.pos.x, rect.pos.y - base.pos.y);
+    return rect;
+}
+
+static float AlignOffset(LayoutAlign align, float free_space) {
+    if (free_space <= 0.0f) return 0.0f;
+    switch (align) {
+    case LayoutAlign::Center:
+        return free_space * 0.5f;
+    case LayoutAlign::End:
+        return free_space;
+    default:
+        return 0.0f;
+    }
+}
+
+void Layout::ResolveChildren(int index) {
+    const Node& node = nodes_[index];
+    if (node.first_child < 0) return;
+
+    bool row = node.axis == LayoutAxis::Row;
+    float inner_x = node.rect.pos.x + node.padding;
+    float inner_y = node.rect.pos.y + node.padding;
+    float inner_w = node.rect.size.x - node.padding * 2.0f;
+    float inner_h = node.rect.size.y - node.padding * 2.0f;
+    if (inner_w < 0.0f) inner_w = 0.0f;
+    if (inner_h < 0.0f) inner_h = 0.0f;
+    float main_avail = row ? inner_w : inner_h;
+    float cross_avail = row ? inner_h : inner_w;
+
+    float fixed_total = 0.0f;
+    float flex_total = 0.0f;
+    int count = 0;
+    for (int c = node.first_child; c >= 0; c = nodes_[c].next_sibling) {
+        const LayoutSize& main = row ? nodes_[c].width : nodes_[c].height;
+        if (main.flex) {
+            flex_total += main.value;
+        } else {
+            fixed_total += main.value;
+        }
+        ++count;
+    }
+    fixed_total += node.gap * static_cast<float>(count - 1);
+
+    float flex_space = main_avail - fixed_total;
+    if (flex_space < 0.0f) flex_space = 0.0f;
+    float cursor = flex_total > 0.0f ? 0.0f : AlignOffset(node.align_main, main_avail - fixed_total);
+
+    for (int c = node.first_child; c >= 0; c = nodes_[c].next_sibling) {
+        Node& child = nodes_[c];
+        const LayoutSize& main = row ? child.width : child.height;
+        const LayoutSize& cross = row ? child.height : child.width;
+
+        float main_size = main.flex ? flex_space * (main.value / flex_total) : main.value;
+        float cross_size = cross.flex ? cross_avail : cross.value;
+        float cross_pos = AlignOffset(node.align_cross, cross_avail - cross_size);
+
+        if (row) {
+            child.rect.pos = ImVec2(inner_x + cursor, inner_y + cross_pos);
+            child.rect.size = ImVec2(main_size, cross_size);
+        } else {
+            child.rect.pos = ImVec2(inner_x + cross_pos, inner_y + cursor);
+            child.rect.size = ImVec2(cross_size, main_size);
+        }
+        cursor += main_size + node.gap;
+    }
+}
@@ -0,0 +1,90 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+#include "imgui.h"
+
+// Small declarative layout: nodes are arranged in rows or columns with fixed
+// or flex sizes and resolved into rectangles once. Rectangles are only
+// recomputed when the root size or the content version changes, so screens
+// can look them up every frame for free.
+
+enum class LayoutAxis {
+    Row,
+    Column
+};
+
+enum class LayoutAlign {
+    Start,
+    Center,
+    End
+};
+
+struct LayoutSize {
+    bool flex = true;
+    float value = 1.0f; // Pixels when fixed, weight when flex.
+};
+
+inline LayoutSize LayoutFixed(float pixels) {
+    LayoutSize size;
+    size.flex = false;
+    size.value = pixels;
+    return size;
+}
+
+inline LayoutSize LayoutFlex(float weight = 1.0f) {
+    LayoutSize size;
+    size.flex = true;
+    size.value = weight;
+    return size;
+}
+
+struct LayoutRect {
+    ImVec2 pos;
+    ImVec2 size;
+};
+
+class Layout {
+public:
+    Layout();
+
+    // The root (node 0) always fills the size passed to Resolve().
+    int Root() const { return 0; }
+    int Add(int parent, LayoutSize width, LayoutSize height);
+
+    void SetAxis(int node, LayoutAxis axis);
+    void SetAlign(int node, LayoutAlign main, LayoutAlign cross);
+    void SetPadding(int node, float padding);
+    void SetGap(int node, float gap);
+
+    // Returns true when rectangles were recomputed this call.
+    bool Resolve(const ImVec2& root_size, uint32_t content_version = 0);
+    void Invalidate() { valid_ = false; }
+
+    const LayoutRect& Rect(int node) const { return nodes_[node].rect; }
+    // Rectangle of |node| relative to the top-left corner of |ancestor|.
+    LayoutRect RectIn(int node, int ancestor) const;
+
+private:
+    struct Node {
+        int parent = -1;
+        int first_child = -1;
+        int last_child = -1;
+        int next_sibling = -1;
+        LayoutSize width;
+        LayoutSize height;
+        LayoutAxis axis = LayoutAxis::Column;
+        LayoutAlign align_main = LayoutAlign::Start;
+        LayoutAlign align_cross = LayoutAlign::Start;
+        float padding = 0.0f;
+        float gap = 0.0f;
+        LayoutRect rect;
+    };
+
+    void ResolveChildren(int node);
+
+    std::vector<Node> nodes_;
+    ImVec2 resolved_size_;
+    uint32_t resolved_version_ = 0;
+    bool valid_ = false;
+};
@@ -1,20 +1,40 @@
 #include <windows.h>
-#include <d3d11.h>
+#include <d3d11_1.h>
+#include <dxgi1_2.h>
 #include <tchar.h>
 #include <dwmapi.h>
-#include <winhttp.h>
 #include <commdlg.h>
 #include <shellapi.h>
 #include <string>
 #include <vector>
-#include <thread>
-#include <atomic>
-#include <mutex>
 #include <chrono>
+#include <memory>
 
 #include "imgui.h"
 #include "imgui_impl_win32.h"
 #include "imgui_impl_dx11.h"
+#include "animation.h"
+#include "app_paths.h"
+#include "child_process.h"
+#include "damage_tracker.h"
+#include "event_log.h"
+#include "fingerprint.h"
+#include "image_cache.h"
+#include "launch_profiles.h"
+#include "launch_queue.h"
+#include "layout.h"
+#include "output_ring.h"
+#include "parallel_draw.h"
+#include "recent_targets.h"
+#include "row_sorter.h"
+#include "soft_renderer.h"
+#include "string_util.h"
+#include "task_pool.h"
+#include "theme.h"
+#include "trace.h"
+#include "verify_cache.h"
+#include "verify_client.h"
+#include "verify_scheduler.h"
 
 #pragma comment(lib, "d3d11.lib")
 #pragma comment(lib, "dxgi.lib")
@@ -23,253 +43,343 @@
 #pragma comment(lib, "comdlg32.lib")
 
 static constexpr float kPi = 3.14159265358979323846f;
+static constexpr float kContentTop = 58.0f;
+// Longest the frame loop sleeps with nothing animating, so results from
+// background workers still appear promptly.
+static constexpr float kIdlePollInterval = 0.1f;
 
-static float ClampFloat(float v, float lo, float hi) {
-    if (v < lo) return lo;
-    if (v > hi) return hi;
-    return v;
-}
+struct Toast {
+    std::string message;
+    ThemeColor color = ThemeColor::Neutral;
+    TweenId fade_in = kNoTween;
+    TweenId fade_out = kNoTween;
+};
 
-static std::wstring Utf8ToWide(const std::string& str) {
-    if (str.empty()) return L"";
-    int size = MultiByteToWideChar(CP_UTF8, 0, str.c_str(), -1, nullptr, 0);
-    std::wstring wide(size - 1, L'\0');
-    MultiByteToWideChar(CP_UTF8, 0, str.c_str(), -1, wide.data(), size);
-    return wide;
-}
+// A process started through the launch queue, kept until pruned so its status
+// and spawn timing stay visible.
+struct LaunchedTarget {
+    LaunchResult launch;
+    bool exit_logged = false;
+};
 
-static std::string WideToUtf8(const std::wstring& str) {
-    if (str.empty()) return "";
-    int size = WideCharToMultiByte(CP_UTF8, 0, str.c_str(), -1, nullptr, 0, nullptr, nullptr);
-    std::string utf8(size - 1, '\0');
-    WideCharToMultiByte(CP_UTF8, 0, str.c_str(), -1, utf8.data(), size, nullptr, nullptr);
-    return utf8;
-}
+enum class ScreenState {
+    Login,
+    Loading,
+    Main
+};
 
-static std::string UrlEncode(const std::string& value) {
-    static const char* kHex = "0123456789ABCDEF";
-    std::string encoded;
-    for (unsigned char c : value) {
-        if ((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') ||
-            (c >= '0' && c <= '9') || c == '-' || c == '_' || c == '.' || c == '~') {
-            encoded.push_back(static_cast<char>(c));
-        } else {
-            encoded.push_back('%');
-            encoded.push_back(kHex[c >> 4]);
-            encoded.push_back(kHex[c & 0x0F]);
-        }
-    }
-    return encoded;
-}
+struct AppState {
+    ScreenState current = ScreenState::Login;
+    ScreenState target = ScreenState::Login;
+    Animator animator;
+    float transition = 1.0f;
+    TweenId transition_tween = kNoTween;
+    float loading_progress = 0.0f;
+    TweenId loading_tween = kNoTween;
+    TweenId spinner_tween = kNoTween;
 
-struct Toast {
-    std::string message;
-    ImVec4 color;
-    float start_time = 0.0f;
-    float duration = 3.0f;
+    std::string key_input;
+    bool show_key = false;
+    bool remember_me = false;
+    bool verifying = false;
+    // Set while a cached verification is being confirmed in the background.
+    bool revalidating = false;
+    std::string status_text;
+
+    VerifyScheduler verifier{VerifyKeyOnline};
+
+    std::wstring selected_path;
+    std::wstring selected_name;
+    RecentTargets recent;
+    std::vector<RecentTarget> recent_list;
+    uint64_t recent_version = 0;
+    AsyncRowSorter recent_sorter;
+    // Rows the running sort reads, and rows the sorter's current order indexes.
+    std::shared_ptr<const std::vector<RecentTarget>> recent_sorting;
+    std::shared_ptr<const std::vector<RecentTarget>> recent_rows;
+    FingerprintService fingerprints;
+    float fingerprint_check_time = 0.0f;
+    bool fingerprint_change_shown = false;
+    ImageCache images;
+    // Ring of the newest capturing launch, shown in the output pane.
+    std::shared_ptr<OutputRing> target_output = std::make_shared<OutputRing>();
+    // Lines the output pane read this frame, kept to reuse their storage.
+    std::vector<OutputLine> output_lines;
+    bool capture_output = true;
+
+    LaunchQueue launches;
+    std::vector<LaunchedTarget> launched;
+    std::vector<LaunchProfile> profiles;
+    std::string profile_name;
+    std::string launch_args;
+    std::string launch_cwd;
+    std::string env_entry;
+    std::vector<EnvOverride> launch_env;
+
+    std::vector<Toast> toasts;
+
+    // Newest event log records shown in the Activity card, and the log
+    // sequence they were read at.
+    LogRecord activity[32];
+    size_t activity_count = 0;
+    uint64_t activity_sequence = 0;
 };
 
-static void AddToast(std::vector<Toast>& toasts, const std::string& message, const ImVec4& color) {
-    if (toasts.size() >= 4) {
-        toasts.erase(toasts.begin());
+static void AddToast(AppState& state, const std::string& message, ThemeColor color) {
+    static const float kToastDuration = 3.0f;
+    static const float kToastFadeIn = 0.3f;
+    static const float kToastFadeOut = 0.45f;
+    if (state.toasts.size() >= 4) {
+        state.animator.Release(state.toasts.front().fade_in);
+        state.animator.Release(state.toasts.front().fade_out);
+        state.toasts.erase(state.toasts.begin());
     }
+    float now = static_cast<float>(ImGui::GetTime());
     Toast toast;
     toast.message = message;
     toast.color = color;
-    toast.start_time = static_cast<float>(ImGui::GetTime());
-    toast.duration = 3.0f;
-    toasts.push_back(toast);
+    toast.fade_in = state.animator.Start(0.0f, 1.0f, kToastFadeIn, Ease::OutQuad, now);
+    toast.fade_out = state.animator.Start(1.0f, 0.0f, kToastFadeOut, Ease::Linear, now + kToastDuration - kToastFadeOut);
+    state.toasts.push_back(toast);
+}
+
+// Soft drop shadow around a panel: rounded rects that grow and fade
+// outwards, offset slightly downwards.
+static const int kShadowLayers = 6;
+static const float kShadowSpread = 2.0f;
+
+static void DrawPanelShadow(ImDrawList* draw_list, const ImVec2& pos, const ImVec2& size, float rounding, ImU32 alpha) {
+    for (int i = kShadowLayers; i >= 1; --i) {
+        float grow = kShadowSpread * i;
+        ImU32 layer_alpha = alpha * (kShadowLayers + 1 - i) / (kShadowLayers * 6);
+        draw_list->AddRectFilled(ImVec2(pos.x - grow, pos.y - grow + 3.0f),
+                                 ImVec2(pos.x + size.x + grow, pos.y + size.y + grow + 3.0f),
+                                 IM_COL32(0, 0, 0, layer_alpha), rounding + grow);
+    }
+}
+
+// Records the shadow of the window about to be begun at |pos| into the
+// current window's draw list, beneath it. Windows are independent, so their
+// shadows record in parallel.
+static void RecordPanelShadow(ParallelDrawLists& draw_lists, ImDrawList* target, const ImVec2& pos,
+                              const ImVec2& size, float alpha) {
+    float rounding = ImGui::GetStyle().ChildRounding;
+    ImU32 alpha_byte = AlphaToByte(alpha);
+    draw_lists.Record(target, [pos, size, rounding, alpha_byte](ImDrawList* draw_list) {
+        DrawPanelShadow(draw_list, pos, size, rounding, alpha_byte);
+    });
 }
 
-static void DrawToasts(std::vector<Toast>& toasts) {
+static void DrawToasts(AppState& state, ParallelDrawLists& draw_lists) {
     ImGuiViewport* viewport = ImGui::GetMainViewport();
+    // Toasts float above the main window; their shadows go into its list.
+    ImDrawList* backdrop = ImGui::GetWindowDrawList();
     ImVec2 base_pos(viewport->Pos.x + viewport->Size.x - 20.0f, viewport->Pos.y + 20.0f);
     float y_offset = 0.0f;
-    float now = static_cast<float>(ImGui::GetTime());
-    for (int i = static_cast<int>(toasts.size()) - 1; i >= 0; --i) {
-        Toast& toast = toasts[i];
-        float t = (now - toast.start_time) / toast.duration;
-        if (t >= 1.0f) {
-            toasts.erase(toasts.begin() + i);
+    for (int i = static_cast<int>(state.toasts.size()) - 1; i >= 0; --i) {
+        Toast& toast = state.toasts[i];
+        if (!state.animator.Running(toast.fade_out)) {
+            state.animator.Release(toast.fade_in);
+            state.animator.Release(toast.fade_out);
+            state.toasts.erase(state.toasts.begin() + i);
             continue;
         }
-        float alpha = 1.0f;
-        if (t < 0.1f) {
-            alpha = t / 0.1f;
-        } else if (t > 0.85f) {
-            alpha = (1.0f - t) / 0.15f;
-        }
-        alpha = ClampFloat(alpha, 0.0f, 1.0f);
+        float alpha = state.animator.Value(toast.fade_in) * state.animator.Value(toast.fade_out);
         ImGui::SetNextWindowBgAlpha(0.85f * alpha);
         ImGui::SetNextWindowPos(ImVec2(base_pos.x, base_pos.y + y_offset), ImGuiCond_Always, ImVec2(1.0f, 0.0f));
         ImGui::Begin(("toast_" + std::to_string(i)).c_str(), nullptr,
                      ImGuiWindowFlags_NoDecoration | ImGuiWindowFlags_AlwaysAutoResize |
                          ImGuiWindowFlags_NoSavedSettings | ImGuiWindowFlags_NoMove);
-        ImGui::TextColored(ImVec4(toast.color.x, toast.color.y, toast.color.z, alpha), "%s", toast.message.c_str());
+        RecordPanelShadow(draw_lists, backdrop, ImGui::GetWindowPos(), ImGui::GetWindowSize(), alpha);
+        ImGui::PushStyleColor(ImGuiCol_Text, ModulateAlpha(ThemeU32(toast.color), AlphaToByte(alpha)));
+        ImGui::Text("%s", toast.message.c_str());
+        ImGui::PopStyleColor();
         y_offset += ImGui::GetWindowHeight() + 8.0f;
         ImGui::End();
     }
 }
 
-enum class ScreenState {
-    Login,
-    Loading,
-    Main
-};
-
-struct VerifyResult {
-    bool success = false;
-    bool network_error = false;
-    std::string status_message;
+// Precomputed rectangles for each screen, relative to the content child.
+struct ScreenLayouts {
+    Layout login;
+    int login_panel = 0;
+    Layout loading;
+    int loading_card = 0;
+    Layout main;
+    int sidebar = 0;
+    int content_panel = 0;
 };
 
-static const wchar_t* kVerifyHost = L"example.com";
-static const INTERNET_PORT kVerifyPort = 443;
-static const bool kVerifyUseHttps = true;
-static const char* kVerifyPathPrefix = "/verify/v1/nitrosdk?key=";
-
-static VerifyResult VerifyKeyOnline(const std::string& key) {
-    VerifyResult result;
-    std::wstring host(kVerifyHost);
-    std::string query = std::string(kVerifyPathPrefix) + UrlEncode(key);
-    std::wstring path = Utf8ToWide(query);
-
-    HINTERNET session = WinHttpOpen(L"ModGui/1.0",
-                                    WINHTTP_ACCESS_TYPE_DEFAULT_PROXY,
-                                    WINHTTP_NO_PROXY_NAME,
-                                    WINHTTP_NO_PROXY_BYPASS, 0);
-    if (!session) {
-        result.network_error = true;
-        result.status_message = "Network error: WinHttpOpen failed";
-        return result;
-    }
-
-    HINTERNET connect = WinHttpConnect(session, host.c_str(), kVerifyPort, 0);
-    if (!connect) {
-        WinHttpCloseHandle(session);
-        result.network_error = true;
-        result.status_message = "Network error: WinHttpConnect failed";
-        return result;
-    }
-
-    DWORD flags = kVerifyUseHttps ? WINHTTP_FLAG_SECURE : 0;
-    HINTERNET request = WinHttpOpenRequest(connect, L"GET", path.c_str(),
-                                           nullptr, WINHTTP_NO_REFERER,
-                                           WINHTTP_DEFAULT_ACCEPT_TYPES, flags);
-    if (!request) {
-        WinHttpCloseHandle(connect);
-        WinHttpCloseHandle(session);
-        result.network_error = true;
-        result.status_message = "Network error: WinHttpOpenRequest failed";
-        return result;
-    }
-
-    BOOL sent = WinHttpSendRequest(request,
-                                   WINHTTP_NO_ADDITIONAL_HEADERS, 0,
-                                   WINHTTP_NO_REQUEST_DATA, 0,
-                                   0, 0);
-    if (!sent) {
-        WinHttpCloseHandle(request);
-        WinHttpCloseHandle(connect);
-        WinHttpCloseHandle(session);
-        result.network_error = true;
-        result.status_message = "Network error: WinHttpSendRequest failed";
-        return result;
-    }
-
-    BOOL received = WinHttpReceiveResponse(request, nullptr);
-    if (!received) {
-        WinHttpCloseHandle(request);
-        WinHttpCloseHandle(connect);
-        WinHttpCloseHandle(session);
-        result.network_error = true;
-        result.status_message = "Network error: WinHttpReceiveResponse failed";
-        return result;
-    }
-
-    DWORD status_code = 0;
-    DWORD status_size = sizeof(status_code);
-    WinHttpQueryHeaders(request,
-                        WINHTTP_QUERY_STATUS_CODE | WINHTTP_QUERY_FLAG_NUMBER,
-                        WINHTTP_HEADER_NAME_BY_INDEX,
-                        &status_code, &status_size, WINHTTP_NO_HEADER_INDEX);
-
-    std::string body;
-    DWORD available = 0;
-    while (WinHttpQueryDataAvailable(request, &available) && available > 0) {
-        std::string buffer(available, '\0');
-        DWORD read = 0;
-        if (!WinHttpReadData(request, buffer.data(), available, &read) || read == 0) {
-            break;
-        }
-        buffer.resize(read);
-        body += buffer;
-    }
-
-    WinHttpCloseHandle(request);
-    WinHttpCloseHandle(connect);
-    WinHttpCloseHandle(session);
-
-    result.status_message = "HTTP " + std::to_string(status_code);
-    if (body.find("\"valid\":true") != std::string::npos ||
-        body.find("\"success\":true") != std::string::npos ||
-        body == "true") {
-        result.success = true;
-    } else {
-        result.success = false;
-    }
-    return result;
+static void BuildScreenLayouts(ScreenLayouts& layouts, float item_spacing) {
+    Layout& login = layouts.login;
+    login.SetAxis(login.Root(), LayoutAxis::Column);
+    login.Add(login.Root(), LayoutFlex(), LayoutFixed(80.0f));
+    int login_row = login.Add(login.Root(), LayoutFlex(), LayoutFixed(360.0f));
+    login.SetAxis(login_row, LayoutAxis::Row);
+    login.SetAlign(login_row, LayoutAlign::Center, LayoutAlign::Start);
+    layouts.login_panel = login.Add(login_row, LayoutFixed(360.0f), LayoutFixed(360.0f));
+
+    Layout& loading = layouts.loading;
+    loading.SetAxis(loading.Root(), LayoutAxis::Column);
+    loading.Add(loading.Root(), LayoutFlex(), LayoutFixed(160.0f));
+    int loading_row = loading.Add(loading.Root(), LayoutFlex(), LayoutFixed(260.0f));
+    loading.SetAxis(loading_row, LayoutAxis::Row);
+    loading.SetAlign(loading_row, LayoutAlign::Center, LayoutAlign::Start);
+    layouts.loading_card = loading.Add(loading_row, LayoutFixed(280.0f), LayoutFixed(260.0f));
+
+    Layout& main = layouts.main;
+    main.SetAxis(main.Root(), LayoutAxis::Row);
+    main.SetGap(main.Root(), item_spacing);
+    layouts.sidebar = main.Add(main.Root(), LayoutFixed(140.0f), LayoutFlex());
+    layouts.content_panel = main.Add(main.Root(), LayoutFlex(), LayoutFlex());
 }
 
-struct AppState {
-    ScreenState current = ScreenState::Login;
-    ScreenState target = ScreenState::Login;
-    float transition = 1.0f;
-    float transition_start = 0.0f;
-    float loading_progress = 0.0f;
-    float loading_start = 0.0f;
+static void ResolveScreenLayouts(ScreenLayouts& layouts, const ImVec2& content_size) {
+    layouts.login.Resolve(content_size);
+    layouts.loading.Resolve(content_size);
+    layouts.main.Resolve(content_size);
+}
 
-    char key_input[128] = "";
-    bool show_key = false;
-    bool remember_me = false;
-    bool verifying = false;
-    std::string status_text;
+static void StartTransition(AppState& state, ScreenState next) {
+    static const float kTransitionDuration = 0.35f;
+    state.target = next;
+    state.transition = 0.0f;
+    state.animator.Release(state.transition_tween);
+    state.transition_tween = state.animator.Start(0.0f, 1.0f, kTransitionDuration, Ease::InOutCubic,
+                                                  static_cast<float>(ImGui::GetTime()));
+}
 
-    std::mutex verify_mutex;
-    VerifyResult verify_result;
-    std::atomic<bool> verify_ready{false};
+// Progress bar fill, and the spinner phase in turns, looping until the
+// Loading screen is left.
+static void StartLoading(AppState& state) {
+    static const float kLoadingDuration = 2.5f;
+    static const float kSpinnerPeriod = kPi * 0.5f;
+    float now = static_cast<float>(ImGui::GetTime());
+    state.animator.Release(state.loading_tween);
+    state.animator.Release(state.spinner_tween);
+    state.loading_tween = state.animator.Start(0.0f, 1.0f, kLoadingDuration, Ease::Linear, now);
+    state.spinner_tween = state.animator.Start(0.0f, 1.0f, kSpinnerPeriod, Ease::Linear, now, true);
+}
 
-    std::wstring selected_path;
-    std::wstring selected_name;
-    PROCESS_INFORMATION target_process{};
-    bool has_process = false;
+// Applies this frame's tween values to the screen state.
+static void UpdateAnimations(AppState& state, float now) {
+    state.animator.Update(now);
+    if (state.transition_tween == kNoTween) return;
+    state.transition = state.animator.Value(state.transition_tween);
+    if (state.animator.Running(state.transition_tween)) return;
+    state.animator.Release(state.transition_tween);
+    state.transition = 1.0f;
+    state.current = state.target;
+    if (state.current != ScreenState::Loading) {
+        state.animator.Release(state.loading_tween);
+        state.animator.Release(state.spinner_tween);
+    }
+}
 
-    std::vector<Toast> toasts;
-};
+// Skips the Login screen when a remembered verification is still valid; the
+// scheduler confirms it online while the Loading screen runs.
+static void ResumeFromVerifyCache(AppState& state) {
+    VerifyCacheEntry cached;
+    int64_t now = UnixNow();
+    if (!VerifyCacheLoad(cached, now)) return;
+    LogWrite(LogEvent::VerifyCacheHit, cached.expires_at - now);
+    state.key_input = cached.key;
+    state.remember_me = true;
+    state.current = ScreenState::Loading;
+    state.target = ScreenState::Loading;
+    StartLoading(state);
+    state.revalidating = true;
+    state.verifier.Request(cached.key);
+}
 
-static void StartTransition(AppState& state, ScreenState next) {
-    state.target = next;
-    state.transition = 0.0f;
-    state.transition_start = static_cast<float>(ImGui::GetTime());
+// Only an explicit decline drops the saved verification. Offline, an
+// overloaded server or any other reply without a verdict leaves the cached
+// result in place until it expires on its own.
+static void FinishRevalidation(AppState& state, const VerifyResult& result) {
+    state.revalidating = false;
+    if (result.success) {
+        LogWrite(LogEvent::VerifyAccepted);
+        VerifyCacheStore(state.key_input, UnixNow(), result.expires_at);
+    } else if (!result.declined) {
+        AddToast(state, "Using saved verification (" + result.status_message + ")", ThemeColor::Neutral);
+    } else {
+        LogWrite(LogEvent::VerifyDeclined);
+        VerifyCacheClear();
+        state.status_text = "Saved key is no longer valid";
+        AddToast(state, state.status_text, ThemeColor::Danger);
+        StartTransition(state, ScreenState::Login);
+    }
 }
 
-static void DrawSpinner(ImDrawList* draw_list, const ImVec2& center, float radius, float thickness, float t) {
+static void DrawSpinner(ImDrawList* draw_list, const ImVec2& center, float radius, float thickness, float phase) {
     int num_segments = 30;
-    float start = t * 4.0f;
+    float start = phase * 2.0f * kPi;
     float end = start + kPi * 1.5f;
-    for (int i = 0; i < num_segments; ++i) {
-        float a0 = start + (end - start) * (static_cast<float>(i) / num_segments);
-        float a1 = start + (end - start) * (static_cast<float>(i + 1) / num_segments);
-        draw_list->PathLineTo(ImVec2(center.x + std::cos(a0) * radius, center.y + std::sin(a0) * radius));
-        draw_list->PathLineTo(ImVec2(center.x + std::cos(a1) * radius, center.y + std::sin(a1) * radius));
+    for (int i = 0; i <= num_segments; ++i) {
+        float a = start + (end - start) * (static_cast<float>(i) / num_segments);
+        draw_list->PathLineTo(ImVec2(center.x + std::cos(a) * radius, center.y + std::sin(a) * radius));
     }
-    draw_list->PathStroke(IM_COL32(120, 180, 255, 200), false, thickness);
+    draw_list->PathStroke(ThemeU32(ThemeColor::Graph), false, thickness);
 }
 
-static bool IsProcessRunning(const PROCESS_INFORMATION& pi) {
-    if (!pi.hProcess) return false;
-    DWORD wait = WaitForSingleObject(pi.hProcess, 0);
-    return wait == WAIT_TIMEOUT;
+// Re-reads the event log only when a record has been written since the last
+// read, so an idle log costs one atomic load per frame.
+static void DrawActivityLog(AppState& state) {
+    uint64_t sequence = EventLogSequence();
+    if (sequence != state.activity_sequence) {
+        state.activity_count = EventLogReadRecent(state.activity, IM_ARRAYSIZE(state.activity));
+        state.activity_sequence = sequence;
+    }
+    ImGui::BeginChild("activity_card", ImVec2(0, 0), true);
+    ImGui::TextColored(ThemeVec4(ThemeColor::Heading), "Activity");
+    ImGui::Separator();
+    char text[160];
+    for (size_t i = state.activity_count; i-- > 0;) {
+        const LogRecord& record = state.activity[i];
+        FormatLogRecord(record, text, sizeof(text));
+        ImGui::Text("%8.2fs  %s", static_cast<double>(record.time_ns) / 1e9, text);
+    }
+    ImGui::EndChild();
+}
+
+// Scrollable view of the captured output. The clipper asks the ring only for
+// the lines in view, however many it holds; while scrolled to the bottom the
+// view follows new output.
+static void DrawTargetOutput(AppState& state) {
+    std::vector<OutputLine>& lines = state.output_lines;
+    ImGui::BeginChild("output_card", ImVec2(0, 160), true);
+    ImGui::TextColored(ThemeVec4(ThemeColor::Heading), "Output");
+    const OutputRing& output = *state.target_output;
+    uint64_t dropped = output.DroppedLines();
+    if (dropped > 0) {
+        ImGui::SameLine();
+        ImGui::TextColored(ThemeVec4(ThemeColor::Muted), "(%llu earlier lines dropped)",
+                           static_cast<unsigned long long>(dropped));
+    }
+    ImGui::Separator();
+    ImGui::BeginChild("output_lines", ImVec2(0, 0), false);
+    bool follow = ImGui::GetScrollY() >= ImGui::GetScrollMaxY();
+    uint64_t first = output.FirstLine();
+    uint64_t end = output.EndLine();
+    ImGuiListClipper clipper;
+    clipper.Begin(static_cast<int>(end - first));
+    if (follow) {
+        // Scroll before the clipper picks rows, so new lines show this frame.
+        ImGui::SetScrollY(clipper.StartPosY + clipper.RowTop(clipper.ItemsCount) - ImGui::GetWindowSize().y);
+    }
+    while (clipper.Step()) {
+        size_t count = output.ReadLines(first + clipper.DisplayStart,
+                                        static_cast<size_t>(clipper.DisplayEnd - clipper.DisplayStart), lines);
+        for (size_t i = 0; i < count; ++i) {
+            if (lines[i].stream == OutputStream::Stderr) {
+                ImGui::TextColored(ThemeVec4(ThemeColor::DangerSoft), "%s", lines[i].text.c_str());
+            } else {
+                ImGui::Text("%s", lines[i].text.c_str());
+            }
+        }
+    }
+    ImGui::EndChild();
+    ImGui::EndChild();
 }
 
 static std::wstring GetFileNameFromPath(const std::wstring& path) {
@@ -293,34 +403,404 @@ static bool OpenExeDialog(std::wstring& out_path) {
     return false;
 }
 
-static bool LaunchTarget(const std::wstring& path, PROCESS_INFORMATION& out_pi) {
-    STARTUPINFOW si = {};
-    si.cb = sizeof(si);
-    PROCESS_INFORMATION pi = {};
-    std::wstring command = L"\"" + path + L"\"";
-    BOOL ok = CreateProcessW(nullptr, command.data(), nullptr, nullptr, FALSE, 0, nullptr, nullptr, &si, &pi);
-    if (ok) {
-        out_pi = pi;
-        return true;
+static void SelectTarget(AppState& state, const std::wstring& path) {
+    state.selected_path = path;
+    state.selected_name = GetFileNameFromPath(path);
+    state.recent.Touch(WideToUtf8(path), UnixNow());
+    state.fingerprints.Request(WideToUtf8(path));
+    state.fingerprint_check_time = static_cast<float>(ImGui::GetTime());
+    state.fingerprint_change_shown = false;
+}
+
+// Re-requests the selected target every few seconds; the service only stats
+// the file unless its size or mtime changed.
+static void DrawFingerprint(AppState& state, float now) {
+    static const float kRecheckInterval = 2.0f;
+    if (state.selected_path.empty()) return;
+    std::string path = WideToUtf8(state.selected_path);
+    if (now - state.fingerprint_check_time > kRecheckInterval) {
+        state.fingerprints.Request(path);
+        state.fingerprint_check_time = now;
+    }
+
+    FingerprintStatus status = state.fingerprints.Status();
+    if (status.path != path) {
+        ImGui::TextColored(ThemeVec4(ThemeColor::Muted), "Fingerprint: pending");
+        return;
+    }
+    if (status.state == FingerprintState::Hashing) {
+        float fraction = status.size ? static_cast<float>(static_cast<double>(status.bytes_done) / status.size) : 0.0f;
+        ImGui::TextColored(ThemeVec4(ThemeColor::Muted), "Fingerprint: hashing %.0f%%", fraction * 100.0f);
+        ImGui::ProgressBar(fraction, ImVec2(-1, 4));
+    } else if (status.state == FingerprintState::Failed) {
+        ImGui::TextColored(ThemeVec4(ThemeColor::Danger), "Fingerprint: file unavailable");
+    } else if (status.changed) {
+        ImGui::TextColored(ThemeVec4(ThemeColor::Warning), "Fingerprint: %016llx (updated on disk)",
+                           static_cast<unsigned long long>(status.hash));
+        if (!state.fingerprint_change_shown) {
+            AddToast(state, "Target was updated on disk", ThemeColor::Warning);
+            state.fingerprint_change_shown = true;
+        }
+    } else {
+        ImGui::Text("Fingerprint: %016llx", static_cast<unsigned long long>(status.hash));
+    }
+}
+
+// Metadata comes from the index; the files themselves are only read by the
+// RecentTargets worker.
+static std::string FormatPeVersion(const PeMetadata& meta) {
+    if (!meta.has_version) return "-";
+    return std::to_string(meta.version[0]) + "." + std::to_string(meta.version[1]) + "." +
+           std::to_string(meta.version[2]) + "." + std::to_string(meta.version[3]);
+}
+
+// Three-way comparison of two recent targets on a table column.
+static int CompareRecentTargets(const RecentTarget& a, const RecentTarget& b, int column) {
+    switch (column) {
+    case 0: {
+        std::wstring name_a = GetFileNameFromPath(Utf8ToWide(a.path));
+        std::wstring name_b = GetFileNameFromPath(Utf8ToWide(b.path));
+        return _wcsicmp(name_a.c_str(), name_b.c_str());
+    }
+    case 1:
+        return strcmp(PeMachineName(a.meta.machine), PeMachineName(b.meta.machine));
+    case 2:
+        for (int i = 0; i < 4; ++i) {
+            if (a.meta.version[i] != b.meta.version[i]) return a.meta.version[i] < b.meta.version[i] ? -1 : 1;
+        }
+        return 0;
+    default:
+        return a.size < b.size ? -1 : (a.size > b.size ? 1 : 0);
+    }
+}
+
+// Metadata comes from the index; the files themselves are only read by the
+// RecentTargets worker. Sorting runs on the row sorter against an immutable
+// copy of the list, and the table keeps showing the previous order until the
+// new one is swapped in.
+static void DrawRecentTargets(AppState& state) {
+    static const int kRecentIconSize = 16;
+    bool changed = state.recent.Snapshot(state.recent_list, state.recent_version);
+    ImGui::BeginChild("recent_card", ImVec2(0, 150), true);
+    ImGui::TextColored(ThemeVec4(ThemeColor::Heading), "Recent");
+    ImGui::Separator();
+    if (state.recent_list.empty()) {
+        ImGui::TextColored(ThemeVec4(ThemeColor::Muted), "No recent targets");
+    }
+
+    std::wstring picked;
+    if (!state.recent_list.empty() && ImGui::BeginTable("recent_table", 4, ImGuiTableFlags_Sortable | ImGuiTableFlags_ScrollY)) {
+        ImGui::TableSetupColumn("Name", ImGuiTableColumnFlags_WidthStretch);
+        ImGui::TableSetupColumn("Arch", ImGuiTableColumnFlags_WidthFixed, 60.0f);
+        ImGui::TableSetupColumn("Version", ImGuiTableColumnFlags_WidthFixed, 90.0f);
+        ImGui::TableSetupColumn("Size", ImGuiTableColumnFlags_WidthFixed, 70.0f);
+        ImGui::TableHeadersRow();
+
+        ImGuiTableSortSpecs* specs = ImGui::TableGetSortSpecs();
+        if (specs && (specs->SpecsDirty || changed)) {
+            auto rows = std::make_shared<const std::vector<RecentTarget>>(state.recent_list);
+            int column = specs->Specs->ColumnIndex;
+            bool ascending = specs->Specs->SortDirection == ImGuiSortDirection_Ascending;
+            state.recent_sorting = rows;
+            state.recent_sorter.Sort(static_cast<uint32_t>(rows->size()), [rows, column, ascending](uint32_t a, uint32_t b) {
+                int order = CompareRecentTargets((*rows)[a], (*rows)[b], column);
+                return ascending ? order < 0 : order > 0;
+            });
+            specs->SpecsDirty = false;
+        }
+        if (state.recent_sorter.Poll()) {
+            state.recent_rows = state.recent_sorting;
+        }
+
+        if (state.recent_rows) {
+            const std::vector<RecentTarget>& rows = *state.recent_rows;
+            ImGuiListClipper clipper;
+            clipper.Begin(static_cast<int>(rows.size()));
+            while (clipper.Step()) {
+                for (int i = clipper.DisplayStart; i < clipper.DisplayEnd; ++i) {
+                    const RecentTarget& target = rows[state.recent_sorter.Row(static_cast<uint32_t>(i))];
+                    std::wstring path = Utf8ToWide(target.path);
+                    ImGui::TableNextRow();
+                    ImGui::TableNextColumn();
+                    ImVec2 icon_pos = ImGui::GetCursorScreenPos();
+                    state.images.Draw(ImGui::GetWindowDrawList(), state.images.Request(target.path, kRecentIconSize),
+                                      icon_pos, ImVec2(icon_pos.x + kRecentIconSize, icon_pos.y + kRecentIconSize));
+                    ImGui::Dummy(ImVec2(kRecentIconSize, kRecentIconSize));
+                    ImGui::SameLine();
+                    std::string label = WideToUtf8(GetFileNameFromPath(path)) + "##recent" + std::to_string(i);
+                    if (ImGui::Button(label.c_str(), ImVec2(-1, 0))) {
+                        picked = path;
+                    }
+                    ImGui::TableNextColumn();
+                    if (!target.scanned) {
+                        ImGui::TextColored(ThemeVec4(ThemeColor::Muted), "...");
+                        continue;
+                    }
+                    if (!target.is_pe) {
+                        ImGui::TextColored(ThemeVec4(ThemeColor::Caution), "not PE");
+                        continue;
+                    }
+                    ImGui::Text("%s", PeMachineName(target.meta.machine));
+                    ImGui::TableNextColumn();
+                    ImGui::Text("%s", FormatPeVersion(target.meta).c_str());
+                    ImGui::TableNextColumn();
+                    ImGui::Text("%.1f MB", static_cast<double>(target.size) / (1024.0 * 1024.0));
+                }
+            }
+        }
+        ImGui::EndTable();
+    }
+    ImGui::EndChild();
+    if (!picked.empty()) {
+        SelectTarget(state, picked);
     }
-    return false;
 }
 
-static void DrawTitleBar(HWND hwnd, const ImVec2& window_pos, const ImVec2& window_size, const ImVec4& accent) {
-    ImDrawList* draw_list = ImGui::GetWindowDrawList();
+// Queues a launch of |path|. A capturing launch takes over the output pane
+// with a ring of its own. Earlier launches keep draining into their own
+// rings, so their children never see a closed pipe, and launches still
+// queued or spawning never write into the pane.
+static void SubmitLaunch(AppState& state, const std::string& label, const std::string& path,
+                         const ChildLaunchOptions& options) {
+    LaunchRequest request;
+    request.label = label;
+    request.path = path;
+    request.options = options;
+    if (options.capture_output) {
+        state.target_output = std::make_shared<OutputRing>();
+        request.output = state.target_output;
+    }
+    state.launches.Submit(request);
+}
+
+// Collects finished launches and notices exits. Runs once per frame; the
+// process handles are only polled, never waited on.
+static void UpdateLaunches(AppState& state) {
+    static const size_t kMaxLaunchedTargets = 16;
+    std::vector<LaunchResult> results;
+    if (state.launches.Poll(results)) {
+        for (LaunchResult& result : results) {
+            if (result.ok) {
+                LogWrite(LogEvent::LaunchSucceeded, result.process->Pid(),
+                         static_cast<int64_t>(result.spawn_ms * 1000.0));
+            } else {
+                LogWrite(LogEvent::LaunchFailed, result.process->LastError());
+                AddToast(state, "Failed to launch " + result.label, ThemeColor::Danger);
+            }
+            LaunchedTarget target;
+            target.launch = std::move(result);
+            state.launched.push_back(std::move(target));
+        }
+        // Drop the oldest finished entries first. Releasing a running one
+        // frees its ring; the child keeps running and its output is
+        // discarded.
+        while (state.launched.size() > kMaxLaunchedTargets) {
+            size_t victim = 0;
+            for (size_t i = 0; i < state.launched.size(); ++i) {
+                if (!state.launched[i].launch.process->Running()) {
+                    victim = i;
+                    break;
+                }
+            }
+            state.launched.erase(state.launched.begin() + victim);
+        }
+    }
+    for (LaunchedTarget& target : state.launched) {
+        int exit_code = 0;
+        if (!target.exit_logged && target.launch.ok && target.launch.process->ExitCode(exit_code)) {
+            LogWrite(LogEvent::ProcessExited, target.launch.process->Pid(), exit_code);
+            target.exit_logged = true;
+        }
+    }
+}
+
+// Options from the launch editor fields.
+static ChildLaunchOptions CurrentLaunchOptions(const AppState& state) {
+    ChildLaunchOptions options;
+    options.arguments = state.launch_args;
+    options.working_dir = state.launch_cwd;
+    options.environment = state.launch_env;
+    options.capture_output = state.capture_output;
+    return options;
+}
+
+static void LoadProfileIntoEditor(AppState& state, const LaunchProfile& profile) {
+    state.profile_name = profile.name;
+    state.launch_args = profile.options.arguments;
+    state.launch_cwd = profile.options.working_dir;
+    state.launch_env = profile.options.environment;
+    state.capture_output = profile.options.capture_output;
+    SelectTarget(state, Utf8ToWide(profile.path));
+}
+
+// Saves the editor fields for the selected target, replacing a profile of
+// the same name.
+static void SaveCurrentProfile(AppState& state) {
+    if (state.selected_path.empty()) return;
+    LaunchProfile profile;
+    profile.name = !state.profile_name.empty() ? state.profile_name : WideToUtf8(state.selected_name);
+    profile.path = WideToUtf8(state.selected_path);
+    profile.options = CurrentLaunchOptions(state);
+    bool replaced = false;
+    for (LaunchProfile& existing : state.profiles) {
+        if (existing.name == profile.name) {
+            existing = profile;
+            replaced = true;
+            break;
+        }
+    }
+    if (!replaced) {
+        if (state.profiles.size() >= kMaxLaunchProfiles) {
+            AddToast(state, "Too many profiles", ThemeColor::Warning);
+            return;
+        }
+        state.profiles.push_back(profile);
+    }
+    if (SaveLaunchProfiles(state.profiles)) {
+        AddToast(state, "Saved profile " + profile.name, ThemeColor::Success);
+    } else {
+        AddToast(state, "Failed to save profiles", ThemeColor::Danger);
+    }
+}
+
+static void DrawLaunchProfiles(AppState& state) {
+    ImGui::BeginChild("profiles_card", ImVec2(0, 230), true);
+    ImGui::TextColored(ThemeVec4(ThemeColor::Heading), "Launch options");
+    ImGui::Separator();
+    ImGui::InputText("Profile name", &state.profile_name);
+    ImGui::InputText("Arguments", &state.launch_args);
+    ImGui::InputText("Working dir", &state.launch_cwd);
+    ImGui::InputText("##env_entry", &state.env_entry);
+    ImGui::SameLine();
+    if (ImGui::Button("Add NAME=value")) {
+        size_t eq = state.env_entry.find('=');
+        if (eq != std::string::npos && eq > 0) {
+            EnvOverride entry;
+            entry.name = state.env_entry.substr(0, eq);
+            entry.value = state.env_entry.substr(eq + 1);
+            state.launch_env.push_back(entry);
+            state.env_entry.clear();
+        }
+    }
+    int removed_env = -1;
+    for (size_t i = 0; i < state.launch_env.size(); ++i) {
+        const EnvOverride& entry = state.launch_env[i];
+        if (entry.value.empty()) {
+            ImGui::TextColored(ThemeVec4(ThemeColor::Muted), "unset %s", entry.name.c_str());
+        } else {
+            ImGui::Text("%s=%s", entry.name.c_str(), entry.value.c_str());
+        }
+        ImGui::SameLine();
+        if (ImGui::Button(("x##env" + std::to_string(i)).c_str())) removed_env = static_cast<int>(i);
+    }
+    if (removed_env >= 0) state.launch_env.erase(state.launch_env.begin() + removed_env);
+    if (ImGui::Button("Save profile", ImVec2(120, 0))) {
+        SaveCurrentProfile(state);
+    }
+    ImGui::SameLine();
+    if (ImGui::Button("Launch all", ImVec2(120, 0))) {
+        for (const LaunchProfile& profile : state.profiles) {
+            SubmitLaunch(state, profile.name, profile.path, profile.options);
+        }
+    }
+    ImGui::SameLine();
+    int concurrency = state.launches.Concurrency();
+    if (ImGui::Button("-##concurrency")) state.launches.SetConcurrency(concurrency - 1);
+    ImGui::SameLine();
+    ImGui::Text("%d at once", concurrency);
+    ImGui::SameLine();
+    if (ImGui::Button("+##concurrency")) state.launches.SetConcurrency(concurrency + 1);
+
+    int removed = -1;
+    if (!state.profiles.empty() && ImGui::BeginTable("profiles_table", 3, ImGuiTableFlags_ScrollY)) {
+        ImGui::TableSetupColumn("Profile", ImGuiTableColumnFlags_WidthStretch);
+        ImGui::TableSetupColumn("Arguments", ImGuiTableColumnFlags_WidthStretch);
+        ImGui::TableSetupColumn("", ImGuiTableColumnFlags_WidthFixed, 170.0f);
+        ImGui::TableHeadersRow();
+        for (size_t i = 0; i < state.profiles.size(); ++i) {
+            const LaunchProfile& profile = state.profiles[i];
+            std::string suffix = "##profile" + std::to_string(i);
+            ImGui::TableNextRow();
+            ImGui::TableNextColumn();
+            ImGui::Text("%s", profile.name.c_str());
+            ImGui::TableNextColumn();
+            ImGui::TextColored(ThemeVec4(ThemeColor::Muted), "%s", profile.options.arguments.c_str());
+            ImGui::TableNextColumn();
+            if (ImGui::Button(("Launch" + suffix).c_str())) {
+                SubmitLaunch(state, profile.name, profile.path, profile.options);
+            }
+            ImGui::SameLine();
+            if (ImGui::Button(("Edit" + suffix).c_str())) {
+                LoadProfileIntoEditor(state, profile);
+            }
+            ImGui::SameLine();
+            if (ImGui::Button(("Delete" + suffix).c_str())) removed = static_cast<int>(i);
+        }
+        ImGui::EndTable();
+    }
+    if (removed >= 0) {
+        state.profiles.erase(state.profiles.begin() + removed);
+        SaveLaunchProfiles(state.profiles);
+    }
+    ImGui::EndChild();
+}
+
+static void DrawLaunches(AppState& state) {
+    if (state.launched.empty()) return;
+    ImGui::BeginChild("launches_card", ImVec2(0, 150), true);
+    ImGui::TextColored(ThemeVec4(ThemeColor::Heading), "Launches");
+    ImGui::Separator();
+    if (ImGui::BeginTable("launches_table", 5, ImGuiTableFlags_ScrollY)) {
+        ImGui::TableSetupColumn("Name", ImGuiTableColumnFlags_WidthStretch);
+        ImGui::TableSetupColumn("PID", ImGuiTableColumnFlags_WidthFixed, 70.0f);
+        ImGui::TableSetupColumn("Status", ImGuiTableColumnFlags_WidthFixed, 110.0f);
+        ImGui::TableSetupColumn("Queued", ImGuiTableColumnFlags_WidthFixed, 70.0f);
+        ImGui::TableSetupColumn("Spawn", ImGuiTableColumnFlags_WidthFixed, 70.0f);
+        ImGui::TableHeadersRow();
+        // Newest first.
+        for (size_t i = state.launched.size(); i-- > 0;) {
+            const LaunchResult& launch = state.launched[i].launch;
+            ChildProcess& process = *launch.process;
+            ImGui::TableNextRow();
+            ImGui::TableNextColumn();
+            ImGui::Text("%s", launch.label.c_str());
+            ImGui::TableNextColumn();
+            if (launch.ok) {
+                ImGui::Text("%u", process.Pid());
+            }
+            ImGui::TableNextColumn();
+            int exit_code = 0;
+            if (!launch.ok) {
+                ImGui::TextColored(ThemeVec4(ThemeColor::Danger), "Error %u", process.LastError());
+            } else if (process.ExitCode(exit_code)) {
+                ImGui::TextColored(ThemeVec4(ThemeColor::Muted), "Exited (%d)", exit_code);
+            } else {
+                ImGui::TextColored(ThemeVec4(ThemeColor::Success), "Running");
+            }
+            ImGui::TableNextColumn();
+            ImGui::Text("%.1f ms", launch.queued_ms);
+            ImGui::TableNextColumn();
+            ImGui::Text("%.1f ms", launch.spawn_ms);
+        }
+        ImGui::EndTable();
+    }
+    ImGui::EndChild();
+}
+
+static void DrawTitleBar(ParallelDrawLists& draw_lists, HWND hwnd, const ImVec2& window_pos, const ImVec2& window_size) {
     ImVec2 title_pos = window_pos;
     ImVec2 title_size(window_size.x, 48.0f);
-    draw_list->AddRectFilled(title_pos, ImVec2(title_pos.x + title_size.x, title_pos.y + title_size.y),
-                             IM_COL32(15, 18, 24, 255), 12.0f, ImDrawFlags_RoundCornersTop);
-    draw_list->AddText(ImVec2(title_pos.x + 18.0f, title_pos.y + 14.0f),
-                       IM_COL32(200, 230, 255, 255), "LITHIUM.RIP");
-    draw_list->AddCircleFilled(ImVec2(title_pos.x + 6.0f, title_pos.y + 22.0f), 6.0f,
-                               ImGui::ColorConvertFloat4ToU32(accent));
+    ImU32 bar_col = ThemeU32(ThemeColor::TitleBar);
+    ImU32 text_col = ThemeU32(ThemeColor::TitleText);
+    ImU32 accent_col = ThemeU32(ThemeColor::Accent);
+    draw_lists.Record(ImGui::GetWindowDrawList(), [title_pos, title_size, bar_col, text_col, accent_col](ImDrawList* draw_list) {
+        draw_list->AddRectFilled(title_pos, ImVec2(title_pos.x + title_size.x, title_pos.y + title_size.y),
+                                 bar_col, 12.0f, ImDrawFlags_RoundCornersTop);
+        draw_list->AddText(ImVec2(title_pos.x + 18.0f, title_pos.y + 14.0f), text_col, "LITHIUM.RIP");
+        draw_list->AddCircleFilled(ImVec2(title_pos.x + 6.0f, title_pos.y + 22.0f), 6.0f, accent_col);
+    });
 
     ImGui::SetCursorScreenPos(ImVec2(title_pos.x + window_size.x - 60.0f, title_pos.y + 12.0f));
-    ImGui::PushStyleColor(ImGuiCol_Button, IM_COL32(45, 50, 60, 255));
-    ImGui::PushStyleColor(ImGuiCol_ButtonHovered, IM_COL32(70, 80, 95, 255));
-    ImGui::PushStyleColor(ImGuiCol_ButtonActive, IM_COL32(90, 100, 115, 255));
     if (ImGui::Button("-", ImVec2(20, 20))) {
         ShowWindow(hwnd, SW_MINIMIZE);
     }
@@ -328,7 +808,6 @@ static void DrawTitleBar(HWND hwnd, const ImVec2& window_pos, const ImVec2& wind
     if (ImGui::Button("x", ImVec2(20, 20))) {
         PostMessage(hwnd, WM_CLOSE, 0, 0);
     }
-    ImGui::PopStyleColor(3);
 
     ImGui::SetCursorScreenPos(title_pos);
     ImGui::InvisibleButton("titlebar_drag", title_size);
@@ -338,12 +817,11 @@ static void DrawTitleBar(HWND hwnd, const ImVec2& window_pos, const ImVec2& wind
     }
 }
 
-static void DrawBackgroundGradient(const ImVec2& pos, const ImVec2& size) {
-    ImDrawList* draw_list = ImGui::GetWindowDrawList();
-    ImU32 col_top = IM_COL32(10, 12, 18, 255);
-    ImU32 col_bottom = IM_COL32(5, 8, 12, 255);
+static void DrawBackgroundGradient(ImDrawList* draw_list, const ImVec2& pos, const ImVec2& size, float rounding) {
+    ImU32 col_top = ThemeU32(ThemeColor::BackgroundTop);
+    ImU32 col_bottom = ThemeU32(ThemeColor::BackgroundBottom);
     draw_list->AddRectFilledMultiColor(pos, ImVec2(pos.x + size.x, pos.y + size.y),
-                                       col_top, col_top, col_bottom, col_bottom);
+                                       col_top, col_top, col_bottom, col_bottom, rounding);
 }
 
 // DirectX/Win32 globals.
@@ -352,6 +830,69 @@ static ID3D11DeviceContext* g_pd3dDeviceContext = nullptr;
 static IDXGISwapChain* g_pSwapChain = nullptr;
 static ID3D11RenderTargetView* g_mainRenderTargetView = nullptr;
 static HWND g_hWnd = nullptr;
+static ID3D11Texture2D* g_imageAtlasTexture = nullptr;
+static ID3D11ShaderResourceView* g_imageAtlasView = nullptr;
+// Present1() with dirty rects and ClearView() need the flip model and the
+// 11.1 runtime; without them every frame is redrawn in full.
+static IDXGISwapChain1* g_pSwapChain1 = nullptr;
+static ID3D11DeviceContext1* g_pd3dDeviceContext1 = nullptr;
+static const int kSwapChainBuffers = 2;
+static DamageTracker g_damage;
+
+// CPU path, used with --software or when no Direct3D 11 device can be
+// created. The framebuffer is a DIB section blitted to the window.
+static bool g_softwareRendering = false;
+static SoftwareRenderer g_softwareRenderer;
+static SoftwareTarget g_softwareTarget;
+static HDC g_softwareDc = nullptr;
+static HBITMAP g_softwareBitmap = nullptr;
+static HGDIOBJ g_softwareOldBitmap = nullptr;
+
+// Creates the atlas texture on first use, then uploads only the rows the
+// cache changed since the last frame.
+static void UploadImageAtlas(ImageCache& images) {
+    int size = images.AtlasSize();
+    int y_begin = 0;
+    int y_end = 0;
+    if (g_softwareRendering) {
+        // The rasterizer samples the cache's pixels directly; any pointer
+        // unique to the atlas serves as its texture id.
+        ImTextureID id = const_cast<uint8_t*>(images.AtlasPixels());
+        g_softwareRenderer.SetTexture(id, images.AtlasPixels(), size, size);
+        images.SetTextureId(id);
+        if (images.TakeDirtyRows(y_begin, y_end)) g_damage.Invalidate();
+        return;
+    }
+    if (!g_imageAtlasTexture) {
+        D3D11_TEXTURE2D_DESC desc = {};
+        desc.Width = static_cast<UINT>(size);
+        desc.Height = static_cast<UINT>(size);
+        desc.MipLevels = 1;
+        desc.ArraySize = 1;
+        desc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
+        desc.SampleDesc.Count = 1;
+        desc.Usage = D3D11_USAGE_DEFAULT;
+        desc.BindFlags = D3D11_BIND_SHADER_RESOURCE;
+        D3D11_SUBRESOURCE_DATA initial = {};
+        initial.pSysMem = images.AtlasPixels();
+        initial.SysMemPitch = static_cast<UINT>(size * 4);
+        if (FAILED(g_pd3dDevice->CreateTexture2D(&desc, &initial, &g_imageAtlasTexture))) return;
+        if (FAILED(g_pd3dDevice->CreateShaderResourceView(g_imageAtlasTexture, nullptr, &g_imageAtlasView))) {
+            g_imageAtlasTexture->Release();
+            g_imageAtlasTexture = nullptr;
+            return;
+        }
+        images.SetTextureId(static_cast<ImTextureID>(g_imageAtlasView));
+        images.TakeDirtyRows(y_begin, y_end);
+        return;
+    }
+    if (!images.TakeDirtyRows(y_begin, y_end)) return;
+    // Images drawn with unchanged geometry now sample new pixels.
+    g_damage.Invalidate();
+    D3D11_BOX box = { 0, static_cast<UINT>(y_begin), 0, static_cast<UINT>(size), static_cast<UINT>(y_end), 1 };
+    const uint8_t* rows = images.AtlasPixels() + static_cast<size_t>(y_begin) * size * 4;
+    g_pd3dDeviceContext->UpdateSubresource(g_imageAtlasTexture, 0, &box, rows, static_cast<UINT>(size * 4), 0);
+}
 
 static void CreateRenderTarget() {
     ID3D11Texture2D* pBackBuffer = nullptr;
@@ -369,7 +910,7 @@ static void CleanupRenderTarget() {
 
 static bool CreateDeviceD3D(HWND hWnd) {
     DXGI_SWAP_CHAIN_DESC sd = {};
-    sd.BufferCount = 2;
+    sd.BufferCount = kSwapChainBuffers;
     sd.BufferDesc.Width = 0;
     sd.BufferDesc.Height = 0;
     sd.BufferDesc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
@@ -381,24 +922,163 @@ static bool CreateDeviceD3D(HWND hWnd) {
     sd.SampleDesc.Count = 1;
     sd.SampleDesc.Quality = 0;
     sd.Windowed = TRUE;
-    sd.SwapEffect = DXGI_SWAP_EFFECT_DISCARD;
+    sd.SwapEffect = DXGI_SWAP_EFFECT_FLIP_SEQUENTIAL;
 
     UINT createDeviceFlags = 0;
     D3D_FEATURE_LEVEL featureLevel;
     const D3D_FEATURE_LEVEL featureLevelArray[1] = { D3D_FEATURE_LEVEL_11_0 };
-    if (D3D11CreateDeviceAndSwapChain(nullptr, D3D_DRIVER_TYPE_HARDWARE, nullptr,
-                                     createDeviceFlags, featureLevelArray, 1,
-                                     D3D11_SDK_VERSION, &sd, &g_pSwapChain,
-                                     &g_pd3dDevice, &featureLevel, &g_pd3dDeviceContext) != S_OK) {
-        return false;
+    HRESULT hr = D3D11CreateDeviceAndSwapChain(nullptr, D3D_DRIVER_TYPE_HARDWARE, nullptr,
+                                               createDeviceFlags, featureLevelArray, 1,
+                                               D3D11_SDK_VERSION, &sd, &g_pSwapChain,
+                                               &g_pd3dDevice, &featureLevel, &g_pd3dDeviceContext);
+    if (hr != S_OK) {
+        // The flip model needs Windows 8; older systems redraw in full.
+        sd.SwapEffect = DXGI_SWAP_EFFECT_DISCARD;
+        hr = D3D11CreateDeviceAndSwapChain(nullptr, D3D_DRIVER_TYPE_HARDWARE, nullptr,
+                                           createDeviceFlags, featureLevelArray, 1,
+                                           D3D11_SDK_VERSION, &sd, &g_pSwapChain,
+                                           &g_pd3dDevice, &featureLevel, &g_pd3dDeviceContext);
+        if (hr != S_OK) return false;
+    } else {
+        g_pSwapChain->QueryInterface(IID_PPV_ARGS(&g_pSwapChain1));
+        g_pd3dDeviceContext->QueryInterface(IID_PPV_ARGS(&g_pd3dDeviceContext1));
     }
 
     CreateRenderTarget();
     return true;
 }
 
+// (Re)creates the DIB section the software renderer draws into, sized to
+// the client area.
+static void CreateSoftwareFramebuffer(HWND hWnd) {
+    RECT client = {};
+    GetClientRect(hWnd, &client);
+    int width = client.right - client.left;
+    int height = client.bottom - client.top;
+    if (width <= 0 || height <= 0) return;
+    if (!g_softwareDc) g_softwareDc = CreateCompatibleDC(nullptr);
+    if (g_softwareBitmap) {
+        SelectObject(g_softwareDc, g_softwareOldBitmap);
+        DeleteObject(g_softwareBitmap);
+        g_softwareBitmap = nullptr;
+    }
+    BITMAPINFO bmi = {};
+    bmi.bmiHeader.biSize = sizeof(bmi.bmiHeader);
+    bmi.bmiHeader.biWidth = width;
+    bmi.bmiHeader.biHeight = -height;  // Top-down rows.
+    bmi.bmiHeader.biPlanes = 1;
+    bmi.bmiHeader.biBitCount = 32;
+    bmi.bmiHeader.biCompression = BI_RGB;
+    void* bits = nullptr;
+    g_softwareBitmap = CreateDIBSection(g_softwareDc, &bmi, DIB_RGB_COLORS, &bits, nullptr, 0);
+    g_softwareTarget = SoftwareTarget();
+    if (!g_softwareBitmap) return;
+    g_softwareOldBitmap = SelectObject(g_softwareDc, g_softwareBitmap);
+    g_softwareTarget.pixels = static_cast<uint32_t*>(bits);
+    g_softwareTarget.width = width;
+    g_softwareTarget.height = height;
+    g_softwareTarget.pitch = width;
+    g_damage.Invalidate();
+}
+
+static void CleanupSoftwareFramebuffer() {
+    if (g_softwareBitmap) {
+        SelectObject(g_softwareDc, g_softwareOldBitmap);
+        DeleteObject(g_softwareBitmap);
+        g_softwareBitmap = nullptr;
+    }
+    if (g_softwareDc) {
+        DeleteDC(g_softwareDc);
+        g_softwareDc = nullptr;
+    }
+    g_softwareTarget = SoftwareTarget();
+}
+
+// Redraws only the damaged parts of the back buffer and presents them as a
+// dirty rect. A frame without changes is neither drawn nor presented.
+static void RenderFrameD3D(ImDrawData* draw_data) {
+    if (!g_damage.HasChanges()) return;
+    bool partial = g_pSwapChain1 && g_pd3dDeviceContext1;
+    // Flip-model back buffers still hold the frame from kSwapChainBuffers
+    // presents ago.
+    const std::vector<DamageRect>& damage = g_damage.Damage(partial ? kSwapChainBuffers : 0);
+    const ImVec4& clear_color = ThemeVec4(ThemeColor::Clear);
+    const float clear_color_with_alpha[4] = { clear_color.x, clear_color.y, clear_color.z, clear_color.w };
+    g_pd3dDeviceContext->OMSetRenderTargets(1, &g_mainRenderTargetView, nullptr);
+
+    DamageRect bounds = DamageTracker::Bounds(damage);
+    bool full = bounds.x0 == 0 && bounds.y0 == 0 && bounds.x1 >= g_damage.Width() && bounds.y1 >= g_damage.Height();
+    if (!partial || full) {
+        g_pd3dDeviceContext->ClearRenderTargetView(g_mainRenderTargetView, clear_color_with_alpha);
+        ImGui_ImplDX11_RenderDrawData(draw_data);
+        if (g_pSwapChain1) {
+            DXGI_PRESENT_PARAMETERS params = {};
+            g_pSwapChain1->Present1(1, 0, &params);
+        } else {
+            g_pSwapChain->Present(1, 0);
+        }
+        g_damage.Presented();
+        return;
+    }
+
+    // One pass over the damage bounding box: commands are clipped to it, and
+    // the backend skips those left with an empty clip rect. Clearing and
+    // presenting the same box keeps every redrawn pixel starting from the
+    // clear color, so translucent geometry is never blended twice.
+    RECT rect = { bounds.x0, bounds.y0, bounds.x1, bounds.y1 };
+    g_pd3dDeviceContext1->ClearView(g_mainRenderTargetView, clear_color_with_alpha, &rect, 1);
+    ImVec4 scissor(draw_data->DisplayPos.x + bounds.x0, draw_data->DisplayPos.y + bounds.y0,
+                   draw_data->DisplayPos.x + bounds.x1, draw_data->DisplayPos.y + bounds.y1);
+    for (int n = 0; n < draw_data->CmdLists.Size; ++n) {
+        for (ImDrawCmd& cmd : draw_data->CmdLists[n]->CmdBuffer) {
+            if (cmd.ClipRect.x < scissor.x) cmd.ClipRect.x = scissor.x;
+            if (cmd.ClipRect.y < scissor.y) cmd.ClipRect.y = scissor.y;
+            if (cmd.ClipRect.z > scissor.z) cmd.ClipRect.z = scissor.z;
+            if (cmd.ClipRect.w > scissor.w) cmd.ClipRect.w = scissor.w;
+        }
+    }
+    ImGui_ImplDX11_RenderDrawData(draw_data);
+    DXGI_PRESENT_PARAMETERS params = {};
+    params.DirtyRectsCount = 1;
+    params.pDirtyRects = &rect;
+    g_pSwapChain1->Present1(1, 0, &params);
+    g_damage.Presented();
+}
+
+static void RenderFrameSoftware(ImDrawData* draw_data) {
+    if (!g_softwareTarget.pixels || !g_damage.HasChanges()) return;
+    const std::vector<DamageRect>& damage = g_damage.Damage(1);
+    {
+        TRACE_SCOPE("frame.software_raster");
+        g_softwareRenderer.Render(draw_data, g_softwareTarget, damage.data(), static_cast<int>(damage.size()),
+                                  ThemeU32(ThemeColor::Clear));
+    }
+    HDC dc = GetDC(g_hWnd);
+    for (const DamageRect& r : damage) {
+        BitBlt(dc, r.x0, r.y0, r.x1 - r.x0, r.y1 - r.y0, g_softwareDc, r.x0, r.y0, SRCCOPY);
+    }
+    ReleaseDC(g_hWnd, dc);
+    g_damage.Presented();
+}
+
 static void CleanupDeviceD3D() {
     CleanupRenderTarget();
+    if (g_pSwapChain1) {
+        g_pSwapChain1->Release();
+        g_pSwapChain1 = nullptr;
+    }
+    if (g_pd3dDeviceContext1) {
+        g_pd3dDeviceContext1->Release();
+        g_pd3dDeviceContext1 = nullptr;
+    }
+    if (g_imageAtlasView) {
+        g_imageAtlasView->Release();
+        g_imageAtlasView = nullptr;
+    }
+    if (g_imageAtlasTexture) {
+        g_imageAtlasTexture->Release();
+        g_imageAtlasTexture = nullptr;
+    }
     if (g_pSwapChain) {
         g_pSwapChain->Release();
         g_pSwapChain = nullptr;
@@ -421,12 +1101,27 @@ static LRESULT WINAPI WndProc(HWND hWnd, UINT msg, WPARAM wParam, LPARAM lParam)
 
     switch (msg) {
     case WM_SIZE:
-        if (g_pd3dDevice != nullptr && wParam != SIZE_MINIMIZED) {
+        if (wParam == SIZE_MINIMIZED) return 0;
+        if (g_softwareRendering) {
+            CreateSoftwareFramebuffer(hWnd);
+        } else if (g_pd3dDevice != nullptr) {
             CleanupRenderTarget();
             g_pSwapChain->ResizeBuffers(0, (UINT)LOWORD(lParam), (UINT)HIWORD(lParam), DXGI_FORMAT_UNKNOWN, 0);
             CreateRenderTarget();
+            g_damage.Invalidate();
         }
         return 0;
+    case WM_PAINT:
+        if (g_softwareRendering && g_softwareDc) {
+            // Uncovered parts come straight from the framebuffer.
+            PAINTSTRUCT ps;
+            HDC dc = BeginPaint(hWnd, &ps);
+            BitBlt(dc, ps.rcPaint.left, ps.rcPaint.top, ps.rcPaint.right - ps.rcPaint.left,
+                   ps.rcPaint.bottom - ps.rcPaint.top, g_softwareDc, ps.rcPaint.left, ps.rcPaint.top, SRCCOPY);
+            EndPaint(hWnd, &ps);
+            return 0;
+        }
+        break;
     case WM_SYSCOMMAND:
         if ((wParam & 0xfff0) == SC_KEYMENU) // Disable ALT application menu
             return 0;
@@ -438,7 +1133,46 @@ static LRESULT WINAPI WndProc(HWND hWnd, UINT msg, WPARAM wParam, LPARAM lParam)
     return DefWindowProc(hWnd, msg, wParam, lParam);
 }
 
+static bool HasCommandLineSwitch(const wchar_t* name) {
+    int argc = 0;
+    LPWSTR* argv = CommandLineToArgvW(GetCommandLineW(), &argc);
+    if (!argv) return false;
+    bool found = false;
+    for (int i = 1; i < argc && !found; ++i) {
+        found = wcscmp(argv[i], name) == 0;
+    }
+    LocalFree(argv);
+    return found;
+}
+
+// Returns the argument following |name| on the command line, or an empty string.
+static std::string CommandLineValue(const wchar_t* name) {
+    std::string value;
+    int argc = 0;
+    LPWSTR* argv = CommandLineToArgvW(GetCommandLineW(), &argc);
+    if (!argv) return value;
+    for (int i = 1; i + 1 < argc; ++i) {
+        if (wcscmp(argv[i], name) == 0) {
+            value = WideToUtf8(argv[i + 1]);
+            break;
+        }
+    }
+    LocalFree(argv);
+    return value;
+}
+
 int APIENTRY WinMain(HINSTANCE hInstance, HINSTANCE, LPSTR, int) {
+    std::string trace_path = CommandLineValue(L"--trace");
+    if (!trace_path.empty()) {
+        TraceEnable();
+        TRACE_THREAD_NAME("UI");
+    }
+    // e.g. "--verify-endpoint http://127.0.0.1:8080" for the stand-in in tools/.
+    VerifyEndpoint verify_endpoint;
+    if (ParseVerifyEndpoint(CommandLineValue(L"--verify-endpoint"), verify_endpoint)) {
+        SetVerifyEndpoint(verify_endpoint);
+    }
+
     WNDCLASSEX wc = { sizeof(WNDCLASSEX), CS_CLASSDC, WndProc, 0L, 0L,
                       GetModuleHandle(nullptr), nullptr, nullptr, nullptr, nullptr,
                       _T("ModGuiWindow"), nullptr };
@@ -448,10 +1182,13 @@ int APIENTRY WinMain(HINSTANCE hInstance, HINSTANCE, LPSTR, int) {
                              nullptr, nullptr, wc.hInstance, nullptr);
     g_hWnd = hwnd;
 
-    if (!CreateDeviceD3D(hwnd)) {
+    g_softwareRendering = HasCommandLineSwitch(L"--software");
+    if (!g_softwareRendering && !CreateDeviceD3D(hwnd)) {
         CleanupDeviceD3D();
-        UnregisterClass(wc.lpszClassName, wc.hInstance);
-        return 1;
+        g_softwareRendering = true;
+    }
+    if (g_softwareRendering) {
+        CreateSoftwareFramebuffer(hwnd);
     }
 
     ShowWindow(hwnd, SW_SHOWDEFAULT);
@@ -474,45 +1211,91 @@ int APIENTRY WinMain(HINSTANCE hInstance, HINSTANCE, LPSTR, int) {
     style.PopupRounding = 8.0f;
     style.WindowPadding = ImVec2(20, 20);
     style.ItemSpacing = ImVec2(12, 12);
+    SetTheme(0);
 
     ImGui_ImplWin32_Init(hwnd);
-    ImGui_ImplDX11_Init(g_pd3dDevice, g_pd3dDeviceContext);
+    if (!g_softwareRendering) {
+        ImGui_ImplDX11_Init(g_pd3dDevice, g_pd3dDeviceContext);
+    }
+
+    EventLogStart(AppDataPath("launcher.log"));
 
     AppState state;
+    // Custom geometry is recorded per window on the task pool and merged back
+    // in submission order before Render().
+    TaskPool task_pool;
+    ParallelDrawLists draw_lists(task_pool);
+    state.recent.Load();
+    state.profiles = LoadLaunchProfiles();
+    state.fingerprints.Load();
+    ScreenLayouts layouts;
+    BuildScreenLayouts(layouts, style.ItemSpacing.x);
+    ResumeFromVerifyCache(state);
     bool done = false;
     MSG msg;
     ZeroMemory(&msg, sizeof(msg));
+    // Input is drawn twice: ImGui settles hover and active state a frame
+    // after the event that changed them.
+    bool redraw = true;
 
     while (!done) {
+        if (!redraw) {
+            float idle_now = static_cast<float>(ImGui::GetTime());
+            float wake = idle_now + kIdlePollInterval;
+            if (state.animator.NextRedrawTime() < wake) wake = state.animator.NextRedrawTime();
+            if (wake > idle_now) {
+                DWORD timeout_ms = static_cast<DWORD>((wake - idle_now) * 1000.0f);
+                MsgWaitForMultipleObjectsEx(0, nullptr, timeout_ms, QS_ALLINPUT, MWMO_INPUTAVAILABLE);
+            }
+        }
+        redraw = false;
         while (PeekMessage(&msg, nullptr, 0U, 0U, PM_REMOVE)) {
             TranslateMessage(&msg);
             DispatchMessage(&msg);
             if (msg.message == WM_QUIT)
                 done = true;
+            redraw = true;
         }
         if (done)
             break;
 
-        if (state.verify_ready.load()) {
-            std::lock_guard<std::mutex> lock(state.verify_mutex);
+        TRACE_SCOPE("frame");
+        VerifyResult verify_result;
+        if (state.verifier.Poll(verify_result)) {
             state.verifying = false;
-            state.verify_ready.store(false);
-            if (state.verify_result.network_error) {
-                state.status_text = state.verify_result.status_message;
-                AddToast(state.toasts, state.verify_result.status_message, ImVec4(0.7f, 0.7f, 0.7f, 1.0f));
-            } else if (state.verify_result.success) {
+            if (state.revalidating) {
+                FinishRevalidation(state, verify_result);
+            } else if (verify_result.network_error) {
+                state.status_text = verify_result.status_message;
+                AddToast(state, verify_result.status_message, ThemeColor::Neutral);
+            } else if (verify_result.success) {
+                LogWrite(LogEvent::VerifyAccepted);
                 state.status_text = "Key accepted";
-                AddToast(state.toasts, "Key accepted", ImVec4(0.3f, 0.9f, 0.4f, 1.0f));
+                AddToast(state, "Key accepted", ThemeColor::Success);
+                if (state.remember_me) {
+                    VerifyCacheStore(state.key_input, UnixNow(), verify_result.expires_at);
+                } else {
+                    VerifyCacheClear();
+                }
                 StartTransition(state, ScreenState::Loading);
-                state.loading_start = static_cast<float>(ImGui::GetTime());
-                state.loading_progress = 0.0f;
-            } else {
+                StartLoading(state);
+            } else if (verify_result.declined) {
+                LogWrite(LogEvent::VerifyDeclined);
                 state.status_text = "Key declined";
-                AddToast(state.toasts, "Key declined", ImVec4(0.9f, 0.2f, 0.2f, 1.0f));
+                AddToast(state, "Key declined", ThemeColor::Danger);
+            } else {
+                state.status_text = "Verification failed (" + verify_result.status_message + ")";
+                AddToast(state, state.status_text, ThemeColor::Danger);
             }
         }
 
-        ImGui_ImplDX11_NewFrame();
+        UpdateLaunches(state);
+        state.images.Update();
+        UploadImageAtlas(state.images);
+
+        if (!g_softwareRendering) {
+            ImGui_ImplDX11_NewFrame();
+        }
         ImGui_ImplWin32_NewFrame();
         ImGui::NewFrame();
 
@@ -522,139 +1305,154 @@ int APIENTRY WinMain(HINSTANCE hInstance, HINSTANCE, LPSTR, int) {
                      ImGuiWindowFlags_NoDecoration | ImGuiWindowFlags_NoBringToFrontOnFocus |
                          ImGuiWindowFlags_NoMove | ImGuiWindowFlags_NoSavedSettings);
 
-        DrawBackgroundGradient(ImGui::GetWindowPos(), ImGui::GetWindowSize());
+        ImVec2 window_pos = ImGui::GetWindowPos();
+        ImVec2 window_size = ImGui::GetWindowSize();
+        float window_rounding = style.WindowRounding;
+        draw_lists.Record(ImGui::GetWindowDrawList(), [window_pos, window_size, window_rounding](ImDrawList* draw_list) {
+            DrawBackgroundGradient(draw_list, window_pos, window_size, window_rounding);
+        });
 
-        ImVec4 accent(0.25f, 0.55f, 0.95f, 1.0f);
-        DrawTitleBar(hwnd, ImGui::GetWindowPos(), ImGui::GetWindowSize(), accent);
+        DrawTitleBar(draw_lists, hwnd, window_pos, window_size);
 
-        ImGui::SetCursorPos(ImVec2(0, 58));
+        ImGui::SetCursorPos(ImVec2(0, kContentTop));
         ImGui::BeginChild("Content", ImVec2(0, 0), false, ImGuiWindowFlags_NoScrollbar);
+        ResolveScreenLayouts(layouts, ImVec2(io.DisplaySize.x, io.DisplaySize.y - kContentTop));
 
         float now = static_cast<float>(ImGui::GetTime());
-        if (state.transition < 1.0f) {
-            float t = (now - state.transition_start) / 0.35f;
-            state.transition = ClampFloat(t, 0.0f, 1.0f);
-            if (state.transition >= 1.0f) {
-                state.current = state.target;
-            }
-        }
+        UpdateAnimations(state, now);
 
         auto draw_screen = [&](ScreenState screen, float alpha, float offset) {
             ImGui::PushStyleVar(ImGuiStyleVar_Alpha, alpha);
-            ImGui::SetCursorPos(ImGui::GetCursorPos() + ImVec2(offset, 0));
 
             if (screen == ScreenState::Login) {
-                ImGui::SetCursorPos(ImVec2(0, 40));
-                ImGui::BeginChild("login_card", ImVec2(0, 0), false);
-                ImVec2 center = ImGui::GetContentRegionAvail();
-                ImGui::SetCursorPos(ImVec2(center.x * 0.5f - 180.0f, 40));
-                ImGui::BeginChild("login_panel", ImVec2(360, 360), true);
-                ImGui::TextColored(ImVec4(0.8f, 0.9f, 1.0f, 1.0f), "SIGN IN");
-                ImGui::TextColored(ImVec4(0.6f, 0.65f, 0.75f, 1.0f), "Best UD Cheats since 2024");
+                TRACE_SCOPE("draw_screen.Login");
+                const LayoutRect& panel = layouts.login.Rect(layouts.login_panel);
+                ImGui::SetCursorPos(ImVec2(panel.pos.x + offset, panel.pos.y));
+                RecordPanelShadow(draw_lists, ImGui::GetWindowDrawList(), ImGui::GetCursorScreenPos(), panel.size, alpha);
+                ImGui::BeginChild("login_panel", panel.size, true);
+                ImGui::TextColored(ThemeVec4(ThemeColor::Heading), "SIGN IN");
+                ImGui::TextColored(ThemeVec4(ThemeColor::Muted), "Best UD Cheats since 2024");
                 ImGui::Separator();
                 ImGui::Text("License Key");
                 ImGuiInputTextFlags flags = state.show_key ? 0 : ImGuiInputTextFlags_Password;
-                ImGui::InputText("##key", state.key_input, IM_ARRAYSIZE(state.key_input), flags);
+                ImGui::InputText("##key", &state.key_input, flags);
                 ImGui::SameLine();
                 if (ImGui::Button("Paste")) {
                     if (const char* clip = ImGui::GetClipboardText()) {
-                        strncpy_s(state.key_input, clip, IM_ARRAYSIZE(state.key_input) - 1);
+                        state.key_input = clip;
                     }
                 }
                 ImGui::Checkbox("Show", &state.show_key);
                 if (ImGui::Button("Sign In", ImVec2(-1, 0))) {
-                    if (!state.verifying) {
-                        state.verifying = true;
-                        state.status_text = "Verifying...";
-                        std::string key = state.key_input;
-                        std::thread([&state, key]() {
-                            VerifyResult res = VerifyKeyOnline(key);
-                            std::lock_guard<std::mutex> lock(state.verify_mutex);
-                            state.verify_result = res;
-                            state.verify_ready.store(true);
-                        }).detach();
+                    state.verifying = true;
+                    state.status_text = "Verifying...";
+                    state.verifier.Request(state.key_input);
+                }
+                if (state.verifying) {
+                    if (state.verifier.CurrentKey() != state.key_input) {
+                        // The key was edited after Sign In; its answer no longer applies.
+                        state.verifier.Cancel();
+                        state.verifying = false;
+                        state.status_text.clear();
+                    } else if (state.verifier.Attempt() > 0) {
+                        state.status_text = "Network error, retrying (attempt " +
+                            std::to_string(state.verifier.Attempt() + 1) + ")...";
                     }
                 }
                 ImGui::Checkbox("Remember me", &state.remember_me);
                 if (!state.status_text.empty()) {
-                    ImVec4 status_color = state.status_text == "Key declined" ? ImVec4(0.9f, 0.2f, 0.2f, 1.0f)
-                        : ImVec4(0.7f, 0.8f, 0.9f, 1.0f);
-                    ImGui::TextColored(status_color, "%s", state.status_text.c_str());
+                    ThemeColor status_color = state.status_text == "Key declined" ? ThemeColor::Danger : ThemeColor::Status;
+                    ImGui::TextColored(ThemeVec4(status_color), "%s", state.status_text.c_str());
                 }
                 ImGui::EndChild();
-                ImGui::EndChild();
             } else if (screen == ScreenState::Loading) {
-                ImGui::SetCursorPos(ImVec2(0, 40));
-                ImGui::BeginChild("loading_panel", ImVec2(0, 0), false);
-                ImVec2 center = ImGui::GetContentRegionAvail();
-                ImVec2 panel_pos(center.x * 0.5f - 140.0f, 120);
-                ImGui::SetCursorPos(panel_pos);
-                ImGui::BeginChild("loading_card", ImVec2(280, 260), true);
+                TRACE_SCOPE("draw_screen.Loading");
+                const LayoutRect& card = layouts.loading.Rect(layouts.loading_card);
+                ImGui::SetCursorPos(ImVec2(card.pos.x + offset, card.pos.y));
+                RecordPanelShadow(draw_lists, ImGui::GetWindowDrawList(), ImGui::GetCursorScreenPos(), card.size, alpha);
+                ImGui::BeginChild("loading_card", card.size, true);
                 ImVec2 card_pos = ImGui::GetCursorScreenPos();
                 ImVec2 card_size = ImGui::GetContentRegionAvail();
-                ImDrawList* draw_list = ImGui::GetWindowDrawList();
                 ImVec2 spinner_center(card_pos.x + card_size.x * 0.5f, card_pos.y + 90.0f);
-                DrawSpinner(draw_list, spinner_center, 32.0f, 4.0f, now);
+                float spinner_phase = state.animator.Value(state.spinner_tween);
+                draw_lists.Record(ImGui::GetWindowDrawList(), [spinner_center, spinner_phase](ImDrawList* draw_list) {
+                    DrawSpinner(draw_list, spinner_center, 32.0f, 4.0f, spinner_phase);
+                });
                 ImGui::SetCursorPosY(140);
-                ImGui::TextColored(ImVec4(0.7f, 0.75f, 0.85f, 1.0f), "Loading");
-                float elapsed = now - state.loading_start;
-                state.loading_progress = ClampFloat(elapsed / 2.5f, 0.0f, 1.0f);
+                ImGui::TextColored(ThemeVec4(ThemeColor::Status), "Loading");
+                state.loading_progress = state.animator.Value(state.loading_tween);
                 ImGui::ProgressBar(state.loading_progress, ImVec2(-1, 8));
-                if (state.loading_progress >= 1.0f && state.transition >= 1.0f) {
+                if (!state.animator.Running(state.loading_tween) && state.transition >= 1.0f) {
                     StartTransition(state, ScreenState::Main);
                 }
                 ImGui::EndChild();
-                ImGui::EndChild();
             } else if (screen == ScreenState::Main) {
-                ImGui::BeginChild("main_layout", ImVec2(0, 0), false);
-                ImVec2 content = ImGui::GetContentRegionAvail();
-                ImGui::BeginChild("sidebar", ImVec2(140, content.y), true);
-                ImGui::TextColored(ImVec4(0.7f, 0.8f, 1.0f, 1.0f), "Main");
+                TRACE_SCOPE("draw_screen.Main");
+                const LayoutRect& sidebar = layouts.main.Rect(layouts.sidebar);
+                const LayoutRect& content = layouts.main.Rect(layouts.content_panel);
+                ImGui::SetCursorPos(ImVec2(sidebar.pos.x + offset, sidebar.pos.y));
+                RecordPanelShadow(draw_lists, ImGui::GetWindowDrawList(), ImGui::GetCursorScreenPos(), sidebar.size, alpha);
+                ImGui::BeginChild("sidebar", sidebar.size, true);
+                ImGui::TextColored(ThemeVec4(ThemeColor::Heading), "Main");
                 ImGui::Separator();
                 ImGui::Text("Dashboard");
+                std::string theme_label = std::string("Theme: ") + ThemeName(ActiveThemeIndex());
+                if (ImGui::Button(theme_label.c_str(), ImVec2(-1, 0))) {
+                    SetTheme((ActiveThemeIndex() + 1) % ThemeCount());
+                }
                 ImGui::EndChild();
-                ImGui::SameLine();
-                ImGui::BeginChild("content_panel", ImVec2(0, content.y), false);
-                ImGui::BeginChild("target_card", ImVec2(0, 140), true);
-                ImGui::TextColored(ImVec4(0.8f, 0.9f, 1.0f, 1.0f), "Target");
+                ImGui::SetCursorPos(ImVec2(content.pos.x + offset, content.pos.y));
+                RecordPanelShadow(draw_lists, ImGui::GetWindowDrawList(), ImGui::GetCursorScreenPos(), content.size, alpha);
+                ImGui::BeginChild("content_panel", content.size, false);
+                ImGui::BeginChild("target_card", ImVec2(0, 200), true);
+                ImGui::TextColored(ThemeVec4(ThemeColor::Heading), "Target");
                 ImGui::Separator();
                 std::string target_name = state.selected_name.empty() ? "No target selected" : WideToUtf8(state.selected_name);
+                if (!state.selected_path.empty()) {
+                    static const float kTargetIconSize = 32.0f;
+                    ImVec2 icon_pos = ImGui::GetCursorScreenPos();
+                    ImageHandle icon = state.images.Request(WideToUtf8(state.selected_path), static_cast<int>(kTargetIconSize));
+                    state.images.Draw(ImGui::GetWindowDrawList(), icon, icon_pos,
+                                      ImVec2(icon_pos.x + kTargetIconSize, icon_pos.y + kTargetIconSize));
+                    ImGui::Dummy(ImVec2(kTargetIconSize, kTargetIconSize));
+                    ImGui::SameLine();
+                }
                 ImGui::Text("Selected: %s", target_name.c_str());
-                bool running = state.has_process && IsProcessRunning(state.target_process);
-                if (running) {
-                    ImGui::TextColored(ImVec4(0.2f, 0.9f, 0.3f, 1.0f), "Running (PID %lu)", state.target_process.dwProcessId);
+                DrawFingerprint(state, now);
+                ChildProcess* latest = state.launched.empty() ? nullptr : state.launched.back().launch.process.get();
+                if (state.launches.Pending() > 0) {
+                    ImGui::TextColored(ThemeVec4(ThemeColor::Status), "Launching...");
+                } else if (latest && latest->Running()) {
+                    ImGui::TextColored(ThemeVec4(ThemeColor::Success), "Running (PID %u)", latest->Pid());
                 } else {
-                    ImGui::TextColored(ImVec4(0.9f, 0.2f, 0.2f, 1.0f), "Not running");
+                    ImGui::TextColored(ThemeVec4(ThemeColor::Danger), "Not running");
                 }
                 if (ImGui::Button("Browse...", ImVec2(120, 0))) {
                     std::wstring path;
                     if (OpenExeDialog(path)) {
-                        state.selected_path = path;
-                        state.selected_name = GetFileNameFromPath(path);
+                        SelectTarget(state, path);
                     }
                 }
                 ImGui::SameLine();
                 if (ImGui::Button("Launch Target", ImVec2(140, 0))) {
                     if (!state.selected_path.empty()) {
-                        if (state.has_process) {
-                            CloseHandle(state.target_process.hProcess);
-                            CloseHandle(state.target_process.hThread);
-                        }
-                        PROCESS_INFORMATION pi = {};
-                        if (LaunchTarget(state.selected_path, pi)) {
-                            state.target_process = pi;
-                            state.has_process = true;
-                        } else {
-                            AddToast(state.toasts, "Failed to launch target", ImVec4(0.9f, 0.2f, 0.2f, 1.0f));
-                        }
+                        SubmitLaunch(state, WideToUtf8(state.selected_name), WideToUtf8(state.selected_path),
+                                     CurrentLaunchOptions(state));
                     }
                 }
                 ImGui::SameLine();
                 if (ImGui::Button("Inject", ImVec2(100, 0))) {
-                    AddToast(state.toasts, "Injected!", ImVec4(0.2f, 0.9f, 0.3f, 1.0f));
+                    AddToast(state, "Injected!", ThemeColor::Success);
                 }
+                ImGui::Checkbox("Capture output", &state.capture_output);
                 ImGui::EndChild();
-                ImGui::EndChild();
+                DrawLaunchProfiles(state);
+                DrawLaunches(state);
+                if (state.capture_output) {
+                    DrawTargetOutput(state);
+                }
+                DrawRecentTargets(state);
+                DrawActivityLog(state);
                 ImGui::EndChild();
             }
 
@@ -671,27 +1469,37 @@ int APIENTRY WinMain(HINSTANCE hInstance, HINSTANCE, LPSTR, int) {
         }
 
         ImGui::EndChild();
-        DrawToasts(state.toasts);
+        DrawToasts(state, draw_lists);
         ImGui::End();
 
-        ImGui::Render();
-        const float clear_color_with_alpha[4] = { 0.05f, 0.06f, 0.08f, 1.00f };
-        g_pd3dDeviceContext->OMSetRenderTargets(1, &g_mainRenderTargetView, nullptr);
-        g_pd3dDeviceContext->ClearRenderTargetView(g_mainRenderTargetView, clear_color_with_alpha);
-        ImGui_ImplDX11_RenderDrawData(ImGui::GetDrawData());
-        g_pSwapChain->Present(1, 0);
+        draw_lists.Flush();
+        {
+            TRACE_SCOPE("frame.render");
+            ImGui::Render();
+        }
+        TRACE_SCOPE("frame.present");
+        ImDrawData* draw_data = ImGui::GetDrawData();
+        g_damage.Update(draw_data);
+        if (g_softwareRendering) {
+            RenderFrameSoftware(draw_data);
+        } else {
+            RenderFrameD3D(draw_data);
+        }
     }
 
-    if (state.has_process) {
-        CloseHandle(state.target_process.hProcess);
-        CloseHandle(state.target_process.hThread);
+    EventLogStop();
+    if (!trace_path.empty()) {
+        TraceWriteJson(trace_path);
     }
 
-    ImGui_ImplDX11_Shutdown();
+    if (!g_softwareRendering) {
+        ImGui_ImplDX11_Shutdown();
+    }
     ImGui_ImplWin32_Shutdown();
     ImGui::DestroyContext();
 
     CleanupDeviceD3D();
+    CleanupSoftwareFramebuffer();
     DestroyWindow(hwnd);
     UnregisterClass(wc.lpszClassName, wc.hInstance);
 
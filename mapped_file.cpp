@@ -0,0 +1,97 @@
+#include "mapped_file.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "string_util.h"
+
+#ifdef _WIN32
+// FILETIME counts 100 ns intervals since 1601-01-01.
+static int64_t FileTimeToUnix(const FILETIME& ft) {
+    uint64_t ticks = (static_cast<uint64_t>(ft.dwHighDateTime) << 32) | ft.dwLowDateTime;
+    return static_cast<int64_t>(ticks / 10000000ULL) - 11644473600LL;
+}
+#endif
+
+bool MappedFile::Open(const std::string& path, bool sequential) {
+    Close();
+#ifdef _WIN32
+    HANDLE file = CreateFileW(Utf8ToWide(path).c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE,
+                              nullptr, OPEN_EXISTING, sequential ? FILE_FLAG_SEQUENTIAL_SCAN : FILE_ATTRIBUTE_NORMAL,
+                              nullptr);
+    if (file == INVALID_HANDLE_VALUE) return false;
+    LARGE_INTEGER size = {};
+    FILETIME write_time = {};
+    if (!GetFileSizeEx(file, &size) || !GetFileTime(file, nullptr, nullptr, &write_time)) {
+        CloseHandle(file);
+        return false;
+    }
+    file_ = file;
+    size_ = static_cast<size_t>(size.QuadPart);
+    mtime_ = FileTimeToUnix(write_time);
+    if (size_ == 0) return true;
+    mapping_ = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!mapping_) {
+        Close();
+        return false;
+    }
+    data_ = static_cast<const uint8_t*>(MapViewOfFile(mapping_, FILE_MAP_READ, 0, 0, 0));
+#else
+    fd_ = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd_ < 0) return false;
+    struct stat st;
+    if (fstat(fd_, &st) != 0) {
+        Close();
+        return false;
+    }
+    size_ = static_cast<size_t>(st.st_size);
+    mtime_ = static_cast<int64_t>(st.st_mtime);
+    if (size_ == 0) return true;
+    void* data = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd_, 0);
+    data_ = data == MAP_FAILED ? nullptr : static_cast<const uint8_t*>(data);
+    if (data_ && sequential) madvise(data, size_, MADV_SEQUENTIAL);
+#endif
+    if (!data_) {
+        Close();
+        return false;
+    }
+    return true;
+}
+
+void MappedFile::Close() {
+#ifdef _WIN32
+    if (data_) UnmapViewOfFile(data_);
+    if (mapping_) CloseHandle(mapping_);
+    if (file_) CloseHandle(file_);
+    mapping_ = nullptr;
+    file_ = nullptr;
+#else
+    if (data_) munmap(const_cast<uint8_t*>(data_), size_);
+    if (fd_ >= 0) close(fd_);
+    fd_ = -1;
+#endif
+    data_ = nullptr;
+    size_ = 0;
+    mtime_ = 0;
+}
+
+bool StatFileUtf8(const std::string& path, uint64_t& size, int64_t& mtime) {
+#ifdef _WIN32
+    WIN32_FILE_ATTRIBUTE_DATA attrs = {};
+    if (!GetFileAttributesExW(Utf8ToWide(path).c_str(), GetFileExInfoStandard, &attrs)) return false;
+    size = (static_cast<uint64_t>(attrs.nFileSizeHigh) << 32) | attrs.nFileSizeLow;
+    mtime = FileTimeToUnix(attrs.ftLastWriteTime);
+#else
+    struct stat st;
+    if (stat(path.c_str(), &st) != 0) return false;
+    size = static_cast<uint64_t>(st.st_size);
+    mtime = static_cast<int64_t>(st.st_mtime);
+#endif
+    return true;
+}
@@ -0,0 +1,37 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Read-only memory mapping of a whole file, addressed by UTF-8 path.
+class MappedFile {
+public:
+    MappedFile() = default;
+    ~MappedFile() { Close(); }
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    // |sequential| hints that the file will be read front to back once, so
+    // the OS can read ahead aggressively and drop pages behind.
+    bool Open(const std::string& path, bool sequential = false);
+    void Close();
+
+    const uint8_t* Data() const { return data_; }
+    size_t Size() const { return size_; }
+    // Last write time in Unix seconds.
+    int64_t ModifiedTime() const { return mtime_; }
+
+private:
+    const uint8_t* data_ = nullptr;
+    size_t size_ = 0;
+    int64_t mtime_ = 0;
+#ifdef _WIN32
+    void* file_ = nullptr;
+    void* mapping_ = nullptr;
+#else
+    int fd_ = -1;
+#endif
+};
+
+// Size and last write time (Unix seconds) without opening a mapping.
+bool StatFileUtf8(const std::string& path, uint64_t& size, int64_t& mtime);
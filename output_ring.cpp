@@ -0,0 +1,130 @@
+#include "output_ring.h"
+
+#include <cstring>
+
+OutputRing::OutputRing(size_t byte_capacity, size_t line_capacity)
+    : bytes_(byte_capacity), lines_(line_capacity) {
+}
+
+void OutputRing::Clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    write_pos_ = 0;
+    first_line_ = 0;
+    end_line_ = 0;
+    dropped_ = 0;
+}
+
+void OutputRing::DropOldest() {
+    ++first_line_;
+    ++dropped_;
+}
+
+OutputRing::LineEntry& OutputRing::BeginLine(OutputStream stream) {
+    if (end_line_ - first_line_ == lines_.size()) DropOldest();
+    LineEntry& line = lines_[end_line_ % lines_.size()];
+    line.start = write_pos_;
+    line.length = 0;
+    line.stream = stream;
+    line.open = true;
+    ++end_line_;
+    return line;
+}
+
+// Drops every line that starts in the region about to be overwritten, then
+// copies |size| bytes in at most two spans. kMaxLineLength is far below the
+// byte capacity, so the line being written is never the one dropped.
+void OutputRing::WriteBytes(const char* data, size_t size) {
+    uint64_t capacity = bytes_.size();
+    uint64_t end = write_pos_ + size;
+    while (first_line_ < end_line_ && end > capacity && lines_[first_line_ % lines_.size()].start < end - capacity) {
+        DropOldest();
+    }
+    size_t offset = static_cast<size_t>(write_pos_ % capacity);
+    size_t head = bytes_.size() - offset < size ? bytes_.size() - offset : size;
+    memcpy(&bytes_[offset], data, head);
+    memcpy(&bytes_[0], data + head, size - head);
+    write_pos_ = end;
+}
+
+void OutputRing::Append(OutputStream stream, const char* data, size_t size) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    LineEntry* line = nullptr;
+    if (end_line_ > first_line_) {
+        LineEntry& last = lines_[(end_line_ - 1) % lines_.size()];
+        if (last.open && last.stream == stream) line = &last;
+    }
+    size_t i = 0;
+    while (i < size) {
+        if (!line) line = &BeginLine(stream);
+        const char* newline = static_cast<const char*>(memchr(data + i, '\n', size - i));
+        size_t segment_end = newline ? static_cast<size_t>(newline - data) : size;
+        size_t room = kMaxLineLength - line->length;
+        size_t segment = segment_end - i < room ? segment_end - i : room;
+        WriteBytes(data + i, segment);
+        line->length += static_cast<uint32_t>(segment);
+        i += segment;
+        if (i < segment_end) {
+            // Overlong line: break it and continue on a new one.
+            line->open = false;
+            line = nullptr;
+        } else if (newline) {
+            if (line->length > 0 && bytes_[(line->start + line->length - 1) % bytes_.size()] == '\r') {
+                --line->length;
+            }
+            line->open = false;
+            line = nullptr;
+            ++i;
+        }
+    }
+}
+
+uint64_t OutputRing::FirstLine() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return first_line_;
+}
+
+uint64_t OutputRing::EndLine() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return end_line_;
+}
+
+size_t OutputRing::ReadLinesLocked(uint64_t first, size_t count, std::vector<OutputLine>& out) const {
+    if (first < first_line_) {
+        uint64_t skip = first_line_ - first;
+        count = skip < count ? count - static_cast<size_t>(skip) : 0;
+        first = first_line_;
+    }
+    if (first >= end_line_) return 0;
+    if (end_line_ - first < count) count = static_cast<size_t>(end_line_ - first);
+    if (out.size() < count) out.resize(count);
+    for (size_t i = 0; i < count; ++i) {
+        const LineEntry& line = lines_[(first + i) % lines_.size()];
+        OutputLine& dst = out[i];
+        dst.number = first + i;
+        dst.stream = line.stream;
+        dst.text.resize(line.length);
+        // At most two contiguous spans because the line may wrap the ring.
+        size_t offset = static_cast<size_t>(line.start % bytes_.size());
+        size_t head = bytes_.size() - offset < line.length ? bytes_.size() - offset : line.length;
+        if (head > 0) dst.text.replace(0, head, &bytes_[offset], head);
+        if (line.length > head) dst.text.replace(head, line.length - head, &bytes_[0], line.length - head);
+    }
+    return count;
+}
+
+size_t OutputRing::ReadLines(uint64_t first, size_t count, std::vector<OutputLine>& out) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return ReadLinesLocked(first, count, out);
+}
+
+size_t OutputRing::ReadTail(size_t max_lines, std::vector<OutputLine>& out) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    uint64_t available = end_line_ - first_line_;
+    size_t count = static_cast<size_t>(available < max_lines ? available : max_lines);
+    return ReadLinesLocked(end_line_ - count, count, out);
+}
+
+uint64_t OutputRing::DroppedLines() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return dropped_;
+}
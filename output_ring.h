@@ -0,0 +1,69 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Fixed-size byte ring with a line index for captured child output. The I/O
+// thread appends raw chunks; the UI copies out only the lines it displays.
+// Memory is bounded by the byte and line capacities: the oldest lines are
+// dropped when either fills, so a chatty child can never grow it.
+
+enum class OutputStream : uint8_t {
+    Stdout,
+    Stderr
+};
+
+struct OutputLine {
+    uint64_t number = 0;  // Absolute line number since the last Clear().
+    OutputStream stream = OutputStream::Stdout;
+    std::string text;
+};
+
+class OutputRing {
+public:
+    explicit OutputRing(size_t byte_capacity = 256 * 1024, size_t line_capacity = 4096);
+
+    // Splits |data| on '\n' (a trailing '\r' is dropped). A partial last line
+    // stays open and is continued by the next chunk from the same stream;
+    // lines longer than kMaxLineLength are broken.
+    void Append(OutputStream stream, const char* data, size_t size);
+    void Clear();
+
+    // Absolute line numbers [FirstLine(), EndLine()) currently held.
+    uint64_t FirstLine() const;
+    uint64_t EndLine() const;
+
+    // Copies lines [first, first + count) that are still held into |out|,
+    // reusing the strings' storage. Returns the number of lines copied.
+    size_t ReadLines(uint64_t first, size_t count, std::vector<OutputLine>& out) const;
+    // Same for the newest |max_lines| lines, oldest first.
+    size_t ReadTail(size_t max_lines, std::vector<OutputLine>& out) const;
+
+    // Lines dropped from the front because the ring was full.
+    uint64_t DroppedLines() const;
+
+    static const size_t kMaxLineLength = 4096;
+
+private:
+    struct LineEntry {
+        uint64_t start;   // Absolute byte offset into the ring.
+        uint32_t length;
+        OutputStream stream;
+        bool open;        // Not yet terminated by '\n'.
+    };
+
+    void WriteBytes(const char* data, size_t size);
+    LineEntry& BeginLine(OutputStream stream);
+    void DropOldest();
+    size_t ReadLinesLocked(uint64_t first, size_t count, std::vector<OutputLine>& out) const;
+
+    mutable std::mutex mutex_;
+    std::vector<char> bytes_;
+    std::vector<LineEntry> lines_;  // Ring of line_capacity entries.
+    uint64_t write_pos_ = 0;        // Absolute bytes written.
+    uint64_t first_line_ = 0;       // Absolute number of the oldest kept line.
+    uint64_t end_line_ = 0;         // One past the newest line.
+    uint64_t dropped_ = 0;
+};
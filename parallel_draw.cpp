@@ -0,0 +1,57 @@
+#include "parallel_draw.h"
+
+#include "task_pool.h"
+#include "trace.h"
+
+// Frames that recorded fewer vertices than this draw inline on the next
+// frame: waking the workers and splicing would cost more than the geometry.
+static const int kParallelMinVertices = 4096;
+
+void ParallelDrawLists::Record(ImDrawList* target, DrawRecorder recorder) {
+    if (!deferred_) {
+        int vtx_before = target->VtxBuffer.Size;
+        recorder(target);
+        frame_vtx_count_ += target->VtxBuffer.Size - vtx_before;
+        return;
+    }
+    Job job;
+    job.target = target;
+    job.idx_pos = target->IdxBuffer.Size;
+    job.recorder = std::move(recorder);
+    jobs_.push_back(std::move(job));
+}
+
+void ParallelDrawLists::Flush() {
+    TRACE_SCOPE("draw.flush");
+    const int count = static_cast<int>(jobs_.size());
+    while (static_cast<int>(lists_.size()) < count) {
+        lists_.push_back(std::make_unique<ImDrawList>());
+    }
+    pool_.ParallelFor(count, [this](int i) {
+        TRACE_SCOPE("draw.record");
+        ImDrawList* list = lists_[i].get();
+        list->_ResetForNewFrame();
+        jobs_[i].recorder(list);
+    });
+
+    // Splice per target, in Record() order; positions recorded for one
+    // target never decrease.
+    for (int i = 0; i < count; ++i) {
+        ImDrawList* target = jobs_[i].target;
+        if (!target) continue;
+        splice_srcs_.clear();
+        splice_pos_.clear();
+        for (int j = i; j < count; ++j) {
+            if (jobs_[j].target != target) continue;
+            splice_srcs_.push_back(lists_[j].get());
+            splice_pos_.push_back(jobs_[j].idx_pos);
+            frame_vtx_count_ += lists_[j]->VtxBuffer.Size;
+            jobs_[j].target = nullptr;
+        }
+        target->InsertDrawLists(splice_srcs_.data(), splice_pos_.data(), static_cast<int>(splice_srcs_.size()));
+    }
+    jobs_.clear();
+
+    deferred_ = pool_.WorkerCount() > 0 && frame_vtx_count_ >= kParallelMinVertices;
+    frame_vtx_count_ = 0;
+}
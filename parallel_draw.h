@@ -0,0 +1,48 @@
+#pragma once
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "imgui.h"
+
+class TaskPool;
+
+// Records custom geometry for independent windows concurrently. Record() is
+// called on the UI thread where the geometry would have been drawn and notes
+// that position in the target list; Flush() runs every recorder on the task
+// pool, each into a private draw list, then splices the lists into their
+// targets in Record() order, so the frame matches drawing serially.
+//
+// Splicing costs a copy, so when the previous frame recorded little geometry
+// (or the pool has no workers) recorders run immediately inside Record().
+//
+// Recorders may run on worker threads: they may only use the draw list they
+// are given and values they captured. ImGui itself is not thread-safe.
+
+using DrawRecorder = std::function<void(ImDrawList* draw_list)>;
+
+class ParallelDrawLists {
+public:
+    explicit ParallelDrawLists(TaskPool& pool) : pool_(pool) {}
+
+    void Record(ImDrawList* target, DrawRecorder recorder);
+    // Builds and merges everything recorded this frame. Call before
+    // ImGui::Render().
+    void Flush();
+
+private:
+    struct Job {
+        ImDrawList* target = nullptr;
+        int idx_pos = 0;
+        DrawRecorder recorder;
+    };
+
+    TaskPool& pool_;
+    bool deferred_ = false;
+    int frame_vtx_count_ = 0;
+    std::vector<Job> jobs_;
+    // One list per job slot, kept across frames so the buffers stay warm.
+    std::vector<std::unique_ptr<ImDrawList>> lists_;
+    std::vector<const ImDrawList*> splice_srcs_;
+    std::vector<int> splice_pos_;
+};
@@ -0,0 +1,168 @@
+#include "pe_metadata.h"
+
+
+// The structures are read field by field from little-endian bytes rather than
+// through <windows.h> types, so the parser has no platform dependency.
+
+static const uint32_t kPeSignature = 0x00004550;        // "PE\0\0"
+static const uint16_t kOptionalMagic32 = 0x10B;
+static const uint16_t kOptionalMagic64 = 0x20B;
+static const uint32_t kResourceDirectoryIndex = 2;
+static const uint32_t kResourceTypeVersion = 16;         // RT_VERSION
+static const uint32_t kFixedFileInfoSignature = 0xFEEF04BD;
+static const int kMaxResourceEntries = 4096;
+
+namespace {
+
+// Bounds-checked little-endian view over the mapped file.
+struct ByteView {
+    const uint8_t* data;
+    size_t size;
+
+    bool Has(size_t offset, size_t length) const {
+        return offset <= size && length <= size - offset;
+    }
+    uint16_t U16(size_t offset) const {
+        return static_cast<uint16_t>(data[offset] | (data[offset + 1] << 8));
+    }
+    uint32_t U32(size_t offset) const {
+        return static_cast<uint32_t>(data[offset]) | (static_cast<uint32_t>(data[offset + 1]) << 8) |
+               (static_cast<uint32_t>(data[offset + 2]) << 16) | (static_cast<uint32_t>(data[offset + 3]) << 24);
+    }
+};
+
+struct Section {
+    uint32_t virtual_address;
+    uint32_t virtual_size;
+    uint32_t raw_offset;
+    uint32_t raw_size;
+};
+
+} // namespace
+
+// Translates a relative virtual address to a file offset via the section table.
+static bool RvaToOffset(const ByteView& view, size_t section_table, uint16_t section_count, uint32_t rva, size_t& out) {
+    for (uint16_t i = 0; i < section_count; ++i) {
+        size_t entry = section_table + static_cast<size_t>(i) * 40;
+        if (!view.Has(entry, 40)) return false;
+        Section section = { view.U32(entry + 12), view.U32(entry + 8), view.U32(entry + 20), view.U32(entry + 16) };
+        uint32_t extent = section.virtual_size > section.raw_size ? section.virtual_size : section.raw_size;
+        if (rva >= section.virtual_address && rva - section.virtual_address < extent) {
+            uint32_t delta = rva - section.virtual_address;
+            if (delta >= section.raw_size) return false;
+            out = static_cast<size_t>(section.raw_offset) + delta;
+            return true;
+        }
+    }
+    return false;
+}
+
+// Looks up |id| in the IMAGE_RESOURCE_DIRECTORY at |dir| (relative to the
+// resource section start |base|); id 0 takes the first entry. Returns the
+// entry's OffsetToData field.
+static bool FindResourceEntry(const ByteView& view, size_t base, size_t dir, uint32_t id, uint32_t& out) {
+    if (!view.Has(base + dir, 16)) return false;
+    int named = view.U16(base + dir + 12);
+    int ids = view.U16(base + dir + 14);
+    if (named + ids > kMaxResourceEntries) return false;
+    for (int i = 0; i < named + ids; ++i) {
+        size_t entry = base + dir + 16 + static_cast<size_t>(i) * 8;
+        if (!view.Has(entry, 8)) return false;
+        uint32_t name = view.U32(entry);
+        if (id == 0 || (i >= named && name == id)) {
+            out = view.U32(entry + 4);
+            return true;
+        }
+    }
+    return false;
+}
+
+static bool ReadFileVersion(const ByteView& view, size_t section_table, uint16_t section_count,
+                            uint32_t resource_rva, PeMetadata& out) {
+    size_t base = 0;
+    if (!RvaToOffset(view, section_table, section_count, resource_rva, base)) return false;
+
+    // Type -> name -> language; the first two levels point at subdirectories
+    // (high bit set), the last at a data entry.
+    uint32_t entry = 0;
+    if (!FindResourceEntry(view, base, 0, kResourceTypeVersion, entry) || !(entry & 0x80000000u)) return false;
+    if (!FindResourceEntry(view, base, entry & 0x7FFFFFFFu, 0, entry) || !(entry & 0x80000000u)) return false;
+    if (!FindResourceEntry(view, base, entry & 0x7FFFFFFFu, 0, entry) || (entry & 0x80000000u)) return false;
+    if (!view.Has(base + entry, 16)) return false;
+    uint32_t data_rva = view.U32(base + entry);
+    uint32_t data_size = view.U32(base + entry + 4);
+
+    size_t info = 0;
+    if (!RvaToOffset(view, section_table, section_count, data_rva, info)) return false;
+    if (!view.Has(info, 0)) return false;
+    if (!view.Has(info, data_size)) data_size = static_cast<uint32_t>(view.size - info);
+
+    // VS_VERSIONINFO: three WORDs, the UTF-16 key "VS_VERSION_INFO", padding
+    // to a DWORD boundary, then VS_FIXEDFILEINFO. Scan the aligned slots
+    // rather than trusting the key length.
+    for (size_t offset = 4; offset + 52 <= data_size && offset < 96; offset += 4) {
+        if (view.U32(info + offset) != kFixedFileInfoSignature) continue;
+        uint32_t ms = view.U32(info + offset + 8);
+        uint32_t ls = view.U32(info + offset + 12);
+        out.version[0] = static_cast<uint16_t>(ms >> 16);
+        out.version[1] = static_cast<uint16_t>(ms & 0xFFFF);
+        out.version[2] = static_cast<uint16_t>(ls >> 16);
+        out.version[3] = static_cast<uint16_t>(ls & 0xFFFF);
+        out.has_version = true;
+        return true;
+    }
+    return false;
+}
+
+bool ParsePeMetadata(const uint8_t* data, size_t size, PeMetadata& out) {
+    out = PeMetadata();
+    ByteView view = { data, size };
+    if (!data || !view.Has(0, 64) || data[0] != 'M' || data[1] != 'Z') return false;
+
+    size_t pe = view.U32(0x3C);
+    if (!view.Has(pe, 24) || view.U32(pe) != kPeSignature) return false;
+    size_t coff = pe + 4;
+    out.machine = view.U16(coff);
+    uint16_t section_count = view.U16(coff + 2);
+    uint16_t optional_size = view.U16(coff + 16);
+
+    size_t optional = coff + 20;
+    if (!view.Has(optional, optional_size) || optional_size < 72) return false;
+    uint16_t magic = view.U16(optional);
+    if (magic != kOptionalMagic32 && magic != kOptionalMagic64) return false;
+    out.is_64bit = magic == kOptionalMagic64;
+    out.subsystem = view.U16(optional + 68);
+
+    // The data directory array follows the fixed fields, which are 16 bytes
+    // longer in PE32+ because of the 64-bit ImageBase and stack/heap sizes.
+    size_t rva_count_offset = optional + (out.is_64bit ? 108 : 92);
+    size_t directories = rva_count_offset + 4;
+    size_t resource_dir = directories + kResourceDirectoryIndex * 8;
+    if (resource_dir + 8 <= optional + optional_size && view.U32(rva_count_offset) > kResourceDirectoryIndex) {
+        uint32_t resource_rva = view.U32(resource_dir);
+        if (resource_rva != 0) {
+            ReadFileVersion(view, optional + optional_size, section_count, resource_rva, out);
+        }
+    }
+    return true;
+}
+
+const char* PeMachineName(uint16_t machine) {
+    switch (machine) {
+    case 0x014C: return "x86";
+    case 0x8664: return "x64";
+    case 0xAA64: return "ARM64";
+    case 0x01C4: return "ARM";
+    default: return "?";
+    }
+}
+
+const char* PeSubsystemName(uint16_t subsystem) {
+    switch (subsystem) {
+    case 1: return "Native";
+    case 2: return "GUI";
+    case 3: return "Console";
+    case 10: return "EFI";
+    default: return "?";
+    }
+}
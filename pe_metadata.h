@@ -0,0 +1,23 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+// Header-level facts about a PE image (.exe/.dll), read straight from the
+// file bytes so it works on any platform.
+struct PeMetadata {
+    uint16_t machine = 0;      // IMAGE_FILE_MACHINE_*
+    uint16_t subsystem = 0;    // IMAGE_SUBSYSTEM_*
+    bool is_64bit = false;     // PE32+ optional header.
+    bool has_version = false;
+    uint16_t version[4] = {};  // File version from VS_FIXEDFILEINFO.
+};
+
+// Parses the DOS, COFF and optional headers and, if present, the fixed part
+// of the RT_VERSION resource. Only the pages holding those structures are
+// touched. Returns false if |data| is not a PE image; every offset is
+// bounds-checked against |size|.
+bool ParsePeMetadata(const uint8_t* data, size_t size, PeMetadata& out);
+
+// Short display names such as "x64" or "GUI"; "?" for unknown values.
+const char* PeMachineName(uint16_t machine);
+const char* PeSubsystemName(uint16_t subsystem);
@@ -0,0 +1,207 @@
+#include "recent_targets.h"
+
+#include <cstdio>
+#include <cstdlib>
+
+#include "app_paths.h"
+#include "mapped_file.h"
+#include "trace.h"
+
+static const char* kIndexFile = "recent_targets.idx";
+static const char* kIndexVersion = "v1";
+// mtime, size, last_used, flags, machine, subsystem, version, path.
+static const int kIndexFields = 8;
+
+static const unsigned kFlagScanned = 1u << 0;
+static const unsigned kFlagPe = 1u << 1;
+static const unsigned kFlagVersion = 1u << 2;
+static const unsigned kFlag64Bit = 1u << 3;
+
+bool ScanTargetFile(const std::string& path, RecentTarget& out) {
+    TRACE_SCOPE("recent.scan");
+    MappedFile file;
+    if (!file.Open(path)) return false;
+    out.size = file.Size();
+    out.mtime = file.ModifiedTime();
+    out.is_pe = ParsePeMetadata(file.Data(), file.Size(), out.meta);
+    out.scanned = true;
+    return true;
+}
+
+RecentTargets::RecentTargets() {
+    worker_ = std::thread(&RecentTargets::WorkerMain, this);
+}
+
+RecentTargets::~RecentTargets() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    cv_.notify_all();
+    worker_.join();
+}
+
+void RecentTargets::Load() {
+    std::string contents;
+    if (!ReadFileUtf8(AppDataPath(kIndexFile), contents)) return;
+
+    std::vector<RecentTarget> loaded;
+    size_t start = 0;
+    bool header = true;
+    for (size_t pos = contents.find('\n'); pos != std::string::npos; pos = contents.find('\n', start)) {
+        std::string line = contents.substr(start, pos - start);
+        start = pos + 1;
+        if (header) {
+            if (line != kIndexVersion) return;
+            header = false;
+            continue;
+        }
+
+        // The path is the last field so it may contain tabs.
+        std::string fields[kIndexFields];
+        size_t field_start = 0;
+        int field = 0;
+        for (; field < kIndexFields - 1; ++field) {
+            size_t tab = line.find('\t', field_start);
+            if (tab == std::string::npos) break;
+            fields[field] = line.substr(field_start, tab - field_start);
+            field_start = tab + 1;
+        }
+        if (field != kIndexFields - 1) continue;
+        fields[field] = line.substr(field_start);
+        if (fields[field].empty()) continue;
+
+        RecentTarget target;
+        target.mtime = std::strtoll(fields[0].c_str(), nullptr, 10);
+        target.size = std::strtoull(fields[1].c_str(), nullptr, 10);
+        target.last_used = std::strtoll(fields[2].c_str(), nullptr, 10);
+        unsigned flags = static_cast<unsigned>(std::strtoul(fields[3].c_str(), nullptr, 10));
+        target.scanned = (flags & kFlagScanned) != 0;
+        target.is_pe = (flags & kFlagPe) != 0;
+        target.meta.has_version = (flags & kFlagVersion) != 0;
+        target.meta.is_64bit = (flags & kFlag64Bit) != 0;
+        target.meta.machine = static_cast<uint16_t>(std::strtoul(fields[4].c_str(), nullptr, 16));
+        target.meta.subsystem = static_cast<uint16_t>(std::strtoul(fields[5].c_str(), nullptr, 10));
+        unsigned v[4] = {};
+        if (sscanf(fields[6].c_str(), "%u.%u.%u.%u", &v[0], &v[1], &v[2], &v[3]) == 4) {
+            for (int i = 0; i < 4; ++i) target.meta.version[i] = static_cast<uint16_t>(v[i]);
+        }
+        target.path = fields[7];
+        loaded.push_back(target);
+        if (loaded.size() == kMaxRecentTargets) break;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    targets_ = loaded;
+    ++version_;
+}
+
+void RecentTargets::Touch(const std::string& path, int64_t now) {
+    if (path.empty() || path.find('\n') != std::string::npos) return;
+    std::lock_guard<std::mutex> lock(mutex_);
+    RecentTarget target;
+    for (size_t i = 0; i < targets_.size(); ++i) {
+        if (targets_[i].path == path) {
+            target = targets_[i];
+            targets_.erase(targets_.begin() + i);
+            break;
+        }
+    }
+    target.path = path;
+    target.last_used = now;
+    targets_.insert(targets_.begin(), target);
+    if (targets_.size() > kMaxRecentTargets) targets_.resize(kMaxRecentTargets);
+    ++version_;
+    queue_.push_back(path);
+    cv_.notify_all();
+}
+
+bool RecentTargets::Snapshot(std::vector<RecentTarget>& out, uint64_t& version) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (version == version_) return false;
+    out = targets_;
+    version = version_;
+    return true;
+}
+
+std::string RecentTargets::SerializeLocked() const {
+    std::string text = std::string(kIndexVersion) + "\n";
+    char line[160];
+    for (const RecentTarget& target : targets_) {
+        unsigned flags = (target.scanned ? kFlagScanned : 0) | (target.is_pe ? kFlagPe : 0) |
+                         (target.meta.has_version ? kFlagVersion : 0) | (target.meta.is_64bit ? kFlag64Bit : 0);
+        snprintf(line, sizeof(line), "%lld\t%llu\t%lld\t%u\t%04x\t%u\t%u.%u.%u.%u\t",
+                 static_cast<long long>(target.mtime), static_cast<unsigned long long>(target.size),
+                 static_cast<long long>(target.last_used), flags, target.meta.machine, target.meta.subsystem,
+                 target.meta.version[0], target.meta.version[1], target.meta.version[2], target.meta.version[3]);
+        text += line;
+        text += target.path;
+        text += "\n";
+    }
+    return text;
+}
+
+// Runs on the worker without the lock held; only the stat and, when the file
+// changed, the header parse touch the disk.
+void RecentTargets::Scan(const std::string& path) {
+    uint64_t size = 0;
+    int64_t mtime = 0;
+    bool exists = StatFileUtf8(path, size, mtime);
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (const RecentTarget& target : targets_) {
+            if (target.path == path && target.scanned && exists && target.size == size && target.mtime == mtime) {
+                return;
+            }
+        }
+    }
+
+    RecentTarget scanned;
+    if (exists && !ScanTargetFile(path, scanned)) exists = false;
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (RecentTarget& target : targets_) {
+        if (target.path != path) continue;
+        if (exists) {
+            target.size = scanned.size;
+            target.mtime = scanned.mtime;
+            target.scanned = true;
+            target.is_pe = scanned.is_pe;
+            target.meta = scanned.meta;
+        } else {
+            // Keep the entry so the user sees it, but mark it for a rescan.
+            target.scanned = false;
+        }
+        ++version_;
+        break;
+    }
+}
+
+void RecentTargets::WorkerMain() {
+    TRACE_THREAD_NAME("Recent targets");
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (!stop_) {
+        if (queue_.empty()) {
+            cv_.wait(lock);
+            continue;
+        }
+        std::string path = queue_.front();
+        queue_.pop_front();
+        lock.unlock();
+        Scan(path);
+        lock.lock();
+
+        // Persist once the burst is drained; the list order changed in
+        // Touch() even if no file needed parsing.
+        if (queue_.empty()) {
+            std::string text = SerializeLocked();
+            lock.unlock();
+            WriteFileAtomicUtf8(AppDataPath(kIndexFile), text);
+            lock.lock();
+        }
+    }
+    // Stopped with scans outstanding: still record the new list order.
+    if (!queue_.empty()) {
+        WriteFileAtomicUtf8(AppDataPath(kIndexFile), SerializeLocked());
+    }
+}
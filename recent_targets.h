@@ -0,0 +1,61 @@
+#pragma once
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "pe_metadata.h"
+
+// Recently chosen launch targets with their PE header metadata. The list is
+// persisted as a small index keyed by path and mtime: loading it never opens
+// the executables, and a target is only re-parsed when it is picked again and
+// its size or mtime no longer match the stored entry.
+
+struct RecentTarget {
+    std::string path;       // UTF-8.
+    uint64_t size = 0;
+    int64_t mtime = 0;      // Unix seconds, as last scanned.
+    int64_t last_used = 0;  // Unix seconds.
+    bool scanned = false;   // Metadata below matches size/mtime.
+    bool is_pe = false;
+    PeMetadata meta;
+};
+
+static const size_t kMaxRecentTargets = 12;
+
+class RecentTargets {
+public:
+    RecentTargets();
+    ~RecentTargets();
+    RecentTargets(const RecentTargets&) = delete;
+    RecentTargets& operator=(const RecentTargets&) = delete;
+
+    // Reads the index from the app data directory. Call once at startup.
+    void Load();
+    // Moves |path| to the front of the list and queues a background check of
+    // its size and mtime, re-parsing the headers if they changed.
+    void Touch(const std::string& path, int64_t now);
+
+    // Copies the list, most recent first, if it changed since |version|.
+    bool Snapshot(std::vector<RecentTarget>& out, uint64_t& version) const;
+
+private:
+    void WorkerMain();
+    void Scan(const std::string& path);
+    std::string SerializeLocked() const;
+
+    mutable std::mutex mutex_;
+    std::condition_variable cv_;
+    std::vector<RecentTarget> targets_;
+    std::deque<std::string> queue_;
+    uint64_t version_ = 1;
+    bool stop_ = false;
+    std::thread worker_;
+};
+
+// Scans one file synchronously: maps it and parses the PE headers.
+// Returns false if the file cannot be opened.
+bool ScanTargetFile(const std::string& path, RecentTarget& out);
@@ -0,0 +1,93 @@
+#include "row_sorter.h"
+
+#include <algorithm>
+
+#include "trace.h"
+
+// Rows per independently sorted run; runs are then merged pairwise. The
+// generation is checked between runs and merges.
+static const size_t kSortRunSize = 64 * 1024;
+
+AsyncRowSorter::AsyncRowSorter() {
+    worker_ = std::thread(&AsyncRowSorter::WorkerMain, this);
+}
+
+AsyncRowSorter::~AsyncRowSorter() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    generation_.fetch_add(1, std::memory_order_relaxed);
+    cv_.notify_all();
+    worker_.join();
+}
+
+void AsyncRowSorter::Sort(uint32_t count, RowLess less) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    generation_.fetch_add(1, std::memory_order_relaxed);
+    pending_count_ = count;
+    pending_less_ = std::move(less);
+    pending_ = true;
+    ready_ = false;
+    busy_.store(true, std::memory_order_release);
+    cv_.notify_all();
+}
+
+bool AsyncRowSorter::Poll() {
+    if (busy_.load(std::memory_order_acquire)) return false;
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!ready_) return false;
+    order_.swap(result_);
+    ready_ = false;
+    return true;
+}
+
+bool AsyncRowSorter::SortChunked(std::vector<uint32_t>& rows, const RowLess& less, uint64_t generation) {
+    auto cancelled = [&]() { return generation_.load(std::memory_order_relaxed) != generation; };
+    size_t count = rows.size();
+    for (size_t start = 0; start < count; start += kSortRunSize) {
+        if (cancelled()) return false;
+        size_t end = std::min(count, start + kSortRunSize);
+        std::stable_sort(rows.begin() + start, rows.begin() + end, less);
+    }
+    for (size_t width = kSortRunSize; width < count; width *= 2) {
+        for (size_t start = 0; start + width < count; start += 2 * width) {
+            if (cancelled()) return false;
+            size_t middle = start + width;
+            size_t end = std::min(count, start + 2 * width);
+            std::inplace_merge(rows.begin() + start, rows.begin() + middle, rows.begin() + end, less);
+        }
+    }
+    return true;
+}
+
+void AsyncRowSorter::WorkerMain() {
+    TRACE_THREAD_NAME("Row sorter");
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (!stop_) {
+        if (!pending_) {
+            cv_.wait(lock);
+            continue;
+        }
+        pending_ = false;
+        uint64_t generation = generation_.load(std::memory_order_relaxed);
+        RowLess less = std::move(pending_less_);
+        uint32_t count = pending_count_;
+        lock.unlock();
+
+        std::vector<uint32_t> rows(count);
+        for (uint32_t i = 0; i < count; ++i) rows[i] = i;
+        bool done = false;
+        {
+            TRACE_SCOPE("rows.sort");
+            done = SortChunked(rows, less, generation);
+        }
+
+        lock.lock();
+        if (done && generation_.load(std::memory_order_relaxed) == generation) {
+            result_.swap(rows);
+            ready_ = true;
+            busy_.store(false, std::memory_order_release);
+        }
+    }
+}
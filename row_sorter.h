@@ -0,0 +1,56 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Sorts a permutation of table rows on a worker thread. The UI keeps drawing
+// with the current order while a sort runs; Poll() swaps the finished order
+// in. The sort is stable, and works in chunks so that a newer Sort() call
+// abandons an older one between chunks instead of waiting for it.
+
+using RowLess = std::function<bool(uint32_t a, uint32_t b)>;
+
+class AsyncRowSorter {
+public:
+    AsyncRowSorter();
+    ~AsyncRowSorter();
+    AsyncRowSorter(const AsyncRowSorter&) = delete;
+    AsyncRowSorter& operator=(const AsyncRowSorter&) = delete;
+
+    // Sorts rows [0, count). |less| runs on the worker, so the data it reads
+    // must not change until Poll() returns the result or Sort() is called
+    // again.
+    void Sort(uint32_t count, RowLess less);
+    // Returns true when a finished order has been swapped into Order().
+    bool Poll();
+    bool Busy() const { return busy_.load(std::memory_order_acquire); }
+
+    // Display index -> data row. Empty until the first sort completes, in
+    // which case rows are shown in data order.
+    const std::vector<uint32_t>& Order() const { return order_; }
+    uint32_t Row(uint32_t display_index) const {
+        return display_index < order_.size() ? order_[display_index] : display_index;
+    }
+
+private:
+    void WorkerMain();
+    bool SortChunked(std::vector<uint32_t>& rows, const RowLess& less, uint64_t generation);
+
+    std::vector<uint32_t> order_;  // UI thread only.
+
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    uint32_t pending_count_ = 0;
+    RowLess pending_less_;
+    bool pending_ = false;
+    bool stop_ = false;
+    std::vector<uint32_t> result_;
+    bool ready_ = false;
+    std::atomic<uint64_t> generation_{0};
+    std::atomic<bool> busy_{false};
+    std::thread worker_;
+};
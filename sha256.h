@@ -0,0 +1,26 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// SHA-256 and HMAC-SHA256 (FIPS 180-4, RFC 2104) for integrity checks on
+// local state files.
+
+struct Sha256 {
+    Sha256();
+    void Update(const void* data, size_t size);
+    void Final(uint8_t out[32]);
+
+private:
+    void Transform(const uint8_t block[64]);
+
+    uint32_t state_[8];
+    uint64_t length_ = 0;
+    uint8_t buffer_[64];
+    size_t buffered_ = 0;
+};
+
+void HmacSha256(const void* key, size_t key_size, const void* data, size_t data_size, uint8_t out[32]);
+
+// Lowercase hex encoding of |size| bytes.
+std::string HexEncode(const uint8_t* data, size_t size);
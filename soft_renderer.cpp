@@ -0,0 +1,213 @@
+#include "soft_renderer.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+    struct ScissorRect {
+        int x0, y0, x1, y1;
+    };
+
+    // IM_COL32 byte order to the BGRA framebuffer's.
+    inline uint32_t ToBgra(ImU32 col) {
+        return ((col & 0xFFu) << 16) | (col & 0xFF00u) | ((col >> 16) & 0xFFu);
+    }
+
+    inline uint32_t Blend(uint32_t dst, uint32_t r, uint32_t g, uint32_t b, uint32_t a) {
+        uint32_t inv = 255 - a;
+        uint32_t db = dst & 0xFF;
+        uint32_t dg = (dst >> 8) & 0xFF;
+        uint32_t dr = (dst >> 16) & 0xFF;
+        uint32_t ob = (b * a + db * inv + 127) / 255;
+        uint32_t og = (g * a + dg * inv + 127) / 255;
+        uint32_t orr = (r * a + dr * inv + 127) / 255;
+        return (orr << 16) | (og << 8) | ob;
+    }
+
+    // Vertex positions snap to 1/256 pixel; edge values are exact in 64-bit
+    // integers, so a pixel's coverage does not depend on where stepping
+    // started and partial repaints match full ones bit for bit.
+    const int kSubpixelBits = 8;
+    const int64_t kSubpixelOne = 1 << kSubpixelBits;
+
+    struct FixedPoint {
+        int64_t x, y;
+    };
+
+    inline FixedPoint ToFixed(const ImVec2& p, const ImVec2& origin) {
+        FixedPoint f;
+        f.x = static_cast<int64_t>(std::lround((p.x - origin.x) * kSubpixelOne));
+        f.y = static_cast<int64_t>(std::lround((p.y - origin.y) * kSubpixelOne));
+        return f;
+    }
+
+    struct Edge {
+        int64_t x0, y0, dx, dy;
+        bool inclusive;  // Pixels exactly on the edge belong to this triangle.
+
+        void Set(const FixedPoint& from, const FixedPoint& to) {
+            x0 = from.x;
+            y0 = from.y;
+            dx = to.x - from.x;
+            dy = to.y - from.y;
+            // A shared edge is walked in opposite directions by its two
+            // triangles, so exactly one of them owns the pixels on it.
+            inclusive = dy > 0 || (dy == 0 && dx > 0);
+        }
+        int64_t At(int64_t px, int64_t py) const {
+            return dx * (py - y0) - dy * (px - x0);
+        }
+        bool Inside(int64_t w) const {
+            return w > 0 || (w == 0 && inclusive);
+        }
+    };
+}
+
+void SoftwareRenderer::SetTexture(ImTextureID id, const uint8_t* rgba, int width, int height) {
+    for (Texture& texture : textures_) {
+        if (texture.id == id) {
+            texture.rgba = rgba;
+            texture.width = width;
+            texture.height = height;
+            return;
+        }
+    }
+    Texture texture;
+    texture.id = id;
+    texture.rgba = rgba;
+    texture.width = width;
+    texture.height = height;
+    textures_.push_back(texture);
+}
+
+const SoftwareRenderer::Texture* SoftwareRenderer::FindTexture(ImTextureID id) const {
+    if (!id) return nullptr;
+    for (const Texture& texture : textures_) {
+        if (texture.id == id && texture.rgba) return &texture;
+    }
+    return nullptr;
+}
+
+namespace {
+    void DrawTriangle(const SoftwareTarget& target, const ScissorRect& scissor, const ImVec2& origin,
+                      const ImDrawVert* va, const ImDrawVert* vb, const ImDrawVert* vc,
+                      const uint8_t* tex, int tex_w, int tex_h, uint64_t& touched) {
+        FixedPoint a = ToFixed(va->pos, origin);
+        FixedPoint b = ToFixed(vb->pos, origin);
+        FixedPoint c = ToFixed(vc->pos, origin);
+        int64_t area = (b.x - a.x) * (c.y - a.y) - (b.y - a.y) * (c.x - a.x);
+        if (area == 0) return;
+        if (area < 0) {
+            std::swap(b, c);
+            std::swap(vb, vc);
+            area = -area;
+        }
+
+        // Pixels whose centers can fall inside the triangle.
+        int x0 = std::max(static_cast<int>(std::min(std::min(a.x, b.x), c.x) >> kSubpixelBits), scissor.x0);
+        int y0 = std::max(static_cast<int>(std::min(std::min(a.y, b.y), c.y) >> kSubpixelBits), scissor.y0);
+        int x1 = std::min(static_cast<int>((std::max(std::max(a.x, b.x), c.x) >> kSubpixelBits) + 1), scissor.x1);
+        int y1 = std::min(static_cast<int>((std::max(std::max(a.y, b.y), c.y) >> kSubpixelBits) + 1), scissor.y1);
+        if (x1 <= x0 || y1 <= y0) return;
+
+        // Edge i is opposite vertex i, so its value weights that vertex.
+        Edge e0, e1, e2;
+        e0.Set(b, c);
+        e1.Set(c, a);
+        e2.Set(a, b);
+        float inv_area = 1.0f / static_cast<float>(area);
+
+        const ImU32 cols[3] = { va->col, vb->col, vc->col };
+        bool flat = !tex && cols[0] == cols[1] && cols[1] == cols[2];
+        float channel[3][4];
+        for (int v = 0; v < 3; ++v) {
+            for (int k = 0; k < 4; ++k) channel[v][k] = static_cast<float>((cols[v] >> (8 * k)) & 0xFF);
+        }
+        uint32_t flat_r = cols[0] & 0xFF;
+        uint32_t flat_g = (cols[0] >> 8) & 0xFF;
+        uint32_t flat_b = (cols[0] >> 16) & 0xFF;
+        uint32_t flat_a = cols[0] >> 24;
+        uint32_t flat_bgra = ToBgra(cols[0]);
+        if (flat && flat_a == 0) return;
+
+        int64_t step0 = e0.dy * kSubpixelOne;
+        int64_t step1 = e1.dy * kSubpixelOne;
+        int64_t step2 = e2.dy * kSubpixelOne;
+        for (int y = y0; y < y1; ++y) {
+            int64_t py = (static_cast<int64_t>(y) << kSubpixelBits) + kSubpixelOne / 2;
+            int64_t px = (static_cast<int64_t>(x0) << kSubpixelBits) + kSubpixelOne / 2;
+            int64_t w0 = e0.At(px, py);
+            int64_t w1 = e1.At(px, py);
+            int64_t w2 = e2.At(px, py);
+            uint32_t* row = target.pixels + static_cast<size_t>(y) * target.pitch;
+            for (int x = x0; x < x1; ++x, w0 -= step0, w1 -= step1, w2 -= step2) {
+                if (!e0.Inside(w0) || !e1.Inside(w1) || !e2.Inside(w2)) continue;
+                ++touched;
+                if (flat) {
+                    row[x] = flat_a == 255 ? flat_bgra : Blend(row[x], flat_r, flat_g, flat_b, flat_a);
+                    continue;
+                }
+                float l0 = static_cast<float>(w0) * inv_area;
+                float l1 = static_cast<float>(w1) * inv_area;
+                float l2 = 1.0f - l0 - l1;
+                float rgba[4];
+                for (int k = 0; k < 4; ++k) rgba[k] = channel[0][k] * l0 + channel[1][k] * l1 + channel[2][k] * l2;
+                if (tex) {
+                    float u = va->uv.x * l0 + vb->uv.x * l1 + vc->uv.x * l2;
+                    float v = va->uv.y * l0 + vb->uv.y * l1 + vc->uv.y * l2;
+                    int tx = std::min(std::max(static_cast<int>(u * tex_w), 0), tex_w - 1);
+                    int ty = std::min(std::max(static_cast<int>(v * tex_h), 0), tex_h - 1);
+                    const uint8_t* texel = tex + (static_cast<size_t>(ty) * tex_w + tx) * 4;
+                    for (int k = 0; k < 4; ++k) rgba[k] *= texel[k] * (1.0f / 255.0f);
+                }
+                uint32_t alpha = static_cast<uint32_t>(std::min(std::max(rgba[3], 0.0f), 255.0f) + 0.5f);
+                if (alpha == 0) continue;
+                row[x] = Blend(row[x], static_cast<uint32_t>(std::min(std::max(rgba[0], 0.0f), 255.0f) + 0.5f),
+                               static_cast<uint32_t>(std::min(std::max(rgba[1], 0.0f), 255.0f) + 0.5f),
+                               static_cast<uint32_t>(std::min(std::max(rgba[2], 0.0f), 255.0f) + 0.5f), alpha);
+            }
+        }
+    }
+}
+
+void SoftwareRenderer::Render(const ImDrawData* draw_data, const SoftwareTarget& target, const DamageRect* rects,
+                              int rect_count, ImU32 clear) {
+    pixels_touched_ = 0;
+    uint32_t clear_bgra = ToBgra(clear);
+    ImVec2 origin = draw_data->DisplayPos;
+    for (int r = 0; r < rect_count; ++r) {
+        ScissorRect damage;
+        damage.x0 = std::max(rects[r].x0, 0);
+        damage.y0 = std::max(rects[r].y0, 0);
+        damage.x1 = std::min(rects[r].x1, target.width);
+        damage.y1 = std::min(rects[r].y1, target.height);
+        if (damage.x1 <= damage.x0 || damage.y1 <= damage.y0) continue;
+        for (int y = damage.y0; y < damage.y1; ++y) {
+            uint32_t* row = target.pixels + static_cast<size_t>(y) * target.pitch;
+            std::fill(row + damage.x0, row + damage.x1, clear_bgra);
+        }
+        pixels_touched_ += static_cast<uint64_t>(damage.x1 - damage.x0) * (damage.y1 - damage.y0);
+
+        for (int n = 0; n < draw_data->CmdLists.Size; ++n) {
+            const ImDrawList* list = draw_data->CmdLists[n];
+            for (const ImDrawCmd& cmd : list->CmdBuffer) {
+                // Truncated like the GPU backends' scissor rects.
+                ScissorRect scissor;
+                scissor.x0 = std::max(static_cast<int>(cmd.ClipRect.x - origin.x), damage.x0);
+                scissor.y0 = std::max(static_cast<int>(cmd.ClipRect.y - origin.y), damage.y0);
+                scissor.x1 = std::min(static_cast<int>(cmd.ClipRect.z - origin.x), damage.x1);
+                scissor.y1 = std::min(static_cast<int>(cmd.ClipRect.w - origin.y), damage.y1);
+                if (scissor.x1 <= scissor.x0 || scissor.y1 <= scissor.y0) continue;
+                const Texture* texture = FindTexture(cmd.TextureId);
+                const uint8_t* tex = texture ? texture->rgba : nullptr;
+                int tex_w = texture ? texture->width : 0;
+                int tex_h = texture ? texture->height : 0;
+                const ImDrawIdx* idx = list->IdxBuffer.Data + cmd.IdxOffset;
+                for (unsigned int i = 0; i + 2 < cmd.ElemCount; i += 3) {
+                    DrawTriangle(target, scissor, origin, &list->VtxBuffer.Data[idx[i]], &list->VtxBuffer.Data[idx[i + 1]],
+                                 &list->VtxBuffer.Data[idx[i + 2]], tex, tex_w, tex_h, pixels_touched_);
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,47 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+#include "damage_tracker.h"
+#include "imgui.h"
+
+// CPU rasterizer for ImDrawData, used when no Direct3D 11 device is
+// available. It repaints only the given damage rectangles of a persistent
+// BGRA framebuffer, so the pixels touched per frame follow what changed
+// rather than the window size.
+
+struct SoftwareTarget {
+    uint32_t* pixels = nullptr;  // BGRA, alpha ignored.
+    int width = 0;
+    int height = 0;
+    int pitch = 0;               // In pixels.
+};
+
+class SoftwareRenderer {
+public:
+    // |rgba| is straight-alpha RGBA8 and must stay valid while registered;
+    // its contents are read at draw time. Unregistered ids, including the
+    // null default texture, sample as opaque white.
+    void SetTexture(ImTextureID id, const uint8_t* rgba, int width, int height);
+
+    // Clears each rect to |clear| (packed like IM_COL32) and draws the parts
+    // of |draw_data| that fall inside it.
+    void Render(const ImDrawData* draw_data, const SoftwareTarget& target, const DamageRect* rects, int rect_count,
+                ImU32 clear);
+
+    // Framebuffer pixels written by the last Render(), for tracing.
+    uint64_t PixelsTouched() const { return pixels_touched_; }
+
+private:
+    struct Texture {
+        ImTextureID id = nullptr;
+        const uint8_t* rgba = nullptr;
+        int width = 0;
+        int height = 0;
+    };
+
+    const Texture* FindTexture(ImTextureID id) const;
+
+    std::vector<Texture> textures_;
+    uint64_t pixels_touched_ = 0;
+};
@@ -0,0 +1,37 @@
+#include "string_util.h"
+
+#ifdef _WIN32
+#include <windows.h>
+
+std::wstring Utf8ToWide(const std::string& str) {
+    if (str.empty()) return L"";
+    int size = MultiByteToWideChar(CP_UTF8, 0, str.c_str(), -1, nullptr, 0);
+    std::wstring wide(size - 1, L'\0');
+    MultiByteToWideChar(CP_UTF8, 0, str.c_str(), -1, wide.data(), size);
+    return wide;
+}
+
+std::string WideToUtf8(const std::wstring& str) {
+    if (str.empty()) return "";
+    int size = WideCharToMultiByte(CP_UTF8, 0, str.c_str(), -1, nullptr, 0, nullptr, nullptr);
+    std::string utf8(size - 1, '\0');
+    WideCharToMultiByte(CP_UTF8, 0, str.c_str(), -1, utf8.data(), size, nullptr, nullptr);
+    return utf8;
+}
+#endif
+
+std::string UrlEncode(const std::string& value) {
+    static const char* kHex = "0123456789ABCDEF";
+    std::string encoded;
+    for (unsigned char c : value) {
+        if ((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') ||
+            (c >= '0' && c <= '9') || c == '-' || c == '_' || c == '.' || c == '~') {
+            encoded.push_back(static_cast<char>(c));
+        } else {
+            encoded.push_back('%');
+            encoded.push_back(kHex[c >> 4]);
+            encoded.push_back(kHex[c & 0x0F]);
+        }
+    }
+    return encoded;
+}
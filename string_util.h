@@ -0,0 +1,10 @@
+#pragma once
+#include <string>
+
+#ifdef _WIN32
+std::wstring Utf8ToWide(const std::string& str);
+std::string WideToUtf8(const std::wstring& str);
+#endif
+
+// Percent-encodes everything except RFC 3986 unreserved characters.
+std::string UrlEncode(const std::string& value);
@@ -0,0 +1,79 @@
+#include "task_pool.h"
+
+#include "trace.h"
+
+// Enough to cover the draw jobs of a frame; more threads only add wake-up cost.
+static const unsigned kMaxTaskWorkers = 7;
+
+TaskPool::TaskPool(unsigned threads) {
+    if (threads == 0) {
+        unsigned hardware = std::thread::hardware_concurrency();
+        threads = hardware > 1 ? hardware - 1 : 0;
+    }
+    if (threads > kMaxTaskWorkers) threads = kMaxTaskWorkers;
+    for (unsigned i = 0; i < threads; ++i) {
+        workers_.emplace_back(&TaskPool::WorkerMain, this);
+    }
+}
+
+TaskPool::~TaskPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    cv_.notify_all();
+    for (std::thread& worker : workers_) {
+        worker.join();
+    }
+}
+
+void TaskPool::RunItems(const std::function<void(int)>* fn, int count) {
+    if (!fn) return;
+    for (;;) {
+        int index = next_.fetch_add(1, std::memory_order_relaxed);
+        if (index >= count) return;
+        (*fn)(index);
+    }
+}
+
+void TaskPool::ParallelFor(int count, const std::function<void(int index)>& fn) {
+    if (count <= 0) return;
+    if (count == 1 || workers_.empty()) {
+        for (int i = 0; i < count; ++i) fn(i);
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        fn_ = &fn;
+        count_ = count;
+        next_.store(0, std::memory_order_relaxed);
+        ++generation_;
+    }
+    cv_.notify_all();
+    RunItems(&fn, count);
+
+    // Every index has been handed out; wait for workers still running one.
+    std::unique_lock<std::mutex> lock(mutex_);
+    idle_cv_.wait(lock, [this]() { return active_ == 0; });
+    fn_ = nullptr;
+    count_ = 0;
+}
+
+void TaskPool::WorkerMain() {
+    TRACE_THREAD_NAME("Task worker");
+    std::unique_lock<std::mutex> lock(mutex_);
+    uint64_t seen = generation_;
+    for (;;) {
+        cv_.wait(lock, [&]() { return stop_ || generation_ != seen; });
+        if (stop_) return;
+        seen = generation_;
+        // A worker that wakes after ParallelFor() returned sees no job.
+        const std::function<void(int)>* fn = fn_;
+        int count = count_;
+        ++active_;
+        lock.unlock();
+        RunItems(fn, count);
+        lock.lock();
+        if (--active_ == 0) idle_cv_.notify_all();
+    }
+}
@@ -0,0 +1,45 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fork-join pool for short, CPU-bound work on the UI thread's behalf, such as
+// recording draw lists. ParallelFor() hands out item indices to the workers
+// and the calling thread alike and returns once every item has finished, so
+// items may freely reference the caller's stack.
+
+class TaskPool {
+public:
+    // |threads| workers in addition to the caller; 0 picks one fewer than
+    // the hardware thread count.
+    explicit TaskPool(unsigned threads = 0);
+    ~TaskPool();
+    TaskPool(const TaskPool&) = delete;
+    TaskPool& operator=(const TaskPool&) = delete;
+
+    // Runs fn(0) .. fn(count - 1) across the pool. Not reentrant: call from
+    // one thread at a time, and not from inside an item.
+    void ParallelFor(int count, const std::function<void(int index)>& fn);
+
+    // Worker threads, not counting the caller.
+    unsigned WorkerCount() const { return static_cast<unsigned>(workers_.size()); }
+
+private:
+    void WorkerMain();
+    void RunItems(const std::function<void(int)>* fn, int count);
+
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::condition_variable idle_cv_;
+    const std::function<void(int)>* fn_ = nullptr;
+    int count_ = 0;
+    std::atomic<int> next_{0};
+    uint64_t generation_ = 0;
+    int active_ = 0;
+    bool stop_ = false;
+    std::vector<std::thread> workers_;
+};
@@ -0,0 +1,108 @@
+#include "theme.h"
+
+namespace {
+    constexpr bool ThemeComplete(const Theme& theme) {
+        for (const ThemeSwatch& swatch : theme.colors) {
+            if (swatch.packed == 0) return false;
+        }
+        return true;
+    }
+
+    // Entries follow the ThemeColor order.
+    constexpr Theme kThemes[] = {
+        { "Midnight", {
+            ThemeRgba(0.8f, 0.9f, 1.0f),          // Heading
+            ThemeRgba(0.92f, 0.94f, 0.97f),       // Body
+            ThemeRgba(0.7f, 0.8f, 0.9f),          // Status
+            ThemeRgba(0.6f, 0.65f, 0.75f),        // Muted
+            ThemeRgba(0.7f, 0.7f, 0.7f),          // Neutral
+            ThemeRgba(0.9f, 0.2f, 0.2f),          // Danger
+            ThemeRgba(0.95f, 0.45f, 0.45f),       // DangerSoft
+            ThemeRgba(0.9f, 0.7f, 0.2f),          // Warning
+            ThemeRgba(0.9f, 0.5f, 0.2f),          // Caution
+            ThemeRgba(0.2f, 0.9f, 0.3f),          // Success
+            ThemeRgba(0.25f, 0.55f, 0.95f),       // Accent
+            ThemeRgba8(120, 180, 255, 200),       // Graph
+            ThemeRgba8(15, 18, 24),               // TitleBar
+            ThemeRgba8(200, 230, 255),            // TitleText
+            ThemeRgba8(45, 50, 60),               // Button
+            ThemeRgba8(70, 80, 95),               // ButtonHovered
+            ThemeRgba8(90, 100, 115),             // ButtonActive
+            ThemeRgba8(28, 32, 40),               // FrameBg
+            ThemeRgba8(10, 12, 18, 240),          // WindowBg
+            ThemeRgba8(18, 21, 28, 200),          // ChildBg
+            ThemeRgba8(60, 68, 82, 128),          // Border
+            ThemeRgba8(10, 12, 18),               // BackgroundTop
+            ThemeRgba8(5, 8, 12),                 // BackgroundBottom
+            ThemeRgba(0.05f, 0.06f, 0.08f),       // Clear
+        } },
+        { "Slate", {
+            ThemeRgba(0.95f, 0.96f, 0.98f),       // Heading
+            ThemeRgba(0.88f, 0.89f, 0.91f),       // Body
+            ThemeRgba(0.72f, 0.76f, 0.82f),       // Status
+            ThemeRgba(0.55f, 0.58f, 0.64f),       // Muted
+            ThemeRgba(0.75f, 0.75f, 0.75f),       // Neutral
+            ThemeRgba(0.95f, 0.3f, 0.3f),         // Danger
+            ThemeRgba(0.98f, 0.55f, 0.5f),        // DangerSoft
+            ThemeRgba(0.95f, 0.75f, 0.3f),        // Warning
+            ThemeRgba(0.95f, 0.58f, 0.3f),        // Caution
+            ThemeRgba(0.35f, 0.85f, 0.5f),        // Success
+            ThemeRgba(0.55f, 0.6f, 0.95f),        // Accent
+            ThemeRgba8(170, 180, 240, 210),       // Graph
+            ThemeRgba8(34, 37, 43),               // TitleBar
+            ThemeRgba8(230, 232, 238),            // TitleText
+            ThemeRgba8(58, 62, 71),               // Button
+            ThemeRgba8(78, 84, 96),               // ButtonHovered
+            ThemeRgba8(98, 105, 120),             // ButtonActive
+            ThemeRgba8(44, 48, 56),               // FrameBg
+            ThemeRgba8(30, 33, 39, 240),          // WindowBg
+            ThemeRgba8(38, 41, 48, 200),          // ChildBg
+            ThemeRgba8(80, 86, 98, 128),          // Border
+            ThemeRgba8(32, 35, 41),               // BackgroundTop
+            ThemeRgba8(22, 24, 29),               // BackgroundBottom
+            ThemeRgba(0.09f, 0.1f, 0.12f),        // Clear
+        } },
+    };
+
+    static_assert(ThemeComplete(kThemes[0]) && ThemeComplete(kThemes[1]),
+                  "every ThemeColor needs a non-transparent entry");
+    static_assert(kThemes[0].colors[static_cast<size_t>(ThemeColor::TitleText)].packed ==
+                      ThemeRgba8(200, 230, 255).packed, "palette entries are out of ThemeColor order");
+
+    int g_active_index = 0;
+}
+
+namespace theme_detail {
+    const Theme* g_active = &kThemes[0];
+}
+
+int ThemeCount() {
+    return IM_ARRAYSIZE(kThemes);
+}
+
+int ActiveThemeIndex() {
+    return g_active_index;
+}
+
+const char* ThemeName(int index) {
+    if (index < 0 || index >= ThemeCount()) return "";
+    return kThemes[index].name;
+}
+
+void SetTheme(int index) {
+    if (index < 0 || index >= ThemeCount()) return;
+    g_active_index = index;
+    theme_detail::g_active = &kThemes[index];
+
+    ImVec4* colors = ImGui::GetStyle().Colors;
+    colors[ImGuiCol_Text] = ThemeVec4(ThemeColor::Body);
+    colors[ImGuiCol_WindowBg] = ThemeVec4(ThemeColor::WindowBg);
+    colors[ImGuiCol_ChildBg] = ThemeVec4(ThemeColor::ChildBg);
+    colors[ImGuiCol_Border] = ThemeVec4(ThemeColor::Border);
+    colors[ImGuiCol_FrameBg] = ThemeVec4(ThemeColor::FrameBg);
+    colors[ImGuiCol_Button] = ThemeVec4(ThemeColor::Button);
+    colors[ImGuiCol_ButtonHovered] = ThemeVec4(ThemeColor::ButtonHovered);
+    colors[ImGuiCol_ButtonActive] = ThemeVec4(ThemeColor::ButtonActive);
+    const ImVec4& accent = ThemeVec4(ThemeColor::Accent);
+    colors[ImGuiCol_TextSelectedBg] = ImVec4(accent.x, accent.y, accent.z, 0.35f);
+}
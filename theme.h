@@ -0,0 +1,97 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+#include "imgui.h"
+
+// Named color palette for every screen. Each entry carries both the float
+// color (for ImGui calls taking ImVec4) and the packed ImU32 (for draw lists),
+// computed at compile time, so drawing never converts between the two.
+// Switching themes swaps one table pointer and rewrites the ImGui style
+// colors once; frames push no style colors of their own.
+
+enum class ThemeColor : uint8_t {
+    Heading,          // Card and screen titles.
+    Body,             // Default text.
+    Status,           // Secondary text and status lines.
+    Muted,            // Hints, placeholders, pending states.
+    Neutral,          // Informational toasts.
+    Danger,           // Failures and declined keys.
+    DangerSoft,       // Child stderr lines.
+    Warning,          // Changed-on-disk notices.
+    Caution,          // Non-PE recent entries.
+    Success,          // Running process, accepted key.
+    Accent,           // Title bar dot.
+    Graph,            // Spinner stroke.
+    TitleBar,
+    TitleText,
+    Button,
+    ButtonHovered,
+    ButtonActive,
+    FrameBg,
+    WindowBg,
+    ChildBg,
+    Border,
+    BackgroundTop,    // Window gradient.
+    BackgroundBottom,
+    Clear,            // Swap chain clear color.
+    Count
+};
+
+static constexpr size_t kThemeColorCount = static_cast<size_t>(ThemeColor::Count);
+
+struct ThemeSwatch {
+    ImVec4 rgba;
+    ImU32 packed;
+};
+
+struct Theme {
+    const char* name;
+    ThemeSwatch colors[kThemeColorCount];
+};
+
+constexpr ImU32 ThemeUnormToByte(float v) {
+    return v <= 0.0f ? 0u : v >= 1.0f ? 255u : static_cast<ImU32>(v * 255.0f + 0.5f);
+}
+
+// Palette entry from float components.
+constexpr ThemeSwatch ThemeRgba(float r, float g, float b, float a = 1.0f) {
+    return { ImVec4(r, g, b, a),
+             IM_COL32(ThemeUnormToByte(r), ThemeUnormToByte(g), ThemeUnormToByte(b), ThemeUnormToByte(a)) };
+}
+
+// Palette entry from 8-bit components.
+constexpr ThemeSwatch ThemeRgba8(ImU32 r, ImU32 g, ImU32 b, ImU32 a = 255) {
+    return { ImVec4(r / 255.0f, g / 255.0f, b / 255.0f, a / 255.0f), IM_COL32(r, g, b, a) };
+}
+
+// Scales the alpha byte of |col| by |alpha| (0..255) with exact rounding of
+// the divide by 255; the color channels are untouched.
+constexpr ImU32 ModulateAlpha(ImU32 col, ImU32 alpha) {
+    ImU32 a = (col >> 24) * alpha + 128;
+    return (col & 0x00FFFFFFu) | (((a + (a >> 8)) >> 8) << 24);
+}
+
+// Converts a fade factor to the byte ModulateAlpha() takes; call once per
+// fade, not per color.
+inline ImU32 AlphaToByte(float alpha) {
+    return ThemeUnormToByte(alpha);
+}
+
+namespace theme_detail {
+    extern const Theme* g_active;
+}
+
+inline const ImVec4& ThemeVec4(ThemeColor color) {
+    return theme_detail::g_active->colors[static_cast<size_t>(color)].rgba;
+}
+
+inline ImU32 ThemeU32(ThemeColor color) {
+    return theme_detail::g_active->colors[static_cast<size_t>(color)].packed;
+}
+
+int ThemeCount();
+int ActiveThemeIndex();
+const char* ThemeName(int index);
+// Makes |index| the active theme and writes its colors into the ImGui style.
+void SetTheme(int index);
@@ -0,0 +1,152 @@
+// Offline check for partial repaints. Replays a scripted UI through
+// DamageTracker and SoftwareRenderer into a simulated swap chain, repainting
+// only the damage of each buffer the way main.cpp does, and compares every
+// presented buffer with a full repaint of the same frame. Frames without
+// changes are skipped (neither drawn nor presented), and idle stretches sit
+// between changes, so buffer ages are counted in presents rather than
+// frames. Both repaint strategies are covered: one clear and draw per damage
+// rect (the CPU path) and one over their bounding box (the Direct3D path).
+//
+// Build instructions are in README.md.
+
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include "damage_tracker.h"
+#include "soft_renderer.h"
+
+namespace {
+    const int kWidth = 640;
+    const int kHeight = 480;
+    const ImU32 kClear = IM_COL32(13, 15, 20, 255);
+
+    // 2x2 texture standing in for the image atlas.
+    uint8_t g_texture[16] = { 255, 0, 0, 255, 0, 255, 0, 255, 0, 0, 255, 128, 255, 255, 255, 255 };
+
+    struct Scene {
+        int spinner = 0;
+        bool toast = false;
+        int panel_x = 40;
+        bool selected = false;
+    };
+
+    // Layered, translucent geometry like the launcher's: a gradient, panels
+    // over it, a stroked spinner and an optional toast.
+    void Build(ImDrawList& list, const Scene& scene) {
+        list._ResetForNewFrame();
+        list.AddRectFilledMultiColor(ImVec2(0, 0), ImVec2(kWidth, kHeight), IM_COL32(10, 12, 18, 255),
+                                     IM_COL32(10, 12, 18, 255), IM_COL32(5, 8, 12, 255), IM_COL32(5, 8, 12, 255));
+        list.AddRectFilled(ImVec2(0, 0), ImVec2(200, kHeight), IM_COL32(24, 26, 32, 200));
+        for (int i = 0; i < 10; ++i) {
+            ImU32 col = scene.selected && i == 3 ? IM_COL32(64, 140, 240, 160) : IM_COL32(45, 50, 60, 240);
+            list.AddRectFilled(ImVec2(10, 20.0f + i * 40), ImVec2(190, 50.0f + i * 40), col, 4.0f);
+        }
+        float x = static_cast<float>(scene.panel_x);
+        list.AddRectFilled(ImVec2(220 + x, 80), ImVec2(520 + x, 300), IM_COL32(30, 34, 42, 200), 8.0f);
+        list.AddCircleFilled(ImVec2(300, 380), 30, IM_COL32(64, 140, 240, 200));
+        float start = scene.spinner * 0.35f;
+        for (int i = 0; i <= 30; ++i) {
+            float a = start + 4.71f * i / 30;
+            list.PathLineTo(ImVec2(420 + cosf(a) * 24, 400 + sinf(a) * 24));
+        }
+        list.PathStroke(IM_COL32(120, 180, 255, 200), false, 4.0f);
+        list.AddImage(reinterpret_cast<ImTextureID>(g_texture), ImVec2(500, 380), ImVec2(600, 460));
+        if (scene.toast) list.AddRectFilled(ImVec2(430, 20), ImVec2(620, 64), IM_COL32(30, 30, 30, 200), 8.0f);
+    }
+
+    uint32_t g_rng = 12345;
+    int Random(int n) {
+        g_rng = g_rng * 1664525u + 1013904223u;
+        return static_cast<int>((g_rng >> 8) % static_cast<uint32_t>(n));
+    }
+
+    // Mostly idle frames with occasional changes, like the launcher between
+    // input events.
+    void Step(Scene& scene) {
+        switch (Random(10)) {
+        case 0: scene.spinner++; break;
+        case 1: scene.toast = !scene.toast; break;
+        case 2: scene.panel_x = 20 + Random(60); break;
+        case 3: scene.selected = !scene.selected; break;
+        default: break;
+        }
+    }
+
+    struct Result {
+        int frames = 0;
+        int presents = 0;
+        int mismatches = 0;
+        uint64_t pixels = 0;
+    };
+
+    Result Run(int buffers, bool bounds_only, int frames) {
+        ImDrawList list;
+        ImDrawData draw_data;
+        draw_data.CmdLists.push_back(&list);
+        draw_data.DisplaySize = ImVec2(kWidth, kHeight);
+
+        // Distinct garbage per buffer, so an unrepaired pixel shows.
+        std::vector<std::vector<uint32_t>> chain;
+        for (int b = 0; b < buffers; ++b) chain.emplace_back(kWidth * kHeight, 0xDEAD0000u + b);
+        std::vector<uint32_t> reference(kWidth * kHeight);
+        const SoftwareTarget reference_target = { reference.data(), kWidth, kHeight, kWidth };
+        const DamageRect full = { 0, 0, kWidth, kHeight };
+
+        DamageTracker damage;
+        SoftwareRenderer renderer;
+        renderer.SetTexture(reinterpret_cast<ImTextureID>(g_texture), g_texture, 2, 2);
+        Scene scene;
+        int back = 0;
+        Result result;
+        g_rng = 12345;
+        for (int f = 0; f < frames; ++f) {
+            Step(scene);
+            // Texture contents change under unchanged geometry now and then.
+            if (f % 97 == 96) {
+                g_texture[0] ^= 0xFF;
+                damage.Invalidate();
+            }
+            Build(list, scene);
+            damage.Update(&draw_data);
+            ++result.frames;
+            if (!damage.HasChanges()) continue;
+
+            std::vector<DamageRect> rects = damage.Damage(buffers);
+            if (bounds_only) rects.assign(1, DamageTracker::Bounds(rects));
+            const SoftwareTarget target = { chain[back].data(), kWidth, kHeight, kWidth };
+            renderer.Render(&draw_data, target, rects.data(), static_cast<int>(rects.size()), kClear);
+            result.pixels += renderer.PixelsTouched();
+            renderer.Render(&draw_data, reference_target, &full, 1, kClear);
+            if (memcmp(chain[back].data(), reference.data(), reference.size() * sizeof(uint32_t)) != 0) {
+                if (result.mismatches++ == 0) fprintf(stderr, "  first mismatch at frame %d\n", f);
+            }
+            damage.Presented();
+            ++result.presents;
+            back = (back + 1) % buffers;
+        }
+        return result;
+    }
+}
+
+int main(int argc, char** argv) {
+    int frames = argc > 1 ? atoi(argv[1]) : 2000;
+    if (frames <= 0) {
+        printf("usage: damage_check [frames]\n");
+        return 2;
+    }
+    int failures = 0;
+    for (int buffers = 1; buffers <= DamageTracker::kMaxBufferAge; ++buffers) {
+        for (int bounds_only = 0; bounds_only <= 1; ++bounds_only) {
+            Result r = Run(buffers, bounds_only != 0, frames);
+            double share = static_cast<double>(r.pixels) / (static_cast<double>(r.presents) * kWidth * kHeight);
+            printf("buffers %d  %-12s  frames %5d  presents %5d  pixel writes/present %5.1f%%  mismatches %d\n", buffers,
+                   bounds_only ? "bounding box" : "per rect", r.frames, r.presents, 100.0 * share, r.mismatches);
+            failures += r.mismatches;
+        }
+    }
+    return failures != 0;
+}
@@ -0,0 +1,143 @@
+// Offline benchmark for the draw list primitive builders. Fills a draw list
+// with each kind of primitive and reports vertices written per second. The
+// SSE2 paths are chosen at compile time, so build it twice (once with
+// -DIMGUI_DISABLE_SSE) to compare them with the scalar loops; the printed
+// checksums must match between the two builds.
+//
+// Build instructions are in README.md.
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <vector>
+
+#include "imgui.h"
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    struct Options {
+        int prims = 20000;  // Primitives per frame.
+        int frames = 200;
+    };
+
+    struct Scenario {
+        const char* name;
+        std::function<void(ImDrawList&)> draw;
+    };
+
+    // FNV-1a over the vertex and index buffers.
+    uint64_t Checksum(const ImDrawList& list) {
+        uint64_t h = 0xCBF29CE484222325ull;
+        auto mix = [&h](const void* data, size_t size) {
+            const unsigned char* p = static_cast<const unsigned char*>(data);
+            for (size_t i = 0; i < size; ++i) h = (h ^ p[i]) * 0x100000001B3ull;
+        };
+        mix(list.VtxBuffer.Data, static_cast<size_t>(list.VtxBuffer.Size) * sizeof(ImDrawVert));
+        mix(list.IdxBuffer.Data, static_cast<size_t>(list.IdxBuffer.Size) * sizeof(ImDrawIdx));
+        return h;
+    }
+
+    void Run(const Scenario& scenario, const Options& options) {
+        ImDrawList list;
+        // Warm-up frame, so buffers are at their final size.
+        list._ResetForNewFrame();
+        scenario.draw(list);
+        std::vector<double> seconds;
+        for (int f = 0; f < options.frames; ++f) {
+            list._ResetForNewFrame();
+            Clock::time_point begin = Clock::now();
+            scenario.draw(list);
+            seconds.push_back(std::chrono::duration<double>(Clock::now() - begin).count());
+        }
+        std::sort(seconds.begin(), seconds.end());
+        double p50 = seconds[seconds.size() / 2];
+        printf("%-28s %8d vtx/frame  %9.1f us  %8.1f Mvtx/s  checksum %016llx\n", scenario.name,
+               list.VtxBuffer.Size, p50 * 1e6, list.VtxBuffer.Size / p50 / 1e6,
+               static_cast<unsigned long long>(Checksum(list)));
+    }
+
+    bool ParseOptions(int argc, char** argv, Options& options) {
+        for (int i = 1; i < argc; ++i) {
+            const char* value = i + 1 < argc ? argv[i + 1] : nullptr;
+            int* target = nullptr;
+            if (strcmp(argv[i], "--prims") == 0) target = &options.prims;
+            else if (strcmp(argv[i], "--frames") == 0) target = &options.frames;
+            if (!target || !value) return false;
+            *target = atoi(value);
+            ++i;
+        }
+        return options.prims > 0 && options.frames > 0;
+    }
+}
+
+int main(int argc, char** argv) {
+    Options options;
+    if (!ParseOptions(argc, argv, options)) {
+        printf("usage: draw_bench [--prims N] [--frames N]\n");
+        return 2;
+    }
+#if (defined(_M_X64) || defined(__x86_64__) || defined(__SSE2__)) && !defined(IMGUI_DISABLE_SSE)
+    printf("primitive builders: SSE2\n");
+#else
+    printf("primitive builders: scalar\n");
+#endif
+
+    const int n = options.prims;
+    std::vector<ImVec4> rects(n);
+    std::vector<ImU32> cols(n);
+    for (int i = 0; i < n; ++i) {
+        float x = static_cast<float>(i % 200) * 6.0f;
+        float y = static_cast<float>(i / 200) * 6.0f;
+        rects[i] = ImVec4(x, y, x + 5.0f, y + 5.0f);
+        cols[i] = IM_COL32(i & 0xFF, (i >> 8) & 0xFF, 128, 255);
+    }
+    std::vector<ImVec2> polygon(32);
+    for (int i = 0; i < 32; ++i) {
+        float a = i * 6.2831853f / 32;
+        polygon[i] = ImVec2(100.0f + std::cos(a) * 40.0f, 100.0f + std::sin(a) * 40.0f);
+    }
+
+    const Scenario scenarios[] = {
+        { "PrimRectBatch (one run)", [&](ImDrawList& list) { list.PrimRectBatch(rects.data(), cols.data(), n); } },
+        { "AddRectFilled (one by one)",
+          [&](ImDrawList& list) {
+              for (int i = 0; i < n; ++i) {
+                  const ImVec4& r = rects[i];
+                  list.AddRectFilled(ImVec2(r.x, r.y), ImVec2(r.z, r.w), cols[i]);
+              }
+          } },
+        { "AddRectFilledMultiColor",
+          [&](ImDrawList& list) {
+              for (int i = 0; i < n; ++i) {
+                  const ImVec4& r = rects[i];
+                  list.AddRectFilledMultiColor(ImVec2(r.x, r.y), ImVec2(r.z, r.w), cols[i], cols[i], 0xFF000000,
+                                               0xFF000000);
+              }
+          } },
+        { "AddRectFilled (rounded)",
+          [&](ImDrawList& list) {
+              for (int i = 0; i < n / 8; ++i) {
+                  const ImVec4& r = rects[i];
+                  list.AddRectFilled(ImVec2(r.x, r.y), ImVec2(r.z + 20.0f, r.w + 20.0f), cols[i], 6.0f);
+              }
+          } },
+        { "AddConvexPolyFilled (32)",
+          [&](ImDrawList& list) {
+              for (int i = 0; i < n / 8; ++i) list.AddConvexPolyFilled(polygon.data(), 32, cols[i]);
+          } },
+        { "AddCircleFilled (r=12)",
+          [&](ImDrawList& list) {
+              for (int i = 0; i < n / 8; ++i) {
+                  list.AddCircleFilled(ImVec2(rects[i].x, rects[i].y), 12.0f, cols[i]);
+              }
+          } },
+    };
+    for (const Scenario& scenario : scenarios) Run(scenario, options);
+    return 0;
+}
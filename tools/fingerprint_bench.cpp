@@ -0,0 +1,198 @@
+// Offline throughput harness for target fingerprinting. Generates a large
+// file, then measures XXH3 in memory (the hash's ceiling), over a read-only
+// mapping in the chunks the service uses, and end to end through
+// FingerprintService, reporting GB/s for each. File passes run cold (pages
+// dropped from the cache first) and warm. The service's hash must match
+// the direct one, and a second request must be answered from the index.
+//
+// Build instructions are in README.md.
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "fingerprint.h"
+#include "mapped_file.h"
+#include "xxh3.h"
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    struct Options {
+        double size_gb = 4.0;
+        std::string file = "/tmp/fingerprint_bench.bin";
+        bool keep = false;
+    };
+
+    const size_t kWriteChunk = 64u << 20;
+    // Matches kHashChunkSize in fingerprint.cpp.
+    const size_t kHashChunk = 8u << 20;
+
+    double Seconds(Clock::time_point begin) {
+        return std::chrono::duration<double>(Clock::now() - begin).count();
+    }
+
+    double GBps(uint64_t bytes, double seconds) {
+        return static_cast<double>(bytes) / seconds / 1e9;
+    }
+
+    void FillRandom(std::vector<uint8_t>& buffer, uint64_t seed) {
+        uint64_t x = seed * 0x9E3779B97F4A7C15ull + 1;
+        for (size_t i = 0; i + 8 <= buffer.size(); i += 8) {
+            x ^= x << 13;
+            x ^= x >> 7;
+            x ^= x << 17;
+            memcpy(&buffer[i], &x, 8);
+        }
+    }
+
+    bool Generate(const Options& options, uint64_t size) {
+        FILE* f = fopen(options.file.c_str(), "wb");
+        if (!f) return false;
+        std::vector<uint8_t> buffer(kWriteChunk);
+        FillRandom(buffer, 1);
+        bool ok = true;
+        for (uint64_t done = 0; ok && done < size;) {
+            size_t n = size - done < kWriteChunk ? static_cast<size_t>(size - done) : kWriteChunk;
+            // Vary every chunk so no two are alike.
+            memcpy(buffer.data(), &done, sizeof(done));
+            ok = fwrite(buffer.data(), 1, n, f) == n;
+            done += n;
+        }
+        return fclose(f) == 0 && ok;
+    }
+
+    // Writes back and evicts the file's pages, so the next read comes from
+    // the disk.
+    void DropCache(const std::string& path) {
+        int fd = open(path.c_str(), O_RDONLY);
+        if (fd < 0) return;
+        fdatasync(fd);
+        posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+        close(fd);
+    }
+
+    bool HashMapped(const std::string& path, uint64_t& hash) {
+        MappedFile file;
+        if (!file.Open(path, true)) return false;
+        Xxh3 hasher;
+        for (size_t offset = 0; offset < file.Size(); offset += kHashChunk) {
+            size_t chunk = file.Size() - offset < kHashChunk ? file.Size() - offset : kHashChunk;
+            hasher.Update(file.Data() + offset, chunk);
+        }
+        hash = hasher.Digest();
+        return true;
+    }
+
+    FingerprintStatus WaitDone(FingerprintService& service) {
+        for (;;) {
+            FingerprintStatus status = service.Status();
+            if (status.state == FingerprintState::Done || status.state == FingerprintState::Failed) return status;
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+
+    bool ParseOptions(int argc, char** argv, Options& options) {
+        for (int i = 1; i < argc; ++i) {
+            const char* value = i + 1 < argc ? argv[i + 1] : nullptr;
+            if (strcmp(argv[i], "--keep") == 0) {
+                options.keep = true;
+                continue;
+            }
+            if (!value) return false;
+            if (strcmp(argv[i], "--size-gb") == 0) options.size_gb = atof(value);
+            else if (strcmp(argv[i], "--file") == 0) options.file = value;
+            else return false;
+            ++i;
+        }
+        return options.size_gb > 0.0 && !options.file.empty();
+    }
+}
+
+int main(int argc, char** argv) {
+    Options options;
+    if (!ParseOptions(argc, argv, options)) {
+        printf("usage: fingerprint_bench [--size-gb N] [--file PATH] [--keep]\n");
+        return 2;
+    }
+    // Keep the service's cache index out of the user's data directory.
+    std::string data_home = options.file + ".data";
+    setenv("XDG_DATA_HOME", data_home.c_str(), 1);
+
+    const uint64_t size = static_cast<uint64_t>(options.size_gb * 1e9) & ~uint64_t(7);
+    Clock::time_point begin = Clock::now();
+    if (!Generate(options, size)) {
+        fprintf(stderr, "cannot write %s\n", options.file.c_str());
+        return 1;
+    }
+    printf("generated %s: %.2f GB in %.1f s\n", options.file.c_str(), size / 1e9, Seconds(begin));
+
+    {
+        std::vector<uint8_t> buffer(256u << 20);
+        FillRandom(buffer, 2);
+        begin = Clock::now();
+        uint64_t h = Xxh3Hash(buffer.data(), buffer.size());
+        double s = Seconds(begin);
+        printf("%-30s %7.2f GB/s  (%016llx)\n", "XXH3 in memory, 256 MB", GBps(buffer.size(), s),
+               static_cast<unsigned long long>(h));
+    }
+
+    uint64_t direct = 0;
+    for (int warm = 0; warm <= 1; ++warm) {
+        if (!warm) DropCache(options.file);
+        begin = Clock::now();
+        if (!HashMapped(options.file, direct)) {
+            fprintf(stderr, "cannot map %s\n", options.file.c_str());
+            return 1;
+        }
+        double s = Seconds(begin);
+        printf("%-30s %7.2f GB/s  (%016llx)\n", warm ? "mapped file, warm" : "mapped file, cold", GBps(size, s),
+               static_cast<unsigned long long>(direct));
+    }
+
+    int failures = 0;
+    {
+        FingerprintService service;
+        service.Load();
+        DropCache(options.file);
+        begin = Clock::now();
+        service.Request(options.file);
+        FingerprintStatus status = WaitDone(service);
+        double s = Seconds(begin);
+        printf("%-30s %7.2f GB/s  (%016llx)\n", "FingerprintService, cold", GBps(size, s),
+               static_cast<unsigned long long>(status.hash));
+        if (status.state != FingerprintState::Done || status.hash != direct || status.from_cache) {
+            fprintf(stderr, "service hash does not match the direct hash\n");
+            ++failures;
+        }
+    }
+    {
+        // A new service reloads the index the first one wrote.
+        FingerprintService service;
+        service.Load();
+        begin = Clock::now();
+        service.Request(options.file);
+        FingerprintStatus status = WaitDone(service);
+        printf("%-30s %7.3f ms\n", "FingerprintService, indexed", Seconds(begin) * 1e3);
+        if (!status.from_cache || status.hash != direct) {
+            fprintf(stderr, "unchanged file was not answered from the index\n");
+            ++failures;
+        }
+    }
+
+    if (!options.keep) {
+        remove(options.file.c_str());
+        remove((data_home + "/ModGui/fingerprints.idx").c_str());
+        rmdir((data_home + "/ModGui").c_str());
+        rmdir(data_home.c_str());
+    }
+    return failures != 0;
+}
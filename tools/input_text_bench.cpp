@@ -0,0 +1,258 @@
+// Offline benchmark for InputText. Builds a large multi-line document,
+// focuses an InputTextMultiline on it and replays typing, caret movement,
+// deletion and mouse drags through ImGuiIO one frame at a time, reporting
+// the cost per frame. For comparison it times a full re-measure of the
+// document, which a widget without the incremental glyph offset cache would
+// pay on every keystroke. The edited text is checked against the expected
+// result after each scenario.
+//
+// Build instructions are in README.md.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "imgui.h"
+#include "imgui_internal.h"
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    struct Options {
+        int lines = 50000;
+        int columns = 72;
+        int keys = 5000;
+    };
+
+    const ImVec2 kWindowSize(1280, 800);
+    const ImVec2 kDocSize(1200, 700);
+    // Inside the document field, and inside the password field below it.
+    const ImVec2 kDocPoint(120, 90);
+    const ImVec2 kPasswordPoint(60, 712);
+
+    struct Samples {
+        std::vector<double> us;
+
+        void Report(const char* name) {
+            if (us.empty()) return;
+            std::sort(us.begin(), us.end());
+            double total = 0.0;
+            for (double v : us) total += v;
+            auto at = [&](double q) { return us[std::min(us.size() - 1, static_cast<size_t>(q * us.size()))]; };
+            printf("%-26s %7zu frames  mean %8.2f us  p50 %8.2f  p99 %8.2f  max %8.2f\n", name, us.size(),
+                   total / us.size(), at(0.50), at(0.99), us.back());
+        }
+    };
+
+    double Micros(Clock::time_point begin, Clock::time_point end) {
+        return std::chrono::duration<double, std::micro>(end - begin).count();
+    }
+
+    std::string g_doc;
+    std::string g_password;
+
+    // One UI frame; returns its duration.
+    double Frame() {
+        Clock::time_point begin = Clock::now();
+        ImGui::NewFrame();
+        ImGui::SetNextWindowPos(ImVec2(0, 0));
+        ImGui::SetNextWindowSize(kWindowSize);
+        ImGui::Begin("bench");
+        ImGui::InputTextMultiline("##doc", &g_doc, kDocSize);
+        ImGui::InputText("##password", &g_password, ImGuiInputTextFlags_Password);
+        ImGui::End();
+        ImGui::Render();
+        return Micros(begin, Clock::now());
+    }
+
+    void Key(ImGuiKey key, bool ctrl = false, bool shift = false) {
+        ImGuiIO& io = ImGui::GetIO();
+        io.KeyCtrl = ctrl;
+        io.KeyShift = shift;
+        io.AddKeyEvent(key, true);
+        io.KeyCtrl = false;
+        io.KeyShift = false;
+    }
+
+    void Click(const ImVec2& pos) {
+        ImGuiIO& io = ImGui::GetIO();
+        io.AddMousePosEvent(pos.x, pos.y);
+        io.AddMouseButtonEvent(0, true);
+        Frame();
+        io.AddMouseButtonEvent(0, false);
+        Frame();
+    }
+
+    // Types |count| characters, pressing Enter every |columns| when
+    // |newlines|; returns what was typed.
+    std::string Type(int count, int columns, bool newlines, Samples& samples) {
+        std::string typed;
+        for (int i = 0; i < count; ++i) {
+            if (newlines && i % columns == columns - 1) {
+                Key(ImGuiKey_Enter);
+                typed.push_back('\n');
+            } else {
+                char c = static_cast<char>('a' + i % 26);
+                ImGui::GetIO().AddInputCharacter(static_cast<unsigned char>(c));
+                typed.push_back(c);
+            }
+            samples.us.push_back(Frame());
+        }
+        return typed;
+    }
+
+    std::string MakeDocument(int lines, int columns) {
+        // Some multi-byte characters so the cache handles UTF-8 offsets.
+        static const char* const kWords[] = { "launcher", "profile", "caf\xC3\xA9", "na\xC3\xAFve", "\xE2\x86\x92",
+                                              "verify", "queue", "glyph", "offset", "cache" };
+        std::string doc;
+        char prefix[16];
+        for (int line = 0; line < lines; ++line) {
+            snprintf(prefix, sizeof(prefix), "%06d", line);
+            std::string text = prefix;
+            for (int w = line; static_cast<int>(text.size()) < columns; ++w) {
+                text += ' ';
+                text += kWords[w % IM_ARRAYSIZE(kWords)];
+            }
+            doc += text;
+            if (line + 1 < lines) doc += '\n';
+        }
+        return doc;
+    }
+
+    size_t LineStart(const std::string& text, int line) {
+        size_t pos = 0;
+        for (int l = 0; l < line && pos != std::string::npos; ++l) {
+            pos = text.find('\n', pos);
+            if (pos != std::string::npos) ++pos;
+        }
+        return pos == std::string::npos ? text.size() : pos;
+    }
+
+    bool Check(const char* scenario, const std::string& expected) {
+        if (g_doc == expected) return true;
+        fprintf(stderr, "%s: edited text does not match (got %zu bytes, expected %zu)\n", scenario, g_doc.size(),
+                expected.size());
+        return false;
+    }
+
+    void PrintUsage() {
+        printf("usage: input_text_bench [--lines N] [--columns N] [--keys N]\n");
+    }
+
+    bool ParseOptions(int argc, char** argv, Options& options) {
+        for (int i = 1; i < argc; ++i) {
+            const char* arg = argv[i];
+            const char* value = i + 1 < argc ? argv[i + 1] : nullptr;
+            int* target = nullptr;
+            if (strcmp(arg, "--lines") == 0) target = &options.lines;
+            else if (strcmp(arg, "--columns") == 0) target = &options.columns;
+            else if (strcmp(arg, "--keys") == 0) target = &options.keys;
+            if (!target || !value) return false;
+            *target = atoi(value);
+            ++i;
+        }
+        return options.lines > 1 && options.columns > 8 && options.keys > 0;
+    }
+}
+
+int main(int argc, char** argv) {
+    Options options;
+    if (!ParseOptions(argc, argv, options)) {
+        PrintUsage();
+        return 2;
+    }
+
+    ImGui::CreateContext();
+    ImGui::GetIO().DisplaySize = kWindowSize;
+    g_doc = MakeDocument(options.lines, options.columns);
+    printf("document: %d lines, %zu bytes\n", options.lines, g_doc.size());
+
+    // What every keystroke would cost if the widget re-measured the text.
+    Samples rebuild;
+    {
+        ImGuiInputTextState reference;
+        for (int i = 0; i < 20; ++i) {
+            Clock::time_point begin = Clock::now();
+            reference.Init(g_doc.data(), static_cast<int>(g_doc.size()), -1, 0.0f, false);
+            rebuild.us.push_back(Micros(begin, Clock::now()));
+        }
+    }
+
+    Click(kDocPoint);
+
+    // Typing at the end of the document.
+    Samples type_end;
+    std::string expected = g_doc;
+    Key(ImGuiKey_End, true);
+    Frame();
+    expected += Type(options.keys, options.columns, true, type_end);
+    if (!Check("type at end", expected)) return 1;
+
+    // Typing in the middle: every later line shifts.
+    Samples type_middle;
+    const int middle_line = options.lines / 2;
+    Key(ImGuiKey_Home, true);
+    for (int i = 0; i < middle_line; ++i) Key(ImGuiKey_DownArrow);
+    Key(ImGuiKey_Home);
+    Frame();
+    size_t insert_at = LineStart(expected, middle_line);
+    std::string typed = Type(options.keys, options.columns, true, type_middle);
+    expected.insert(insert_at, typed);
+    if (!Check("type in middle", expected)) return 1;
+
+    Samples backspace;
+    const int deletes = options.keys / 2;
+    for (int i = 0; i < deletes; ++i) {
+        Key(ImGuiKey_Backspace);
+        backspace.us.push_back(Frame());
+    }
+    expected.erase(insert_at + typed.size() - deletes, deletes);
+    if (!Check("backspace in middle", expected)) return 1;
+
+    // Vertical caret moves keep their column through the cache.
+    Samples caret_moves;
+    for (int i = 0; i < options.keys; ++i) {
+        Key((i / 40) % 2 ? ImGuiKey_UpArrow : ImGuiKey_DownArrow, false, i % 3 == 0);
+        caret_moves.us.push_back(Frame());
+    }
+
+    // Drag selection: every frame hit-tests the mouse position.
+    Samples drag;
+    ImGuiIO& io = ImGui::GetIO();
+    io.AddMousePosEvent(kDocPoint.x, kDocPoint.y);
+    io.AddMouseButtonEvent(0, true);
+    Frame();
+    for (int i = 0; i < options.keys; ++i) {
+        float t = static_cast<float>(i % 500) / 500.0f;
+        io.AddMousePosEvent(10.0f + t * (kDocSize.x - 20.0f), 10.0f + (i % 97) * 7.0f);
+        drag.us.push_back(Frame());
+    }
+    io.AddMouseButtonEvent(0, false);
+    Frame();
+    if (!Check("drag select", expected)) return 1;
+
+    // Masked field: same cache, measured with the '*' advance.
+    Samples password;
+    Click(kPasswordPoint);
+    std::string typed_password = Type(options.keys, options.columns, false, password);
+    if (g_password != typed_password) {
+        fprintf(stderr, "password: edited text does not match\n");
+        return 1;
+    }
+
+    printf("%d keys per scenario, document now %zu bytes\n", options.keys, g_doc.size());
+    type_end.Report("type at end");
+    type_middle.Report("type in middle");
+    backspace.Report("backspace in middle");
+    caret_moves.Report("up/down (shift) moves");
+    drag.Report("drag select");
+    password.Report("password field");
+    rebuild.Report("full re-measure (ref)");
+    ImGui::DestroyContext();
+    return 0;
+}
@@ -0,0 +1,211 @@
+// Offline benchmark for ImGuiListClipper and AsyncRowSorter. Draws a list
+// view like the launcher's output pane over 100 up to 1M rows, parked at the
+// top, scrolled by the mouse wheel and following appended rows, and reports
+// the frame time, which should not depend on the row count. Then sorts the
+// largest list on the background sorter while frames keep drawing with the
+// previous order. It fails if a frame submits more rows than fit in the
+// view, if the view does not stay put, scroll or follow as driven, or if a
+// sort comes back out of order.
+//
+// Build instructions are in README.md.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#include "imgui.h"
+#include "row_sorter.h"
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    const ImVec2 kWindowSize(800, 600);
+    const float kListHeight = 400.0f;
+
+    struct Options {
+        int max_rows = 1000000;
+        int frames = 2000;
+    };
+
+    enum class Mode { Top, Wheel, Follow };
+
+    struct FrameResult {
+        int submitted = 0;
+        int display_end = 0;
+        bool followed = false;
+    };
+
+    std::vector<uint32_t> g_keys;
+    const AsyncRowSorter* g_sorter = nullptr;
+
+    // One frame of a list of |count| rows.
+    FrameResult Frame(int count) {
+        FrameResult result;
+        ImGui::NewFrame();
+        ImGui::SetNextWindowPos(ImVec2(0, 0));
+        ImGui::SetNextWindowSize(kWindowSize);
+        ImGui::Begin("bench");
+        ImGui::BeginChild("list", ImVec2(0, kListHeight), false);
+        result.followed = ImGui::GetScrollY() >= ImGui::GetScrollMaxY();
+        ImGuiListClipper clipper;
+        clipper.Begin(count);
+        if (result.followed) {
+            ImGui::SetScrollY(clipper.StartPosY + clipper.RowTop(clipper.ItemsCount) - ImGui::GetWindowSize().y);
+        }
+        while (clipper.Step()) {
+            for (int i = clipper.DisplayStart; i < clipper.DisplayEnd; ++i) {
+                uint32_t row = g_sorter ? g_sorter->Row(static_cast<uint32_t>(i)) : static_cast<uint32_t>(i);
+                ImGui::Text("%8u  key %08x", row, g_keys[row]);
+            }
+            result.submitted += clipper.DisplayEnd - clipper.DisplayStart;
+            result.display_end = clipper.DisplayEnd;
+        }
+        ImGui::EndChild();
+        ImGui::End();
+        ImGui::Render();
+        return result;
+    }
+
+    double Median(std::vector<double>& v) {
+        std::sort(v.begin(), v.end());
+        return v[v.size() / 2];
+    }
+
+    // Runs |frames| frames and returns the median frame time in microseconds,
+    // or a negative value if a check failed.
+    double Run(int rows, Mode mode, const Options& options, int& submitted) {
+        ImGuiIO& io = ImGui::GetIO();
+        io.AddMousePosEvent(100.0f, 100.0f);
+        int count = rows;
+        // Settle the scroll extent, then wheel to the bottom to follow or
+        // back to the top otherwise.
+        Frame(count);
+        io.AddMouseWheelEvent(mode == Mode::Follow ? -1e9f : 1e9f);
+        Frame(count);
+        const int max_visible = static_cast<int>(kListHeight / ImGui::GetTextLineHeightWithSpacing()) + 2;
+        std::vector<double> us;
+        submitted = 0;
+        int lowest_end = count;
+        int highest_end = 0;
+        for (int f = 0; f < options.frames; ++f) {
+            if (mode == Mode::Wheel) io.AddMouseWheelEvent(f % 400 < 200 ? -4.0f : 3.0f);
+            if (mode == Mode::Follow) count = rows + f;
+            Clock::time_point begin = Clock::now();
+            FrameResult result = Frame(count);
+            us.push_back(std::chrono::duration<double, std::micro>(Clock::now() - begin).count());
+            submitted = std::max(submitted, result.submitted);
+            if (result.submitted > max_visible) {
+                fprintf(stderr, "%d rows: frame %d submitted %d rows\n", rows, f, result.submitted);
+                return -1.0;
+            }
+            if (mode == Mode::Follow && (!result.followed || result.display_end != count)) {
+                fprintf(stderr, "%d rows: frame %d lost the newest row\n", rows, f);
+                return -1.0;
+            }
+            if (mode == Mode::Top && result.display_end != result.submitted) {
+                fprintf(stderr, "%d rows: frame %d left the top\n", rows, f);
+                return -1.0;
+            }
+            lowest_end = std::min(lowest_end, result.display_end);
+            highest_end = std::max(highest_end, result.display_end);
+        }
+        if (mode == Mode::Wheel && lowest_end == highest_end) {
+            fprintf(stderr, "%d rows: the wheel did not scroll\n", rows);
+            return -1.0;
+        }
+        return Median(us);
+    }
+
+    bool Sorted(const AsyncRowSorter& sorter, uint32_t count, bool descending) {
+        const std::vector<uint32_t>& order = sorter.Order();
+        if (order.size() != count) return false;
+        for (size_t i = 1; i < order.size(); ++i) {
+            uint32_t a = g_keys[order[i - 1]];
+            uint32_t b = g_keys[order[i]];
+            if (descending ? a < b : a > b) return false;
+        }
+        return true;
+    }
+
+    bool ParseOptions(int argc, char** argv, Options& options) {
+        for (int i = 1; i < argc; ++i) {
+            const char* value = i + 1 < argc ? argv[i + 1] : nullptr;
+            int* target = nullptr;
+            if (strcmp(argv[i], "--max-rows") == 0) target = &options.max_rows;
+            else if (strcmp(argv[i], "--frames") == 0) target = &options.frames;
+            if (!target || !value) return false;
+            *target = atoi(value);
+            ++i;
+        }
+        return options.max_rows >= 100 && options.frames > 0;
+    }
+}
+
+int main(int argc, char** argv) {
+    Options options;
+    if (!ParseOptions(argc, argv, options)) {
+        printf("usage: list_clipper_bench [--max-rows N] [--frames N]\n");
+        return 2;
+    }
+    ImGui::CreateContext();
+    ImGui::GetIO().DisplaySize = kWindowSize;
+    g_keys.resize(static_cast<size_t>(options.max_rows) + options.frames);
+    uint32_t x = 2463534242u;
+    for (uint32_t& key : g_keys) {
+        x ^= x << 13;
+        x ^= x >> 17;
+        x ^= x << 5;
+        key = x;
+    }
+
+    const struct {
+        Mode mode;
+        const char* name;
+    } modes[] = { { Mode::Top, "top" }, { Mode::Wheel, "wheel" }, { Mode::Follow, "follow" } };
+    printf("%9s %-7s %9s %10s\n", "rows", "mode", "rows/frm", "us/frame");
+    double first[3] = {};
+    double last[3] = {};
+    for (int rows = 100; rows <= options.max_rows; rows *= 100) {
+        for (int m = 0; m < 3; ++m) {
+            int submitted = 0;
+            double us = Run(rows, modes[m].mode, options, submitted);
+            if (us < 0.0) return 1;
+            printf("%9d %-7s %9d %10.2f\n", rows, modes[m].name, submitted, us);
+            if (rows == 100) first[m] = us;
+            last[m] = us;
+        }
+    }
+    for (int m = 0; m < 3; ++m) {
+        printf("%-7s largest / 100 rows: %.2fx\n", modes[m].name, last[m] / first[m]);
+    }
+
+    // Sort the largest list twice, the second request superseding the
+    // first, while frames keep drawing in the current order.
+    AsyncRowSorter sorter;
+    g_sorter = &sorter;
+    const uint32_t count = static_cast<uint32_t>(options.max_rows);
+    const std::vector<uint32_t>* keys = &g_keys;
+    Clock::time_point begin = Clock::now();
+    sorter.Sort(count, [keys](uint32_t a, uint32_t b) { return (*keys)[a] < (*keys)[b]; });
+    sorter.Sort(count, [keys](uint32_t a, uint32_t b) { return (*keys)[a] > (*keys)[b]; });
+    std::vector<double> us;
+    while (!sorter.Poll()) {
+        Clock::time_point frame_begin = Clock::now();
+        Frame(static_cast<int>(count));
+        us.push_back(std::chrono::duration<double, std::micro>(Clock::now() - frame_begin).count());
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    double sort_ms = std::chrono::duration<double, std::milli>(Clock::now() - begin).count();
+    printf("background sort of %u rows: %.1f ms, %zu frames drawn meanwhile (p50 %.2f us)\n", count, sort_ms,
+           us.size(), us.empty() ? 0.0 : Median(us));
+    if (!Sorted(sorter, count, true)) {
+        fprintf(stderr, "sorted order is wrong\n");
+        return 1;
+    }
+    return 0;
+}
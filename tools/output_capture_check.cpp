@@ -0,0 +1,371 @@
+// Offline check for child output capture. Feeds OutputRing scripted and
+// random output in random chunks and compares what it holds with a model:
+// line splitting, '\r\n' endings, per-stream open lines, breaking of lines
+// longer than kMaxLineLength, and the lines dropped when the byte or line
+// capacity wraps. Then starts /bin/sh -c scripts through ChildProcess's
+// posix_spawn path and checks the stdout and stderr lines that arrive,
+// exit codes, the environment and working directory, that a child keeps
+// running normally after capture stops, and that a released child is reaped.
+//
+// Build instructions are in README.md.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <cerrno>
+#include <signal.h>
+
+#include "child_process.h"
+#include "output_ring.h"
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    struct Options {
+        int rounds = 200;
+    };
+
+    int g_failures = 0;
+
+    void Expect(bool condition, const char* what) {
+        if (condition) return;
+        fprintf(stderr, "FAILED: %s\n", what);
+        ++g_failures;
+    }
+
+    uint32_t g_rng = 0x9E3779B9u;
+    uint32_t Random(uint32_t n) {
+        g_rng ^= g_rng << 13;
+        g_rng ^= g_rng >> 17;
+        g_rng ^= g_rng << 5;
+        return g_rng % n;
+    }
+
+    std::vector<OutputLine> ReadAll(const OutputRing& ring) {
+        std::vector<OutputLine> lines;
+        size_t count = ring.ReadLines(ring.FirstLine(), static_cast<size_t>(ring.EndLine() - ring.FirstLine()), lines);
+        lines.resize(count);
+        return lines;
+    }
+
+    void Append(OutputRing& ring, OutputStream stream, const std::string& text) {
+        ring.Append(stream, text.data(), text.size());
+    }
+
+    void CheckSplitting() {
+        OutputRing ring;
+        Append(ring, OutputStream::Stdout, "alpha\nbeta\r\ngam");
+        Append(ring, OutputStream::Stdout, "ma\n\n");
+        Append(ring, OutputStream::Stderr, "oops\n");
+        Append(ring, OutputStream::Stdout, "open");
+        // Another stream's output ends the open line's run; it stays as is.
+        Append(ring, OutputStream::Stderr, "err");
+        Append(ring, OutputStream::Stdout, "next\n");
+        std::vector<OutputLine> lines = ReadAll(ring);
+        const char* expected[] = { "alpha", "beta", "gamma", "", "oops", "open", "err", "next" };
+        bool same = lines.size() == 8;
+        for (size_t i = 0; same && i < lines.size(); ++i) same = lines[i].text == expected[i] && lines[i].number == i;
+        Expect(same, "lines are split on '\\n' with '\\r' dropped");
+        Expect(lines.size() == 8 && lines[4].stream == OutputStream::Stderr && lines[6].stream == OutputStream::Stderr &&
+                   lines[7].stream == OutputStream::Stdout,
+               "each line keeps its stream");
+
+        std::vector<OutputLine> tail;
+        Expect(ring.ReadTail(2, tail) == 2 && tail[0].text == "err" && tail[1].text == "next", "tail reads the newest");
+        ring.Clear();
+        Expect(ring.FirstLine() == 0 && ring.EndLine() == 0 && ring.DroppedLines() == 0, "clear empties the ring");
+    }
+
+    // Lines are broken every kMaxLineLength bytes whichever way the chunks
+    // fall, and a line of exactly that length is not followed by an empty one.
+    void CheckLongLines() {
+        const size_t max = OutputRing::kMaxLineLength;
+        const size_t lengths[] = { max - 1, max, max + 1, 2 * max, 2 * max + 5, 10000 };
+        for (size_t length : lengths) {
+            for (size_t chunk : { size_t(1) << 20, size_t(333), size_t(4096), size_t(1) }) {
+                OutputRing ring(1 << 20, 64);
+                std::string text(length, 'x');
+                for (size_t i = 0; i < length; ++i) text[i] = static_cast<char>('a' + i % 26);
+                std::string data = text + "\n" + "after\n";
+                for (size_t i = 0; i < data.size(); i += chunk) {
+                    ring.Append(OutputStream::Stdout, data.data() + i, std::min(chunk, data.size() - i));
+                }
+                std::vector<OutputLine> lines = ReadAll(ring);
+                size_t pieces = (length + max - 1) / max;
+                bool ok = lines.size() == pieces + 1 && lines.back().text == "after";
+                for (size_t p = 0; ok && p < pieces; ++p) ok = lines[p].text == text.substr(p * max, max);
+                if (!ok) {
+                    fprintf(stderr, "FAILED: %zu-byte line in %zu-byte chunks: %zu lines\n", length, chunk,
+                            lines.size());
+                    ++g_failures;
+                }
+            }
+        }
+    }
+
+    // Lines that tile the byte capacity exactly: the ring holds exactly
+    // capacity / length of them, with the oldest one starting right at the
+    // overwrite boundary.
+    void CheckExactFit() {
+        const size_t length = 64;
+        const size_t capacity = 2 * OutputRing::kMaxLineLength;
+        OutputRing ring(capacity, 1000);
+        for (int i = 0; i < 300; ++i) {
+            char text[length + 2];
+            snprintf(text, sizeof(text), "%0*d\n", static_cast<int>(length), i);
+            Append(ring, OutputStream::Stdout, text);
+        }
+        std::vector<OutputLine> lines = ReadAll(ring);
+        const size_t held = capacity / length;
+        bool ok = lines.size() == held && ring.DroppedLines() == 300 - held;
+        for (size_t i = 0; ok && i < lines.size(); ++i) ok = atoi(lines[i].text.c_str()) == static_cast<int>(300 - held + i);
+        Expect(ok, "lines that fill the bytes exactly are all kept");
+
+        OutputRing small(1 << 20, 5);
+        for (int i = 0; i < 12; ++i) Append(small, OutputStream::Stderr, std::to_string(i) + "\n");
+        lines = ReadAll(small);
+        Expect(lines.size() == 5 && small.FirstLine() == 7 && small.DroppedLines() == 7 && lines[0].text == "7" &&
+                   lines[4].text == "11",
+               "a full line index drops the oldest lines");
+    }
+
+    struct ModelLine {
+        OutputStream stream;
+        std::string text;
+        uint64_t start;  // Absolute byte offset of the text.
+        bool open;
+    };
+
+    // Random output in random chunks through rings small enough to wrap many
+    // times, compared with a model that applies the same rules: a line is
+    // dropped once its first byte is overwritten or the line index is full.
+    void CheckWrap(const Options& options) {
+        const size_t max = OutputRing::kMaxLineLength;
+        uint64_t total_dropped = 0;
+        for (int round = 0; round < options.rounds; ++round) {
+            size_t byte_capacity = max + 1 + Random(3 * static_cast<uint32_t>(max));
+            size_t line_capacity = 1 + Random(64);
+            OutputRing ring(byte_capacity, line_capacity);
+            std::vector<ModelLine> model;
+            uint64_t written = 0;
+            size_t first = 0;
+
+            for (int step = 0; step < 60; ++step) {
+                OutputStream stream = Random(4) == 0 ? OutputStream::Stderr : OutputStream::Stdout;
+                std::string data;
+                int parts = 1 + static_cast<int>(Random(6));
+                for (int p = 0; p < parts; ++p) {
+                    uint32_t kind = Random(10);
+                    size_t length = kind == 0 ? max + Random(static_cast<uint32_t>(max)) : Random(kind < 3 ? 3 : 200);
+                    for (size_t i = 0; i < length; ++i) data += static_cast<char>('!' + Random(90));
+                    if (Random(4) != 0) data += Random(8) == 0 ? "\r\n" : "\n";
+                }
+                // Append in random pieces; the model consumes byte by byte.
+                for (size_t i = 0; i < data.size();) {
+                    size_t piece = 1 + Random(static_cast<uint32_t>(data.size() - i));
+                    ring.Append(stream, data.data() + i, piece);
+                    i += piece;
+                }
+                for (size_t i = 0; i < data.size(); ++i) {
+                    ModelLine* line = nullptr;
+                    if (model.size() > first && model.back().open && model.back().stream == stream) line = &model.back();
+                    if (data[i] == '\n') {
+                        if (!line) {
+                            model.push_back({ stream, "", written, false });
+                            if (model.size() - first > line_capacity) ++first;
+                        } else {
+                            if (!line->text.empty() && line->text.back() == '\r') line->text.pop_back();
+                            line->open = false;
+                        }
+                        continue;
+                    }
+                    if (line && line->text.size() == max) {
+                        line->open = false;
+                        line = nullptr;
+                    }
+                    if (!line) {
+                        model.push_back({ stream, "", written, true });
+                        if (model.size() - first > line_capacity) ++first;
+                        line = &model.back();
+                    }
+                    line->text += data[i];
+                    ++written;
+                    while (first < model.size() && written > byte_capacity && model[first].start < written - byte_capacity) {
+                        ++first;
+                    }
+                }
+            }
+
+            std::vector<OutputLine> lines = ReadAll(ring);
+            bool ok = ring.FirstLine() == first && ring.EndLine() == model.size() && ring.DroppedLines() == first &&
+                      lines.size() == model.size() - first;
+            for (size_t i = 0; ok && i < lines.size(); ++i) {
+                const ModelLine& expected = model[first + i];
+                ok = lines[i].number == first + i && lines[i].stream == expected.stream && lines[i].text == expected.text;
+            }
+            if (!ok) {
+                fprintf(stderr, "FAILED: round %d (%zu bytes, %zu lines): ring holds [%llu, %llu), model [%zu, %zu)\n",
+                        round, byte_capacity, line_capacity, static_cast<unsigned long long>(ring.FirstLine()),
+                        static_cast<unsigned long long>(ring.EndLine()), first, model.size());
+                ++g_failures;
+            }
+            total_dropped += first;
+        }
+        printf("  %d rounds, %llu lines dropped in total\n", options.rounds,
+               static_cast<unsigned long long>(total_dropped));
+    }
+
+    // Waits for the child to exit and its output to drain into |ring|.
+    bool WaitFor(ChildProcess& process, const OutputRing& ring, uint64_t lines, int& exit_code) {
+        Clock::time_point deadline = Clock::now() + std::chrono::seconds(10);
+        while (Clock::now() < deadline) {
+            if (process.ExitCode(exit_code) && ring.EndLine() >= lines) return true;
+            std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        }
+        return false;
+    }
+
+    bool Run(ChildProcess& process, const std::string& script, OutputRing& ring,
+             const ChildLaunchOptions& base = ChildLaunchOptions()) {
+        ChildLaunchOptions options = base;
+        options.arguments = "-c '" + script + "'";
+        options.capture_output = true;
+        return process.Start("/bin/sh", options, &ring);
+    }
+
+    void CheckChildProcess() {
+        {
+            ChildProcess process;
+            OutputRing ring;
+            int exit_code = -1;
+            Expect(Run(process, "echo out1; echo err1 >&2; printf partial; echo err2 >&2; echo; exit 3", ring),
+                   "sh starts");
+            Expect(WaitFor(process, ring, 4, exit_code) && exit_code == 3, "exit code is reported");
+            int out = 0;
+            int err = 0;
+            for (const OutputLine& line : ReadAll(ring)) {
+                if (line.stream == OutputStream::Stdout) out += line.text == "out1" || line.text == "partial";
+                if (line.stream == OutputStream::Stderr) err += line.text == "err1" || line.text == "err2";
+            }
+            Expect(out == 2 && err == 2, "stdout and stderr lines arrive on their streams");
+        }
+        {
+            // Far more than the ring holds, as fast as the child can write.
+            ChildProcess process;
+            OutputRing ring(256 * 1024, 4096);
+            int exit_code = -1;
+            Clock::time_point begin = Clock::now();
+            Expect(Run(process, "seq 1 200000", ring), "seq starts");
+            Expect(WaitFor(process, ring, 200000, exit_code) && exit_code == 0, "seq output drains");
+            double ms = std::chrono::duration<double, std::milli>(Clock::now() - begin).count();
+            std::vector<OutputLine> lines = ReadAll(ring);
+            bool ok = ring.EndLine() == 200000 && ring.DroppedLines() == ring.FirstLine() && lines.size() == 4096;
+            for (size_t i = 0; ok && i < lines.size(); ++i) ok = lines[i].text == std::to_string(ring.FirstLine() + i + 1);
+            Expect(ok, "newest lines are kept in order, older ones counted as dropped");
+            printf("  200000 lines captured in %.1f ms, %llu dropped\n", ms,
+                   static_cast<unsigned long long>(ring.DroppedLines()));
+        }
+        {
+            ChildProcess process;
+            OutputRing ring;
+            int exit_code = -1;
+            Expect(Run(process, "head -c 10000 /dev/zero | tr \"\\\\0\" x; echo", ring), "long line starts");
+            Expect(WaitFor(process, ring, 3, exit_code), "long line drains");
+            std::vector<OutputLine> lines = ReadAll(ring);
+            Expect(lines.size() == 3 && lines[0].text.size() == OutputRing::kMaxLineLength &&
+                       lines[1].text.size() == OutputRing::kMaxLineLength && lines[2].text == std::string(1808, 'x'),
+                   "a long child line is broken at kMaxLineLength");
+        }
+        {
+            ChildProcess process;
+            OutputRing ring;
+            ChildLaunchOptions options;
+            options.working_dir = "/tmp";
+            options.environment.push_back({ "CAPTURE_CHECK", "yes" });
+            int exit_code = -1;
+            Expect(Run(process, "echo $CAPTURE_CHECK; pwd", ring, options), "sh with environment starts");
+            Expect(WaitFor(process, ring, 2, exit_code), "environment output drains");
+            std::vector<OutputLine> lines = ReadAll(ring);
+            Expect(lines.size() == 2 && lines[0].text == "yes" && lines[1].text == "/tmp",
+                   "environment and working directory apply");
+        }
+        {
+            // The child keeps writing after capture stops, more than a pipe
+            // holds; it must neither die of SIGPIPE nor block.
+            ChildProcess process;
+            OutputRing ring;
+            int exit_code = -1;
+            Expect(Run(process, "echo started; sleep 0.3; echo more; seq 1 100000 >&2; exit 3", ring),
+                   "writer starts");
+            Clock::time_point deadline = Clock::now() + std::chrono::seconds(5);
+            while (ring.EndLine() < 1 && Clock::now() < deadline) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            Clock::time_point begin = Clock::now();
+            process.StopCapture();
+            double ms = std::chrono::duration<double, std::milli>(Clock::now() - begin).count();
+            Expect(ms < 250.0 && process.Running(), "stopping capture returns while the child runs");
+            Expect(WaitFor(process, ring, 1, exit_code) && exit_code == 3,
+                   "a child writing after capture stops exits normally");
+            Expect(ring.EndLine() == 1, "nothing reaches the ring after capture stops");
+        }
+        {
+            // Released while running, the child is reaped once it exits
+            // rather than left as a zombie.
+            ChildProcess process;
+            OutputRing ring;
+            Expect(Run(process, "sleep 0.2; echo late", ring), "released child starts");
+            pid_t pid = static_cast<pid_t>(process.Pid());
+            process.Release();
+            Clock::time_point deadline = Clock::now() + std::chrono::seconds(5);
+            bool reaped = false;
+            while (!reaped && Clock::now() < deadline) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(5));
+                reaped = kill(pid, 0) != 0 && errno == ESRCH;
+            }
+            Expect(reaped, "a child released while running is reaped when it exits");
+        }
+        {
+            ChildProcess process;
+            OutputRing ring;
+            ChildLaunchOptions options;
+            options.capture_output = true;
+            Expect(!process.Start("/nonexistent/target", options, &ring) && process.LastError() != 0,
+                   "a missing target fails with an error");
+        }
+    }
+
+    bool ParseOptions(int argc, char** argv, Options& options) {
+        for (int i = 1; i < argc; ++i) {
+            const char* value = i + 1 < argc ? argv[i + 1] : nullptr;
+            if (strcmp(argv[i], "--rounds") != 0 || !value) return false;
+            options.rounds = atoi(value);
+            ++i;
+        }
+        return options.rounds > 0;
+    }
+}
+
+int main(int argc, char** argv) {
+    Options options;
+    if (!ParseOptions(argc, argv, options)) {
+        printf("usage: output_capture_check [--rounds N]\n");
+        return 2;
+    }
+    printf("line splitting\n");
+    CheckSplitting();
+    printf("long lines\n");
+    CheckLongLines();
+    printf("wrapping\n");
+    CheckExactFit();
+    CheckWrap(options);
+    printf("child processes\n");
+    CheckChildProcess();
+    printf("%s\n", g_failures ? "FAILED" : "all checks passed");
+    return g_failures != 0;
+}
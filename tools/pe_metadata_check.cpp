@@ -0,0 +1,466 @@
+// Offline check for the PE header parser and the recent targets index.
+// Builds PE32 and PE32+ images in memory, with and without a version
+// resource, and checks what ParsePeMetadata reads from them, from every
+// truncated prefix of them, from hand-broken offsets and counts, and from
+// randomly corrupted copies (run it under -fsanitize=address to catch stray
+// reads). Then drives RecentTargets over real files: scanning, ordering, the
+// size cap, persisting the index and reloading it without the files, and
+// rescanning a file that changed or vanished.
+//
+// Build instructions are in README.md.
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "pe_metadata.h"
+#include "recent_targets.h"
+
+namespace {
+    struct Options {
+        int fuzz = 20000;
+        std::string dir = "/tmp/pe_metadata_check";
+    };
+
+    // Layout of the crafted images.
+    const size_t kPeOffset = 0x80;
+    const size_t kSectionRaw = 0x200;
+    const uint32_t kSectionRva = 0x1000;
+    const size_t kSectionSize = 0x200;
+    // Resource tree inside the section: type, name and language directories,
+    // the data entry and VS_VERSIONINFO.
+    const size_t kNameDir = 0x18;
+    const size_t kLangDir = 0x30;
+    const size_t kDataEntry = 0x48;
+    const size_t kVersionInfo = 0x58;
+    const size_t kVersionInfoSize = 92;
+
+    struct Image {
+        bool is_64bit = false;
+        uint16_t machine = 0x014C;
+        uint16_t subsystem = 2;
+        bool with_version = true;
+        uint16_t version[4] = { 1, 2, 3, 4 };
+    };
+
+    void Put16(std::vector<uint8_t>& b, size_t offset, uint32_t v) {
+        b[offset] = static_cast<uint8_t>(v);
+        b[offset + 1] = static_cast<uint8_t>(v >> 8);
+    }
+
+    void Put32(std::vector<uint8_t>& b, size_t offset, uint32_t v) {
+        Put16(b, offset, v & 0xFFFF);
+        Put16(b, offset + 2, v >> 16);
+    }
+
+    size_t OptionalOffset() {
+        return kPeOffset + 24;
+    }
+
+    size_t OptionalSize(bool is_64bit) {
+        return is_64bit ? 240 : 224;
+    }
+
+    size_t SectionTable(bool is_64bit) {
+        return OptionalOffset() + OptionalSize(is_64bit);
+    }
+
+    size_t ResourceDirectory(bool is_64bit) {
+        return OptionalOffset() + (is_64bit ? 112 : 96) + 2 * 8;
+    }
+
+    std::vector<uint8_t> Build(const Image& image) {
+        std::vector<uint8_t> b(kSectionRaw + kSectionSize, 0);
+        b[0] = 'M';
+        b[1] = 'Z';
+        Put32(b, 0x3C, kPeOffset);
+        memcpy(&b[kPeOffset], "PE\0\0", 4);
+        size_t coff = kPeOffset + 4;
+        Put16(b, coff, image.machine);
+        Put16(b, coff + 2, 1);
+        Put16(b, coff + 16, static_cast<uint32_t>(OptionalSize(image.is_64bit)));
+
+        size_t optional = OptionalOffset();
+        Put16(b, optional, image.is_64bit ? 0x20B : 0x10B);
+        Put16(b, optional + 68, image.subsystem);
+        Put32(b, optional + (image.is_64bit ? 108 : 92), 16);
+        if (image.with_version) {
+            Put32(b, ResourceDirectory(image.is_64bit), kSectionRva);
+            Put32(b, ResourceDirectory(image.is_64bit) + 4, static_cast<uint32_t>(kSectionSize));
+        }
+
+        size_t section = SectionTable(image.is_64bit);
+        memcpy(&b[section], ".rsrc", 5);
+        Put32(b, section + 8, static_cast<uint32_t>(kSectionSize));
+        Put32(b, section + 12, kSectionRva);
+        Put32(b, section + 16, static_cast<uint32_t>(kSectionSize));
+        Put32(b, section + 20, static_cast<uint32_t>(kSectionRaw));
+        if (!image.with_version) return b;
+
+        size_t rsrc = kSectionRaw;
+        Put16(b, rsrc + 14, 1);
+        Put32(b, rsrc + 16, 16);  // RT_VERSION
+        Put32(b, rsrc + 20, 0x80000000u | kNameDir);
+        Put16(b, rsrc + kNameDir + 14, 1);
+        Put32(b, rsrc + kNameDir + 16, 1);
+        Put32(b, rsrc + kNameDir + 20, 0x80000000u | kLangDir);
+        Put16(b, rsrc + kLangDir + 14, 1);
+        Put32(b, rsrc + kLangDir + 16, 0x409);
+        Put32(b, rsrc + kLangDir + 20, static_cast<uint32_t>(kDataEntry));
+        Put32(b, rsrc + kDataEntry, static_cast<uint32_t>(kSectionRva + kVersionInfo));
+        Put32(b, rsrc + kDataEntry + 4, static_cast<uint32_t>(kVersionInfoSize));
+
+        size_t info = rsrc + kVersionInfo;
+        Put16(b, info, static_cast<uint32_t>(kVersionInfoSize));
+        Put16(b, info + 2, 52);
+        const char* key = "VS_VERSION_INFO";
+        for (size_t i = 0; key[i]; ++i) Put16(b, info + 6 + i * 2, static_cast<uint8_t>(key[i]));
+        size_t fixed = info + 40;
+        Put32(b, fixed, 0xFEEF04BD);
+        Put32(b, fixed + 4, 0x00010000);
+        Put32(b, fixed + 8, (static_cast<uint32_t>(image.version[0]) << 16) | image.version[1]);
+        Put32(b, fixed + 12, (static_cast<uint32_t>(image.version[2]) << 16) | image.version[3]);
+        return b;
+    }
+
+    int g_failures = 0;
+
+    void Expect(bool condition, const char* what) {
+        if (condition) return;
+        fprintf(stderr, "FAILED: %s\n", what);
+        ++g_failures;
+    }
+
+    bool SameVersion(const PeMetadata& meta, const uint16_t (&version)[4]) {
+        return memcmp(meta.version, version, sizeof(version)) == 0;
+    }
+
+    bool Parse(const std::vector<uint8_t>& b, PeMetadata& meta) {
+        return ParsePeMetadata(b.data(), b.size(), meta);
+    }
+
+    void CheckWellFormed() {
+        Image pe32;
+        PeMetadata meta;
+        Expect(Parse(Build(pe32), meta), "PE32 parses");
+        Expect(meta.machine == 0x014C && meta.subsystem == 2 && !meta.is_64bit, "PE32 headers");
+        Expect(meta.has_version && SameVersion(meta, pe32.version), "PE32 file version");
+        Expect(strcmp(PeMachineName(meta.machine), "x86") == 0, "x86 machine name");
+
+        Image pe64;
+        pe64.is_64bit = true;
+        pe64.machine = 0x8664;
+        pe64.subsystem = 3;
+        pe64.version[0] = 10;
+        pe64.version[1] = 0;
+        pe64.version[2] = 19041;
+        pe64.version[3] = 65535;
+        Expect(Parse(Build(pe64), meta), "PE32+ parses");
+        Expect(meta.machine == 0x8664 && meta.subsystem == 3 && meta.is_64bit, "PE32+ headers");
+        Expect(meta.has_version && SameVersion(meta, pe64.version), "PE32+ file version");
+        Expect(strcmp(PeSubsystemName(meta.subsystem), "Console") == 0, "console subsystem name");
+
+        Image plain;
+        plain.is_64bit = true;
+        plain.with_version = false;
+        Expect(Parse(Build(plain), meta) && !meta.has_version, "image without resources parses without version");
+    }
+
+    // Every prefix must either be rejected or yield the right headers, and a
+    // version only once the whole fixed file info is present.
+    void CheckTruncated() {
+        for (int is_64bit = 0; is_64bit <= 1; ++is_64bit) {
+            Image image;
+            image.is_64bit = is_64bit != 0;
+            std::vector<uint8_t> b = Build(image);
+            const size_t headers_end = SectionTable(image.is_64bit);
+            const size_t version_end = kSectionRaw + kVersionInfo + kVersionInfoSize;
+            for (size_t size = 0; size <= b.size(); ++size) {
+                // A copy of exactly |size| bytes, so reads past it are caught.
+                std::vector<uint8_t> prefix(b.begin(), b.begin() + size);
+                PeMetadata meta;
+                bool ok = ParsePeMetadata(prefix.empty() ? nullptr : prefix.data(), size, meta);
+                if (ok != (size >= headers_end)) {
+                    fprintf(stderr, "FAILED: %s prefix of %zu bytes %s\n", is_64bit ? "PE32+" : "PE32", size,
+                            ok ? "accepted" : "rejected");
+                    ++g_failures;
+                    continue;
+                }
+                if (!ok) continue;
+                if (meta.machine != image.machine || meta.is_64bit != image.is_64bit ||
+                    meta.has_version != (size >= version_end) ||
+                    (meta.has_version && !SameVersion(meta, image.version))) {
+                    fprintf(stderr, "FAILED: %s prefix of %zu bytes misread\n", is_64bit ? "PE32+" : "PE32", size);
+                    ++g_failures;
+                }
+            }
+        }
+    }
+
+    struct Breakage {
+        const char* name;
+        bool parses;  // Headers still valid, only the version is lost.
+        std::function<void(std::vector<uint8_t>&)> apply;
+    };
+
+    void CheckMalformed() {
+        const size_t rsrc = kSectionRaw;
+        const size_t section = SectionTable(false);
+        const size_t optional = OptionalOffset();
+        const Breakage cases[] = {
+            { "not MZ", false, [](std::vector<uint8_t>& b) { b[1] = 'X'; } },
+            { "e_lfanew past the end", false, [](std::vector<uint8_t>& b) { Put32(b, 0x3C, 0xFFFFFFF0u); } },
+            { "e_lfanew into the last bytes", false,
+              [](std::vector<uint8_t>& b) { Put32(b, 0x3C, static_cast<uint32_t>(b.size() - 10)); } },
+            { "bad PE signature", false, [](std::vector<uint8_t>& b) { b[kPeOffset + 2] = 'X'; } },
+            { "bad optional magic", false, [optional](std::vector<uint8_t>& b) { Put16(b, optional, 0x107); } },
+            { "optional header too small", false,
+              [](std::vector<uint8_t>& b) { Put16(b, kPeOffset + 4 + 16, 40); } },
+            { "optional header past the end", false,
+              [](std::vector<uint8_t>& b) { Put16(b, kPeOffset + 4 + 16, 0xFFFF); } },
+            { "no resource directory slot", true, [optional](std::vector<uint8_t>& b) { Put32(b, optional + 92, 2); } },
+            { "resource RVA outside every section", true,
+              [](std::vector<uint8_t>& b) { Put32(b, ResourceDirectory(false), 0x90000); } },
+            { "section table past the end", true,
+              [](std::vector<uint8_t>& b) { Put16(b, kPeOffset + 4 + 2, 0xFFFF); Put32(b, ResourceDirectory(false), 0x90000); } },
+            { "section raw offset past the end", true,
+              [section](std::vector<uint8_t>& b) { Put32(b, section + 20, 0xFFFFFF00u); } },
+            { "section raw size wraps", true,
+              [section](std::vector<uint8_t>& b) { Put32(b, section + 16, 0xFFFFFFFFu); Put32(b, section + 20, 0x100); } },
+            { "resource entry count too large", true, [rsrc](std::vector<uint8_t>& b) { Put16(b, rsrc + 14, 0xFFFF); } },
+            { "resource entries past the end", true,
+              [rsrc](std::vector<uint8_t>& b) { Put16(b, rsrc + 12, 2000); } },
+            { "subdirectory offset past the end", true,
+              [rsrc](std::vector<uint8_t>& b) { Put32(b, rsrc + 20, 0xFFFFFFF0u); } },
+            { "type entry is not a directory", true,
+              [rsrc](std::vector<uint8_t>& b) { Put32(b, rsrc + 20, static_cast<uint32_t>(kDataEntry)); } },
+            { "no RT_VERSION entry", true, [rsrc](std::vector<uint8_t>& b) { Put32(b, rsrc + 16, 3); } },
+            { "language entry is a directory", true,
+              [rsrc](std::vector<uint8_t>& b) { Put32(b, rsrc + kLangDir + 20, 0x80000000u | kNameDir); } },
+            { "data entry past the end", true,
+              [rsrc](std::vector<uint8_t>& b) { Put32(b, rsrc + kLangDir + 20, 0x7FFFFFF0u); } },
+            { "version data RVA past the section", true,
+              [rsrc](std::vector<uint8_t>& b) { Put32(b, rsrc + kDataEntry, kSectionRva + 0x400); } },
+            { "version data size past the end", true,
+              [rsrc](std::vector<uint8_t>& b) {
+                  Put32(b, rsrc + kDataEntry, static_cast<uint32_t>(kSectionRva + kSectionSize - 8));
+                  Put32(b, rsrc + kDataEntry + 4, 0xFFFFFFFFu);
+              } },
+            { "no fixed file info signature", true,
+              [rsrc](std::vector<uint8_t>& b) { Put32(b, rsrc + kVersionInfo + 40, 0); } },
+        };
+        for (const Breakage& breakage : cases) {
+            std::vector<uint8_t> b = Build(Image());
+            breakage.apply(b);
+            PeMetadata meta;
+            bool ok = Parse(b, meta);
+            bool expected = ok == breakage.parses && !meta.has_version;
+            printf("  %-40s %s\n", breakage.name, expected ? "ok" : "WRONG");
+            if (!expected) ++g_failures;
+        }
+    }
+
+    // Random byte and word corruption of well-formed images; only the absence
+    // of crashes and out-of-bounds reads is checked.
+    void Fuzz(int iterations) {
+        uint32_t rng = 0x2545F491u;
+        auto next = [&rng]() {
+            rng ^= rng << 13;
+            rng ^= rng >> 17;
+            rng ^= rng << 5;
+            return rng;
+        };
+        const std::vector<uint8_t> originals[2] = { Build(Image()), Build([] {
+            Image image;
+            image.is_64bit = true;
+            return image;
+        }()) };
+        int parsed = 0;
+        for (int i = 0; i < iterations; ++i) {
+            std::vector<uint8_t> b = originals[i & 1];
+            int edits = 1 + static_cast<int>(next() % 4);
+            for (int e = 0; e < edits; ++e) {
+                size_t offset = next() % (b.size() - 4);
+                if (next() & 1) {
+                    b[offset] = static_cast<uint8_t>(next());
+                } else {
+                    Put32(b, offset, next() & 1 ? 0xFFFFFFFFu - (next() & 0xFF) : next());
+                }
+            }
+            b.resize(b.size() - next() % 64);
+            PeMetadata meta;
+            parsed += ParsePeMetadata(b.data(), b.size(), meta);
+        }
+        printf("  %d corrupted images, %d still parsed\n", iterations, parsed);
+    }
+
+    bool WriteFile(const std::string& path, const std::vector<uint8_t>& data) {
+        FILE* f = fopen(path.c_str(), "wb");
+        if (!f) return false;
+        bool ok = fwrite(data.data(), 1, data.size(), f) == data.size();
+        return fclose(f) == 0 && ok;
+    }
+
+    // Waits for the worker to settle the list into a state |done| accepts.
+    bool WaitFor(const RecentTargets& recent, std::vector<RecentTarget>& list,
+                 const std::function<bool(const std::vector<RecentTarget>&)>& done) {
+        uint64_t version = 0;
+        for (int i = 0; i < 5000; ++i) {
+            recent.Snapshot(list, version);
+            if (done(list)) return true;
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        return false;
+    }
+
+    bool AllScanned(const std::vector<RecentTarget>& list) {
+        for (const RecentTarget& target : list) {
+            if (!target.scanned) return false;
+        }
+        return !list.empty();
+    }
+
+    void CheckRecentTargets(const Options& options) {
+        const std::string dir = options.dir + "/";
+        Image x86;
+        Image x64;
+        x64.is_64bit = true;
+        x64.machine = 0x8664;
+        x64.version[0] = 7;
+        const std::string a = dir + "a.exe";
+        const std::string b = dir + "b\tname.exe";  // The path is the last index field, so tabs survive.
+        const std::string text = dir + "notes.txt";
+        if (!WriteFile(a, Build(x86)) || !WriteFile(b, Build(x64)) ||
+            !WriteFile(text, std::vector<uint8_t>(100, 'x'))) {
+            fprintf(stderr, "cannot write files under %s\n", dir.c_str());
+            ++g_failures;
+            return;
+        }
+
+        std::vector<RecentTarget> list;
+        {
+            RecentTargets recent;
+            recent.Load();
+            recent.Touch(text, 100);
+            recent.Touch(b, 200);
+            recent.Touch(a, 300);
+            Expect(WaitFor(recent, list, AllScanned), "targets are scanned");
+            Expect(list.size() == 3 && list[0].path == a && list[1].path == b && list[2].path == text,
+                   "most recent first");
+            Expect(list.size() == 3 && list[0].is_pe && list[0].meta.machine == 0x014C &&
+                       SameVersion(list[0].meta, x86.version),
+                   "PE32 target metadata");
+            Expect(list.size() == 3 && list[1].is_pe && list[1].meta.is_64bit && SameVersion(list[1].meta, x64.version),
+                   "PE32+ target metadata");
+            Expect(list.size() == 3 && list[2].scanned && !list[2].is_pe && list[2].size == 100, "non-PE target");
+            recent.Touch(text, 400);
+            Expect(WaitFor(recent, list, [&](const std::vector<RecentTarget>& l) { return !l.empty() && l[0].path == text; }),
+                   "touching again moves to the front");
+        }
+
+        // The index alone carries the metadata: reload with the files gone.
+        remove(a.c_str());
+        remove(text.c_str());
+        {
+            RecentTargets recent;
+            recent.Load();
+            uint64_t version = 0;
+            recent.Snapshot(list, version);
+            Expect(list.size() == 3 && list[0].path == text && list[1].path == a && list[2].path == b,
+                   "index keeps the order");
+            Expect(list.size() == 3 && list[1].scanned && list[1].meta.machine == 0x014C && list[1].last_used == 300 &&
+                       SameVersion(list[1].meta, x86.version),
+                   "index keeps PE32 metadata");
+            Expect(list.size() == 3 && list[2].meta.is_64bit && list[2].meta.machine == 0x8664 &&
+                       SameVersion(list[2].meta, x64.version),
+                   "index keeps PE32+ metadata");
+
+            // A vanished file stays listed but unscanned; a changed one is
+            // parsed again.
+            recent.Touch(a, 500);
+            Expect(WaitFor(recent, list, [&](const std::vector<RecentTarget>& l) { return !l.empty() && !l[0].scanned; }),
+                   "missing file is marked for a rescan");
+            Image changed = x64;
+            changed.version[3] = 99;
+            std::vector<uint8_t> image = Build(changed);
+            image.resize(image.size() + 16);
+            WriteFile(b, image);
+            recent.Touch(b, 600);
+            Expect(WaitFor(recent, list,
+                           [&](const std::vector<RecentTarget>& l) {
+                               return !l.empty() && l[0].path == b && l[0].scanned && SameVersion(l[0].meta, changed.version);
+                           }),
+                   "changed file is parsed again");
+
+            for (int i = 0; i < static_cast<int>(kMaxRecentTargets) + 3; ++i) {
+                recent.Touch(dir + "missing" + std::to_string(i) + ".exe", 700 + i);
+            }
+            WaitFor(recent, list, [](const std::vector<RecentTarget>& l) { return l.size() == kMaxRecentTargets; });
+            Expect(list.size() == kMaxRecentTargets, "list is capped");
+        }
+
+        // An index from another format version is ignored.
+        std::string index = std::string(getenv("XDG_DATA_HOME")) + "/ModGui/recent_targets.idx";
+        WriteFile(index, std::vector<uint8_t>{ 'v', '9', '\n', '1', '\t', '2', '\n' });
+        {
+            RecentTargets recent;
+            recent.Load();
+            uint64_t version = 0;
+            list.assign(1, RecentTarget());
+            recent.Snapshot(list, version);
+            Expect(list.empty(), "unknown index version is ignored");
+        }
+        remove(b.c_str());
+        remove(index.c_str());
+    }
+
+    bool ParseOptions(int argc, char** argv, Options& options) {
+        for (int i = 1; i < argc; ++i) {
+            const char* value = i + 1 < argc ? argv[i + 1] : nullptr;
+            if (!value) return false;
+            if (strcmp(argv[i], "--fuzz") == 0) options.fuzz = atoi(value);
+            else if (strcmp(argv[i], "--dir") == 0) options.dir = value;
+            else return false;
+            ++i;
+        }
+        return options.fuzz >= 0 && !options.dir.empty();
+    }
+}
+
+int main(int argc, char** argv) {
+    Options options;
+    if (!ParseOptions(argc, argv, options)) {
+        printf("usage: pe_metadata_check [--fuzz N] [--dir PATH]\n");
+        return 2;
+    }
+    // Keep the index out of the user's data directory.
+    mkdir(options.dir.c_str(), 0755);
+    std::string data_home = options.dir + "/data";
+    setenv("XDG_DATA_HOME", data_home.c_str(), 1);
+
+    printf("well-formed images\n");
+    CheckWellFormed();
+    printf("truncated images\n");
+    CheckTruncated();
+    printf("malformed images\n");
+    CheckMalformed();
+    printf("fuzzed images\n");
+    Fuzz(options.fuzz);
+    printf("recent targets index\n");
+    CheckRecentTargets(options);
+
+    rmdir((data_home + "/ModGui").c_str());
+    rmdir(data_home.c_str());
+    rmdir(options.dir.c_str());
+    printf("%s\n", g_failures ? "FAILED" : "all checks passed");
+    return g_failures != 0;
+}
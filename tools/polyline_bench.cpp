@@ -0,0 +1,112 @@
+// Offline benchmark for ImDrawList::AddPolyline. Strokes long open and
+// closed paths, mixing gentle (mitered) and sharp (beveled) joins, at
+// growing point counts, and reports the time per point, which should stay
+// flat as paths grow. After a warm-up frame the draw list's buffers and the
+// stroker's scratch arrays must not be reallocated; the benchmark counts
+// every reallocation and fails if there is one, or if the stroker writes
+// other than exactly what it reserved.
+//
+// Build instructions are in README.md.
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include "imgui.h"
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    struct Options {
+        int max_points = 1000000;
+        int frames = 20;
+    };
+
+    // A wave with a sharp spike every 16 points.
+    std::vector<ImVec2> MakePath(int count) {
+        std::vector<ImVec2> points(count);
+        for (int i = 0; i < count; ++i) {
+            float x = static_cast<float>(i) * 0.5f;
+            float y = 300.0f + 80.0f * std::sin(i * 0.05f);
+            if (i % 16 == 8) y -= 60.0f;
+            points[i] = ImVec2(x, y);
+        }
+        return points;
+    }
+
+    struct Buffers {
+        const void* data[4] = {};
+
+        explicit Buffers(const ImDrawList& list) {
+            data[0] = list.VtxBuffer.Data;
+            data[1] = list.IdxBuffer.Data;
+            data[2] = list._StrokeScratch.Data;
+            data[3] = list._StrokeBevel.Data;
+        }
+
+        int Changed(const Buffers& other) const {
+            int changed = 0;
+            for (int i = 0; i < 4; ++i) changed += data[i] != other.data[i];
+            return changed;
+        }
+    };
+
+    bool ParseOptions(int argc, char** argv, Options& options) {
+        for (int i = 1; i < argc; ++i) {
+            const char* value = i + 1 < argc ? argv[i + 1] : nullptr;
+            int* target = nullptr;
+            if (strcmp(argv[i], "--max-points") == 0) target = &options.max_points;
+            else if (strcmp(argv[i], "--frames") == 0) target = &options.frames;
+            if (!target || !value) return false;
+            *target = atoi(value);
+            ++i;
+        }
+        return options.max_points >= 1000 && options.frames > 0;
+    }
+}
+
+int main(int argc, char** argv) {
+    Options options;
+    if (!ParseOptions(argc, argv, options)) {
+        printf("usage: polyline_bench [--max-points N] [--frames N]\n");
+        return 2;
+    }
+
+    int failures = 0;
+    printf("%9s %6s %10s %10s %9s %8s\n", "points", "closed", "vertices", "us/frame", "ns/point", "reallocs");
+    for (int count = 1000; count <= options.max_points; count *= 10) {
+        std::vector<ImVec2> path = MakePath(count);
+        for (int closed = 0; closed <= 1; ++closed) {
+            ImDrawList list;
+            list._ResetForNewFrame();
+            list.AddPolyline(path.data(), count, IM_COL32(120, 180, 255, 200), closed != 0, 2.0f);
+            Buffers warm(list);
+
+            int reallocs = 0;
+            std::vector<double> us;
+            for (int f = 0; f < options.frames; ++f) {
+                list._ResetForNewFrame();
+                Clock::time_point begin = Clock::now();
+                list.AddPolyline(path.data(), count, IM_COL32(120, 180, 255, 200), closed != 0, 2.0f);
+                us.push_back(std::chrono::duration<double, std::micro>(Clock::now() - begin).count());
+                reallocs += Buffers(list).Changed(warm);
+                if (list._VtxWritePtr != list.VtxBuffer.Data + list.VtxBuffer.Size ||
+                    list._IdxWritePtr != list.IdxBuffer.Data + list.IdxBuffer.Size ||
+                    list._VtxCurrentIdx != static_cast<unsigned int>(list.VtxBuffer.Size)) {
+                    fprintf(stderr, "%d points: stroker output does not match its reservation\n", count);
+                    return 1;
+                }
+            }
+            std::sort(us.begin(), us.end());
+            double p50 = us[us.size() / 2];
+            printf("%9d %6s %10d %10.1f %9.2f %8d\n", count, closed ? "yes" : "no", list.VtxBuffer.Size, p50,
+                   p50 * 1000.0 / count, reallocs);
+            failures += reallocs;
+        }
+    }
+    return failures != 0;
+}
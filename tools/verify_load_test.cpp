@@ -0,0 +1,242 @@
+// Offline load test for the verification client. Starts the loopback
+// stand-in, points VerifyKeyOnline() at it, calls it from many threads at
+// once and reports latency percentiles, connection reuse and heap
+// allocations per request. Fails unless every result is classified as the
+// stand-in answered it: declines as declined, 503s and resets as network
+// errors. With --serve it only runs the stand-in.
+//
+// Build instructions are in README.md.
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "verify_client.h"
+#include "verify_stub_server.h"
+
+namespace {
+    // Only allocations made inside VerifyKeyOnline() on a client thread count.
+    thread_local bool t_count_allocations = false;
+    std::atomic<uint64_t> g_allocations{0};
+
+    struct Options {
+        int clients = 64;
+        int requests = 20000;
+        bool serve = false;
+        StubServerConfig server;
+    };
+
+    struct ClientTotals {
+        std::vector<double> latencies_ms;
+        uint64_t accepted = 0;
+        uint64_t declined = 0;
+        uint64_t http_errors = 0;
+        uint64_t network_errors = 0;
+    };
+
+    void PrintUsage() {
+        fprintf(stderr,
+                "usage: verify_load_test [options]\n"
+                "  --clients N         concurrent client threads (64)\n"
+                "  --requests N        total verifications (20000)\n"
+                "  --latency MS        server delay per response (0)\n"
+                "  --jitter MS         extra uniform delay [0, MS] (0)\n"
+                "  --error-rate F      fraction answered with HTTP 503 (0)\n"
+                "  --reset-rate F      fraction dropped with a connection reset (0)\n"
+                "  --decline-rate F    fraction answered {\"valid\":false} (0)\n"
+                "  --body-bytes N      pad response bodies to N bytes (0)\n"
+                "  --keep-alive N      requests per connection before close, 0 = no limit (100)\n"
+                "  --port N            server port; 0 picks one (0)\n"
+                "  --seed N            server random seed (1)\n"
+                "  --serve             run only the stand-in until stdin closes\n");
+    }
+
+    bool ParseOptions(int argc, char** argv, Options& options) {
+        for (int i = 1; i < argc; ++i) {
+            const char* name = argv[i];
+            if (strcmp(name, "--serve") == 0) {
+                options.serve = true;
+                continue;
+            }
+            if (i + 1 >= argc) return false;
+            const char* value = argv[++i];
+            if (strcmp(name, "--clients") == 0) {
+                options.clients = atoi(value);
+            } else if (strcmp(name, "--requests") == 0) {
+                options.requests = atoi(value);
+            } else if (strcmp(name, "--latency") == 0) {
+                options.server.latency_ms = atoi(value);
+            } else if (strcmp(name, "--jitter") == 0) {
+                options.server.jitter_ms = atoi(value);
+            } else if (strcmp(name, "--error-rate") == 0) {
+                options.server.error_rate = atof(value);
+            } else if (strcmp(name, "--reset-rate") == 0) {
+                options.server.reset_rate = atof(value);
+            } else if (strcmp(name, "--decline-rate") == 0) {
+                options.server.decline_rate = atof(value);
+            } else if (strcmp(name, "--body-bytes") == 0) {
+                options.server.body_bytes = static_cast<size_t>(atol(value));
+            } else if (strcmp(name, "--keep-alive") == 0) {
+                options.server.max_requests_per_connection = atoi(value);
+            } else if (strcmp(name, "--port") == 0) {
+                options.server.port = static_cast<uint16_t>(atoi(value));
+            } else if (strcmp(name, "--seed") == 0) {
+                options.server.seed = static_cast<uint32_t>(strtoul(value, nullptr, 10));
+            } else {
+                return false;
+            }
+        }
+        return options.clients > 0 && options.requests > 0;
+    }
+
+    // Nearest-rank percentile of sorted |values|.
+    double Percentile(const std::vector<double>& values, double p) {
+        if (values.empty()) return 0.0;
+        size_t rank = static_cast<size_t>(p / 100.0 * static_cast<double>(values.size()) + 0.5);
+        if (rank < 1) rank = 1;
+        if (rank > values.size()) rank = values.size();
+        return values[rank - 1];
+    }
+
+    void ClientMain(std::atomic<int>& next, int requests, ClientTotals& totals) {
+        std::string key;
+        for (int i = next.fetch_add(1); i < requests; i = next.fetch_add(1)) {
+            key = "load-test-key-" + std::to_string(i);
+            t_count_allocations = true;
+            std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+            VerifyResult result = VerifyKeyOnline(key);
+            std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+            t_count_allocations = false;
+
+            totals.latencies_ms.push_back(std::chrono::duration<double, std::milli>(end - start).count());
+            if (result.network_error) {
+                ++totals.network_errors;
+            } else if (result.success) {
+                ++totals.accepted;
+            } else if (result.declined) {
+                ++totals.declined;
+            } else {
+                ++totals.http_errors;
+            }
+        }
+    }
+
+    int Serve(const Options& options) {
+        VerifyStubServer server(options.server);
+        if (!server.Start()) {
+            fprintf(stderr, "cannot listen on port %u\n", static_cast<unsigned>(options.server.port));
+            return 1;
+        }
+        printf("listening on http://127.0.0.1:%u (close stdin to stop)\n", static_cast<unsigned>(server.Port()));
+        fflush(stdout);
+        while (getchar() != EOF) {
+        }
+        server.Stop();
+        StubServerStats stats = server.Stats();
+        printf("served %llu requests on %llu connections\n", static_cast<unsigned long long>(stats.requests),
+               static_cast<unsigned long long>(stats.connections));
+        return 0;
+    }
+}
+
+void* operator new(size_t size) {
+    if (t_count_allocations) g_allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept {
+    free(p);
+}
+
+void operator delete(void* p, size_t) noexcept {
+    free(p);
+}
+
+int main(int argc, char** argv) {
+    Options options;
+    if (!ParseOptions(argc, argv, options)) {
+        PrintUsage();
+        return 2;
+    }
+    if (options.serve) return Serve(options);
+
+    VerifyStubServer server(options.server);
+    if (!server.Start()) {
+        fprintf(stderr, "cannot listen on port %u\n", static_cast<unsigned>(options.server.port));
+        return 1;
+    }
+    VerifyEndpoint endpoint;
+    endpoint.host = "127.0.0.1";
+    endpoint.port = server.Port();
+    endpoint.https = false;
+    SetVerifyEndpoint(endpoint);
+
+    std::vector<ClientTotals> totals(static_cast<size_t>(options.clients));
+    for (ClientTotals& client : totals) {
+        client.latencies_ms.reserve(static_cast<size_t>(options.requests / options.clients + 1));
+    }
+    std::atomic<int> next{0};
+    std::vector<std::thread> clients;
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (ClientTotals& client : totals) {
+        clients.emplace_back(ClientMain, std::ref(next), options.requests, std::ref(client));
+    }
+    for (std::thread& client : clients) client.join();
+    double elapsed_s = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    server.Stop();
+
+    ClientTotals all;
+    for (const ClientTotals& client : totals) {
+        all.latencies_ms.insert(all.latencies_ms.end(), client.latencies_ms.begin(), client.latencies_ms.end());
+        all.accepted += client.accepted;
+        all.declined += client.declined;
+        all.http_errors += client.http_errors;
+        all.network_errors += client.network_errors;
+    }
+    std::sort(all.latencies_ms.begin(), all.latencies_ms.end());
+    double sum = 0.0;
+    for (double ms : all.latencies_ms) sum += ms;
+    double count = static_cast<double>(all.latencies_ms.size());
+
+    StubServerStats stats = server.Stats();
+    double reuse = stats.requests ? 1.0 - static_cast<double>(stats.connections) / static_cast<double>(stats.requests) : 0.0;
+
+    printf("requests     %d in %.2f s (%.0f/s) from %d clients\n", options.requests, elapsed_s,
+           count / elapsed_s, options.clients);
+    printf("results      accepted %llu, declined %llu, http errors %llu, network errors %llu\n",
+           static_cast<unsigned long long>(all.accepted), static_cast<unsigned long long>(all.declined),
+           static_cast<unsigned long long>(all.http_errors), static_cast<unsigned long long>(all.network_errors));
+    printf("latency ms   p50 %.3f  p90 %.3f  p99 %.3f  p99.9 %.3f  max %.3f  mean %.3f\n",
+           Percentile(all.latencies_ms, 50.0), Percentile(all.latencies_ms, 90.0), Percentile(all.latencies_ms, 99.0),
+           Percentile(all.latencies_ms, 99.9), all.latencies_ms.back(), sum / count);
+    printf("connections  %llu for %llu server requests (%.1f%% reused)\n",
+           static_cast<unsigned long long>(stats.connections), static_cast<unsigned long long>(stats.requests),
+           reuse * 100.0);
+    printf("allocations  %.2f per request\n", static_cast<double>(g_allocations.load()) / count);
+
+    int failures = 0;
+    if (all.http_errors != 0) {
+        fprintf(stderr, "%llu results were neither accepted, declined nor network errors\n",
+                static_cast<unsigned long long>(all.http_errors));
+        ++failures;
+    }
+    if (all.declined != stats.declines) {
+        fprintf(stderr, "declined %llu keys, the server declined %llu\n", static_cast<unsigned long long>(all.declined),
+                static_cast<unsigned long long>(stats.declines));
+        ++failures;
+    }
+    if (all.network_errors < stats.errors) {
+        fprintf(stderr, "%llu network errors for %llu server errors\n",
+                static_cast<unsigned long long>(all.network_errors), static_cast<unsigned long long>(stats.errors));
+        ++failures;
+    }
+    return failures != 0;
+}
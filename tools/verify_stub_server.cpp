@@ -0,0 +1,191 @@
+#include "verify_stub_server.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <string>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+static const char* kVerifyPath = "GET /verify/v1/nitrosdk?";
+static const size_t kMaxRequestHeaderBytes = 16 * 1024;
+
+VerifyStubServer::VerifyStubServer(const StubServerConfig& config) : config_(config) {}
+
+VerifyStubServer::~VerifyStubServer() {
+    Stop();
+}
+
+bool VerifyStubServer::Start() {
+    listen_fd_ = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (listen_fd_ < 0) return false;
+    int one = 1;
+    setsockopt(listen_fd_, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+    sockaddr_in address = {};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    address.sin_port = htons(config_.port);
+    socklen_t length = sizeof(address);
+    if (bind(listen_fd_, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 ||
+        listen(listen_fd_, SOMAXCONN) != 0 ||
+        getsockname(listen_fd_, reinterpret_cast<sockaddr*>(&address), &length) != 0) {
+        close(listen_fd_);
+        listen_fd_ = -1;
+        return false;
+    }
+    port_ = ntohs(address.sin_port);
+    acceptor_ = std::thread(&VerifyStubServer::AcceptMain, this);
+    return true;
+}
+
+void VerifyStubServer::Stop() {
+    if (!acceptor_.joinable()) return;
+    stop_ = true;
+    // Wakes the blocked accept().
+    shutdown(listen_fd_, SHUT_RDWR);
+    acceptor_.join();
+    close(listen_fd_);
+    listen_fd_ = -1;
+
+    std::vector<std::thread> threads;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (int fd : open_fds_) shutdown(fd, SHUT_RDWR);
+        threads.swap(threads_);
+    }
+    for (std::thread& thread : threads) thread.join();
+}
+
+StubServerStats VerifyStubServer::Stats() const {
+    StubServerStats stats;
+    stats.connections = connections_.load();
+    stats.requests = requests_.load();
+    stats.errors = errors_.load();
+    stats.declines = declines_.load();
+    stats.resets = resets_.load();
+    return stats;
+}
+
+void VerifyStubServer::AcceptMain() {
+    while (!stop_) {
+        int fd = accept4(listen_fd_, nullptr, nullptr, SOCK_CLOEXEC);
+        if (fd < 0) {
+            if (stop_) break;
+            // Out of descriptors: let connections finish before retrying.
+            if (errno == EMFILE || errno == ENFILE) std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            continue;
+        }
+        int one = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+        uint64_t index = connections_.fetch_add(1);
+        std::lock_guard<std::mutex> lock(mutex_);
+        open_fds_.push_back(fd);
+        threads_.emplace_back(&VerifyStubServer::ConnectionMain, this, fd,
+                              config_.seed + static_cast<uint32_t>(index) * 0x9E3779B9u);
+    }
+}
+
+// Request headers are read but not interpreted beyond the request line and
+// "Connection: close"; GET requests carry no body.
+void VerifyStubServer::ConnectionMain(int fd, uint32_t seed) {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    std::string buffer;
+    std::string body;
+    std::string response;
+    char chunk[4096];
+    int served = 0;
+    bool open = true;
+    while (open && !stop_) {
+        size_t header_end;
+        while ((header_end = buffer.find("\r\n\r\n")) == std::string::npos) {
+            if (buffer.size() > kMaxRequestHeaderBytes) {
+                open = false;
+                break;
+            }
+            ssize_t n = recv(fd, chunk, sizeof(chunk), 0);
+            if (n < 0 && errno == EINTR) continue;
+            if (n <= 0) {
+                open = false;
+                break;
+            }
+            buffer.append(chunk, static_cast<size_t>(n));
+        }
+        if (!open) break;
+
+        bool verify_path = buffer.compare(0, strlen(kVerifyPath), kVerifyPath) == 0;
+        std::string head = buffer.substr(0, header_end);
+        std::transform(head.begin(), head.end(), head.begin(), [](char c) {
+            return static_cast<char>(c >= 'A' && c <= 'Z' ? c - 'A' + 'a' : c);
+        });
+        buffer.erase(0, header_end + 4);
+        ++served;
+        requests_.fetch_add(1);
+        bool close_after = head.find("\r\nconnection: close") != std::string::npos ||
+                           (config_.max_requests_per_connection > 0 && served >= config_.max_requests_per_connection);
+
+        int delay_ms = config_.latency_ms;
+        if (config_.jitter_ms > 0) delay_ms += static_cast<int>(rng() % static_cast<uint32_t>(config_.jitter_ms + 1));
+        if (delay_ms > 0) std::this_thread::sleep_for(std::chrono::milliseconds(delay_ms));
+
+        double roll = unit(rng);
+        if (roll < config_.reset_rate) {
+            // Zero linger turns close() into a reset, as a crashed server would.
+            resets_.fetch_add(1);
+            linger hard = { 1, 0 };
+            setsockopt(fd, SOL_SOCKET, SO_LINGER, &hard, sizeof(hard));
+            break;
+        }
+        roll -= config_.reset_rate;
+
+        int status = 200;
+        const char* reason = "OK";
+        if (!verify_path) {
+            status = 404;
+            reason = "Not Found";
+            body = "{\"error\":\"not found\"}";
+        } else if (roll < config_.error_rate) {
+            status = 503;
+            reason = "Service Unavailable";
+            body = "{\"error\":\"unavailable\"}";
+            errors_.fetch_add(1);
+        } else if (roll < config_.error_rate + config_.decline_rate) {
+            body = "{\"valid\":false}";
+            declines_.fetch_add(1);
+        } else {
+            body = "{\"valid\":true,\"ttl\":" + std::to_string(config_.ttl) + "}";
+        }
+        static const size_t kPadOverhead = sizeof(",\"pad\":\"\"") - 1;
+        if (body.size() + kPadOverhead < config_.body_bytes) {
+            body.insert(body.size() - 1, ",\"pad\":\"" + std::string(config_.body_bytes - body.size() - kPadOverhead, 'x') + "\"");
+        } else if (body.size() < config_.body_bytes) {
+            body.append(config_.body_bytes - body.size(), ' ');
+        }
+
+        char header[256];
+        snprintf(header, sizeof(header),
+                 "HTTP/1.1 %d %s\r\nContent-Type: application/json\r\nContent-Length: %zu\r\nConnection: %s\r\n\r\n",
+                 status, reason, body.size(), close_after ? "close" : "keep-alive");
+        response = header;
+        response += body;
+        size_t sent = 0;
+        while (sent < response.size()) {
+            ssize_t n = send(fd, response.data() + sent, response.size() - sent, MSG_NOSIGNAL);
+            if (n < 0 && errno == EINTR) continue;
+            if (n <= 0) break;
+            sent += static_cast<size_t>(n);
+        }
+        if (sent < response.size() || close_after) open = false;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    open_fds_.erase(std::find(open_fds_.begin(), open_fds_.end(), fd));
+    close(fd);
+}
@@ -0,0 +1,67 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Loopback stand-in for the /verify/v1/nitrosdk endpoint, for exercising the
+// verification client offline. POSIX only. Every connection gets its own
+// thread, so injected latency delays that connection and nothing else.
+
+struct StubServerConfig {
+    uint16_t port = 0;              // 0 picks a free port.
+    int latency_ms = 0;             // Delay before every response...
+    int jitter_ms = 0;              // ...plus a uniform extra [0, jitter_ms].
+    double error_rate = 0.0;        // Fraction answered with HTTP 503.
+    double reset_rate = 0.0;        // Fraction dropped by closing the connection.
+    double decline_rate = 0.0;      // Fraction answered {"valid":false}.
+    size_t body_bytes = 0;          // Responses are padded to at least this size.
+    int max_requests_per_connection = 100;  // Then "Connection: close"; 0 for no limit.
+    int ttl = 3600;                 // "ttl" of accepted keys, in seconds.
+    uint32_t seed = 1;
+};
+
+struct StubServerStats {
+    uint64_t connections = 0;       // Accepted.
+    uint64_t requests = 0;          // Answered or dropped.
+    uint64_t errors = 0;            // Answered with 503.
+    uint64_t declines = 0;          // Answered {"valid":false}.
+    uint64_t resets = 0;
+};
+
+class VerifyStubServer {
+public:
+    explicit VerifyStubServer(const StubServerConfig& config);
+    ~VerifyStubServer();
+    VerifyStubServer(const VerifyStubServer&) = delete;
+    VerifyStubServer& operator=(const VerifyStubServer&) = delete;
+
+    // Listens on 127.0.0.1. Returns false if the port cannot be bound.
+    bool Start();
+    // Closes the listener and every open connection, then joins.
+    void Stop();
+
+    uint16_t Port() const { return port_; }
+    StubServerStats Stats() const;
+
+private:
+    void AcceptMain();
+    void ConnectionMain(int fd, uint32_t seed);
+
+    StubServerConfig config_;
+    int listen_fd_ = -1;
+    uint16_t port_ = 0;
+    std::atomic<bool> stop_{false};
+    std::atomic<uint64_t> connections_{0};
+    std::atomic<uint64_t> requests_{0};
+    std::atomic<uint64_t> errors_{0};
+    std::atomic<uint64_t> declines_{0};
+    std::atomic<uint64_t> resets_{0};
+
+    std::mutex mutex_;
+    std::vector<int> open_fds_;
+    std::vector<std::thread> threads_;
+    std::thread acceptor_;
+};
@@ -0,0 +1,164 @@
+#include "trace.h"
+
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "app_paths.h"
+
+std::atomic<bool> g_trace_enabled{false};
+
+namespace {
+    const size_t kTraceBufferEvents = 1 << 16; // Per thread; later events are dropped.
+
+    struct TraceEvent {
+        const char* name;
+        uint64_t start_us;
+        uint64_t dur_us;
+    };
+
+    // Single writer (the owning thread). |count| is published with release
+    // after each event so the exporter can read a consistent prefix while
+    // the thread keeps running.
+    struct TraceBuffer {
+        TraceEvent events[kTraceBufferEvents];
+        std::atomic<size_t> count{0};
+        std::atomic<const char*> thread_name{nullptr};
+        uint32_t tid = 0;
+        uint64_t dropped = 0;
+    };
+
+    // Events of a thread that has exited, copied out of its buffer.
+    struct RetiredThread {
+        uint32_t tid;
+        const char* thread_name;
+        std::vector<TraceEvent> events;
+    };
+
+    // Buffers kept for reuse by later threads; beyond this they are freed.
+    const size_t kMaxFreeBuffers = 4;
+
+    const auto g_trace_epoch = std::chrono::steady_clock::now();
+    std::mutex g_buffers_mutex;
+    std::vector<std::unique_ptr<TraceBuffer>> g_buffers;       // Owned by live threads.
+    std::vector<std::unique_ptr<TraceBuffer>> g_free_buffers;
+    std::vector<RetiredThread> g_retired;
+    uint32_t g_next_tid = 0;
+
+    TraceBuffer* AcquireBuffer() {
+        std::lock_guard<std::mutex> lock(g_buffers_mutex);
+        std::unique_ptr<TraceBuffer> buffer;
+        if (!g_free_buffers.empty()) {
+            buffer = std::move(g_free_buffers.back());
+            g_free_buffers.pop_back();
+        } else {
+            buffer = std::make_unique<TraceBuffer>();
+        }
+        buffer->count.store(0, std::memory_order_relaxed);
+        buffer->thread_name.store(nullptr, std::memory_order_relaxed);
+        buffer->tid = ++g_next_tid;
+        buffer->dropped = 0;
+        g_buffers.push_back(std::move(buffer));
+        return g_buffers.back().get();
+    }
+
+    // Keeps only the events the thread recorded, so short-lived threads such
+    // as child output readers do not each pin a full buffer.
+    void ReleaseBuffer(TraceBuffer* buffer) {
+        std::lock_guard<std::mutex> lock(g_buffers_mutex);
+        size_t count = buffer->count.load(std::memory_order_relaxed);
+        const char* name = buffer->thread_name.load(std::memory_order_relaxed);
+        if (count > 0 || name) {
+            g_retired.push_back(
+                RetiredThread{ buffer->tid, name, std::vector<TraceEvent>(buffer->events, buffer->events + count) });
+        }
+        for (size_t i = 0; i < g_buffers.size(); ++i) {
+            if (g_buffers[i].get() != buffer) continue;
+            if (g_free_buffers.size() < kMaxFreeBuffers) g_free_buffers.push_back(std::move(g_buffers[i]));
+            g_buffers.erase(g_buffers.begin() + i);
+            break;
+        }
+    }
+
+    // Hands the calling thread's buffer back when the thread exits.
+    struct ThreadSlot {
+        TraceBuffer* buffer = AcquireBuffer();
+        ~ThreadSlot() { ReleaseBuffer(buffer); }
+    };
+
+    TraceBuffer* ThreadBuffer() {
+        thread_local ThreadSlot slot;
+        return slot.buffer;
+    }
+
+    void WriteEscaped(FILE* file, const char* text) {
+        for (const char* c = text; *c; ++c) {
+            if (*c == '"' || *c == '\\') fputc('\\', file);
+            fputc(*c, file);
+        }
+    }
+
+    void WriteThread(FILE* file, uint32_t tid, const char* thread_name, const TraceEvent* events, size_t count,
+                     bool& first) {
+        if (thread_name) {
+            fprintf(file, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":\"",
+                    first ? "" : ",\n", tid);
+            WriteEscaped(file, thread_name);
+            fputs("\"}}", file);
+            first = false;
+        }
+        for (size_t i = 0; i < count; ++i) {
+            const TraceEvent& event = events[i];
+            fprintf(file, "%s{\"name\":\"", first ? "" : ",\n");
+            WriteEscaped(file, event.name);
+            fprintf(file, "\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%llu,\"dur\":%llu}", tid,
+                    static_cast<unsigned long long>(event.start_us), static_cast<unsigned long long>(event.dur_us));
+            first = false;
+        }
+    }
+}
+
+void TraceEnable() {
+    g_trace_enabled.store(true, std::memory_order_relaxed);
+}
+
+void TraceSetThreadName(const char* name) {
+    if (!g_trace_enabled.load(std::memory_order_relaxed)) return;
+    ThreadBuffer()->thread_name.store(name, std::memory_order_release);
+}
+
+uint64_t TraceNowMicros() {
+    auto elapsed = std::chrono::steady_clock::now() - g_trace_epoch;
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count());
+}
+
+void TraceRecordComplete(const char* name, uint64_t start_us, uint64_t end_us) {
+    TraceBuffer* buffer = ThreadBuffer();
+    size_t count = buffer->count.load(std::memory_order_relaxed);
+    if (count >= kTraceBufferEvents) {
+        ++buffer->dropped;
+        return;
+    }
+    buffer->events[count] = TraceEvent{ name, start_us, end_us - start_us };
+    buffer->count.store(count + 1, std::memory_order_release);
+}
+
+bool TraceWriteJson(const std::string& path) {
+    FILE* file = OpenFileUtf8(path, "wb");
+    if (!file) return false;
+
+    std::lock_guard<std::mutex> lock(g_buffers_mutex);
+    fputs("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n", file);
+    bool first = true;
+    for (const RetiredThread& thread : g_retired) {
+        WriteThread(file, thread.tid, thread.thread_name, thread.events.data(), thread.events.size(), first);
+    }
+    for (auto& buffer : g_buffers) {
+        WriteThread(file, buffer->tid, buffer->thread_name.load(std::memory_order_acquire), buffer->events,
+                    buffer->count.load(std::memory_order_acquire), first);
+    }
+    fputs("\n]}\n", file);
+    return fclose(file) == 0;
+}
@@ -0,0 +1,56 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+// Scoped tracing for the UI and worker threads. TRACE_SCOPE("name") records a
+// complete event into the calling thread's buffer; the buffers are dumped as
+// Chrome trace-event JSON (loadable in Perfetto) by TraceWriteJson().
+//
+// Build with MODGUI_TRACE=0 to compile every macro out. When compiled in but
+// not enabled at runtime, a scope costs one relaxed load and a branch.
+#ifndef MODGUI_TRACE
+#define MODGUI_TRACE 1
+#endif
+
+extern std::atomic<bool> g_trace_enabled;
+
+// Starts recording; events before this call are not captured.
+void TraceEnable();
+// Names the calling thread in the exported trace if tracing is enabled.
+// |name| must be a literal.
+void TraceSetThreadName(const char* name);
+// Writes all recorded events to |path|. Returns false if the file cannot be written.
+bool TraceWriteJson(const std::string& path);
+
+uint64_t TraceNowMicros();
+void TraceRecordComplete(const char* name, uint64_t start_us, uint64_t end_us);
+
+class TraceScope {
+public:
+    explicit TraceScope(const char* name) {
+        if (g_trace_enabled.load(std::memory_order_relaxed)) {
+            name_ = name;
+            start_us_ = TraceNowMicros();
+        }
+    }
+    ~TraceScope() {
+        if (name_) TraceRecordComplete(name_, start_us_, TraceNowMicros());
+    }
+    TraceScope(const TraceScope&) = delete;
+    TraceScope& operator=(const TraceScope&) = delete;
+
+private:
+    const char* name_ = nullptr;
+    uint64_t start_us_ = 0;
+};
+
+#if MODGUI_TRACE
+#define TRACE_CONCAT_INNER(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_INNER(a, b)
+#define TRACE_SCOPE(name) TraceScope TRACE_CONCAT(trace_scope_, __LINE__)(name)
+#define TRACE_THREAD_NAME(name) TraceSetThreadName(name)
+#else
+#define TRACE_SCOPE(name) ((void)0)
+#define TRACE_THREAD_NAME(name) ((void)0)
+#endif
@@ -0,0 +1,157 @@
+#include "verify_cache.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+#ifdef _WIN32
+#include <windows.h>
+#include <wincrypt.h>
+#pragma comment(lib, "crypt32.lib")
+#endif
+
+#include "app_paths.h"
+#include "sha256.h"
+
+static const char* kCacheFile = "verify.cache";
+static const char* kSecretFile = "verify.secret";
+static const char* kCacheVersion = "v1";
+static const size_t kSecretSize = 32;
+
+int64_t UnixNow() {
+    return std::chrono::duration_cast<std::chrono::seconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+// The secret is random per install. On Windows it is stored DPAPI-protected so
+// it is only readable by the same user account.
+static bool LoadOrCreateSecret(std::string& secret) {
+    std::string path = AppDataPath(kSecretFile);
+    std::string stored;
+    if (ReadFileUtf8(path, stored) && !stored.empty()) {
+#ifdef _WIN32
+        DATA_BLOB in = { static_cast<DWORD>(stored.size()), reinterpret_cast<BYTE*>(stored.data()) };
+        DATA_BLOB out = {};
+        if (CryptUnprotectData(&in, nullptr, nullptr, nullptr, nullptr, 0, &out)) {
+            secret.assign(reinterpret_cast<char*>(out.pbData), out.cbData);
+            LocalFree(out.pbData);
+            return secret.size() == kSecretSize;
+        }
+#else
+        secret = stored;
+        return secret.size() == kSecretSize;
+#endif
+    }
+
+    std::random_device rd;
+    secret.resize(kSecretSize);
+    for (size_t i = 0; i < kSecretSize; ++i) {
+        secret[i] = static_cast<char>(rd() & 0xFF);
+    }
+#ifdef _WIN32
+    DATA_BLOB in = { static_cast<DWORD>(secret.size()), reinterpret_cast<BYTE*>(secret.data()) };
+    DATA_BLOB out = {};
+    if (!CryptProtectData(&in, L"ModGui verification cache", nullptr, nullptr, nullptr, 0, &out)) {
+        return false;
+    }
+    stored.assign(reinterpret_cast<char*>(out.pbData), out.cbData);
+    LocalFree(out.pbData);
+#else
+    stored = secret;
+#endif
+    return WriteFileAtomicUtf8(path, stored);
+}
+
+static std::string CachePayload(const VerifyCacheEntry& entry) {
+    std::string hex_key = HexEncode(reinterpret_cast<const uint8_t*>(entry.key.data()), entry.key.size());
+    return std::string(kCacheVersion) + "\n" +
+           "key=" + hex_key + "\n" +
+           "verified_at=" + std::to_string(entry.verified_at) + "\n" +
+           "expires_at=" + std::to_string(entry.expires_at) + "\n";
+}
+
+static std::string CacheMac(const std::string& secret, const std::string& payload) {
+    uint8_t mac[32];
+    HmacSha256(secret.data(), secret.size(), payload.data(), payload.size(), mac);
+    return HexEncode(mac, sizeof(mac));
+}
+
+static bool HexDecode(const std::string& hex, std::string& out) {
+    if (hex.size() % 2 != 0) return false;
+    out.clear();
+    for (size_t i = 0; i < hex.size(); i += 2) {
+        char pair[3] = { hex[i], hex[i + 1], 0 };
+        char* end = nullptr;
+        long value = std::strtol(pair, &end, 16);
+        if (end != pair + 2) return false;
+        out.push_back(static_cast<char>(value));
+    }
+    return true;
+}
+
+// Compares without an early exit so timing does not reveal the match length.
+static bool ConstantTimeEquals(const std::string& a, const std::string& b) {
+    if (a.size() != b.size()) return false;
+    unsigned char diff = 0;
+    for (size_t i = 0; i < a.size(); ++i) {
+        diff |= static_cast<unsigned char>(a[i] ^ b[i]);
+    }
+    return diff == 0;
+}
+
+bool VerifyCacheLoad(VerifyCacheEntry& out, int64_t now) {
+    std::string contents;
+    if (!ReadFileUtf8(AppDataPath(kCacheFile), contents)) return false;
+
+    std::vector<std::string> lines;
+    size_t start = 0;
+    for (size_t pos = contents.find('\n'); pos != std::string::npos; pos = contents.find('\n', start)) {
+        lines.push_back(contents.substr(start, pos - start));
+        start = pos + 1;
+    }
+    if (lines.size() != 5 || lines[0] != kCacheVersion) return false;
+    auto value_of = [&](const std::string& line, const char* name) -> std::string {
+        std::string prefix = std::string(name) + "=";
+        return line.compare(0, prefix.size(), prefix) == 0 ? line.substr(prefix.size()) : std::string();
+    };
+
+    VerifyCacheEntry entry;
+    if (!HexDecode(value_of(lines[1], "key"), entry.key) || entry.key.empty()) return false;
+    entry.verified_at = std::strtoll(value_of(lines[2], "verified_at").c_str(), nullptr, 10);
+    entry.expires_at = std::strtoll(value_of(lines[3], "expires_at").c_str(), nullptr, 10);
+    std::string mac = value_of(lines[4], "mac");
+
+    std::string secret;
+    if (!LoadOrCreateSecret(secret)) return false;
+    if (!ConstantTimeEquals(mac, CacheMac(secret, CachePayload(entry)))) return false;
+
+    // Reject expired entries and clocks moved back before the verification.
+    if (now >= entry.expires_at || now < entry.verified_at) return false;
+    out = entry;
+    return true;
+}
+
+bool VerifyCacheStore(const std::string& key, int64_t now, int64_t server_expires_at) {
+    // An entitlement the server says has already ended is not remembered,
+    // and neither is any older entry for it.
+    if (server_expires_at != 0 && server_expires_at <= now) {
+        VerifyCacheClear();
+        return false;
+    }
+    std::string secret;
+    if (!LoadOrCreateSecret(secret)) return false;
+
+    VerifyCacheEntry entry;
+    entry.key = key;
+    entry.verified_at = now;
+    entry.expires_at = server_expires_at != 0 ? server_expires_at : now + kVerifyCacheDefaultTtl;
+    if (entry.expires_at > now + kVerifyCacheMaxTtl) entry.expires_at = now + kVerifyCacheMaxTtl;
+
+    std::string payload = CachePayload(entry);
+    return WriteFileAtomicUtf8(AppDataPath(kCacheFile), payload + "mac=" + CacheMac(secret, payload) + "\n");
+}
+
+void VerifyCacheClear() {
+    RemoveFileUtf8(AppDataPath(kCacheFile));
+}
@@ -0,0 +1,29 @@
+#pragma once
+#include <cstdint>
+#include <string>
+
+// Last successful verification, kept on disk when "Remember me" is checked so
+// returning users skip the blocking round trip at startup. The file carries an
+// HMAC-SHA256 over its contents, keyed by a per-install secret, so edits to
+// the key or expiry are rejected.
+
+struct VerifyCacheEntry {
+    std::string key;
+    int64_t verified_at = 0; // Unix seconds.
+    int64_t expires_at = 0;  // Unix seconds.
+};
+
+// Used when the server sends no expiry, and as an upper bound on any expiry.
+static const int64_t kVerifyCacheDefaultTtl = 12 * 60 * 60;
+static const int64_t kVerifyCacheMaxTtl = 7 * 24 * 60 * 60;
+
+int64_t UnixNow();
+
+// Fills |out| and returns true if the cache exists, its MAC checks out and it
+// has not expired at |now|.
+bool VerifyCacheLoad(VerifyCacheEntry& out, int64_t now);
+// Records a successful verification of |key|. |server_expires_at| is the
+// expiry from VerifyResult, or 0 to use the default TTL. An expiry at or
+// before |now| is not cached and clears any stored entry; returns false.
+bool VerifyCacheStore(const std::string& key, int64_t now, int64_t server_expires_at);
+void VerifyCacheClear();
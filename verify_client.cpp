@@ -0,0 +1,464 @@
+#include "verify_client.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <mutex>
+
+#include "event_log.h"
+#include "string_util.h"
+#include "trace.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#include <winhttp.h>
+#else
+#include <cerrno>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <strings.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+#include <vector>
+#endif
+
+static const char* kVerifyPathPrefix = "/verify/v1/nitrosdk?key=";
+static const int kVerifyTimeoutMs = 5000;
+
+static std::mutex g_endpoint_mutex;
+static VerifyEndpoint g_endpoint;
+// Bumped by SetVerifyEndpoint() so connections to the old endpoint are not
+// reused.
+static uint64_t g_endpoint_generation = 1;
+
+VerifyEndpoint GetVerifyEndpoint() {
+    std::lock_guard<std::mutex> lock(g_endpoint_mutex);
+    return g_endpoint;
+}
+
+bool ParseVerifyEndpoint(const std::string& url, VerifyEndpoint& out) {
+    VerifyEndpoint endpoint;
+    std::string rest;
+    if (url.compare(0, 7, "http://") == 0) {
+        endpoint.https = false;
+        endpoint.port = 80;
+        rest = url.substr(7);
+    } else if (url.compare(0, 8, "https://") == 0) {
+        endpoint.https = true;
+        endpoint.port = 443;
+        rest = url.substr(8);
+    } else {
+        return false;
+    }
+    if (!rest.empty() && rest.back() == '/') rest.pop_back();
+    size_t colon = rest.rfind(':');
+    if (colon != std::string::npos) {
+        const char* digits = rest.c_str() + colon + 1;
+        char* end = nullptr;
+        unsigned long port = std::strtoul(digits, &end, 10);
+        if (end == digits || *end != '\0' || port == 0 || port > 65535) return false;
+        endpoint.port = static_cast<uint16_t>(port);
+        rest.resize(colon);
+    }
+    if (rest.empty() || rest.find('/') != std::string::npos) return false;
+    endpoint.host = rest;
+    out = endpoint;
+    return true;
+}
+
+// Finds `"name":<integer>` in a flat JSON body. Good enough for the handful
+// of fields the endpoint returns; not a general JSON parser.
+static bool FindJsonInteger(const std::string& body, const char* name, int64_t& out) {
+    std::string needle = std::string("\"") + name + "\":";
+    size_t pos = body.find(needle);
+    if (pos == std::string::npos) return false;
+    pos += needle.size();
+    while (pos < body.size() && body[pos] == ' ') ++pos;
+    char* end = nullptr;
+    long long value = std::strtoll(body.c_str() + pos, &end, 10);
+    if (end == body.c_str() + pos) return false;
+    out = value;
+    return true;
+}
+
+VerifyResult ParseVerifyResponse(unsigned status_code, const std::string& body, int64_t now) {
+    VerifyResult result;
+    result.status_message = "HTTP " + std::to_string(status_code);
+    if (status_code >= 500 || status_code == 429) {
+        result.network_error = true;
+        result.status_message = "Server unavailable (HTTP " + std::to_string(status_code) + ")";
+        return result;
+    }
+    if (status_code < 200 || status_code >= 300) return result;
+    result.success = body.find("\"valid\":true") != std::string::npos ||
+                     body.find("\"success\":true") != std::string::npos ||
+                     body == "true";
+    result.declined = !result.success;
+    if (result.success) {
+        int64_t value = 0;
+        if (FindJsonInteger(body, "expires_at", value)) {
+            result.expires_at = value;
+        } else if (FindJsonInteger(body, "ttl", value) && value > 0) {
+            result.expires_at = now + value;
+        }
+    }
+    return result;
+}
+
+static VerifyResult NetworkFailure(VerifyStage stage, int64_t error, const char* what) {
+    LogWrite(LogEvent::VerifyNetworkError, static_cast<int64_t>(stage), error);
+    VerifyResult result;
+    result.network_error = true;
+    result.status_message = std::string("Network error: ") + what + " failed";
+    return result;
+}
+
+#ifdef _WIN32
+
+// One session for the process: WinHTTP pools the connections of a session,
+// so consecutive verifications reuse the same TLS connection.
+static HINTERNET g_session = nullptr;
+static HINTERNET g_connect = nullptr;
+
+void SetVerifyEndpoint(const VerifyEndpoint& endpoint) {
+    std::lock_guard<std::mutex> lock(g_endpoint_mutex);
+    g_endpoint = endpoint;
+    ++g_endpoint_generation;
+    // Callers switch endpoints before verifying, never with requests open.
+    if (g_connect) WinHttpCloseHandle(g_connect);
+    g_connect = nullptr;
+}
+
+VerifyResult VerifyKeyOnline(const std::string& key) {
+    TRACE_SCOPE("VerifyKeyOnline");
+    std::wstring path = Utf8ToWide(std::string(kVerifyPathPrefix) + UrlEncode(key));
+
+    HINTERNET connect = nullptr;
+    bool https = true;
+    {
+        std::lock_guard<std::mutex> lock(g_endpoint_mutex);
+        https = g_endpoint.https;
+        if (!g_session) {
+            g_session = WinHttpOpen(L"ModGui/1.0", WINHTTP_ACCESS_TYPE_DEFAULT_PROXY, WINHTTP_NO_PROXY_NAME,
+                                    WINHTTP_NO_PROXY_BYPASS, 0);
+            if (!g_session) return NetworkFailure(VerifyStage::Open, GetLastError(), "WinHttpOpen");
+            // Bounded timeouts keep each attempt short so the scheduler's
+            // retry policy, not WinHTTP defaults, decides how long
+            // verification takes.
+            WinHttpSetTimeouts(g_session, kVerifyTimeoutMs, kVerifyTimeoutMs, kVerifyTimeoutMs, kVerifyTimeoutMs);
+        }
+        if (!g_connect) {
+            TRACE_SCOPE("WinHttpConnect");
+            g_connect = WinHttpConnect(g_session, Utf8ToWide(g_endpoint.host).c_str(), g_endpoint.port, 0);
+            if (!g_connect) return NetworkFailure(VerifyStage::Connect, GetLastError(), "WinHttpConnect");
+        }
+        connect = g_connect;
+    }
+
+    DWORD flags = https ? WINHTTP_FLAG_SECURE : 0;
+    HINTERNET request = WinHttpOpenRequest(connect, L"GET", path.c_str(),
+                                           nullptr, WINHTTP_NO_REFERER,
+                                           WINHTTP_DEFAULT_ACCEPT_TYPES, flags);
+    if (!request) return NetworkFailure(VerifyStage::OpenRequest, GetLastError(), "WinHttpOpenRequest");
+
+    BOOL sent = FALSE;
+    {
+        TRACE_SCOPE("WinHttpSendRequest");
+        sent = WinHttpSendRequest(request,
+                                  WINHTTP_NO_ADDITIONAL_HEADERS, 0,
+                                  WINHTTP_NO_REQUEST_DATA, 0,
+                                  0, 0);
+    }
+    if (!sent) {
+        DWORD error = GetLastError();
+        WinHttpCloseHandle(request);
+        return NetworkFailure(VerifyStage::SendRequest, error, "WinHttpSendRequest");
+    }
+
+    BOOL received = FALSE;
+    {
+        TRACE_SCOPE("WinHttpReceiveResponse");
+        received = WinHttpReceiveResponse(request, nullptr);
+    }
+    if (!received) {
+        DWORD error = GetLastError();
+        WinHttpCloseHandle(request);
+        return NetworkFailure(VerifyStage::ReceiveResponse, error, "WinHttpReceiveResponse");
+    }
+
+    DWORD status_code = 0;
+    DWORD status_size = sizeof(status_code);
+    WinHttpQueryHeaders(request,
+                        WINHTTP_QUERY_STATUS_CODE | WINHTTP_QUERY_FLAG_NUMBER,
+                        WINHTTP_HEADER_NAME_BY_INDEX,
+                        &status_code, &status_size, WINHTTP_NO_HEADER_INDEX);
+
+    std::string body;
+    {
+        TRACE_SCOPE("WinHttpReadData");
+        DWORD available = 0;
+        while (WinHttpQueryDataAvailable(request, &available) && available > 0) {
+            size_t offset = body.size();
+            body.resize(offset + available);
+            DWORD read = 0;
+            if (!WinHttpReadData(request, &body[offset], available, &read) || read == 0) {
+                body.resize(offset);
+                break;
+            }
+            body.resize(offset + read);
+        }
+    }
+    // Reading the body to the end returns the connection to the pool.
+    WinHttpCloseHandle(request);
+
+    LogWrite(LogEvent::VerifyHttpStatus, status_code);
+    return ParseVerifyResponse(status_code, body, static_cast<int64_t>(std::time(nullptr)));
+}
+
+#else
+
+// Plain HTTP/1.1 with keep-alive. Responses must carry Content-Length or end
+// with the connection; chunked bodies are not supported.
+
+static const size_t kMaxIdleSockets = 256;
+static const size_t kMaxHeaderBytes = 16 * 1024;
+
+// Idle keep-alive sockets, all connected to endpoint |g_idle_generation|.
+static std::mutex g_idle_mutex;
+static std::vector<int> g_idle;
+static uint64_t g_idle_generation = 1;
+
+void SetVerifyEndpoint(const VerifyEndpoint& endpoint) {
+    uint64_t generation;
+    {
+        std::lock_guard<std::mutex> lock(g_endpoint_mutex);
+        g_endpoint = endpoint;
+        generation = ++g_endpoint_generation;
+    }
+    std::lock_guard<std::mutex> lock(g_idle_mutex);
+    for (int fd : g_idle) close(fd);
+    g_idle.clear();
+    g_idle_generation = generation;
+}
+
+static int TakeIdleSocket(uint64_t generation) {
+    std::lock_guard<std::mutex> lock(g_idle_mutex);
+    if (g_idle_generation != generation || g_idle.empty()) return -1;
+    int fd = g_idle.back();
+    g_idle.pop_back();
+    return fd;
+}
+
+static void ReturnIdleSocket(int fd, uint64_t generation) {
+    std::lock_guard<std::mutex> lock(g_idle_mutex);
+    // Connected to an endpoint that has since been replaced.
+    if (g_idle_generation == generation && g_idle.size() < kMaxIdleSockets) {
+        g_idle.push_back(fd);
+    } else {
+        close(fd);
+    }
+}
+
+static int ConnectSocket(const VerifyEndpoint& endpoint, int& error) {
+    TRACE_SCOPE("verify.connect");
+    addrinfo hints = {};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    char port[8];
+    snprintf(port, sizeof(port), "%u", static_cast<unsigned>(endpoint.port));
+    addrinfo* addresses = nullptr;
+    int rc = getaddrinfo(endpoint.host.c_str(), port, &hints, &addresses);
+    if (rc != 0) {
+        error = rc;
+        return -1;
+    }
+    int fd = -1;
+    for (addrinfo* ai = addresses; ai && fd < 0; ai = ai->ai_next) {
+        fd = socket(ai->ai_family, ai->ai_socktype | SOCK_CLOEXEC, ai->ai_protocol);
+        if (fd < 0) {
+            error = errno;
+            continue;
+        }
+        // The send timeout also bounds connect().
+        timeval timeout = { kVerifyTimeoutMs / 1000, (kVerifyTimeoutMs % 1000) * 1000 };
+        setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+        setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+        int one = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+        if (connect(fd, ai->ai_addr, ai->ai_addrlen) != 0) {
+            error = errno;
+            close(fd);
+            fd = -1;
+        }
+    }
+    freeaddrinfo(addresses);
+    return fd;
+}
+
+static bool SendAll(int fd, const std::string& data, int& error) {
+    size_t sent = 0;
+    while (sent < data.size()) {
+        ssize_t n = send(fd, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            error = errno;
+            return false;
+        }
+        sent += static_cast<size_t>(n);
+    }
+    return true;
+}
+
+// Appends what one recv() returns to |buffer|; 0 at end of stream.
+static ssize_t ReceiveSome(int fd, std::string& buffer, int& error) {
+    static const size_t kReceiveChunk = 4096;
+    size_t offset = buffer.size();
+    buffer.resize(offset + kReceiveChunk);
+    ssize_t n;
+    do {
+        n = recv(fd, &buffer[offset], kReceiveChunk, 0);
+    } while (n < 0 && errno == EINTR);
+    if (n < 0) error = errno;
+    if (n == 0) error = ECONNRESET;
+    buffer.resize(offset + (n > 0 ? static_cast<size_t>(n) : 0));
+    return n;
+}
+
+static bool HeaderIs(const char* line, size_t length, const char* name) {
+    size_t name_length = strlen(name);
+    return length > name_length && line[name_length] == ':' && strncasecmp(line, name, name_length) == 0;
+}
+
+struct HttpResponse {
+    unsigned status = 0;
+    bool keep_alive = false;
+    size_t body_begin = 0;
+    size_t body_length = 0;
+};
+
+// Reads one response into |buffer|. |received_any| is false when the peer
+// closed without sending anything, which on a pooled socket means it had
+// already timed out the idle connection.
+static bool ReadResponse(int fd, std::string& buffer, HttpResponse& response, bool& received_any, int& error) {
+    buffer.clear();
+    received_any = false;
+    size_t header_end;
+    while ((header_end = buffer.find("\r\n\r\n")) == std::string::npos) {
+        if (buffer.size() > kMaxHeaderBytes) {
+            error = EMSGSIZE;
+            return false;
+        }
+        if (ReceiveSome(fd, buffer, error) <= 0) return false;
+        received_any = true;
+    }
+    if (buffer.compare(0, 7, "HTTP/1.") != 0 || buffer.size() < 12) {
+        error = EPROTO;
+        return false;
+    }
+    response.status = static_cast<unsigned>(std::strtoul(buffer.c_str() + 9, nullptr, 10));
+    response.keep_alive = buffer[7] == '1';
+
+    bool has_length = false;
+    size_t line = buffer.find("\r\n") + 2;
+    while (line < header_end) {
+        size_t line_end = buffer.find("\r\n", line);
+        const char* text = buffer.c_str() + line;
+        size_t length = line_end - line;
+        if (HeaderIs(text, length, "Content-Length")) {
+            response.body_length = static_cast<size_t>(std::strtoull(text + 15, nullptr, 10));
+            has_length = true;
+        } else if (HeaderIs(text, length, "Connection")) {
+            std::string value(text + 11, length - 11);
+            if (value.find("close") != std::string::npos) response.keep_alive = false;
+            if (value.find("keep-alive") != std::string::npos) response.keep_alive = true;
+        } else if (HeaderIs(text, length, "Transfer-Encoding")) {
+            error = EPROTONOSUPPORT;
+            return false;
+        }
+        line = line_end + 2;
+    }
+
+    response.body_begin = header_end + 4;
+    if (has_length) {
+        while (buffer.size() < response.body_begin + response.body_length) {
+            if (ReceiveSome(fd, buffer, error) <= 0) return false;
+        }
+    } else {
+        // Delimited by the end of the connection.
+        response.keep_alive = false;
+        while (ReceiveSome(fd, buffer, error) > 0) {
+        }
+        response.body_length = buffer.size() - response.body_begin;
+    }
+    return true;
+}
+
+VerifyResult VerifyKeyOnline(const std::string& key) {
+    TRACE_SCOPE("VerifyKeyOnline");
+    VerifyEndpoint endpoint;
+    uint64_t generation = 0;
+    {
+        std::lock_guard<std::mutex> lock(g_endpoint_mutex);
+        endpoint = g_endpoint;
+        generation = g_endpoint_generation;
+    }
+    if (endpoint.https) return NetworkFailure(VerifyStage::Open, EPROTONOSUPPORT, "TLS setup");
+
+    // Per-thread buffers keep steady-state requests from reallocating.
+    thread_local std::string request;
+    thread_local std::string buffer;
+    request.clear();
+    request += "GET ";
+    request += kVerifyPathPrefix;
+    request += UrlEncode(key);
+    request += " HTTP/1.1\r\nHost: ";
+    request += endpoint.host;
+    request += "\r\nUser-Agent: ModGui/1.0\r\nConnection: keep-alive\r\n\r\n";
+
+    // A pooled socket the server has since closed fails before any response
+    // arrives; that attempt is repeated once on a fresh connection.
+    for (int attempt = 0; attempt < 2; ++attempt) {
+        int error = 0;
+        int fd = TakeIdleSocket(generation);
+        bool reused = fd >= 0;
+        if (!reused) {
+            fd = ConnectSocket(endpoint, error);
+            if (fd < 0) return NetworkFailure(VerifyStage::Connect, error, "connect");
+        }
+        {
+            TRACE_SCOPE("verify.send");
+            if (!SendAll(fd, request, error)) {
+                close(fd);
+                if (reused) continue;
+                return NetworkFailure(VerifyStage::SendRequest, error, "send");
+            }
+        }
+        HttpResponse response;
+        bool received_any = false;
+        bool ok;
+        {
+            TRACE_SCOPE("verify.receive");
+            ok = ReadResponse(fd, buffer, response, received_any, error);
+        }
+        if (!ok) {
+            close(fd);
+            if (reused && !received_any) continue;
+            return NetworkFailure(VerifyStage::ReceiveResponse, error, "recv");
+        }
+        if (response.keep_alive) {
+            ReturnIdleSocket(fd, generation);
+        } else {
+            close(fd);
+        }
+
+        LogWrite(LogEvent::VerifyHttpStatus, response.status);
+        return ParseVerifyResponse(response.status, buffer.substr(response.body_begin, response.body_length),
+                                   static_cast<int64_t>(std::time(nullptr)));
+    }
+    return NetworkFailure(VerifyStage::SendRequest, ECONNRESET, "send");
+}
+
+#endif
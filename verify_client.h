@@ -0,0 +1,40 @@
+#pragma once
+#include <cstdint>
+#include <string>
+
+struct VerifyResult {
+    bool success = false;
+    // The server could not be reached or answered with a transient failure
+    // (HTTP 5xx or 429); worth retrying, and says nothing about the key.
+    bool network_error = false;
+    // A 2xx response that rejected the key. Other failures are neither this
+    // nor network errors, e.g. a 404 from a misconfigured endpoint.
+    bool declined = false;
+    std::string status_message;
+    // Unix seconds until which the server vouches for the key (from
+    // "expires_at", or now + "ttl"); 0 when the response carries neither.
+    int64_t expires_at = 0;
+};
+
+struct VerifyEndpoint {
+    std::string host = "example.com";
+    uint16_t port = 443;
+    bool https = true;
+};
+
+// Blocking round trip to the verification endpoint. Safe to call from
+// several threads at once; connections to the endpoint are kept alive and
+// reused between calls. Windows uses WinHTTP; the POSIX transport is plain
+// HTTP/1.1 over sockets and reports https endpoints as a network error.
+VerifyResult VerifyKeyOnline(const std::string& key);
+
+// Points VerifyKeyOnline() at another server, e.g. the loopback stand-in in
+// tools/. Idle connections to the previous endpoint are closed.
+void SetVerifyEndpoint(const VerifyEndpoint& endpoint);
+VerifyEndpoint GetVerifyEndpoint();
+// Parses "http://host[:port]" or "https://host[:port]".
+bool ParseVerifyEndpoint(const std::string& url, VerifyEndpoint& out);
+
+// Interprets a response by status code, then body; shared by the transports.
+// |now| is Unix seconds.
+VerifyResult ParseVerifyResponse(unsigned status_code, const std::string& body, int64_t now);
@@ -0,0 +1,127 @@
+#include "verify_scheduler.h"
+
+#include "event_log.h"
+#include "trace.h"
+
+VerifyScheduler::VerifyScheduler(VerifyFunction verify, VerifySchedulerConfig config)
+    : verify_(std::move(verify)), config_(config), rng_(std::random_device{}()) {
+    worker_ = std::thread(&VerifyScheduler::WorkerMain, this);
+}
+
+VerifyScheduler::~VerifyScheduler() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    cv_.notify_all();
+    // A blocking round trip may still be running; it finishes within the
+    // WinHTTP timeouts and its result is discarded.
+    worker_.join();
+}
+
+void VerifyScheduler::Request(const std::string& key) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Clock::time_point now = Clock::now();
+    bool same_key = key == key_ && generation_ != 0;
+    if (same_key && (pending_ || in_flight_)) {
+        return;
+    }
+    if (!same_key) {
+        ++generation_;
+        key_ = key;
+    }
+    // Leading edge fires immediately; anything inside the window waits for
+    // the trailing edge so a burst costs one round trip.
+    bool in_window = now - last_request_ < config_.debounce;
+    due_ = in_window ? last_request_ + config_.debounce : now;
+    last_request_ = now;
+    deadline_ = now + config_.deadline;
+    pending_ = true;
+    attempt_.store(0, std::memory_order_relaxed);
+    ready_.store(false, std::memory_order_relaxed);
+    busy_.store(true, std::memory_order_release);
+    cv_.notify_all();
+}
+
+void VerifyScheduler::Cancel() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    ++generation_;
+    key_.clear();
+    pending_ = false;
+    ready_.store(false, std::memory_order_relaxed);
+    busy_.store(false, std::memory_order_release);
+    cv_.notify_all();
+}
+
+bool VerifyScheduler::Poll(VerifyResult& out) {
+    if (!ready_.load(std::memory_order_acquire)) return false;
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!ready_.load(std::memory_order_relaxed)) return false;
+    out = result_;
+    ready_.store(false, std::memory_order_relaxed);
+    return true;
+}
+
+std::string VerifyScheduler::CurrentKey() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return key_;
+}
+
+std::chrono::milliseconds VerifyScheduler::BackoffDelay(int attempt) {
+    long long base = config_.initial_backoff.count();
+    for (int i = 1; i < attempt && base < config_.max_backoff.count(); ++i) {
+        base *= 2;
+    }
+    if (base > config_.max_backoff.count()) base = config_.max_backoff.count();
+    std::uniform_int_distribution<long long> jitter(base / 2, base);
+    return std::chrono::milliseconds(jitter(rng_));
+}
+
+void VerifyScheduler::WorkerMain() {
+    TRACE_THREAD_NAME("Verify worker");
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (!stop_) {
+        if (!pending_) {
+            cv_.wait(lock);
+            continue;
+        }
+        if (Clock::now() < due_) {
+            cv_.wait_until(lock, due_);
+            continue;
+        }
+
+        pending_ = false;
+        in_flight_ = true;
+        uint64_t generation = generation_;
+        std::string key = key_;
+        lock.unlock();
+
+        LogWrite(LogEvent::VerifyStarted, attempt_.load(std::memory_order_relaxed));
+        VerifyResult result = verify_(key);
+
+        lock.lock();
+        in_flight_ = false;
+        if (generation != generation_) {
+            // The key changed or was cancelled while in flight; a newer
+            // request, if any, is already pending.
+            continue;
+        }
+
+        Clock::time_point now = Clock::now();
+        if (result.network_error) {
+            int attempt = attempt_.load(std::memory_order_relaxed) + 1;
+            std::chrono::milliseconds delay = BackoffDelay(attempt);
+            if (now + delay < deadline_) {
+                LogWrite(LogEvent::VerifyRetryScheduled, attempt, delay.count());
+                attempt_.store(attempt, std::memory_order_relaxed);
+                due_ = now + delay;
+                pending_ = true;
+                continue;
+            }
+        }
+
+        result_ = result;
+        ready_.store(true, std::memory_order_release);
+        busy_.store(false, std::memory_order_release);
+    }
+}
@@ -0,0 +1,79 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+
+#include "verify_client.h"
+
+using VerifyFunction = std::function<VerifyResult(const std::string& key)>;
+
+struct VerifySchedulerConfig {
+    // Requests closer together than this are merged into one trailing request.
+    std::chrono::milliseconds debounce{300};
+    // Network errors, including HTTP 5xx and 429, retry after a jittered
+    // delay drawn from [b/2, b], where b doubles from initial_backoff up to
+    // max_backoff.
+    std::chrono::milliseconds initial_backoff{500};
+    std::chrono::milliseconds max_backoff{8000};
+    // No retry is started after this much time since the key was requested.
+    std::chrono::milliseconds deadline{20000};
+};
+
+// Runs key verification on a single worker thread:
+// - requests for the key already pending or in flight are coalesced
+// - bursts are debounced (leading edge, then trailing)
+// - network errors and transient server errors (VerifyResult::network_error)
+//   retry with jittered exponential backoff until the deadline
+// - results for a key that has since been replaced or cancelled are dropped
+class VerifyScheduler {
+public:
+    explicit VerifyScheduler(VerifyFunction verify, VerifySchedulerConfig config = VerifySchedulerConfig());
+    ~VerifyScheduler();
+    VerifyScheduler(const VerifyScheduler&) = delete;
+    VerifyScheduler& operator=(const VerifyScheduler&) = delete;
+
+    void Request(const std::string& key);
+    // Drops any pending or in-flight verification.
+    void Cancel();
+
+    // Returns true once per completed verification of the current key.
+    bool Poll(VerifyResult& out);
+
+    bool Busy() const { return busy_.load(std::memory_order_acquire); }
+    // Zero-based attempt number of the current verification, for status text.
+    int Attempt() const { return attempt_.load(std::memory_order_relaxed); }
+    std::string CurrentKey() const;
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    void WorkerMain();
+    std::chrono::milliseconds BackoffDelay(int attempt);
+
+    VerifyFunction verify_;
+    VerifySchedulerConfig config_;
+
+    mutable std::mutex mutex_;
+    std::condition_variable cv_;
+    std::string key_;
+    uint64_t generation_ = 0;
+    bool pending_ = false;
+    bool in_flight_ = false;
+    bool stop_ = false;
+    Clock::time_point due_;
+    Clock::time_point last_request_;
+    Clock::time_point deadline_;
+    VerifyResult result_;
+    std::mt19937 rng_;
+
+    std::atomic<bool> busy_{false};
+    std::atomic<bool> ready_{false};
+    std::atomic<int> attempt_{0};
+    std::thread worker_;
+};
@@ -0,0 +1,341 @@
+#include "xxh3.h"
+
+#include <cstring>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+// SSE2 is part of the x64 baseline; the accumulate and scramble steps work on
+// two 64-bit lanes per instruction there and fall back to scalar elsewhere.
+#if defined(_M_X64) || defined(__x86_64__) || defined(__SSE2__)
+#define XXH3_SSE2
+#include <emmintrin.h>
+#endif
+
+static const size_t kStripeLen = 64;
+static const size_t kSecretConsumeRate = 8;
+static const size_t kSecretSize = 192;
+static const size_t kStripesPerBlock = (kSecretSize - kStripeLen) / kSecretConsumeRate;
+static const size_t kSecretMergeAccsStart = 11;
+static const size_t kSecretLastAccStart = 7;
+static const size_t kMidSizeMax = 240;
+static const size_t kSecretSizeMin = 136;
+
+static const uint64_t kPrime32_1 = 0x9E3779B1U;
+static const uint64_t kPrime32_2 = 0x85EBCA77U;
+static const uint64_t kPrime32_3 = 0xC2B2AE3DU;
+static const uint64_t kPrime64_1 = 0x9E3779B185EBCA87ULL;
+static const uint64_t kPrime64_2 = 0xC2B2AE3D27D4EB4FULL;
+static const uint64_t kPrime64_3 = 0x165667B19E3779F9ULL;
+static const uint64_t kPrime64_4 = 0x85EBCA77C2B2AE63ULL;
+static const uint64_t kPrime64_5 = 0x27D4EB2F165667C5ULL;
+
+alignas(16) static const uint8_t kSecret[kSecretSize] = {
+    0xb8, 0xfe, 0x6c, 0x39, 0x23, 0xa4, 0x4b, 0xbe, 0x7c, 0x01, 0x81, 0x2c, 0xf7, 0x21, 0xad, 0x1c,
+    0xde, 0xd4, 0x6d, 0xe9, 0x83, 0x90, 0x97, 0xdb, 0x72, 0x40, 0xa4, 0xa4, 0xb7, 0xb3, 0x67, 0x1f,
+    0xcb, 0x79, 0xe6, 0x4e, 0xcc, 0xc0, 0xe5, 0x78, 0x82, 0x5a, 0xd0, 0x7d, 0xcc, 0xff, 0x72, 0x21,
+    0xb8, 0x08, 0x46, 0x74, 0xf7, 0x43, 0x24, 0x8e, 0xe0, 0x35, 0x90, 0xe6, 0x81, 0x3a, 0x26, 0x4c,
+    0x3c, 0x28, 0x52, 0xbb, 0x91, 0xc3, 0x00, 0xcb, 0x88, 0xd0, 0x65, 0x8b, 0x1b, 0x53, 0x2e, 0xa3,
+    0x71, 0x64, 0x48, 0x97, 0xa2, 0x0d, 0xf9, 0x4e, 0x38, 0x19, 0xef, 0x46, 0xa9, 0xde, 0xac, 0xd8,
+    0xa8, 0xfa, 0x76, 0x3f, 0xe3, 0x9c, 0x34, 0x3f, 0xf9, 0xdc, 0xbb, 0xc7, 0xc7, 0x0b, 0x4f, 0x1d,
+    0x8a, 0x51, 0xe0, 0x4b, 0xcd, 0xb4, 0x59, 0x31, 0xc8, 0x9f, 0x7e, 0xc9, 0xd9, 0x78, 0x73, 0x64,
+    0xea, 0xc5, 0xac, 0x83, 0x34, 0xd3, 0xeb, 0xc3, 0xc5, 0x81, 0xa0, 0xff, 0xfa, 0x13, 0x63, 0xeb,
+    0x17, 0x0d, 0xdd, 0x51, 0xb7, 0xf0, 0xda, 0x49, 0xd3, 0x16, 0x55, 0x26, 0x29, 0xd4, 0x68, 0x9e,
+    0x2b, 0x16, 0xbe, 0x58, 0x7d, 0x47, 0xa1, 0xfc, 0x8f, 0xf8, 0xb8, 0xd1, 0x7a, 0xd0, 0x31, 0xce,
+    0x45, 0xcb, 0x3a, 0x8f, 0x95, 0x16, 0x04, 0x28, 0xaf, 0xd7, 0xfb, 0xca, 0xbb, 0x4b, 0x40, 0x7e,
+};
+
+static const uint64_t kInitialAcc[8] = {
+    kPrime32_3, kPrime64_1, kPrime64_2, kPrime64_3, kPrime64_4, kPrime32_2, kPrime64_5, kPrime32_1
+};
+
+// Little-endian loads; every supported target is little-endian.
+static inline uint32_t Read32(const uint8_t* p) {
+    uint32_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+static inline uint64_t Read64(const uint8_t* p) {
+    uint64_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+static inline uint64_t RotateLeft(uint64_t v, int n) {
+    return (v << n) | (v >> (64 - n));
+}
+
+static inline uint64_t Swap64(uint64_t v) {
+#if defined(_MSC_VER)
+    return _byteswap_uint64(v);
+#else
+    return __builtin_bswap64(v);
+#endif
+}
+
+static inline uint32_t Swap32(uint32_t v) {
+#if defined(_MSC_VER)
+    return _byteswap_ulong(v);
+#else
+    return __builtin_bswap32(v);
+#endif
+}
+
+// Low and high halves of the 128-bit product, xor-folded.
+static inline uint64_t Mul128Fold64(uint64_t a, uint64_t b) {
+#if defined(_MSC_VER) && defined(_M_X64)
+    uint64_t high = 0;
+    uint64_t low = _umul128(a, b, &high);
+    return low ^ high;
+#elif defined(__SIZEOF_INT128__)
+    unsigned __int128 product = static_cast<unsigned __int128>(a) * b;
+    return static_cast<uint64_t>(product) ^ static_cast<uint64_t>(product >> 64);
+#else
+    uint64_t lo_lo = (a & 0xFFFFFFFF) * (b & 0xFFFFFFFF);
+    uint64_t hi_lo = (a >> 32) * (b & 0xFFFFFFFF);
+    uint64_t lo_hi = (a & 0xFFFFFFFF) * (b >> 32);
+    uint64_t hi_hi = (a >> 32) * (b >> 32);
+    uint64_t cross = (lo_lo >> 32) + (hi_lo & 0xFFFFFFFF) + lo_hi;
+    uint64_t upper = (hi_lo >> 32) + (cross >> 32) + hi_hi;
+    uint64_t lower = (cross << 32) | (lo_lo & 0xFFFFFFFF);
+    return lower ^ upper;
+#endif
+}
+
+static inline uint64_t Xxh64Avalanche(uint64_t h) {
+    h ^= h >> 33;
+    h *= kPrime64_2;
+    h ^= h >> 29;
+    h *= kPrime64_3;
+    h ^= h >> 32;
+    return h;
+}
+
+static inline uint64_t Avalanche(uint64_t h) {
+    h ^= h >> 37;
+    h *= 0x165667919E3779F9ULL;
+    h ^= h >> 32;
+    return h;
+}
+
+static inline uint64_t StrongAvalanche(uint64_t h, uint64_t len) {
+    h ^= RotateLeft(h, 49) ^ RotateLeft(h, 24);
+    h *= 0x9FB21C651E98DF25ULL;
+    h ^= (h >> 35) + len;
+    h *= 0x9FB21C651E98DF25ULL;
+    h ^= h >> 28;
+    return h;
+}
+
+static inline uint64_t Mix16(const uint8_t* input, const uint8_t* secret) {
+    return Mul128Fold64(Read64(input) ^ Read64(secret), Read64(input + 8) ^ Read64(secret + 8));
+}
+
+static uint64_t Hash0To16(const uint8_t* input, size_t len) {
+    if (len > 8) {
+        uint64_t lo = Read64(input) ^ (Read64(kSecret + 24) ^ Read64(kSecret + 32));
+        uint64_t hi = Read64(input + len - 8) ^ (Read64(kSecret + 40) ^ Read64(kSecret + 48));
+        return Avalanche(len + Swap64(lo) + hi + Mul128Fold64(lo, hi));
+    }
+    if (len >= 4) {
+        uint64_t flip = Read64(kSecret + 8) ^ Read64(kSecret + 16);
+        uint64_t combined = static_cast<uint64_t>(Read32(input + len - 4)) + (static_cast<uint64_t>(Read32(input)) << 32);
+        return StrongAvalanche(combined ^ flip, len);
+    }
+    if (len > 0) {
+        uint32_t combined = (static_cast<uint32_t>(input[0]) << 16) | (static_cast<uint32_t>(input[len >> 1]) << 24) |
+                            static_cast<uint32_t>(input[len - 1]) | (static_cast<uint32_t>(len) << 8);
+        uint64_t flip = Read32(kSecret) ^ Read32(kSecret + 4);
+        return Xxh64Avalanche(combined ^ flip);
+    }
+    return Xxh64Avalanche(Read64(kSecret + 56) ^ Read64(kSecret + 64));
+}
+
+static uint64_t Hash17To128(const uint8_t* input, size_t len) {
+    uint64_t acc = len * kPrime64_1;
+    if (len > 32) {
+        if (len > 64) {
+            if (len > 96) {
+                acc += Mix16(input + 48, kSecret + 96);
+                acc += Mix16(input + len - 64, kSecret + 112);
+            }
+            acc += Mix16(input + 32, kSecret + 64);
+            acc += Mix16(input + len - 48, kSecret + 80);
+        }
+        acc += Mix16(input + 16, kSecret + 32);
+        acc += Mix16(input + len - 32, kSecret + 48);
+    }
+    acc += Mix16(input, kSecret);
+    acc += Mix16(input + len - 16, kSecret + 16);
+    return Avalanche(acc);
+}
+
+static uint64_t Hash129To240(const uint8_t* input, size_t len) {
+    uint64_t acc = len * kPrime64_1;
+    size_t rounds = len / 16;
+    for (size_t i = 0; i < 8; ++i) {
+        acc += Mix16(input + 16 * i, kSecret + 16 * i);
+    }
+    acc = Avalanche(acc);
+    for (size_t i = 8; i < rounds; ++i) {
+        acc += Mix16(input + 16 * i, kSecret + 16 * (i - 8) + 3);
+    }
+    acc += Mix16(input + len - 16, kSecret + kSecretSizeMin - 17);
+    return Avalanche(acc);
+}
+
+static inline void Accumulate512(uint64_t* acc, const uint8_t* input, const uint8_t* secret) {
+#ifdef XXH3_SSE2
+    __m128i* xacc = reinterpret_cast<__m128i*>(acc);
+    for (int i = 0; i < 4; ++i) {
+        __m128i data = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input) + i);
+        __m128i key = _mm_loadu_si128(reinterpret_cast<const __m128i*>(secret) + i);
+        __m128i data_key = _mm_xor_si128(data, key);
+        __m128i data_key_hi = _mm_shuffle_epi32(data_key, _MM_SHUFFLE(0, 3, 0, 1));
+        __m128i product = _mm_mul_epu32(data_key, data_key_hi);
+        __m128i data_swap = _mm_shuffle_epi32(data, _MM_SHUFFLE(1, 0, 3, 2));
+        xacc[i] = _mm_add_epi64(_mm_add_epi64(xacc[i], data_swap), product);
+    }
+#else
+    for (int i = 0; i < 8; ++i) {
+        uint64_t data = Read64(input + 8 * i);
+        uint64_t data_key = data ^ Read64(secret + 8 * i);
+        acc[i ^ 1] += data;
+        acc[i] += (data_key & 0xFFFFFFFF) * (data_key >> 32);
+    }
+#endif
+}
+
+static inline void ScrambleAcc(uint64_t* acc, const uint8_t* secret) {
+#ifdef XXH3_SSE2
+    __m128i* xacc = reinterpret_cast<__m128i*>(acc);
+    const __m128i prime = _mm_set1_epi32(static_cast<int>(kPrime32_1));
+    for (int i = 0; i < 4; ++i) {
+        __m128i value = _mm_xor_si128(xacc[i], _mm_srli_epi64(xacc[i], 47));
+        __m128i key = _mm_loadu_si128(reinterpret_cast<const __m128i*>(secret) + i);
+        __m128i data_key = _mm_xor_si128(value, key);
+        __m128i data_key_hi = _mm_shuffle_epi32(data_key, _MM_SHUFFLE(0, 3, 0, 1));
+        __m128i product_lo = _mm_mul_epu32(data_key, prime);
+        __m128i product_hi = _mm_mul_epu32(data_key_hi, prime);
+        xacc[i] = _mm_add_epi64(product_lo, _mm_slli_epi64(product_hi, 32));
+    }
+#else
+    for (int i = 0; i < 8; ++i) {
+        uint64_t value = acc[i] ^ (acc[i] >> 47);
+        acc[i] = (value ^ Read64(secret + 8 * i)) * kPrime32_1;
+    }
+#endif
+}
+
+static inline void AccumulateStripes(uint64_t* acc, const uint8_t* input, const uint8_t* secret, size_t stripes) {
+    for (size_t i = 0; i < stripes; ++i) {
+        Accumulate512(acc, input + i * kStripeLen, secret + i * kSecretConsumeRate);
+    }
+}
+
+// Consumes |stripes| full stripes, scrambling at each block boundary. Returns
+// the new stripe position within the current block.
+static size_t ConsumeStripes(uint64_t* acc, size_t stripes_in_block, const uint8_t* input, size_t stripes) {
+    size_t to_end = kStripesPerBlock - stripes_in_block;
+    if (to_end <= stripes) {
+        AccumulateStripes(acc, input, kSecret + stripes_in_block * kSecretConsumeRate, to_end);
+        ScrambleAcc(acc, kSecret + kSecretSize - kStripeLen);
+        AccumulateStripes(acc, input + to_end * kStripeLen, kSecret, stripes - to_end);
+        return stripes - to_end;
+    }
+    AccumulateStripes(acc, input, kSecret + stripes_in_block * kSecretConsumeRate, stripes);
+    return stripes_in_block + stripes;
+}
+
+static uint64_t MergeAccs(const uint64_t* acc, const uint8_t* secret, uint64_t start) {
+    uint64_t result = start;
+    for (int i = 0; i < 4; ++i) {
+        result += Mul128Fold64(acc[2 * i] ^ Read64(secret + 16 * i), acc[2 * i + 1] ^ Read64(secret + 16 * i + 8));
+    }
+    return Avalanche(result);
+}
+
+static uint64_t HashLong(const uint8_t* input, size_t len) {
+    alignas(16) uint64_t acc[8];
+    memcpy(acc, kInitialAcc, sizeof(acc));
+    size_t block_len = kStripeLen * kStripesPerBlock;
+    size_t blocks = (len - 1) / block_len;
+    for (size_t b = 0; b < blocks; ++b) {
+        AccumulateStripes(acc, input + b * block_len, kSecret, kStripesPerBlock);
+        ScrambleAcc(acc, kSecret + kSecretSize - kStripeLen);
+    }
+    size_t stripes = ((len - 1) - block_len * blocks) / kStripeLen;
+    AccumulateStripes(acc, input + blocks * block_len, kSecret, stripes);
+    Accumulate512(acc, input + len - kStripeLen, kSecret + kSecretSize - kStripeLen - kSecretLastAccStart);
+    return MergeAccs(acc, kSecret + kSecretMergeAccsStart, len * kPrime64_1);
+}
+
+uint64_t Xxh3Hash(const void* data, size_t size) {
+    const uint8_t* input = static_cast<const uint8_t*>(data);
+    if (size <= 16) return Hash0To16(input, size);
+    if (size <= 128) return Hash17To128(input, size);
+    if (size <= kMidSizeMax) return Hash129To240(input, size);
+    return HashLong(input, size);
+}
+
+Xxh3::Xxh3() {
+    memcpy(acc_, kInitialAcc, sizeof(acc_));
+}
+
+// Input is consumed a buffer's worth of stripes at a time. The last stripe of
+// the data is always kept in the buffer, because the digest treats the final
+// stripe differently.
+void Xxh3::Update(const void* data, size_t size) {
+    const uint8_t* input = static_cast<const uint8_t*>(data);
+    total_ += size;
+    if (buffered_ + size <= kBufferSize) {
+        memcpy(buffer_ + buffered_, input, size);
+        buffered_ += size;
+        return;
+    }
+
+    const size_t buffer_stripes = kBufferSize / kStripeLen;
+    if (buffered_ > 0) {
+        size_t fill = kBufferSize - buffered_;
+        memcpy(buffer_ + buffered_, input, fill);
+        input += fill;
+        size -= fill;
+        stripes_in_block_ = ConsumeStripes(acc_, stripes_in_block_, buffer_, buffer_stripes);
+        buffered_ = 0;
+    }
+
+    if (size > kBufferSize) {
+        do {
+            stripes_in_block_ = ConsumeStripes(acc_, stripes_in_block_, input, buffer_stripes);
+            input += kBufferSize;
+            size -= kBufferSize;
+        } while (size > kBufferSize);
+        // Digest may need the tail of the previous stripe.
+        memcpy(buffer_ + kBufferSize - kStripeLen, input - kStripeLen, kStripeLen);
+    }
+
+    memcpy(buffer_, input, size);
+    buffered_ = size;
+}
+
+uint64_t Xxh3::Digest() const {
+    if (total_ <= kMidSizeMax) return Xxh3Hash(buffer_, buffered_);
+
+    alignas(16) uint64_t acc[8];
+    memcpy(acc, acc_, sizeof(acc));
+    if (buffered_ >= kStripeLen) {
+        size_t stripes = (buffered_ - 1) / kStripeLen;
+        ConsumeStripes(acc, stripes_in_block_, buffer_, stripes);
+        Accumulate512(acc, buffer_ + buffered_ - kStripeLen, kSecret + kSecretSize - kStripeLen - kSecretLastAccStart);
+    } else {
+        // Rebuild the last stripe from the end of the previous buffer.
+        uint8_t last_stripe[kStripeLen];
+        size_t catchup = kStripeLen - buffered_;
+        memcpy(last_stripe, buffer_ + kBufferSize - catchup, catchup);
+        memcpy(last_stripe + catchup, buffer_, buffered_);
+        Accumulate512(acc, last_stripe, kSecret + kSecretSize - kStripeLen - kSecretLastAccStart);
+    }
+    return MergeAccs(acc, kSecret + kSecretMergeAccsStart, total_ * kPrime64_1);
+}
@@ -0,0 +1,25 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+// XXH3-64 with the default secret and seed 0, bit-compatible with the
+// reference xxHash implementation. Used to fingerprint launch targets; not a
+// cryptographic hash.
+
+struct Xxh3 {
+    Xxh3();
+    void Update(const void* data, size_t size);
+    // May be called at any point; does not modify the state.
+    uint64_t Digest() const;
+
+private:
+    static const size_t kBufferSize = 256;
+
+    alignas(16) uint64_t acc_[8];
+    alignas(16) uint8_t buffer_[kBufferSize];
+    size_t buffered_ = 0;
+    size_t stripes_in_block_ = 0;
+    uint64_t total_ = 0;
+};
+
+uint64_t Xxh3Hash(const void* data, size_t size);